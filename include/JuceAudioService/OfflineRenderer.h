@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <juce_audio_basics/juce_audio_basics.h>
 
 namespace juceaudioservice
@@ -10,12 +11,18 @@ namespace juceaudioservice
 
     Provides frame-accurate windowing and sample rate conversion
     for deterministic audio processing.
+
+    Sample rate conversion uses a polyphase windowed-sinc filter and pulls
+    the source in blocks, so no buffer the size of the source is ever
+    built. The filter history is kept between calls: a renderWindow() that
+    starts where the previous one ended on the same source continues the
+    stream, and consecutive windows join without clicks or drift.
 */
 class OfflineRenderer
 {
 public:
     OfflineRenderer();
-    ~OfflineRenderer() = default;
+    ~OfflineRenderer();
 
     /**
         Render an AudioSource to an AudioBuffer.
@@ -35,6 +42,11 @@ public:
     /**
         Render a windowed section of an AudioSource.
 
+        When the rates differ the result holds the output samples whose
+        positions fall inside the window, about numFrames * outputSampleRate
+        / sourceSampleRate of them. The source is left prepared so that the
+        next window can continue from it.
+
         @param source The AudioSource to render from
         @param startFrame The starting frame in the source
         @param numFrames The number of frames to render
@@ -51,22 +63,59 @@ public:
         double outputSampleRate,
         int numChannels);
 
+    /**
+        Forget the resampling state carried over from the last window.
+
+        The next renderWindow() then starts a new stream even if it
+        continues where the previous window ended.
+    */
+    void reset();
+
 private:
     // Buffer size for rendering chunks
     static constexpr int renderBlockSize = 1024;
 
+    struct ResampleStream;
+    std::unique_ptr<ResampleStream> stream;
+
     /**
-        Perform sample rate conversion if needed.
+        Check whether a window continues the current resampling stream.
+    */
+    bool continuesStream(
+        const juce::AudioSource& source,
+        juce::int64 startFrame,
+        double sourceSampleRate,
+        double outputSampleRate,
+        int numChannels) const;
 
-        @param inputBuffer The input buffer
-        @param inputSampleRate The input sample rate
-        @param outputSampleRate The desired output sample rate
-        @returns The converted buffer (or original if no conversion needed)
+    /**
+        Start a resampling stream whose first output lines up with startFrame.
+
+        @returns false if the rates can't be converted
+    */
+    bool startStream(
+        juce::AudioSource& source,
+        juce::int64 startFrame,
+        double sourceSampleRate,
+        double outputSampleRate,
+        int numChannels);
+
+    /**
+        Resample a run of output from the current stream.
+
+        @param output Receives the samples starting at sample 0
+        @param firstOutput Stream index of the first output sample
+        @param numOutputs Number of output samples
+    */
+    void renderResampled(
+        juce::AudioBuffer<float>& output,
+        juce::int64 firstOutput,
+        int numOutputs);
+
+    /**
+        Pull source frames into the stream history up to a stream position.
     */
-    juce::AudioBuffer<float> convertSampleRate(
-        const juce::AudioBuffer<float>& inputBuffer,
-        double inputSampleRate,
-        double outputSampleRate);
+    void fillHistory(juce::int64 endPosition);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
 };
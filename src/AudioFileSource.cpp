@@ -1,4 +1,5 @@
 #include "JuceAudioService/AudioFileSource.h"
+#include "util/MediaReader.h"
 
 namespace juceaudioservice
 {
@@ -23,8 +24,8 @@ bool AudioFileSource::loadFile(const juce::File& file)
     if (!file.exists())
         return false;
 
-    // Create a new reader for the file
-    reader.reset(formatManager.createReaderFor(file));
+    // Create a new reader for the file, memory-mapped when the format supports it
+    reader = createMediaReader(formatManager, file);
 
     return reader != nullptr;
 }
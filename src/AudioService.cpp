@@ -79,64 +79,58 @@ juce::String AudioService::computePCMHash(
 {
     juce::ScopedNoDenormals noDenormals;
 
-    // Create a memory output stream to collect PCM data
-    juce::MemoryOutputStream pcmStream;
-
     const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
 
-    // Convert and write PCM data based on bit depth
+    // The checksum is folded in as each quantized sample is produced, in the
+    // same little-endian byte order a PCM byte stream would have, so no copy
+    // of the PCM data is ever built
+    juce::uint32 checksum = 0;
+
+    const auto addByte = [&checksum] (juce::uint32 byte) noexcept
+    {
+        checksum = (checksum << 8) ^ (byte & 0xFF);
+        checksum ^= (checksum >> 16);
+    };
+
+    const auto addBytes = [&addByte] (juce::uint32 value, int numBytes) noexcept
+    {
+        for (int i = 0; i < numBytes; ++i)
+            addByte(value >> (8 * i));
+    };
+
+    const auto* const* channels = buffer.getArrayOfReadPointers();
+
     for (int sample = 0; sample < numSamples; ++sample)
     {
         for (int channel = 0; channel < numChannels; ++channel)
         {
-            const float floatSample = buffer.getSample(channel, sample);
+            const float floatSample = channels[channel][sample];
 
             if (bitDepth == 16)
             {
                 // Convert to 16-bit signed integer
-                const auto intSample = static_cast<juce::int16>(
-                    juce::jlimit(-32768, 32767, static_cast<int>(floatSample * 32767.0f))
-                );
-                pcmStream.writeShort(intSample);
+                const auto intSample = juce::jlimit(-32768, 32767, static_cast<int>(floatSample * 32767.0f));
+                addBytes(static_cast<juce::uint32>(intSample), 2);
             }
             else if (bitDepth == 24)
             {
-                // Convert to 24-bit signed integer (stored as 32-bit)
-                const auto intSample = static_cast<juce::int32>(
-                    juce::jlimit(-8388608, 8388607, static_cast<int>(floatSample * 8388607.0f))
-                );
-                // Write as 24-bit (3 bytes, little endian)
-                pcmStream.writeByte(static_cast<char>(intSample & 0xFF));
-                pcmStream.writeByte(static_cast<char>((intSample >> 8) & 0xFF));
-                pcmStream.writeByte(static_cast<char>((intSample >> 16) & 0xFF));
+                // Convert to 24-bit signed integer (3 bytes, little endian)
+                const auto intSample = juce::jlimit(-8388608, 8388607, static_cast<int>(floatSample * 8388607.0f));
+                addBytes(static_cast<juce::uint32>(intSample), 3);
             }
             else if (bitDepth == 32)
             {
                 // Convert to 32-bit signed integer
                 const auto intSample = static_cast<juce::int32>(
                     juce::jlimit(-2147483648LL, 2147483647LL,
-                                static_cast<juce::int64>(floatSample * 2147483647.0f))
+                                 static_cast<juce::int64>(floatSample * 2147483647.0f))
                 );
-                pcmStream.writeInt(intSample);
+                addBytes(static_cast<juce::uint32>(intSample), 4);
             }
         }
     }
 
-    // Compute checksum of the PCM data
-    const auto pcmData = pcmStream.getData();
-    const auto pcmSize = pcmStream.getDataSize();
-
-    // Simple CRC32-style checksum for deterministic verification
-    juce::uint32 checksum = 0;
-    const auto* bytes = static_cast<const juce::uint8*>(pcmData);
-
-    for (size_t i = 0; i < pcmSize; ++i)
-    {
-        checksum = (checksum << 8) ^ bytes[i];
-        checksum ^= (checksum >> 16);
-    }
-
     return juce::String::toHexString(static_cast<int>(checksum)).paddedLeft('0', 8);
 }
 
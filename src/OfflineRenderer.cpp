@@ -1,13 +1,41 @@
 #include "JuceAudioService/OfflineRenderer.h"
 #include "JuceAudioService/AudioFileSource.h"
+#include "util/Resampler.h"
+#include <cstring>
 
 namespace juceaudioservice
 {
 
+/**
+    Resampling state carried from one renderWindow() call to the next.
+
+    Positions are source frames relative to origin, which is where output
+    sample 0 sits; history holds the input the filter still needs.
+*/
+struct OfflineRenderer::ResampleStream
+{
+    Resampler resampler;
+    juce::AudioSource* source = nullptr;
+    double sourceSampleRate = 0.0;
+    double outputSampleRate = 0.0;
+    int numChannels = 0;
+
+    juce::int64 origin = 0;         // source frame of output sample 0
+    juce::int64 nextFrame = 0;      // source frame a continuing window starts at
+    juce::int64 prerollStart = 0;   // first position read from the source; earlier input is silence
+    juce::int64 sourcePosition = 0; // AudioFileSource position after the last window
+
+    juce::AudioBuffer<float> history;
+    juce::int64 historyStart = 0;
+    juce::int64 historyEnd = 0;
+};
+
 OfflineRenderer::OfflineRenderer()
 {
 }
 
+OfflineRenderer::~OfflineRenderer() = default;
+
 juce::AudioBuffer<float> OfflineRenderer::renderToBuffer(
     juce::AudioSource& source,
     double sampleRate,
@@ -57,80 +85,197 @@ juce::AudioBuffer<float> OfflineRenderer::renderWindow(
 {
     juce::ScopedNoDenormals noDenormals;
 
-    // Position the source at the start frame
+    if (juce::approximatelyEqual(sourceSampleRate, outputSampleRate))
+    {
+        // renderToBuffer() releases the source, so no stream can continue after this
+        reset();
+
+        // Position the source at the start frame
+        if (auto* fileSource = dynamic_cast<AudioFileSource*>(&source))
+        {
+            fileSource->setPosition(startFrame);
+        }
+
+        return renderToBuffer(source, sourceSampleRate, numChannels, numFrames);
+    }
+
+    if (!continuesStream(source, startFrame, sourceSampleRate, outputSampleRate, numChannels)
+        && !startStream(source, startFrame, sourceSampleRate, outputSampleRate, numChannels))
+    {
+        jassertfalse;
+        return juce::AudioBuffer<float>(numChannels, 0);
+    }
+
+    // Output samples whose positions fall inside [startFrame, startFrame + numFrames)
+    const auto windowStart = startFrame - stream->origin;
+    const auto firstOutput = stream->resampler.getFirstOutputAtOrAfter(windowStart);
+    const auto endOutput = stream->resampler.getFirstOutputAtOrAfter(windowStart + juce::jmax(0, numFrames));
+    const auto numOutputs = static_cast<int>(endOutput - firstOutput);
+
+    juce::AudioBuffer<float> outputBuffer(numChannels, numOutputs);
+    renderResampled(outputBuffer, firstOutput, numOutputs);
+
+    stream->nextFrame = startFrame + juce::jmax(0, numFrames);
     if (auto* fileSource = dynamic_cast<AudioFileSource*>(&source))
     {
-        fileSource->setPosition(startFrame);
+        stream->sourcePosition = fileSource->getPosition();
     }
 
-    // Render at source sample rate first
-    auto sourceBuffer = renderToBuffer(source, sourceSampleRate, numChannels, numFrames);
+    return outputBuffer;
+}
 
-    // Convert sample rate if needed
-    if (juce::approximatelyEqual(sourceSampleRate, outputSampleRate))
+void OfflineRenderer::reset()
+{
+    stream.reset();
+}
+
+bool OfflineRenderer::continuesStream(
+    const juce::AudioSource& source,
+    juce::int64 startFrame,
+    double sourceSampleRate,
+    double outputSampleRate,
+    int numChannels) const
+{
+    if (stream == nullptr
+        || stream->source != &source
+        || stream->nextFrame != startFrame
+        || stream->numChannels != numChannels
+        || !juce::approximatelyEqual(stream->sourceSampleRate, sourceSampleRate)
+        || !juce::approximatelyEqual(stream->outputSampleRate, outputSampleRate))
     {
-        return sourceBuffer;
+        return false;
     }
-    else
+
+    // A file source that was repositioned since the last window no longer feeds this stream
+    if (auto* fileSource = dynamic_cast<const AudioFileSource*>(&source))
     {
-        return convertSampleRate(sourceBuffer, sourceSampleRate, outputSampleRate);
+        return fileSource->getPosition() == stream->sourcePosition;
     }
+
+    return true;
 }
 
-juce::AudioBuffer<float> OfflineRenderer::convertSampleRate(
-    const juce::AudioBuffer<float>& inputBuffer,
-    double inputSampleRate,
-    double outputSampleRate)
+bool OfflineRenderer::startStream(
+    juce::AudioSource& source,
+    juce::int64 startFrame,
+    double sourceSampleRate,
+    double outputSampleRate,
+    int numChannels)
 {
-    juce::ScopedNoDenormals noDenormals;
+    auto newStream = std::make_unique<ResampleStream>();
+    if (!newStream->resampler.prepare(sourceSampleRate, outputSampleRate))
+    {
+        stream.reset();
+        return false;
+    }
+
+    newStream->source = &source;
+    newStream->sourceSampleRate = sourceSampleRate;
+    newStream->outputSampleRate = outputSampleRate;
+    newStream->numChannels = numChannels;
+    newStream->origin = startFrame;
+    newStream->nextFrame = startFrame;
+
+    // The first output needs input from before the window; read it from the file when there is any
+    juce::int64 firstInput = 0;
+    int numInputs = 0;
+    newStream->resampler.getInputRange(0, 1, firstInput, numInputs);
 
-    if (juce::approximatelyEqual(inputSampleRate, outputSampleRate))
+    juce::int64 preroll = 0;
+    if (auto* fileSource = dynamic_cast<AudioFileSource*>(&source))
     {
-        return inputBuffer; // No conversion needed
+        preroll = juce::jmin(startFrame, -firstInput);
+        fileSource->setPosition(startFrame - preroll);
     }
 
-    // Calculate the conversion ratio
-    const double ratio = outputSampleRate / inputSampleRate;
-    const int outputLength = static_cast<int>(inputBuffer.getNumSamples() * ratio);
+    newStream->prerollStart = -preroll;
+    newStream->historyStart = firstInput;
+    newStream->historyEnd = firstInput;
+    newStream->history.setSize(numChannels, newStream->resampler.getMaxInputSamples(renderBlockSize));
 
-    // Create output buffer
-    juce::AudioBuffer<float> outputBuffer(inputBuffer.getNumChannels(), outputLength);
+    source.prepareToPlay(renderBlockSize, sourceSampleRate);
+
+    stream = std::move(newStream);
+    return true;
+}
 
-    // Simple linear interpolation resampling
-    // Note: For production use, consider using JUCE's ResamplingAudioSource
-    // but for deterministic testing, this simple approach is sufficient
-    for (int channel = 0; channel < inputBuffer.getNumChannels(); ++channel)
+void OfflineRenderer::renderResampled(
+    juce::AudioBuffer<float>& output,
+    juce::int64 firstOutput,
+    int numOutputs)
+{
+    auto& history = stream->history;
+    int samplesDone = 0;
+
+    while (samplesDone < numOutputs)
     {
-        const float* inputData = inputBuffer.getReadPointer(channel);
-        float* outputData = outputBuffer.getWritePointer(channel);
+        const int samplesToRender = juce::jmin(numOutputs - samplesDone, renderBlockSize);
 
-        for (int i = 0; i < outputLength; ++i)
-        {
-            const double sourceIndex = i / ratio;
-            const int sourceIndexInt = static_cast<int>(sourceIndex);
-            const double fraction = sourceIndex - sourceIndexInt;
+        juce::int64 firstInput = 0;
+        int numInputs = 0;
+        stream->resampler.getInputRange(firstOutput + samplesDone, samplesToRender, firstInput, numInputs);
+        jassert(firstInput >= stream->historyStart && firstInput <= stream->historyEnd);
 
-            if (sourceIndexInt < inputBuffer.getNumSamples() - 1)
-            {
-                // Linear interpolation
-                const float sample1 = inputData[sourceIndexInt];
-                const float sample2 = inputData[sourceIndexInt + 1];
-                outputData[i] = sample1 + static_cast<float>(fraction) * (sample2 - sample1);
-            }
-            else if (sourceIndexInt < inputBuffer.getNumSamples())
-            {
-                // Last sample
-                outputData[i] = inputData[sourceIndexInt];
-            }
-            else
+        // Drop the history this run no longer needs
+        const auto discard = static_cast<int>(firstInput - stream->historyStart);
+        const auto kept = static_cast<int>(stream->historyEnd - firstInput);
+        if (discard > 0)
+        {
+            for (int channel = 0; channel < history.getNumChannels(); ++channel)
             {
-                // Beyond input range
-                outputData[i] = 0.0f;
+                float* data = history.getWritePointer(channel);
+                std::memmove(data, data + discard, static_cast<size_t>(kept) * sizeof(float));
             }
+
+            stream->historyStart = firstInput;
         }
+
+        fillHistory(firstInput + numInputs);
+
+        const auto historySamples = static_cast<int>(stream->historyEnd - stream->historyStart);
+        for (int channel = 0; channel < output.getNumChannels(); ++channel)
+        {
+            stream->resampler.process(
+                history.getReadPointer(channel),
+                stream->historyStart,
+                historySamples,
+                output.getWritePointer(channel, samplesDone),
+                firstOutput + samplesDone,
+                samplesToRender);
+        }
+
+        samplesDone += samplesToRender;
     }
+}
 
-    return outputBuffer;
+void OfflineRenderer::fillHistory(juce::int64 endPosition)
+{
+    auto& history = stream->history;
+
+    while (stream->historyEnd < endPosition)
+    {
+        const auto offset = static_cast<int>(stream->historyEnd - stream->historyStart);
+        auto count = static_cast<int>(juce::jmin<juce::int64>(renderBlockSize, endPosition - stream->historyEnd));
+        jassert(offset + count <= history.getNumSamples());
+
+        if (stream->historyEnd < stream->prerollStart)
+        {
+            // Before the start of the source: silence
+            count = static_cast<int>(juce::jmin<juce::int64>(count, stream->prerollStart - stream->historyEnd));
+            history.clear(offset, count);
+        }
+        else
+        {
+            juce::AudioSourceChannelInfo channelInfo;
+            channelInfo.buffer = &history;
+            channelInfo.startSample = offset;
+            channelInfo.numSamples = count;
+
+            stream->source->getNextAudioBlock(channelInfo);
+        }
+
+        stream->historyEnd += count;
+    }
 }
 
 } // namespace juceaudioservice
\ No newline at end of file
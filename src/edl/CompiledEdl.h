@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace juceaudioservice {
+
+/*
+ * Internal timeline representation produced by EdlCompiler.
+ *
+ * A CompiledEdl is immutable once built and shared by refcount: EdlStore
+ * keeps one per applied revision and every render of that revision holds
+ * it for as long as it runs. It holds no protobuf objects: media are
+ * copied into a table and clips name them by index. Tracks are shared
+ * between revisions, so later revisions only append to the table.
+ */
+
+enum class FadeShape {
+    Linear,
+    EqualPower
+};
+
+struct FadeSpec {
+    int64_t length_samples = 0;
+    FadeShape shape = FadeShape::Linear;
+
+    bool isEmpty() const { return length_samples == 0; }
+};
+
+// Position of a media file in CompiledEdl::media
+using MediaIndex = uint32_t;
+
+/**
+ * A media file read by a compiled timeline.
+ *
+ * Copied out of the EDL so a compilation holds no protobuf objects;
+ * clips refer to it by MediaIndex. A file rewritten at the same path is
+ * a different media: its size or modification time differs.
+ */
+struct CompiledMedia {
+    std::string id;
+    std::string path;
+    int sample_rate = 0;
+    int channels = 0;
+    int64_t file_size = 0;         // with modification_time, the version of the file the
+    int64_t modification_time = 0; // compilation saw (ms since epoch); 0 if it was unreadable
+};
+
+// One clip, as EdlCompiler builds it before scattering it into a track
+struct CompiledClip {
+    MediaIndex media = 0;
+    int64_t start_in_media = 0;    // source offset (samples)
+    int64_t t0 = 0;                // timeline start (samples)
+    int64_t t1 = 0;                // timeline end (exclusive)
+    float gain_linear = 1.0f;      // from gain_db
+    FadeSpec fade_in;
+    FadeSpec fade_out;
+};
+
+/**
+ * A track's clips as parallel arrays, sorted by t0.
+ *
+ * Clip i is element i of every array, so the cursor and the mixer walk
+ * contiguous memory and only load the fields they use.
+ */
+struct CompiledTrack {
+    std::string id;
+    float gain_linear = 1.0f;
+    bool muted = false;
+
+    std::vector<int64_t> t0;             // timeline start (samples)
+    std::vector<int64_t> t1;             // timeline end (exclusive)
+    std::vector<int64_t> max_end;        // max_end[i] = max t1 of clips [0..i]
+    std::vector<int64_t> start_in_media; // source offset (samples)
+    std::vector<MediaIndex> media;       // into CompiledEdl::media
+    std::vector<float> clip_gain;        // linear, from gain_db
+    std::vector<FadeSpec> fade_in;
+    std::vector<FadeSpec> fade_out;
+    std::vector<uint8_t> mix_features;   // MixKernels::Feature bits, including the track gain
+
+    size_t numClips() const { return t0.size(); }
+};
+
+/**
+ * Forward-moving lookup of the clips that intersect a render block.
+ *
+ * Keeps the active set: the clips that start before the block end and
+ * end after the block start, in clip index order. Moving forward drops
+ * the clips that ended and appends the ones that started, so a block
+ * costs O(active clips + clips started), however long the clips that
+ * span it. A long bed under many short clips stays one entry. Seeking
+ * backwards, or to a shorter block end, rebuilds the set from a binary
+ * search on max_end, which scans every clip from the first one still
+ * running; that is O(clips) behind a bed, but only once per seek.
+ */
+struct ClipCursor {
+    std::vector<uint32_t> active; // clip indices, ascending
+    size_t next = 0;              // first clip that has not started yet
+    int64_t rangeStart = 0;
+    int64_t rangeEnd = 0;
+    const CompiledTrack* track = nullptr;
+
+    /**
+     * Position the cursor on [rangeStart, rangeEnd).
+     *
+     * Afterwards `active` lists exactly the clips with t0 < rangeEnd and
+     * t1 > rangeStart. Only the first seek on a track allocates.
+     */
+    void seek(const CompiledTrack& track, int64_t rangeStart, int64_t rangeEnd);
+};
+
+struct CompiledEdl {
+    std::string edl_id;
+    std::string revision;
+    int sample_rate = 0;
+    std::vector<std::shared_ptr<const CompiledTrack>> tracks; // in EDL order
+    std::vector<CompiledMedia> media;                          // by MediaIndex; appended to, never reordered
+};
+
+} // namespace juceaudioservice
@@ -1,7 +1,11 @@
 #include "EdlCompiler.h"
+#include "MixKernels.h"
+#include "util/MediaInfoCache.h"
+#include "util/Telemetry.h"
 #include <algorithm>
 #include <cmath>
-#include <iostream>
+#include <limits>
+#include <unordered_set>
 
 namespace juceaudioservice {
 
@@ -10,49 +14,155 @@ EdlCompiler::EdlCompiler() = default;
 bool EdlCompiler::compile(const EdlStore::Snapshot& snapshot, CompiledEdl& compiled, std::string& error) {
     const auto& edl = snapshot.edl;
 
-    std::cout << "[EDL][Compile] Starting compilation for EDL: " << edl.id()
-              << " revision: " << snapshot.revision << std::endl;
+    requestLog() << "[EDL][Compile] Starting compilation for EDL: " << edl.id()
+                 << " revision: " << snapshot.revision << std::endl;
 
     // Initialize compiled EDL
+    compiled.edl_id = edl.id();
+    compiled.revision = snapshot.revision;
     compiled.sample_rate = edl.sample_rate();
     compiled.tracks.clear();
     compiled.tracks.reserve(edl.tracks().size());
+    compiled.media.clear();
 
     // Compile each track
+    MediaTable table(compiled.media);
     for (const auto& track : edl.tracks()) {
-        CompiledTrack compiledTrack;
-        if (!compileTrack(track, edl, compiledTrack, error)) {
+        auto compiledTrack = std::make_shared<CompiledTrack>();
+        if (!compileTrack(track, edl, table, *compiledTrack, error)) {
             return false;
         }
         compiled.tracks.push_back(std::move(compiledTrack));
     }
 
-    std::cout << "[EDL][Compile] Successfully compiled " << compiled.tracks.size()
-              << " tracks for EDL: " << edl.id() << std::endl;
+    requestLog() << "[EDL][Compile] Successfully compiled " << compiled.tracks.size()
+                 << " tracks for EDL: " << edl.id() << std::endl;
 
     return true;
 }
 
-bool EdlCompiler::compileTrack(const audio_engine::Track& track, const audio_engine::Edl& edl,
+bool EdlCompiler::compileIncremental(const EdlStore::Snapshot& snapshot, const CompiledEdl& previous,
+                                     const std::vector<std::string>& dirtyTrackIds,
+                                     CompiledEdl& compiled, std::string& error) {
+    const auto& edl = snapshot.edl;
+
+    if (previous.sample_rate != edl.sample_rate()) {
+        return compile(snapshot, compiled, error);
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<const CompiledTrack>> previousTracks;
+    previousTracks.reserve(previous.tracks.size());
+    for (const auto& track : previous.tracks) {
+        previousTracks.emplace(track->id, track);
+    }
+
+    const std::unordered_set<std::string> dirty(dirtyTrackIds.begin(), dirtyTrackIds.end());
+
+    // Build into a local so `compiled` may alias `previous`
+    CompiledEdl result;
+    result.edl_id = edl.id();
+    result.revision = snapshot.revision;
+    result.sample_rate = edl.sample_rate();
+    result.media = previous.media; // shared tracks index into it, so only append
+    identifyMedia(result.media);
+    result.tracks.reserve(edl.tracks().size());
+
+    MediaTable table(result.media);
+
+    int rebuilt = 0;
+    for (const auto& track : edl.tracks()) {
+        auto it = previousTracks.find(track.id());
+        if (it != previousTracks.end() && dirty.count(track.id()) == 0) {
+            result.tracks.push_back(it->second);
+            continue;
+        }
+
+        auto compiledTrack = std::make_shared<CompiledTrack>();
+        if (!compileTrack(track, edl, table, *compiledTrack, error)) {
+            return false;
+        }
+        result.tracks.push_back(std::move(compiledTrack));
+        ++rebuilt;
+    }
+
+    compiled = std::move(result);
+
+    requestLog() << "[EDL][Compile] Recompiled " << rebuilt << " of " << compiled.tracks.size()
+                 << " tracks for EDL: " << edl.id() << " revision: " << snapshot.revision << std::endl;
+
+    return true;
+}
+
+void EdlCompiler::identifyMedia(std::vector<CompiledMedia>& media) {
+    for (auto& entry : media) {
+        MediaInfoCache::Info info;
+        if (!MediaInfoCache::getInstance().probe(juce::File(entry.path), info)) {
+            info = MediaInfoCache::Info{};
+        }
+        entry.file_size = info.fileSize;
+        entry.modification_time = info.modificationTime;
+    }
+}
+
+EdlCompiler::MediaTable::MediaTable(std::vector<CompiledMedia>& tableMedia)
+    : media(tableMedia) {
+    byId.reserve(media.size());
+    for (size_t i = 0; i < media.size(); ++i) {
+        byId.emplace(media[i].id, static_cast<MediaIndex>(i));
+    }
+}
+
+bool EdlCompiler::resolveMedia(const audio_engine::Edl& edl, const std::string& mediaId, MediaTable& table,
+                               MediaIndex& index) {
+    auto it = table.byId.find(mediaId);
+    if (it != table.byId.end()) {
+        index = it->second;
+        return true;
+    }
+
+    const audio_engine::AudioRef* ref = findMediaById(edl, mediaId);
+    if (!ref) {
+        return false;
+    }
+
+    CompiledMedia media;
+    media.id = ref->id();
+    media.path = ref->path();
+    media.sample_rate = ref->sample_rate();
+    media.channels = ref->channels();
+
+    MediaInfoCache::Info info;
+    if (MediaInfoCache::getInstance().probe(juce::File(media.path), info)) {
+        media.file_size = info.fileSize;
+        media.modification_time = info.modificationTime;
+    }
+
+    index = static_cast<MediaIndex>(table.media.size());
+    table.media.push_back(std::move(media));
+    table.byId.emplace(mediaId, index);
+    return true;
+}
+
+bool EdlCompiler::compileTrack(const audio_engine::Track& track, const audio_engine::Edl& edl, MediaTable& table,
                               CompiledTrack& compiledTrack, std::string& error) {
 
     // Set track properties
+    compiledTrack.id = track.id();
     compiledTrack.gain_linear = dbToLinear(track.gain_db());
     compiledTrack.muted = track.muted();
-    compiledTrack.clips.clear();
-    compiledTrack.clips.reserve(track.clips().size());
+
+    std::vector<CompiledClip> clips;
+    clips.reserve(track.clips().size());
 
     // Compile each clip
     for (const auto& clip : track.clips()) {
-        const audio_engine::AudioRef* media = findMediaById(edl, clip.media_id());
-        if (!media) {
+        CompiledClip compiledClip;
+        if (!resolveMedia(edl, clip.media_id(), table, compiledClip.media)) {
             error = "Media not found for clip " + clip.id() + ": " + clip.media_id();
             return false;
         }
 
-        CompiledClip compiledClip;
-        compiledClip.clip = &clip;
-        compiledClip.media = media;
+        compiledClip.start_in_media = clip.start_in_media();
         compiledClip.t0 = clip.start_in_timeline();
         compiledClip.t1 = clip.start_in_timeline() + clip.duration();
         compiledClip.gain_linear = dbToLinear(clip.gain_db());
@@ -65,11 +175,12 @@ bool EdlCompiler::compileTrack(const audio_engine::Track& track, const audio_eng
             compiledClip.fade_out = convertFade(clip.fade_out());
         }
 
-        compiledTrack.clips.push_back(compiledClip);
+        clips.push_back(compiledClip);
     }
 
-    // Sort clips by timeline position
-    sortClipsByTimeline(compiledTrack.clips);
+    // Sort clips by timeline position, then lay them out as arrays with their end times indexed
+    sortClipsByTimeline(clips);
+    storeClips(clips, compiledTrack);
 
     return true;
 }
@@ -113,4 +224,86 @@ void EdlCompiler::sortClipsByTimeline(std::vector<CompiledClip>& clips) {
         });
 }
 
+void EdlCompiler::storeClips(const std::vector<CompiledClip>& clips, CompiledTrack& track) {
+    const size_t numClips = clips.size();
+    track.t0.clear();
+    track.t1.clear();
+    track.max_end.clear();
+    track.start_in_media.clear();
+    track.media.clear();
+    track.clip_gain.clear();
+    track.fade_in.clear();
+    track.fade_out.clear();
+    track.mix_features.clear();
+
+    track.t0.reserve(numClips);
+    track.t1.reserve(numClips);
+    track.max_end.reserve(numClips);
+    track.start_in_media.reserve(numClips);
+    track.media.reserve(numClips);
+    track.clip_gain.reserve(numClips);
+    track.fade_in.reserve(numClips);
+    track.fade_out.reserve(numClips);
+    track.mix_features.reserve(numClips);
+
+    int64_t maxEnd = std::numeric_limits<int64_t>::min();
+    for (const auto& clip : clips) {
+        maxEnd = std::max(maxEnd, clip.t1);
+
+        track.t0.push_back(clip.t0);
+        track.t1.push_back(clip.t1);
+        track.max_end.push_back(maxEnd);
+        track.start_in_media.push_back(clip.start_in_media);
+        track.media.push_back(clip.media);
+        track.clip_gain.push_back(clip.gain_linear);
+        track.fade_in.push_back(clip.fade_in);
+        track.fade_out.push_back(clip.fade_out);
+
+        // Unit gains and empty fades are skipped by the mix kernels
+        uint8_t features = 0;
+        if (clip.gain_linear != 1.0f) {
+            features |= MixKernels::ClipGain;
+        }
+        if (!clip.fade_in.isEmpty()) {
+            features |= MixKernels::FadeIn;
+        }
+        if (!clip.fade_out.isEmpty()) {
+            features |= MixKernels::FadeOut;
+        }
+        if (track.gain_linear != 1.0f) {
+            features |= MixKernels::TrackGain;
+        }
+        track.mix_features.push_back(features);
+    }
+}
+
+void EdlCompiler::ClipCursor::seek(const CompiledTrack& newTrack, int64_t newRangeStart, int64_t newRangeEnd) {
+    const auto& t0 = newTrack.t0;
+    const auto& t1 = newTrack.t1;
+    const size_t numClips = newTrack.numClips();
+
+    if (track != &newTrack || newRangeStart < rangeStart || newRangeEnd < rangeEnd) {
+        // Rebuild: clips before the first max_end > start have all ended
+        const auto& maxEnd = newTrack.max_end;
+        next = static_cast<size_t>(std::upper_bound(maxEnd.begin(), maxEnd.end(), newRangeStart) - maxEnd.begin());
+        active.clear();
+        active.reserve(numClips);
+        track = &newTrack;
+    } else {
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&](uint32_t i) { return t1[i] <= newRangeStart; }),
+                     active.end());
+    }
+
+    // Clips are sorted by t0, so appending keeps `active` in index order
+    for (; next < numClips && t0[next] < newRangeEnd; ++next) {
+        if (t1[next] > newRangeStart) {
+            active.push_back(static_cast<uint32_t>(next));
+        }
+    }
+
+    rangeStart = newRangeStart;
+    rangeEnd = newRangeEnd;
+}
+
 } // namespace juceaudioservice
\ No newline at end of file
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <string>
 #include <unordered_map>
 #include "audio_engine.pb.h"
+#include "CompiledEdl.h"
 #include "EdlStore.h"
 
 namespace juceaudioservice {
@@ -13,41 +15,22 @@ namespace juceaudioservice {
  *
  * Converts EDL structure into sorted timeline with precomputed gains,
  * fade specifications, and crossfade detection for efficient rendering.
+ *
+ * Compiled tracks hold their own copies of everything they need and are
+ * shared between compiled revisions, so after an edit only the tracks it
+ * touched have to be rebuilt (see compileIncremental). Media are listed
+ * in the order clips first use them.
  */
 class EdlCompiler {
 public:
-    enum class FadeShape {
-        Linear,
-        EqualPower
-    };
-
-    struct FadeSpec {
-        int64_t length_samples = 0;
-        FadeShape shape = FadeShape::Linear;
-
-        bool isEmpty() const { return length_samples == 0; }
-    };
-
-    struct CompiledClip {
-        const audio_engine::Clip* clip = nullptr;
-        const audio_engine::AudioRef* media = nullptr;
-        int64_t t0 = 0;                // timeline start (samples)
-        int64_t t1 = 0;                // timeline end (exclusive)
-        float gain_linear = 1.0f;      // from gain_db
-        FadeSpec fade_in;
-        FadeSpec fade_out;
-    };
-
-    struct CompiledTrack {
-        std::vector<CompiledClip> clips;
-        float gain_linear = 1.0f;
-        bool muted = false;
-    };
-
-    struct CompiledEdl {
-        int sample_rate = 0;
-        std::vector<CompiledTrack> tracks;
-    };
+    using FadeShape = juceaudioservice::FadeShape;
+    using FadeSpec = juceaudioservice::FadeSpec;
+    using CompiledClip = juceaudioservice::CompiledClip;
+    using CompiledTrack = juceaudioservice::CompiledTrack;
+    using ClipCursor = juceaudioservice::ClipCursor;
+    using CompiledMedia = juceaudioservice::CompiledMedia;
+    using MediaIndex = juceaudioservice::MediaIndex;
+    using CompiledEdl = juceaudioservice::CompiledEdl;
 
     EdlCompiler();
     ~EdlCompiler() = default;
@@ -62,14 +45,54 @@ public:
      */
     bool compile(const EdlStore::Snapshot& snapshot, CompiledEdl& compiled, std::string& error);
 
+    /**
+     * Compile an EDL snapshot, rebuilding only the tracks that changed.
+     *
+     * Tracks not listed in dirtyTrackIds are shared with `previous`, so
+     * they must be unchanged since it was compiled; tracks `previous`
+     * doesn't have are always compiled. Cost is O(tracks + clips on the
+     * dirty tracks).
+     *
+     * @param snapshot Validated EDL snapshot from EdlStore
+     * @param previous Compilation of an earlier revision of the same EDL
+     * @param dirtyTrackIds Tracks added or modified since that revision
+     * @param compiled Output parameter for compiled EDL (may be `previous`)
+     * @param error Output parameter for compilation error message
+     * @return true if compilation succeeded
+     */
+    bool compileIncremental(const EdlStore::Snapshot& snapshot, const CompiledEdl& previous,
+                            const std::vector<std::string>& dirtyTrackIds,
+                            CompiledEdl& compiled, std::string& error);
+
+    /**
+     * Stamp media with the size and modification time of their files now.
+     *
+     * Uses MediaInfoCache, so an unchanged file costs one stat.
+     *
+     * @param media Entries to update in place
+     */
+    static void identifyMedia(std::vector<CompiledMedia>& media);
+
 private:
     // Helper methods
     float dbToLinear(float db);
     FadeSpec convertFade(const audio_engine::Fade& fade);
     const audio_engine::AudioRef* findMediaById(const audio_engine::Edl& edl, const std::string& mediaId);
-    bool compileTrack(const audio_engine::Track& track, const audio_engine::Edl& edl,
+
+    // Media table of the compilation in progress, with its index by media id
+    struct MediaTable {
+        std::vector<CompiledMedia>& media;
+        std::unordered_map<std::string, MediaIndex> byId;
+
+        explicit MediaTable(std::vector<CompiledMedia>& tableMedia);
+    };
+
+    bool resolveMedia(const audio_engine::Edl& edl, const std::string& mediaId, MediaTable& table,
+                      MediaIndex& index);
+    bool compileTrack(const audio_engine::Track& track, const audio_engine::Edl& edl, MediaTable& table,
                      CompiledTrack& compiledTrack, std::string& error);
     void sortClipsByTimeline(std::vector<CompiledClip>& clips);
+    void storeClips(const std::vector<CompiledClip>& clips, CompiledTrack& track);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EdlCompiler)
 };
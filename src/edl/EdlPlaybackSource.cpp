@@ -0,0 +1,362 @@
+#include "EdlPlaybackSource.h"
+#include "util/Telemetry.h"
+#include <algorithm>
+#include <iostream>
+
+namespace juceaudioservice {
+
+namespace {
+    constexpr int minimumLookaheadFrames = 256;
+    constexpr std::chrono::milliseconds minimumRingFullWait{1};
+    constexpr std::chrono::milliseconds idleWait{50};
+}
+
+EdlPlaybackSource::EdlPlaybackSource(int numChannels, int lookaheadFrames)
+    : EdlPlaybackSource(MediaPageCache::getInstance(), numChannels, lookaheadFrames) {
+}
+
+EdlPlaybackSource::EdlPlaybackSource(MediaPageCache& mediaCache, int numChannels, int lookaheadFrames)
+    : numChannels_(std::max(1, numChannels)),
+      renderer_(mediaCache) {
+
+    const int capacity = juce::nextPowerOfTwo(std::max(minimumLookaheadFrames, lookaheadFrames));
+    ring_.setSize(numChannels_, capacity);
+    ring_.clear();
+    ringMask_ = static_cast<uint64_t>(capacity) - 1;
+}
+
+EdlPlaybackSource::~EdlPlaybackSource() {
+    stopRenderThread();
+}
+
+void EdlPlaybackSource::setTimeline(std::shared_ptr<const EdlCompiler::CompiledEdl> timeline) {
+    const juce::int64 length = timeline ? getTimelineLength(*timeline) : 0;
+
+    // The previous timeline is released here, or by the render thread if it is still mixing it
+    hasTimeline_.store(timeline != nullptr, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(timelineMutex_);
+        timeline_.swap(timeline);
+    }
+    totalLength_.store(length, std::memory_order_relaxed);
+    timelineVersion_.fetch_add(1, std::memory_order_release);
+
+    wakeRenderThread();
+}
+
+std::shared_ptr<const EdlCompiler::CompiledEdl> EdlPlaybackSource::getTimeline() const {
+    std::lock_guard<std::mutex> lock(timelineMutex_);
+    return timeline_;
+}
+
+EdlPlaybackSource::Stats EdlPlaybackSource::getStats() const {
+    const uint64_t write = writeIndex_.load(std::memory_order_acquire);
+    uint64_t start = readIndex_.load(std::memory_order_acquire);
+
+    // While a seek is pending only frames rendered for the new position count
+    const uint64_t requestedEpoch = seekEpoch_.load(std::memory_order_acquire);
+    if (appliedEpoch_.load(std::memory_order_acquire) != requestedEpoch) {
+        const uint32_t sequence = markerSequence_.load(std::memory_order_acquire);
+        const uint64_t epoch = markerEpoch_.load(std::memory_order_relaxed);
+        const uint64_t index = markerIndex_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        const bool markerReady = (sequence & 1u) == 0 && epoch == requestedEpoch &&
+                                 markerSequence_.load(std::memory_order_relaxed) == sequence;
+        start = markerReady ? index : write;
+    }
+
+    Stats stats;
+    stats.framesPlayed = framesPlayed_.load(std::memory_order_relaxed);
+    stats.underruns = underruns_.load(std::memory_order_relaxed);
+    stats.bufferedFrames = write > start ? static_cast<int>(std::min<uint64_t>(write - start, ringMask_ + 1)) : 0;
+    return stats;
+}
+
+void EdlPlaybackSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    stopRenderThread();
+
+    // Keep at least two device blocks in flight
+    const int minimumFrames = juce::nextPowerOfTwo(std::max(minimumLookaheadFrames, 2 * samplesPerBlockExpected));
+    if (ring_.getNumSamples() < minimumFrames) {
+        ring_.setSize(numChannels_, minimumFrames);
+        ring_.clear();
+        ringMask_ = static_cast<uint64_t>(minimumFrames) - 1;
+    }
+
+    if (auto timeline = getTimeline(); timeline && timeline->sample_rate != static_cast<int>(sampleRate)) {
+        requestLog() << "[EDL][Playback] Device runs at " << sampleRate << " Hz but the timeline is "
+                     << timeline->sample_rate << " Hz; playing without resampling" << std::endl;
+    }
+
+    // A full ring waits for the device to drain about a quarter of it
+    const double ringSeconds = ring_.getNumSamples() / std::max(1.0, sampleRate);
+    ringFullWait_ = std::max(minimumRingFullWait,
+                             std::chrono::milliseconds(static_cast<int64_t>(ringSeconds * 1000.0 / 4.0)));
+
+    // Nothing else runs now, so restart the ring at the playhead (or at a pending seek)
+    const uint64_t epoch = seekEpoch_.load(std::memory_order_acquire);
+    const juce::int64 position = getNextReadPosition();
+
+    writeIndex_.store(0, std::memory_order_relaxed);
+    readIndex_.store(0, std::memory_order_relaxed);
+    publishMarker(epoch, 0, position);
+    appliedEpoch_.store(epoch, std::memory_order_relaxed);
+    playPosition_.store(position, std::memory_order_relaxed);
+    primed_ = false;
+    handledEpoch_ = epoch;
+    writePosition_ = position;
+
+    startRenderThread();
+}
+
+void EdlPlaybackSource::releaseResources() {
+    stopRenderThread();
+}
+
+void EdlPlaybackSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) {
+    // Real-time path: atomics and copies only
+
+    // Load the write index first: any seek marker older than the frames it covers is then visible
+    const uint64_t write = writeIndex_.load(std::memory_order_acquire);
+    uint64_t read = readIndex_.load(std::memory_order_relaxed);
+
+    if (!applyPendingSeek(read)) {
+        bufferToFill.clearActiveBufferRegion(); // seeking; nothing rendered for the new position yet
+        return;
+    }
+
+    auto& buffer = *bufferToFill.buffer;
+    const int startSample = bufferToFill.startSample;
+    const int numSamples = bufferToFill.numSamples;
+    const int count = write > read ? static_cast<int>(std::min<uint64_t>(write - read, static_cast<uint64_t>(numSamples))) : 0;
+
+    const int capacity = ring_.getNumSamples();
+    const int ringStart = static_cast<int>(read & ringMask_);
+    const int firstPart = std::min(count, capacity - ringStart);
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+        if (ch >= numChannels_) {
+            buffer.clear(ch, startSample, numSamples);
+            continue;
+        }
+
+        if (firstPart > 0) {
+            buffer.copyFrom(ch, startSample, ring_, ch, ringStart, firstPart);
+        }
+        if (count > firstPart) {
+            buffer.copyFrom(ch, startSample + firstPart, ring_, ch, 0, count - firstPart);
+        }
+        if (count < numSamples) {
+            buffer.clear(ch, startSample + count, numSamples - count);
+        }
+    }
+
+    // Past the end nothing more is rendered, and the playhead runs on over silence
+    const juce::int64 position = playPosition_.load(std::memory_order_relaxed);
+    const bool pastEnd = count < numSamples && position + count >= totalLength_.load(std::memory_order_relaxed);
+
+    readIndex_.store(read + static_cast<uint64_t>(count), std::memory_order_release);
+    playPosition_.store(position + (pastEnd ? numSamples : count), std::memory_order_relaxed);
+    framesPlayed_.fetch_add(static_cast<uint64_t>(count), std::memory_order_relaxed);
+
+    // Running dry while refilling after a start or seek, or past the end, is not an underrun
+    if (count == numSamples) {
+        primed_ = true;
+    } else if (primed_ && !pastEnd && hasTimeline_.load(std::memory_order_relaxed)) {
+        underruns_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void EdlPlaybackSource::setNextReadPosition(juce::int64 newPosition) {
+    // Lock-free so it can be called from any thread; the render thread polls while it waits
+    seekTarget_.store(std::max<juce::int64>(0, newPosition), std::memory_order_relaxed);
+    seekEpoch_.fetch_add(1, std::memory_order_release);
+    wake_.notify_all();
+}
+
+juce::int64 EdlPlaybackSource::getNextReadPosition() const {
+    if (appliedEpoch_.load(std::memory_order_acquire) != seekEpoch_.load(std::memory_order_acquire)) {
+        return seekTarget_.load(std::memory_order_relaxed); // seek not heard yet
+    }
+    return playPosition_.load(std::memory_order_relaxed);
+}
+
+void EdlPlaybackSource::startRenderThread() {
+    stopRendering_.store(false, std::memory_order_release);
+    renderThread_ = std::thread([this] { renderLoop(); });
+}
+
+void EdlPlaybackSource::stopRenderThread() {
+    if (!renderThread_.joinable()) {
+        return;
+    }
+
+    stopRendering_.store(true, std::memory_order_release);
+    wakeRenderThread();
+    renderThread_.join();
+}
+
+void EdlPlaybackSource::renderLoop() {
+    while (!stopRendering_.load(std::memory_order_acquire)) {
+        handlePendingSeek();
+
+        const uint64_t version = timelineVersion_.load(std::memory_order_acquire);
+        const auto timeline = getTimeline();
+        if (!timeline) {
+            waitForChange(version, idleWait);
+            continue;
+        }
+
+        // The playhead may have run on past the old end; an edit that reaches it resumes there
+        const juce::int64 timelineEnd = getTimelineLength(*timeline);
+        const juce::int64 playhead = playPosition_.load(std::memory_order_relaxed);
+        const bool ringEmpty = readIndex_.load(std::memory_order_acquire) == writeIndex_.load(std::memory_order_relaxed);
+        const bool seekPending = appliedEpoch_.load(std::memory_order_acquire) != seekEpoch_.load(std::memory_order_acquire);
+        if (ringEmpty && !seekPending && playhead > writePosition_ && playhead < timelineEnd) {
+            setNextReadPosition(playhead);
+            continue;
+        }
+
+        // Idle past the end until a seek or an edit that makes the timeline longer
+        if (writePosition_ >= timelineEnd) {
+            waitForChange(version, idleWait);
+            continue;
+        }
+
+        // Render up to the end unless a seek, edit or stop interrupts
+        audio_engine::TimeRange range;
+        range.set_start_samples(writePosition_);
+        range.set_duration_samples(timelineEnd - writePosition_);
+
+        auto pushBlock = [this, version](const juce::AudioBuffer<float>& block, int numSamples) {
+            return pushFrames(block, numSamples, version);
+        };
+
+        std::string error;
+        if (!renderer_.renderBlocks(*timeline, range, pushBlock, nullptr, error) && !isInterrupted(version)) {
+            std::cerr << "[EDL][Playback] Render failed: " << error << std::endl;
+            waitForChange(version, idleWait);
+        }
+    }
+}
+
+void EdlPlaybackSource::handlePendingSeek() {
+    const uint64_t epoch = seekEpoch_.load(std::memory_order_acquire);
+    if (epoch == handledEpoch_) {
+        return;
+    }
+
+    // Frames from the current write index on belong to the new position; older ones are skipped
+    handledEpoch_ = epoch;
+    writePosition_ = seekTarget_.load(std::memory_order_relaxed);
+    publishMarker(epoch, writeIndex_.load(std::memory_order_relaxed), writePosition_);
+}
+
+bool EdlPlaybackSource::isInterrupted(uint64_t timelineVersion) const {
+    return stopRendering_.load(std::memory_order_acquire) ||
+           seekEpoch_.load(std::memory_order_acquire) != handledEpoch_ ||
+           timelineVersion_.load(std::memory_order_acquire) != timelineVersion;
+}
+
+void EdlPlaybackSource::waitForChange(uint64_t timelineVersion, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    wake_.wait_for(lock, timeout, [this, timelineVersion] { return isInterrupted(timelineVersion); });
+}
+
+bool EdlPlaybackSource::pushFrames(const juce::AudioBuffer<float>& block, int numSamples, uint64_t timelineVersion) {
+    const uint64_t capacity = ringMask_ + 1;
+
+    for (int done = 0; done < numSamples;) {
+        if (isInterrupted(timelineVersion)) {
+            return false; // the rest of the block is stale
+        }
+
+        const uint64_t write = writeIndex_.load(std::memory_order_relaxed);
+        const uint64_t read = std::min(readIndex_.load(std::memory_order_acquire), write);
+        const uint64_t space = capacity - (write - read);
+        if (space == 0) {
+            waitForChange(timelineVersion, ringFullWait_);
+            continue;
+        }
+
+        const int count = static_cast<int>(std::min<uint64_t>(space, static_cast<uint64_t>(numSamples - done)));
+        const int ringStart = static_cast<int>(write & ringMask_);
+        const int firstPart = std::min(count, static_cast<int>(capacity) - ringStart);
+
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            if (ch >= block.getNumChannels()) {
+                ring_.clear(ch, ringStart, firstPart);
+                ring_.clear(ch, 0, count - firstPart);
+                continue;
+            }
+
+            ring_.copyFrom(ch, ringStart, block, ch, done, firstPart);
+            if (count > firstPart) {
+                ring_.copyFrom(ch, 0, block, ch, done + firstPart, count - firstPart);
+            }
+        }
+
+        writeIndex_.store(write + static_cast<uint64_t>(count), std::memory_order_release);
+        writePosition_ += count;
+        done += count;
+    }
+
+    return true;
+}
+
+void EdlPlaybackSource::publishMarker(uint64_t epoch, uint64_t index, juce::int64 position) {
+    // Sequence lock: odd while the fields are being written
+    const uint32_t sequence = markerSequence_.load(std::memory_order_relaxed);
+    markerSequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    markerEpoch_.store(epoch, std::memory_order_relaxed);
+    markerIndex_.store(index, std::memory_order_relaxed);
+    markerPosition_.store(position, std::memory_order_relaxed);
+
+    markerSequence_.store(sequence + 2, std::memory_order_release);
+}
+
+bool EdlPlaybackSource::applyPendingSeek(uint64_t& readIndex) {
+    const uint64_t requestedEpoch = seekEpoch_.load(std::memory_order_acquire);
+    if (requestedEpoch == appliedEpoch_.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    const uint32_t sequence = markerSequence_.load(std::memory_order_acquire);
+    const uint64_t epoch = markerEpoch_.load(std::memory_order_relaxed);
+    const uint64_t index = markerIndex_.load(std::memory_order_relaxed);
+    const juce::int64 position = markerPosition_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // Play silence until the render thread has started on the latest seek
+    if ((sequence & 1u) != 0 || epoch != requestedEpoch ||
+        markerSequence_.load(std::memory_order_relaxed) != sequence) {
+        return false;
+    }
+
+    // Skip whatever was rendered for the old position
+    readIndex = index;
+    primed_ = false;
+    playPosition_.store(position, std::memory_order_relaxed);
+    appliedEpoch_.store(epoch, std::memory_order_release);
+    return true;
+}
+
+void EdlPlaybackSource::wakeRenderThread() {
+    { std::lock_guard<std::mutex> lock(wakeMutex_); }
+    wake_.notify_all();
+}
+
+juce::int64 EdlPlaybackSource::getTimelineLength(const EdlCompiler::CompiledEdl& timeline) {
+    juce::int64 length = 0;
+    for (const auto& track : timeline.tracks) {
+        if (!track->max_end.empty()) {
+            length = std::max<juce::int64>(length, track->max_end.back());
+        }
+    }
+    return length;
+}
+
+} // namespace juceaudioservice
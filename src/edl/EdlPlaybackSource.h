@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "EdlCompiler.h"
+#include "EdlRenderer.h"
+#include "MediaPageCache.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+
+namespace juceaudioservice {
+
+/**
+ * Real-time playback of a compiled EDL timeline, for auditioning edits.
+ *
+ * A background thread mixes the timeline with an EdlRenderer a short
+ * look-ahead in front of the playhead and pushes the result into a
+ * single-producer/single-consumer ring buffer. getNextAudioBlock() only
+ * copies out of that ring: it never allocates, locks, logs or touches a
+ * file, so it is safe to call from an audio device callback at any block
+ * size down to a few samples.
+ *
+ * setTimeline() swaps the timeline without stopping playback. Audio that
+ * is already buffered keeps playing and the renderer carries on from the
+ * end of it with the new timeline, so an edit is heard at most
+ * getLookaheadFrames() frames later and never causes a gap. Old timelines
+ * are released on the calling or render thread, never the audio thread.
+ *
+ * Rendering stops at the end of the timeline. Past it the source plays
+ * silence and the playhead keeps moving, and an edit that extends the
+ * timeline beyond the playhead is picked up from there.
+ *
+ * Audio is produced at the timeline's sample rate; the renderer converts
+ * media recorded at other rates.
+ */
+class EdlPlaybackSource : public juce::PositionableAudioSource {
+public:
+    static constexpr int defaultLookaheadFrames = 8192;
+
+    struct Stats {
+        uint64_t framesPlayed = 0;
+        uint64_t underruns = 0;     // callbacks that ran dry after playback had started
+        int bufferedFrames = 0;     // rendered frames waiting to be played
+    };
+
+    /**
+     * Create a playback source reading media through the process-wide cache.
+     *
+     * @param numChannels Number of output channels
+     * @param lookaheadFrames Frames rendered ahead of the playhead (rounded up to a power of two)
+     */
+    explicit EdlPlaybackSource(int numChannels = 2, int lookaheadFrames = defaultLookaheadFrames);
+
+    /**
+     * Create a playback source reading media through a specific cache.
+     *
+     * @param mediaCache Cache to read decoded media from; must outlive the source
+     * @param numChannels Number of output channels
+     * @param lookaheadFrames Frames rendered ahead of the playhead (rounded up to a power of two)
+     */
+    EdlPlaybackSource(MediaPageCache& mediaCache, int numChannels, int lookaheadFrames);
+
+    ~EdlPlaybackSource() override;
+
+    /**
+     * Replace the timeline being played.
+     *
+     * Safe to call from any thread except the audio thread, including
+     * while playing. Pass nullptr to play silence.
+     *
+     * @param timeline Compiled timeline, for example EdlStore::getCompiled()
+     */
+    void setTimeline(std::shared_ptr<const EdlCompiler::CompiledEdl> timeline);
+
+    /** The timeline most recently passed to setTimeline(). */
+    std::shared_ptr<const EdlCompiler::CompiledEdl> getTimeline() const;
+
+    int getNumChannels() const noexcept { return numChannels_; }
+    int getLookaheadFrames() const noexcept { return ring_.getNumSamples(); }
+
+    /** Playback counters; safe to call from any thread. */
+    Stats getStats() const;
+
+    // AudioSource interface
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    // PositionableAudioSource interface
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override { return totalLength_.load(std::memory_order_relaxed); }
+    bool isLooping() const override { return false; }
+
+private:
+    const int numChannels_;
+    EdlRenderer renderer_; // only used by the render thread
+
+    // Rendered audio; indexes count frames since prepareToPlay and never wrap
+    juce::AudioBuffer<float> ring_;
+    uint64_t ringMask_ = 0;
+    std::atomic<uint64_t> writeIndex_{0};
+    std::atomic<uint64_t> readIndex_{0};
+
+    // Requests from control threads to the render thread; the audio thread never takes timelineMutex_
+    mutable std::mutex timelineMutex_;
+    std::shared_ptr<const EdlCompiler::CompiledEdl> timeline_;
+    std::atomic<uint64_t> timelineVersion_{0};
+    std::atomic<bool> hasTimeline_{false};
+    std::atomic<juce::int64> totalLength_{0};
+    std::atomic<juce::int64> seekTarget_{0};
+    std::atomic<uint64_t> seekEpoch_{0};
+
+    // Where the frames of the latest seek start in the ring, published by
+    // the render thread under a sequence lock for the audio thread
+    std::atomic<uint32_t> markerSequence_{0};
+    std::atomic<uint64_t> markerEpoch_{0};
+    std::atomic<uint64_t> markerIndex_{0};
+    std::atomic<juce::int64> markerPosition_{0};
+
+    // Audio thread state
+    std::atomic<uint64_t> appliedEpoch_{0};
+    std::atomic<juce::int64> playPosition_{0};
+    std::atomic<uint64_t> framesPlayed_{0};
+    std::atomic<uint64_t> underruns_{0};
+    bool primed_ = false; // a full block has been played since the last start or seek
+
+    // Render thread
+    std::thread renderThread_;
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> stopRendering_{true}; // true while no render thread runs
+    juce::int64 writePosition_ = 0; // timeline position of the next frame written to the ring
+    std::chrono::milliseconds ringFullWait_{1}; // about a quarter of the ring's play time
+    uint64_t handledEpoch_ = 0;
+
+    void startRenderThread();
+    void stopRenderThread();
+    void renderLoop();
+    void handlePendingSeek();
+    bool isInterrupted(uint64_t timelineVersion) const;
+    void waitForChange(uint64_t timelineVersion, std::chrono::milliseconds timeout);
+    bool pushFrames(const juce::AudioBuffer<float>& block, int numSamples, uint64_t timelineVersion);
+    void publishMarker(uint64_t epoch, uint64_t index, juce::int64 position);
+    bool applyPendingSeek(uint64_t& readIndex);
+    void wakeRenderThread();
+
+    static juce::int64 getTimelineLength(const EdlCompiler::CompiledEdl& timeline);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EdlPlaybackSource)
+};
+
+} // namespace juceaudioservice
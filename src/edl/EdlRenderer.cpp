@@ -1,13 +1,81 @@
 #include "EdlRenderer.h"
+#include "MixKernels.h"
+#include "util/HashingOutputStream.h"
+#include "util/PipelinedAudioWriter.h"
+#include "util/Telemetry.h"
+#include "util/WavStreamWriter.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <fstream>
+#include <limits>
+#include <mutex>
 
 namespace juceaudioservice {
 
-EdlRenderer::EdlRenderer() {
-    formatManager_.registerBasicFormats();
+namespace {
+
+int64_t floorDiv(int64_t numerator, int64_t denominator) {
+    int64_t quotient = numerator / denominator;
+    if ((numerator % denominator != 0) && ((numerator < 0) != (denominator < 0))) {
+        --quotient;
+    }
+    return quotient;
+}
+
+} // namespace
+
+EdlRenderer::EdlRenderer()
+    : EdlRenderer(MediaPageCache::getInstance()) {
+}
+
+EdlRenderer::EdlRenderer(MediaPageCache& mediaCache)
+    : mediaCache_(mediaCache),
+      prefetcher_(mediaCache) {
+}
+
+void EdlRenderer::setNumWorkerThreads(int numThreads) {
+    numThreads = std::max(1, numThreads);
+    if (numThreads == getNumWorkerThreads()) {
+        return;
+    }
+
+    workerPool_.reset();
+    if (numThreads > 1) {
+        workerPool_ = std::make_unique<WorkerPool>(numThreads);
+    }
+}
+
+int EdlRenderer::getNumWorkerThreads() const noexcept {
+    return workerPool_ ? workerPool_->getNumThreads() : 1;
+}
+
+void EdlRenderer::setNumSegmentThreads(int numThreads) {
+    numThreads = std::max(1, numThreads);
+    if (numThreads == getNumSegmentThreads()) {
+        return;
+    }
+
+    segmentPool_.reset();
+    segmentRenderers_.clear();
+    if (numThreads > 1) {
+        segmentPool_ = std::make_unique<WorkerPool>(numThreads);
+        for (int i = 0; i < numThreads; ++i) {
+            segmentRenderers_.push_back(std::make_unique<EdlRenderer>(mediaCache_));
+        }
+    }
+}
+
+int EdlRenderer::getNumSegmentThreads() const noexcept {
+    return segmentPool_ ? segmentPool_->getNumThreads() : 1;
+}
+
+void EdlRenderer::setBlockCache(RenderBlockCache* cache) noexcept {
+    // Blocks are only interchangeable on the same grid
+    jassert(cache == nullptr || cache->getBlockSize() == blockSize_);
+    blockCache_ = cache != nullptr && cache->getBlockSize() == blockSize_ ? cache : nullptr;
 }
 
 bool EdlRenderer::renderToWav(const EdlCompiler::CompiledEdl& compiledEdl,
@@ -15,14 +83,574 @@ bool EdlRenderer::renderToWav(const EdlCompiler::CompiledEdl& compiledEdl,
                               const std::string& outputPath,
                               BitDepth bitDepth,
                               ProgressCallback progressCallback,
+                              std::string& sha256,
                               std::string& error) {
 
-    juce::AudioBuffer<float> outputBuffer;
-    if (!renderToBuffer(compiledEdl, range, outputBuffer, progressCallback, error)) {
+    requestLog() << "[EDL][Render] Starting streaming render: start=" << range.start_samples()
+                 << " duration=" << range.duration_samples() << " samples" << std::endl;
+
+    if (range.duration_samples() <= 0) {
+        error = "Invalid render range: duration must be positive";
+        return false;
+    }
+
+    const auto bounds = planSegments(range.start_samples(), range.start_samples() + range.duration_samples());
+    if (bounds.size() > 2) {
+        return renderSegmentsToWav(compiledEdl, range, bounds, outputPath, bitDepth, progressCallback, sha256, error);
+    }
+
+    auto outputFile = createOutputFile(outputPath, error);
+    if (!outputFile) {
+        return false;
+    }
+
+    // The header is final before the first block, so the file is hashed as it is written
+    auto hashingStream = std::make_unique<HashingOutputStream>(std::move(outputFile));
+    WavStreamWriter writer(*hashingStream, compiledEdl.sample_rate, getOutputChannelCount(compiledEdl),
+                           static_cast<int>(bitDepth), range.duration_samples());
+
+    // Includes hashing; the hash's share is split off when the stages are recorded
+    double writeSeconds = 0.0;
+    auto writeBlock = [&writer, &outputPath, &error, &writeSeconds](const juce::AudioBuffer<float>& block,
+                                                                    int numSamples) {
+        const auto writeStart = std::chrono::steady_clock::now();
+        const bool written = writer.write(block, 0, numSamples);
+        writeSeconds += Telemetry::secondsSince(writeStart);
+
+        if (!written) {
+            error = "Failed to write audio data to: " + outputPath;
+            return false;
+        }
+        return true;
+    };
+
+    bool success = writer.isValid();
+    if (!success) {
+        error = "Render range too long for a WAV file: " + std::to_string(range.duration_samples()) + " samples";
+    }
+
+    success = success && renderTimeRange(compiledEdl, range, writeBlock, progressCallback, error);
+
+    const auto finishStart = std::chrono::steady_clock::now();
+    if (success && !writer.finish()) {
+        error = "Failed to finish WAV file: " + outputPath;
+        success = false;
+    }
+    writeSeconds += Telemetry::secondsSince(finishStart);
+
+    if (!success) {
+        hashingStream.reset();
+        juce::File(outputPath).deleteFile();
+        return false;
+    }
+
+    sha256 = hashingStream->getHexDigest();
+    const double hashSeconds = hashingStream->getHashSeconds();
+    hashingStream.reset(); // Ensure file is closed
+    if (sha256.empty()) {
+        juce::File(outputPath).deleteFile();
+        error = "Failed to hash output file: " + outputPath;
+        return false;
+    }
+
+    auto& telemetry = Telemetry::getInstance();
+    telemetry.recordStage(Telemetry::Stage::Write, std::max(0.0, writeSeconds - hashSeconds));
+    telemetry.recordStage(Telemetry::Stage::Hash, hashSeconds);
+    return true;
+}
+
+bool EdlRenderer::renderToFile(const EdlCompiler::CompiledEdl& compiledEdl,
+                               const audio_engine::TimeRange& range,
+                               const std::string& outputPath,
+                               OutputFormat format,
+                               BitDepth bitDepth,
+                               ProgressCallback progressCallback,
+                               std::string& sha256,
+                               std::string& error) {
+
+    switch (format) {
+        case OutputFormat::Flac:
+            return renderToFlac(compiledEdl, range, outputPath, bitDepth, progressCallback, sha256, error);
+        case OutputFormat::Wav:
+        default:
+            return renderToWav(compiledEdl, range, outputPath, bitDepth, progressCallback, sha256, error);
+    }
+}
+
+const char* EdlRenderer::getFormatName(OutputFormat format) noexcept {
+    switch (format) {
+        case OutputFormat::Flac: return "flac";
+        case OutputFormat::Wav:
+        default: return "wav";
+    }
+}
+
+bool EdlRenderer::renderToFlac(const EdlCompiler::CompiledEdl& compiledEdl,
+                               const audio_engine::TimeRange& range,
+                               const std::string& outputPath,
+                               BitDepth bitDepth,
+                               ProgressCallback progressCallback,
+                               std::string& sha256,
+                               std::string& error) {
+
+    requestLog() << "[EDL][Render] Starting FLAC render: start=" << range.start_samples()
+                 << " duration=" << range.duration_samples() << " samples" << std::endl;
+
+    if (range.duration_samples() <= 0) {
+        error = "Invalid render range: duration must be positive";
+        return false;
+    }
+
+    if (bitDepth == BitDepth::Float32) {
+        error = "FLAC output supports 16 or 24 bits, not 32-bit float";
+        return false;
+    }
+
+    auto outputFile = createOutputFile(outputPath, error);
+    if (!outputFile) {
         return false;
     }
 
-    return writeWavFile(outputBuffer, compiledEdl.sample_rate, outputPath, bitDepth, error);
+    juce::FlacAudioFormat flac;
+    std::unique_ptr<juce::AudioFormatWriter> writer(
+        flac.createWriterFor(outputFile.get(), compiledEdl.sample_rate,
+                             static_cast<unsigned int>(getOutputChannelCount(compiledEdl)),
+                             static_cast<int>(bitDepth), {}, flacCompressionLevel));
+    if (!writer) {
+        outputFile.reset();
+        juce::File(outputPath).deleteFile();
+        error = "FLAC cannot store " + std::to_string(getOutputChannelCount(compiledEdl)) + " channels at " +
+                std::to_string(compiledEdl.sample_rate) + " Hz";
+        return false;
+    }
+    outputFile.release(); // the writer owns the stream now
+
+    // Blocks are compressed on the encoder thread while the following ones are mixed
+    PipelinedAudioWriter encoder(std::move(writer), blockSize_);
+    auto writeBlock = [&encoder, &outputPath, &error](const juce::AudioBuffer<float>& block, int numSamples) {
+        if (!encoder.write(block, numSamples)) {
+            error = "Failed to encode audio data to: " + outputPath;
+            return false;
+        }
+        return true;
+    };
+
+    bool success = renderTimeRange(compiledEdl, range, writeBlock, progressCallback, error);
+
+    if (!encoder.finish() && success) {
+        error = "Failed to encode audio data to: " + outputPath;
+        success = false;
+    }
+
+    if (!success) {
+        juce::File(outputPath).deleteFile();
+        return false;
+    }
+
+    // The encoder rewrites its STREAMINFO header on close, so the file is hashed once complete
+    const auto hashStart = std::chrono::steady_clock::now();
+    sha256 = HashingOutputStream::hashFile(juce::File(outputPath));
+    const double hashSeconds = Telemetry::secondsSince(hashStart);
+    if (sha256.empty()) {
+        juce::File(outputPath).deleteFile();
+        error = "Failed to hash output file: " + outputPath;
+        return false;
+    }
+
+    auto& telemetry = Telemetry::getInstance();
+    telemetry.recordStage(Telemetry::Stage::Write, encoder.getEncodeSeconds()); // on the encoder thread
+    telemetry.recordStage(Telemetry::Stage::Hash, hashSeconds);
+    return true;
+}
+
+std::vector<int64_t> EdlRenderer::planSegments(int64_t rangeStart, int64_t rangeEnd) const {
+    std::vector<int64_t> bounds{rangeStart};
+
+    const int64_t numBlocks = (rangeEnd - rangeStart) / blockSize_;
+    const int64_t numSegments = std::min<int64_t>(getNumSegmentThreads(), numBlocks / minSegmentBlocks);
+
+    // Interior bounds sit on the block grid, so block cache entries stay whole
+    for (int64_t i = 1; i < numSegments; ++i) {
+        const int64_t target = rangeStart + (rangeEnd - rangeStart) * i / numSegments;
+        const int64_t bound = floorDiv(target, blockSize_) * blockSize_;
+        if (bound > bounds.back() && bound < rangeEnd) {
+            bounds.push_back(bound);
+        }
+    }
+
+    bounds.push_back(rangeEnd);
+    return bounds;
+}
+
+bool EdlRenderer::renderSegmentsToWav(const EdlCompiler::CompiledEdl& compiledEdl,
+                                      const audio_engine::TimeRange& range,
+                                      const std::vector<int64_t>& bounds,
+                                      const std::string& outputPath,
+                                      BitDepth bitDepth,
+                                      ProgressCallback progressCallback,
+                                      std::string& sha256,
+                                      std::string& error) {
+
+    const int numSegments = static_cast<int>(bounds.size()) - 1;
+    const int64_t rangeStart = range.start_samples();
+    const int64_t totalSamples = range.duration_samples();
+    const int numChannels = getOutputChannelCount(compiledEdl);
+    const int bitsPerSample = static_cast<int>(bitDepth);
+    const int64_t frameBytes = static_cast<int64_t>(numChannels) * (bitsPerSample / 8);
+
+    requestLog() << "[EDL][Render] Splitting render into " << numSegments << " segments" << std::endl;
+
+    auto outputFile = createOutputFile(outputPath, error);
+    if (!outputFile) {
+        return false;
+    }
+
+    // Only used for the header, which is written once every segment is in place
+    WavStreamWriter header(*outputFile, compiledEdl.sample_rate, numChannels, bitsPerSample, totalSamples);
+    if (!header.isValid()) {
+        outputFile.reset();
+        juce::File(outputPath).deleteFile();
+        error = "Render range too long for a WAV file: " + std::to_string(totalSamples) + " samples";
+        return false;
+    }
+
+    // Size the file up front so every segment can seek to its own frames
+    const int64_t dataSize = totalSamples * frameBytes;
+    if (!outputFile->setPosition(WavStreamWriter::headerSize + dataSize + (dataSize & 1)) ||
+        !outputFile->truncate().wasOk()) {
+        outputFile.reset();
+        juce::File(outputPath).deleteFile();
+        error = "Failed to allocate output file: " + outputPath;
+        return false;
+    }
+    outputFile->flush();
+
+    for (auto& renderer : segmentRenderers_) {
+        renderer->setBlockCache(blockCache_);
+        renderer->setPrefetchBlocks(prefetchBlocks_);
+    }
+
+    std::mutex mutex; // guards the fields below
+    std::string firstError;
+    int64_t samplesDone = 0;
+    double writeSeconds = 0.0;
+    std::atomic<bool> failed{false};
+
+    WorkerPool::Task renderSegment = [&](int segment, int workerIndex) {
+        auto& renderer = *segmentRenderers_[static_cast<size_t>(workerIndex)];
+        const int64_t segmentStart = bounds[static_cast<size_t>(segment)];
+        const int64_t segmentEnd = bounds[static_cast<size_t>(segment) + 1];
+        std::string segmentError;
+
+        auto fail = [&](const std::string& message) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!failed.exchange(true)) {
+                firstError = message;
+            }
+        };
+
+        const juce::File segmentFile(outputPath);
+        juce::FileOutputStream stream(segmentFile);
+        if (!stream.openedOk() ||
+            !stream.setPosition(WavStreamWriter::headerSize + (segmentStart - rangeStart) * frameBytes)) {
+            fail("Cannot open output file: " + outputPath);
+            return;
+        }
+
+        std::vector<char> frames;
+        double segmentWriteSeconds = 0.0;
+        auto writeBlock = [&](const juce::AudioBuffer<float>& block, int numSamples) {
+            if (failed.load()) {
+                return false;
+            }
+
+            const auto writeStart = std::chrono::steady_clock::now();
+            frames.resize(static_cast<size_t>(numSamples * frameBytes));
+            WavStreamWriter::encodeFrames(block, 0, numSamples, numChannels, bitsPerSample, frames.data());
+            const bool written = stream.write(frames.data(), frames.size());
+            segmentWriteSeconds += Telemetry::secondsSince(writeStart);
+
+            if (!written) {
+                segmentError = "Failed to write audio data to: " + outputPath;
+                return false;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            samplesDone += numSamples;
+            if (progressCallback) {
+                progressCallback(static_cast<double>(samplesDone) / totalSamples);
+            }
+            return true;
+        };
+
+        audio_engine::TimeRange segmentRange;
+        segmentRange.set_start_samples(segmentStart);
+        segmentRange.set_duration_samples(segmentEnd - segmentStart);
+
+        bool success = renderer.renderTimeRange(compiledEdl, segmentRange, writeBlock, nullptr, segmentError);
+
+        const auto flushStart = std::chrono::steady_clock::now();
+        stream.flush();
+        segmentWriteSeconds += Telemetry::secondsSince(flushStart);
+        if (success && stream.getStatus().failed()) {
+            segmentError = "Failed to write audio data to: " + outputPath;
+            success = false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            writeSeconds += segmentWriteSeconds;
+        }
+        if (!success) {
+            fail(segmentError);
+        }
+    };
+
+    segmentPool_->parallelFor(numSegments, renderSegment);
+
+    const auto headerStart = std::chrono::steady_clock::now();
+    bool success = !failed.load();
+    if (success && (!outputFile->setPosition(0) || !header.writeHeader())) {
+        firstError = "Failed to finish WAV file: " + outputPath;
+        success = false;
+    }
+    if (success) {
+        outputFile->flush();
+        success = !outputFile->getStatus().failed();
+        if (!success) {
+            firstError = "Failed to finish WAV file: " + outputPath;
+        }
+    }
+    outputFile.reset(); // Ensure file is closed
+    writeSeconds += Telemetry::secondsSince(headerStart);
+
+    if (!success) {
+        juce::File(outputPath).deleteFile();
+        error = firstError;
+        return false;
+    }
+
+    // Written out of order, so hashed in one pass once complete
+    const auto hashStart = std::chrono::steady_clock::now();
+    sha256 = HashingOutputStream::hashFile(juce::File(outputPath));
+    const double hashSeconds = Telemetry::secondsSince(hashStart);
+    if (sha256.empty()) {
+        juce::File(outputPath).deleteFile();
+        error = "Failed to hash output file: " + outputPath;
+        return false;
+    }
+
+    auto& telemetry = Telemetry::getInstance();
+    telemetry.recordStage(Telemetry::Stage::Write, writeSeconds);
+    telemetry.recordStage(Telemetry::Stage::Hash, hashSeconds);
+    return true;
+}
+
+bool EdlRenderer::renderWindowsToWav(const EdlCompiler::CompiledEdl& compiledEdl,
+                                     const std::vector<WindowOutput>& windows,
+                                     ProgressCallback progressCallback,
+                                     WindowCallback windowCallback,
+                                     std::vector<WindowResult>& results) {
+
+    results.assign(windows.size(), WindowResult());
+
+    // An output file being written; opened when the sweep reaches its range
+    struct Output {
+        size_t index = 0;
+        int64_t start = 0;
+        int64_t end = 0;
+        std::unique_ptr<HashingOutputStream> stream;
+        std::unique_ptr<WavStreamWriter> writer;
+        double writeSeconds = 0.0; // includes hashing, as in renderToWav()
+        bool done = false;
+    };
+
+    // A merged run of the timeline that is mixed in one sweep
+    struct Span {
+        int64_t start = 0;
+        int64_t end = 0;
+        std::vector<size_t> outputs; // into outputs, by start
+    };
+
+    auto finishOutput = [&](Output& output, bool success, const std::string& reason) {
+        auto& result = results[output.index];
+        const std::string& outputPath = windows[output.index].outputPath;
+        result.error = reason;
+
+        if (success) {
+            const auto finishStart = std::chrono::steady_clock::now();
+            success = output.writer->finish();
+            output.writeSeconds += Telemetry::secondsSince(finishStart);
+
+            if (success) {
+                result.sha256 = output.stream->getHexDigest();
+            }
+
+            if (!success) {
+                result.error = "Failed to finish WAV file: " + outputPath;
+            } else if (result.sha256.empty()) {
+                result.error = "Failed to hash output file: " + outputPath;
+                success = false;
+            } else {
+                const double hashSeconds = output.stream->getHashSeconds();
+                auto& telemetry = Telemetry::getInstance();
+                telemetry.recordStage(Telemetry::Stage::Write, std::max(0.0, output.writeSeconds - hashSeconds));
+                telemetry.recordStage(Telemetry::Stage::Hash, hashSeconds);
+            }
+        }
+
+        const bool opened = output.stream != nullptr;
+        output.writer.reset();
+        output.stream.reset(); // Ensure file is closed
+        if (!success && opened) {
+            juce::File(outputPath).deleteFile();
+        }
+
+        result.success = success;
+        output.done = true;
+
+        if (windowCallback) {
+            windowCallback(output.index, result);
+        }
+    };
+
+    std::vector<Output> outputs;
+    outputs.reserve(windows.size());
+    for (size_t i = 0; i < windows.size(); ++i) {
+        Output output;
+        output.index = i;
+        output.start = windows[i].range.start_samples();
+        output.end = output.start + windows[i].range.duration_samples();
+        outputs.push_back(std::move(output));
+
+        if (windows[i].range.duration_samples() <= 0) {
+            finishOutput(outputs.back(), false, "Invalid render range: duration must be positive");
+        }
+    }
+
+    std::vector<size_t> order;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        if (!outputs[i].done) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&outputs](size_t a, size_t b) {
+        return outputs[a].start < outputs[b].start;
+    });
+
+    // Mixing a gap shorter than a block costs less than starting another sweep
+    std::vector<Span> spans;
+    int64_t totalSamples = 0;
+    for (size_t i : order) {
+        if (spans.empty() || outputs[i].start > spans.back().end + blockSize_) {
+            if (!spans.empty()) {
+                totalSamples += spans.back().end - spans.back().start;
+            }
+            spans.push_back(Span{outputs[i].start, outputs[i].end, {}});
+        }
+        spans.back().end = std::max(spans.back().end, outputs[i].end);
+        spans.back().outputs.push_back(i);
+    }
+    if (!spans.empty()) {
+        totalSamples += spans.back().end - spans.back().start;
+    }
+
+    requestLog() << "[EDL][Render] Starting batch render: " << windows.size() << " windows in "
+                 << spans.size() << " sweeps, " << totalSamples << " samples" << std::endl;
+
+    const int numChannels = getOutputChannelCount(compiledEdl);
+
+    auto openOutput = [&](Output& output) {
+        const WindowOutput& window = windows[output.index];
+
+        std::string openError;
+        auto outputFile = createOutputFile(window.outputPath, openError);
+        if (!outputFile) {
+            finishOutput(output, false, openError);
+            return;
+        }
+
+        output.stream = std::make_unique<HashingOutputStream>(std::move(outputFile));
+        output.writer = std::make_unique<WavStreamWriter>(*output.stream, compiledEdl.sample_rate, numChannels,
+                                                          static_cast<int>(window.bitDepth),
+                                                          window.range.duration_samples());
+        if (!output.writer->isValid()) {
+            finishOutput(output, false, "Render range too long for a WAV file: " +
+                                        std::to_string(window.range.duration_samples()) + " samples");
+        }
+    };
+
+    int64_t samplesBefore = 0;
+    for (const auto& span : spans) {
+        size_t nextToOpen = 0;
+        std::vector<Output*> active;
+        int64_t position = span.start;
+
+        auto writeBlock = [&](const juce::AudioBuffer<float>& block, int numSamples) {
+            const int64_t blockEnd = position + numSamples;
+
+            while (nextToOpen < span.outputs.size() && outputs[span.outputs[nextToOpen]].start < blockEnd) {
+                Output& output = outputs[span.outputs[nextToOpen++]];
+                openOutput(output);
+                if (!output.done) {
+                    active.push_back(&output);
+                }
+            }
+
+            for (Output* output : active) {
+                const int64_t from = std::max(output->start, position);
+                const int64_t to = std::min(output->end, blockEnd);
+                if (from >= to) {
+                    continue;
+                }
+
+                const auto writeStart = std::chrono::steady_clock::now();
+                const bool written = output->writer->write(block, static_cast<int>(from - position),
+                                                           static_cast<int>(to - from));
+                output->writeSeconds += Telemetry::secondsSince(writeStart);
+
+                if (!written) {
+                    finishOutput(*output, false, "Failed to write audio data to: " + windows[output->index].outputPath);
+                } else if (to == output->end) {
+                    finishOutput(*output, true, {});
+                }
+            }
+
+            active.erase(std::remove_if(active.begin(), active.end(), [](const Output* output) { return output->done; }),
+                         active.end());
+            position = blockEnd;
+
+            // Stop early once every output of the span has failed
+            return position >= span.end || !active.empty() || nextToOpen < span.outputs.size();
+        };
+
+        ProgressCallback spanProgress;
+        if (progressCallback) {
+            const int64_t spanLength = span.end - span.start;
+            spanProgress = [&progressCallback, samplesBefore, spanLength, totalSamples](double fraction) {
+                progressCallback((static_cast<double>(samplesBefore) + fraction * static_cast<double>(spanLength)) /
+                                 static_cast<double>(totalSamples));
+            };
+        }
+
+        audio_engine::TimeRange range;
+        range.set_start_samples(span.start);
+        range.set_duration_samples(span.end - span.start);
+
+        std::string error;
+        renderTimeRange(compiledEdl, range, writeBlock, spanProgress, error);
+
+        // Whatever the sweep did not complete failed with it
+        for (size_t i : span.outputs) {
+            if (!outputs[i].done) {
+                finishOutput(outputs[i], false, error.empty() ? "Render did not reach the end of the range" : error);
+            }
+        }
+
+        samplesBefore += span.end - span.start;
+    }
+
+    return std::all_of(results.begin(), results.end(), [](const WindowResult& result) { return result.success; });
 }
 
 bool EdlRenderer::renderToBuffer(const EdlCompiler::CompiledEdl& compiledEdl,
@@ -31,20 +659,70 @@ bool EdlRenderer::renderToBuffer(const EdlCompiler::CompiledEdl& compiledEdl,
                                  ProgressCallback progressCallback,
                                  std::string& error) {
 
-    std::cout << "[EDL][Render] Starting render: start=" << range.start_samples()
-              << " duration=" << range.duration_samples() << " samples" << std::endl;
+    requestLog() << "[EDL][Render] Starting render: start=" << range.start_samples()
+                 << " duration=" << range.duration_samples() << " samples" << std::endl;
+
+    int64_t totalSamples = range.duration_samples();
+    if (totalSamples <= 0) {
+        error = "Invalid render range: duration must be positive";
+        return false;
+    }
+
+    if (totalSamples > std::numeric_limits<int>::max()) {
+        error = "Render range too long for an in-memory buffer: " + std::to_string(totalSamples) +
+                " samples (use renderToWav or renderBlocks)";
+        return false;
+    }
+
+    // Initialize output buffer
+    ensureBufferSize(outputBuffer, getOutputChannelCount(compiledEdl), static_cast<int>(totalSamples));
+    outputBuffer.clear();
+
+    int samplesCopied = 0;
+    auto copyBlock = [&outputBuffer, &samplesCopied](const juce::AudioBuffer<float>& block, int numSamples) {
+        for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch) {
+            if (ch < block.getNumChannels()) {
+                outputBuffer.copyFrom(ch, samplesCopied, block, ch, 0, numSamples);
+            }
+        }
+        samplesCopied += numSamples;
+        return true;
+    };
+
+    return renderTimeRange(compiledEdl, range, copyBlock, progressCallback, error);
+}
+
+bool EdlRenderer::renderBlocks(const EdlCompiler::CompiledEdl& compiledEdl,
+                               const audio_engine::TimeRange& range,
+                               BlockCallback blockCallback,
+                               ProgressCallback progressCallback,
+                               std::string& error) {
+
+    if (!blockCallback) {
+        error = "Block callback must be provided";
+        return false;
+    }
 
-    return renderTimeRange(compiledEdl, range, outputBuffer, progressCallback, error);
+    return renderTimeRange(compiledEdl, range, blockCallback, progressCallback, error);
+}
+
+int EdlRenderer::getOutputChannelCount(const EdlCompiler::CompiledEdl& compiledEdl) {
+    int maxChannels = 2; // Default stereo
+    for (const auto& track : compiledEdl.tracks) {
+        for (const EdlCompiler::MediaIndex media : track->media) {
+            maxChannels = std::max(maxChannels, compiledEdl.media[media].channels);
+        }
+    }
+    return maxChannels;
 }
 
 bool EdlRenderer::renderTimeRange(const EdlCompiler::CompiledEdl& compiledEdl,
                                   const audio_engine::TimeRange& range,
-                                  juce::AudioBuffer<float>& outputBuffer,
+                                  BlockCallback blockCallback,
                                   ProgressCallback progressCallback,
                                   std::string& error) {
 
     int64_t rangeStart = range.start_samples();
-    int64_t rangeEnd = rangeStart + range.duration_samples();
     int64_t totalSamples = range.duration_samples();
 
     if (totalSamples <= 0) {
@@ -53,207 +731,389 @@ bool EdlRenderer::renderTimeRange(const EdlCompiler::CompiledEdl& compiledEdl,
     }
 
     // Determine max channels needed
-    int maxChannels = 2; // Default stereo
-    for (const auto& track : compiledEdl.tracks) {
-        for (const auto& clip : track.clips) {
-            if (clip.media && clip.media->channels() > maxChannels) {
-                maxChannels = clip.media->channels();
-            }
+    int maxChannels = getOutputChannelCount(compiledEdl);
+    const ScopedMediaHandles openedMedia(mediaCache_, openMedia(compiledEdl));
+    const MediaHandleTable& mediaHandles = openedMedia.get();
+
+    // Resampled media is read into a scratch buffer first; size it for the widest filter span
+    int numSourceSamples = 0;
+    for (const auto& source : mediaHandles) {
+        if (source.resampler != nullptr) {
+            numSourceSamples = std::max(numSourceSamples, source.resampler->getMaxInputSamples(blockSize_));
         }
     }
 
-    // Initialize output buffer
-    ensureBufferSize(outputBuffer, maxChannels, static_cast<int>(totalSamples));
-    outputBuffer.clear();
+    // Parallel renders need a bus per track; serial renders reuse one bus
+    const int numTracks = static_cast<int>(compiledEdl.tracks.size());
+    const bool parallel = workerPool_ != nullptr && numTracks > 1;
+    scratch_.prepare(maxChannels, blockSize_, numTracks, parallel ? numTracks : 1, getNumWorkerThreads(),
+                     numSourceSamples);
 
-    // Render in blocks for progress updates
+    auto& mixBuffer = scratch_.mixBuffer;
+    const int64_t rangeEnd = rangeStart + totalSamples;
+    const int64_t prefetchWindow = static_cast<int64_t>(prefetchBlocks_) * blockSize_;
+    int64_t prefetchedUntil = rangeStart;
     int64_t samplesRendered = 0;
-    juce::AudioBuffer<float> mixBuffer;
-    ensureBufferSize(mixBuffer, maxChannels, blockSize_);
-
-    while (samplesRendered < totalSamples) {
-        int64_t blockStart = rangeStart + samplesRendered;
-        int64_t blockSamples = std::min(static_cast<int64_t>(blockSize_), totalSamples - samplesRendered);
-        int64_t blockEnd = blockStart + blockSamples;
+    int64_t blockStart = 0;
+    int64_t blockSamples = 0;
+    int64_t blockEnd = 0;
+
+    // Built once: capturing this many references would allocate every block
+    WorkerPool::Task renderTrackTask = [&](int trackIndex, int workerIndex) {
+        const auto& track = *compiledEdl.tracks[static_cast<size_t>(trackIndex)];
+        auto& bus = scratch_.trackBuses[static_cast<size_t>(trackIndex)];
+        ensureBufferSize(bus, maxChannels, static_cast<int>(blockSamples));
+        scratch_.trackHasAudio[static_cast<size_t>(trackIndex)] = !track.muted &&
+            renderTrack(track, scratch_.cursors[static_cast<size_t>(trackIndex)], blockStart, blockEnd, bus, 0,
+                        mediaHandles, scratch_.clipBuffers[static_cast<size_t>(workerIndex)],
+                        scratch_.sourceBuffers[static_cast<size_t>(workerIndex)],
+                        scratch_.fadeGains[static_cast<size_t>(workerIndex)]);
+    };
+
+    double mixSeconds = 0.0;
+
+    // Mix [start, start + numSamples) of the timeline into mixBuffer
+    auto mixBlock = [&](int64_t start, int64_t numSamples) {
+        const auto mixStart = std::chrono::steady_clock::now();
+        blockStart = start;
+        blockSamples = numSamples;
+        blockEnd = start + numSamples;
 
         // Clear mix buffer for this block
         ensureBufferSize(mixBuffer, maxChannels, static_cast<int>(blockSamples));
         mixBuffer.clear();
 
-        // Render each track into mix buffer
-        for (const auto& track : compiledEdl.tracks) {
-            if (!track.muted) {
-                renderTrack(track, blockStart, blockEnd, mixBuffer, 0);
+        if (parallel) {
+            // Render each track into its own bus on the worker pool...
+            workerPool_->parallelFor(numTracks, renderTrackTask);
+
+            // ...then sum the buses in track order so the result matches a serial render
+            for (int trackIndex = 0; trackIndex < numTracks; ++trackIndex) {
+                if (scratch_.trackHasAudio[static_cast<size_t>(trackIndex)]) {
+                    addToMixBuffer(mixBuffer, scratch_.trackBuses[static_cast<size_t>(trackIndex)]);
+                }
+            }
+        } else {
+            // Render each track into the shared bus and sum it into the mix
+            auto& bus = scratch_.trackBuses[0];
+            ensureBufferSize(bus, maxChannels, static_cast<int>(blockSamples));
+            for (int trackIndex = 0; trackIndex < numTracks; ++trackIndex) {
+                const auto& track = *compiledEdl.tracks[static_cast<size_t>(trackIndex)];
+                if (!track.muted && renderTrack(track, scratch_.cursors[static_cast<size_t>(trackIndex)],
+                                                blockStart, blockEnd, bus, 0, mediaHandles,
+                                                scratch_.clipBuffers[0], scratch_.sourceBuffers[0],
+                                                scratch_.fadeGains[0])) {
+                    addToMixBuffer(mixBuffer, bus);
+                }
             }
         }
 
-        // Copy block to output buffer
-        for (int ch = 0; ch < maxChannels; ++ch) {
-            if (ch < mixBuffer.getNumChannels()) {
-                outputBuffer.copyFrom(ch, static_cast<int>(samplesRendered),
-                                    mixBuffer, ch, 0, static_cast<int>(blockSamples));
+        mixSeconds += Telemetry::secondsSince(mixStart);
+    };
+
+    // Hand numSamples output samples to the consumer and report progress
+    auto emitBlock = [&](const juce::AudioBuffer<float>& block, int numSamples, int64_t position) {
+        if (!blockCallback(block, numSamples)) {
+            prefetcher_.cancel();
+            if (error.empty()) {
+                error = "Render aborted at sample " + std::to_string(position);
             }
+            return false;
         }
 
-        samplesRendered += blockSamples;
+        samplesRendered += numSamples;
 
         // Report progress
         if (progressCallback) {
             double fraction = static_cast<double>(samplesRendered) / totalSamples;
             progressCallback(fraction);
         }
+        return true;
+    };
+
+    int64_t blocksReused = 0;
+    int64_t blocksMixed = 0;
+
+    if (blockCache_ != nullptr) {
+        // Work on the timeline's block grid so blocks can be shared between renders and revisions
+        const int64_t firstBlock = floorDiv(rangeStart, blockSize_);
+        const int64_t numBlocks = floorDiv(rangeEnd - 1, blockSize_) + 1 - firstBlock;
+        auto& cachedBlocks = scratch_.cachedBlocks;
+        blockCache_->acquire(compiledEdl, maxChannels, firstBlock, numBlocks, cachedBlocks);
+
+        int64_t prefetchedBlocks = 0;
+
+        for (int64_t i = 0; i < numBlocks; ++i) {
+            const int64_t gridStart = (firstBlock + i) * blockSize_;
+
+            // Only blocks that will be mixed need their media read ahead
+            if (prefetchBlocks_ > 0) {
+                const int64_t aheadEnd = std::min(i + 1 + prefetchBlocks_, numBlocks);
+                for (prefetchedBlocks = std::max(prefetchedBlocks, i + 1); prefetchedBlocks < aheadEnd; ++prefetchedBlocks) {
+                    if (!cachedBlocks[static_cast<size_t>(prefetchedBlocks)]) {
+                        const int64_t aheadStart = (firstBlock + prefetchedBlocks) * blockSize_;
+                        requestPrefetch(compiledEdl, aheadStart, aheadStart + blockSize_, mediaHandles);
+                    }
+                }
+            }
+
+            const juce::AudioBuffer<float>* block = cachedBlocks[static_cast<size_t>(i)].get();
+            if (block != nullptr) {
+                ++blocksReused;
+            } else {
+                mixBlock(gridStart, blockSize_);
+                blockCache_->store(compiledEdl, firstBlock + i, mixBuffer);
+                block = &mixBuffer;
+                ++blocksMixed;
+            }
+
+            // The range may start or end inside a block
+            const int64_t outStart = std::max(rangeStart, gridStart);
+            const int numSamples = static_cast<int>(std::min(rangeEnd, gridStart + blockSize_) - outStart);
+            const int offset = static_cast<int>(outStart - gridStart);
+
+            if (offset > 0) {
+                auto& shifted = scratch_.outputBuffer;
+                ensureBufferSize(shifted, maxChannels, numSamples);
+                for (int ch = 0; ch < maxChannels; ++ch) {
+                    shifted.copyFrom(ch, 0, *block, ch, offset, numSamples);
+                }
+                block = &shifted;
+            }
+
+            if (!emitBlock(*block, numSamples, outStart)) {
+                cachedBlocks.clear();
+                return false;
+            }
+        }
+
+        cachedBlocks.clear();
+    } else {
+        // Render in blocks; each block is handed to the callback as soon as it is mixed
+        while (samplesRendered < totalSamples) {
+            const int64_t start = rangeStart + samplesRendered;
+            const int64_t numSamples = std::min(static_cast<int64_t>(blockSize_), totalSamples - samplesRendered);
+
+            // Let the I/O thread read what the next blocks need while this one mixes
+            if (prefetchWindow > 0) {
+                const int64_t aheadEnd = std::min(start + numSamples + prefetchWindow, rangeEnd);
+                if (aheadEnd > prefetchedUntil) {
+                    requestPrefetch(compiledEdl, std::max(prefetchedUntil, start + numSamples), aheadEnd, mediaHandles);
+                    prefetchedUntil = aheadEnd;
+                }
+            }
+
+            mixBlock(start, numSamples);
+            ++blocksMixed;
+
+            if (!emitBlock(mixBuffer, static_cast<int>(numSamples), start)) {
+                return false;
+            }
+        }
     }
 
-    std::cout << "[EDL][Render] Completed render: " << samplesRendered << " samples" << std::endl;
+    Telemetry::getInstance().recordStage(Telemetry::Stage::Mix, mixSeconds);
+
+    auto cacheStats = mediaCache_.getStats();
+    requestLog() << "[EDL][Render] Completed render: " << samplesRendered << " samples"
+                 << " (" << blocksMixed << " blocks mixed, " << blocksReused << " reused; media cache: " << cacheStats.hits << " hits, " << cacheStats.misses << " misses, "
+                 << cacheStats.prefetched << " prefetched, "
+                 << cacheStats.bytesUsed / (1024 * 1024) << " MB)" << std::endl;
     return true;
 }
 
-void EdlRenderer::renderTrack(const EdlCompiler::CompiledTrack& track,
+bool EdlRenderer::renderTrack(const EdlCompiler::CompiledTrack& track,
+                             EdlCompiler::ClipCursor& cursor,
                              int64_t rangeStart, int64_t rangeEnd,
-                             juce::AudioBuffer<float>& mixBuffer,
-                             int64_t bufferOffset) {
+                             juce::AudioBuffer<float>& trackBus,
+                             int64_t bufferOffset,
+                             const MediaHandleTable& mediaHandles,
+                             juce::AudioBuffer<float>& clipBuffer,
+                             juce::AudioBuffer<float>& sourceBuffer,
+                             std::vector<float>& fadeGains) {
 
-    auto clipsInRange = getClipsInRange(track, rangeStart, rangeEnd);
-    if (clipsInRange.empty()) {
-        return;
-    }
+    cursor.seek(track, rangeStart, rangeEnd);
 
-    juce::AudioBuffer<float> clipBuffer;
-    int numChannels = mixBuffer.getNumChannels();
+    int numChannels = trackBus.getNumChannels();
     int blockSamples = static_cast<int>(rangeEnd - rangeStart);
+    bool hasAudio = false;
 
-    for (const auto& clip : clipsInRange) {
-        ensureBufferSize(clipBuffer, numChannels, blockSamples);
-        clipBuffer.clear();
-
-        renderClip(clip, rangeStart, rangeEnd, clipBuffer, bufferOffset);
-
-        // Apply track gain
-        if (track.gain_linear != 1.0f) {
-            applyGain(clipBuffer, track.gain_linear);
+    for (const uint32_t i : cursor.active) {
+        if (!hasAudio) {
+            trackBus.clear();
+            hasAudio = true;
         }
 
-        // Add to mix
-        addToMixBuffer(mixBuffer, clipBuffer);
+        // The clip buffer only holds media samples; gains, fades and the sum happen in one pass
+        ensureBufferSize(clipBuffer, numChannels, blockSamples);
+        renderClip(track, i, rangeStart, rangeEnd, trackBus, bufferOffset, mediaHandles, clipBuffer,
+                   sourceBuffer, fadeGains);
     }
+
+    return hasAudio;
 }
 
-void EdlRenderer::renderClip(const EdlCompiler::CompiledClip& clip,
+void EdlRenderer::renderClip(const EdlCompiler::CompiledTrack& track, size_t clip,
                             int64_t rangeStart, int64_t rangeEnd,
+                            juce::AudioBuffer<float>& trackBus,
+                            int64_t bufferOffset,
+                            const MediaHandleTable& mediaHandles,
                             juce::AudioBuffer<float>& clipBuffer,
-                            int64_t bufferOffset) {
+                            juce::AudioBuffer<float>& sourceBuffer,
+                            std::vector<float>& fadeGains) {
+
+    const int64_t t0 = track.t0[clip];
+    const int64_t t1 = track.t1[clip];
 
     // Calculate intersection
-    int64_t clipStart = std::max(clip.t0, rangeStart);
-    int64_t clipEnd = std::min(clip.t1, rangeEnd);
+    int64_t clipStart = std::max(t0, rangeStart);
+    int64_t clipEnd = std::min(t1, rangeEnd);
 
     if (clipStart >= clipEnd) {
         return; // No intersection
     }
 
-    // Get audio reader
-    juce::AudioFormatReader* reader = getReader(clip.media->path());
-    if (!reader) {
-        std::cerr << "[EDL][Render] Failed to get reader for: " << clip.media->path() << std::endl;
+    // Look up the media in the page cache
+    const MediaSource& source = mediaHandles[track.media[clip]];
+    MediaPageCache::MediaInfo mediaInfo;
+    if (!mediaCache_.getMediaInfo(source.handle, mediaInfo)) {
+        std::cerr << "[EDL][Render] Failed to get reader for: "
+                  << (source.media != nullptr ? source.media->path : std::string()) << std::endl;
         return;
     }
 
-    // Calculate source positions
-    int64_t sourceStart = clip.clip->start_in_media() + (clipStart - clip.t0);
-    int64_t sourceSamples = clipEnd - clipStart;
     int bufferStart = static_cast<int>(clipStart - rangeStart + bufferOffset);
+    if (bufferStart < 0) {
+        return;
+    }
 
-    // Read audio data
-    if (sourceStart >= 0 && sourceStart < reader->lengthInSamples &&
-        sourceSamples > 0 && bufferStart >= 0) {
+    int readSamples = static_cast<int>(std::min(clipEnd - clipStart,
+        static_cast<int64_t>(trackBus.getNumSamples() - bufferStart)));
+    if (readSamples <= 0) {
+        return;
+    }
 
-        int readSamples = static_cast<int>(std::min(sourceSamples,
-            static_cast<int64_t>(clipBuffer.getNumSamples() - bufferStart)));
+    // Read audio data to the start of the clip buffer
+    const int64_t startInMedia = track.start_in_media[clip];
+    if (source.resampler == nullptr) {
+        int64_t sourceStart = startInMedia + (clipStart - t0);
+        if (sourceStart < 0 || sourceStart >= mediaInfo.lengthInSamples) {
+            return;
+        }
 
-        if (readSamples > 0) {
-            reader->read(&clipBuffer, bufferStart, readSamples,
-                        sourceStart, true, true);
+        mediaCache_.read(source.handle, clipBuffer, 0, readSamples, sourceStart);
+    } else if (!readResampled(startInMedia, source, mediaInfo.lengthInSamples, clipStart - t0,
+                              clipBuffer, 0, readSamples, sourceBuffer)) {
+        return;
+    }
 
-            // Apply clip gain
-            if (clip.gain_linear != 1.0f) {
-                for (int ch = 0; ch < clipBuffer.getNumChannels(); ++ch) {
-                    juce::FloatVectorOperations::multiply(
-                        clipBuffer.getWritePointer(ch, bufferStart),
-                        clip.gain_linear, readSamples);
-                }
-            }
+    mixClip(track, clip, clipStart, clipStart + readSamples, clipBuffer, trackBus, bufferStart, fadeGains);
+}
 
-            // Apply fades
-            if (!clip.fade_in.isEmpty()) {
-                applyFade(clipBuffer, clip.fade_in, clip.t0, clip.t1,
-                         clipStart, clipEnd, true);
-            }
+void EdlRenderer::mixClip(const EdlCompiler::CompiledTrack& track, size_t clip,
+                          int64_t mixStart, int64_t mixEnd,
+                          const juce::AudioBuffer<float>& clipBuffer,
+                          juce::AudioBuffer<float>& trackBus, int busStart,
+                          std::vector<float>& fadeGains) {
+    const int64_t t0 = track.t0[clip];
+    const int64_t t1 = track.t1[clip];
+    const unsigned features = track.mix_features[clip];
+    const auto& fadeIn = track.fade_in[clip];
+    const auto& fadeOut = track.fade_out[clip];
+
+    // Fade-in gains, then fade-out gains, for the samples being mixed
+    const int numSamples = static_cast<int>(mixEnd - mixStart);
+    fadeGains.resize(2 * static_cast<size_t>(numSamples));
+    float* fadeInGains = fadeGains.data();
+    float* fadeOutGains = fadeGains.data() + numSamples;
+
+    MixKernels::Span span;
+    span.source = clipBuffer.getArrayOfReadPointers();
+    span.dest = trackBus.getArrayOfWritePointers();
+    span.numChannels = std::min(clipBuffer.getNumChannels(), trackBus.getNumChannels());
+    span.clipGain = track.clip_gain[clip];
+    span.trackGain = track.gain_linear;
+
+    // Split at the fade edges so each piece runs a kernel without per-sample tests
+    const int64_t fadeInEnd = (features & MixKernels::FadeIn) != 0 ? t0 + fadeIn.length_samples : t0;
+    const int64_t fadeOutStart = (features & MixKernels::FadeOut) != 0 ? t1 - fadeOut.length_samples : t1;
+    int64_t edges[] = { mixStart, std::clamp(fadeInEnd, mixStart, mixEnd),
+                        std::clamp(fadeOutStart, mixStart, mixEnd), mixEnd };
+    std::sort(std::begin(edges), std::end(edges));
+
+    for (size_t e = 0; e + 1 < std::size(edges); ++e) {
+        const int64_t pieceStart = edges[e];
+        const int64_t pieceEnd = edges[e + 1];
+        if (pieceStart >= pieceEnd) {
+            continue;
+        }
 
-            if (!clip.fade_out.isEmpty()) {
-                applyFade(clipBuffer, clip.fade_out, clip.t0, clip.t1,
-                         clipStart, clipEnd, false);
-            }
+        const int offset = static_cast<int>(pieceStart - mixStart);
+        const int pieceSamples = static_cast<int>(pieceEnd - pieceStart);
+        unsigned pieceFeatures = features & (MixKernels::ClipGain | MixKernels::TrackGain);
+
+        if (pieceStart < fadeInEnd) {
+            pieceFeatures |= MixKernels::FadeIn;
+            fillFadeGains(fadeIn, pieceStart - t0, true, fadeInGains + offset, pieceSamples);
+        }
+        if (pieceStart >= fadeOutStart) {
+            pieceFeatures |= MixKernels::FadeOut;
+            fillFadeGains(fadeOut, pieceStart - fadeOutStart, false, fadeOutGains + offset, pieceSamples);
         }
-    }
-}
 
-void EdlRenderer::applyGain(juce::AudioBuffer<float>& buffer, float gainLinear) {
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        juce::FloatVectorOperations::multiply(buffer.getWritePointer(ch),
-                                            gainLinear, buffer.getNumSamples());
+        span.sourceStart = offset;
+        span.destStart = busStart + offset;
+        span.numSamples = pieceSamples;
+        span.fadeIn = fadeInGains + offset;
+        span.fadeOut = fadeOutGains + offset;
+        MixKernels::select(span.numChannels, pieceFeatures)(span);
     }
 }
 
-void EdlRenderer::applyFade(juce::AudioBuffer<float>& buffer, const EdlCompiler::FadeSpec& fade,
-                           int64_t clipStart, int64_t clipEnd, int64_t renderStart, int64_t renderEnd,
-                           bool isFadeIn) {
-
-    int64_t fadeStart, fadeEnd;
-    if (isFadeIn) {
-        fadeStart = clipStart;
-        fadeEnd = clipStart + fade.length_samples;
-    } else {
-        fadeStart = clipEnd - fade.length_samples;
-        fadeEnd = clipEnd;
+bool EdlRenderer::readResampled(int64_t startInMedia, const MediaSource& source,
+                                juce::int64 mediaLength, int64_t firstOutput,
+                                juce::AudioBuffer<float>& clipBuffer, int bufferStart, int numSamples,
+                                juce::AudioBuffer<float>& sourceBuffer) {
+    // Media samples around the outputs, including the filter's context on both sides
+    juce::int64 firstInput = 0;
+    int numInputs = 0;
+    source.resampler->getInputRange(firstOutput, numSamples, firstInput, numInputs);
+
+    const juce::int64 sourceStart = startInMedia + firstInput;
+    if (sourceStart >= mediaLength) {
+        return false;
     }
 
-    // Calculate intersection with render range
-    int64_t effectiveStart = std::max(fadeStart, renderStart);
-    int64_t effectiveEnd = std::min(fadeEnd, renderEnd);
+    ensureBufferSize(sourceBuffer, clipBuffer.getNumChannels(), numInputs);
+    mediaCache_.read(source.handle, sourceBuffer, 0, numInputs, sourceStart);
 
-    if (effectiveStart >= effectiveEnd) {
-        return; // No intersection
+    for (int ch = 0; ch < clipBuffer.getNumChannels(); ++ch) {
+        source.resampler->process(sourceBuffer.getReadPointer(ch), firstInput, numInputs,
+                                  clipBuffer.getWritePointer(ch, bufferStart), firstOutput, numSamples);
     }
 
-    int bufferStart = static_cast<int>(effectiveStart - renderStart);
-    int numSamples = static_cast<int>(effectiveEnd - effectiveStart);
-
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        float* samples = buffer.getWritePointer(ch, bufferStart);
+    return true;
+}
 
-        for (int i = 0; i < numSamples; ++i) {
-            int64_t samplePos = effectiveStart + i;
-            float fadePos = static_cast<float>(samplePos - fadeStart) / fade.length_samples;
+void EdlRenderer::fillFadeGains(const EdlCompiler::FadeSpec& fade, int64_t fadeOffset, bool isFadeIn,
+                               float* gains, int numSamples) {
+    // Same arithmetic as a per-sample evaluation, so output is bit-identical
+    const float length = static_cast<float>(fade.length_samples);
 
-            if (!isFadeIn) {
-                fadePos = 1.0f - fadePos;
-            }
+    for (int i = 0; i < numSamples; ++i) {
+        float fadePos = static_cast<float>(fadeOffset + i) / length;
 
-            fadePos = std::max(0.0f, std::min(1.0f, fadePos));
-            float gain = calculateFadeGain(fade.shape, fadePos);
-            samples[i] *= gain;
+        if (!isFadeIn) {
+            fadePos = 1.0f - fadePos;
         }
+
+        gains[i] = std::max(0.0f, std::min(1.0f, fadePos));
     }
-}
 
-float EdlRenderer::calculateFadeGain(EdlCompiler::FadeShape shape, float position) {
-    switch (shape) {
-        case EdlCompiler::FadeShape::Linear:
-            return position;
-        case EdlCompiler::FadeShape::EqualPower:
-            return std::sqrt(position);
-        default:
-            return position;
+    if (fade.shape == EdlCompiler::FadeShape::EqualPower) {
+        for (int i = 0; i < numSamples; ++i) {
+            gains[i] = std::sqrt(gains[i]);
+        }
     }
 }
 
@@ -267,25 +1127,82 @@ void EdlRenderer::addToMixBuffer(juce::AudioBuffer<float>& mixBuffer, const juce
     }
 }
 
-juce::AudioFormatReader* EdlRenderer::getReader(const std::string& filePath) {
-    auto it = readerCache_.find(filePath);
-    if (it != readerCache_.end()) {
-        return it->second.get();
+void EdlRenderer::requestPrefetch(const EdlCompiler::CompiledEdl& compiledEdl, int64_t windowStart,
+                                  int64_t windowEnd, const MediaHandleTable& mediaHandles) {
+    for (size_t trackIndex = 0; trackIndex < compiledEdl.tracks.size(); ++trackIndex) {
+        const auto& track = *compiledEdl.tracks[trackIndex];
+        if (track.muted) {
+            continue;
+        }
+
+        auto& cursor = scratch_.prefetchCursors[trackIndex];
+        cursor.seek(track, windowStart, windowEnd);
+
+        for (const uint32_t i : cursor.active) {
+            const int64_t t0 = track.t0[i];
+            const int64_t start = std::max(t0, windowStart);
+            const int64_t end = std::min(track.t1[i], windowEnd);
+            if (start >= end) {
+                continue;
+            }
+
+            const MediaSource& source = mediaHandles[track.media[i]];
+            if (source.handle == MediaPageCache::invalidHandle) {
+                continue;
+            }
+
+            const int64_t startInMedia = track.start_in_media[i];
+            if (source.resampler == nullptr) {
+                prefetcher_.request(source.handle, startInMedia + (start - t0), end - start);
+            } else {
+                juce::int64 firstInput = 0;
+                int numInputs = 0;
+                source.resampler->getInputRange(start - t0, static_cast<int>(end - start), firstInput, numInputs);
+                prefetcher_.request(source.handle, startInMedia + firstInput, numInputs);
+            }
+        }
+    }
+}
+
+EdlRenderer::MediaHandleTable EdlRenderer::openMedia(const EdlCompiler::CompiledEdl& compiledEdl) {
+    // Resolved once per render so the block loop only indexes an array
+    MediaHandleTable mediaHandles;
+    mediaHandles.reserve(compiledEdl.media.size());
+    for (const auto& media : compiledEdl.media) {
+        MediaSource source;
+        source.handle = mediaCache_.openMedia(media.path);
+        source.media = &media;
+
+        MediaPageCache::MediaInfo info;
+        if (mediaCache_.getMediaInfo(source.handle, info)) {
+            source.resampler = getResampler(info.sampleRate, compiledEdl.sample_rate);
+        }
+
+        mediaHandles.push_back(source);
     }
+    return mediaHandles;
+}
 
-    juce::File file(filePath);
-    std::unique_ptr<juce::AudioFormatReader> reader(formatManager_.createReaderFor(file));
-    if (!reader) {
+const Resampler* EdlRenderer::getResampler(double mediaSampleRate, int edlSampleRate) {
+    const int mediaRate = juce::roundToInt(mediaSampleRate);
+    if (mediaRate <= 0 || edlSampleRate <= 0 || mediaRate == edlSampleRate) {
         return nullptr;
     }
 
-    juce::AudioFormatReader* rawReader = reader.get();
-    readerCache_[filePath] = std::move(reader);
-    return rawReader;
+    const juce::int64 key = (static_cast<juce::int64>(mediaRate) << 32) | static_cast<juce::uint32>(edlSampleRate);
+    auto& resampler = resamplers_[key];
+    if (!resampler) {
+        auto created = std::make_unique<Resampler>();
+        if (!created->prepare(mediaRate, edlSampleRate)) {
+            return nullptr;
+        }
+        resampler = std::move(created);
+    }
+    return resampler.get();
 }
 
-bool EdlRenderer::writeWavFile(const juce::AudioBuffer<float>& buffer, int sampleRate,
-                              const std::string& outputPath, BitDepth bitDepth, std::string& error) {
+std::unique_ptr<juce::FileOutputStream> EdlRenderer::createOutputFile(const std::string& outputPath,
+                                                                     std::string& error) {
 
     juce::File outputFile(outputPath);
     outputFile.getParentDirectory().createDirectory();
@@ -297,45 +1214,70 @@ bool EdlRenderer::writeWavFile(const juce::AudioBuffer<float>& buffer, int sampl
     std::unique_ptr<juce::FileOutputStream> outputStream(outputFile.createOutputStream());
     if (!outputStream) {
         error = "Cannot create output file: " + outputPath;
-        return false;
+        return nullptr;
     }
 
-    juce::WavAudioFormat wavFormat;
-    int bitsPerSample = static_cast<int>(bitDepth);
+    return outputStream;
+}
 
-    std::unique_ptr<juce::AudioFormatWriter> writer(
-        wavFormat.createWriterFor(outputStream.get(), sampleRate, buffer.getNumChannels(),
-                                 bitsPerSample, {}, 0));
+bool EdlRenderer::writeWavFile(const juce::AudioBuffer<float>& buffer, int sampleRate,
+                              const std::string& outputPath, BitDepth bitDepth, std::string& error) {
 
-    if (!writer) {
-        error = "Cannot create WAV writer for: " + outputPath;
+    auto outputStream = createOutputFile(outputPath, error);
+    if (!outputStream) {
         return false;
     }
 
-    outputStream.release(); // Writer takes ownership
+    WavStreamWriter writer(*outputStream, sampleRate, buffer.getNumChannels(),
+                           static_cast<int>(bitDepth), buffer.getNumSamples());
 
-    bool success = writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
-    writer.reset(); // Ensure file is flushed and closed
+    bool success = writer.write(buffer, 0, buffer.getNumSamples()) && writer.finish();
+    outputStream.reset(); // Ensure file is flushed and closed
 
     if (!success) {
         error = "Failed to write audio data to: " + outputPath;
+        juce::File(outputPath).deleteFile();
         return false;
     }
 
     return true;
 }
 
-std::vector<EdlCompiler::CompiledClip> EdlRenderer::getClipsInRange(const EdlCompiler::CompiledTrack& track,
-                                                                   int64_t rangeStart, int64_t rangeEnd) {
-    std::vector<EdlCompiler::CompiledClip> result;
+void EdlRenderer::RenderScratch::prepare(int numChannels, int numSamples, int numTracks,
+                                        int numBuses, int numWorkers, int numSourceSamples) {
+    // Allocate at full size once; later setSize calls within it reuse the memory
+    auto prepareBuffer = [numChannels, numSamples](juce::AudioBuffer<float>& buffer) {
+        buffer.setSize(numChannels, numSamples, false, false, true);
+    };
 
-    for (const auto& clip : track.clips) {
-        if (clip.t1 > rangeStart && clip.t0 < rangeEnd) {
-            result.push_back(clip);
-        }
+    prepareBuffer(mixBuffer);
+    prepareBuffer(outputBuffer);
+
+    trackBuses.resize(static_cast<size_t>(numBuses));
+    std::for_each(trackBuses.begin(), trackBuses.end(), prepareBuffer);
+
+    clipBuffers.resize(static_cast<size_t>(numWorkers));
+    std::for_each(clipBuffers.begin(), clipBuffers.end(), prepareBuffer);
+
+    sourceBuffers.resize(static_cast<size_t>(numWorkers));
+    for (auto& buffer : sourceBuffers) {
+        buffer.setSize(numChannels, numSourceSamples, false, false, true);
     }
 
-    return result;
+    fadeGains.resize(static_cast<size_t>(numWorkers));
+    for (auto& gains : fadeGains) {
+        gains.reserve(2 * static_cast<size_t>(numSamples));
+    }
+
+    trackHasAudio.assign(static_cast<size_t>(numTracks), 0);
+
+    // Unpositioned cursors keep their active lists' capacity from earlier renders
+    for (auto* trackCursors : { &cursors, &prefetchCursors }) {
+        trackCursors->resize(static_cast<size_t>(numTracks));
+        for (auto& cursor : *trackCursors) {
+            cursor.track = nullptr;
+        }
+    }
 }
 
 void EdlRenderer::ensureBufferSize(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) {
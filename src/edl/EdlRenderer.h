@@ -1,9 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include "EdlCompiler.h"
+#include "MediaPageCache.h"
+#include "MediaPrefetcher.h"
+#include "RenderBlockCache.h"
+#include "util/Resampler.h"
+#include "util/WorkerPool.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_formats/juce_audio_formats.h>
 
@@ -15,28 +22,134 @@ namespace juceaudioservice {
  * Renders time ranges from compiled EDL to audio buffers with
  * proper gain, fade, and crossfade handling. Supports multiple
  * bit depths for WAV output.
+ *
+ * Each block is mixed by rendering every track into its own bus and then
+ * summing the buses in track order. Tracks can be rendered on a worker
+ * pool; because the summation order is fixed, serial and parallel renders
+ * are bit-identical.
+ *
+ * Source audio is read through a MediaPageCache, by default the
+ * process-wide one, so renders share decoded media instead of each
+ * opening and decoding the files again. While a block is mixed, a
+ * MediaPrefetcher decodes the media the next few blocks need on its own
+ * I/O thread.
+ *
+ * Media whose sample rate differs from the EDL's is resampled on the fly
+ * with a polyphase Resampler. A clip's start_in_media then counts samples
+ * at the media's own rate, while its timeline position and duration stay
+ * in EDL samples. Each block reads exactly the source span it needs, so
+ * results do not depend on where a render starts or how it is split.
+ *
+ * With a RenderBlockCache attached, renders mix whole blocks of the
+ * timeline's block grid and keep them in the cache; blocks an edit did
+ * not touch are taken from it instead of being mixed again, so the cost
+ * of re-rendering after a small edit follows the size of the edit. The
+ * output is bit-identical to a render without the cache.
  */
 class EdlRenderer {
 public:
     using ProgressCallback = std::function<void(double fraction)>;
 
+    /**
+     * Receives each rendered mix block in timeline order.
+     *
+     * The block buffer is owned by the renderer and only valid for the
+     * duration of the call; the first numSamples samples of every channel
+     * hold the mix. Return false to abort the render.
+     */
+    using BlockCallback = std::function<bool(const juce::AudioBuffer<float>& block, int numSamples)>;
+
     enum class BitDepth {
         Int16 = 16,
         Int24 = 24,
         Float32 = 32
     };
 
+    enum class OutputFormat {
+        Wav,
+        Flac // lossless; 16 or 24 bits
+    };
+
+    /** FLAC compression level (0-8); libFLAC's default balance of size and speed. */
+    static constexpr int flacCompressionLevel = 5;
+
     EdlRenderer();
+
+    /**
+     * Create a renderer that reads media through a specific cache.
+     *
+     * @param mediaCache Cache to read decoded media from; must outlive the renderer
+     */
+    explicit EdlRenderer(MediaPageCache& mediaCache);
+
     ~EdlRenderer() = default;
 
+    /**
+     * Set how many threads render tracks in parallel.
+     *
+     * @param numThreads Threads used per block, including the calling
+     *                   thread; 1 (the default) renders serially
+     */
+    void setNumWorkerThreads(int numThreads);
+
+    /** Number of threads used to render tracks, including the caller. */
+    int getNumWorkerThreads() const noexcept;
+
+    static constexpr int defaultPrefetchBlocks = 8;
+
+    /**
+     * Set how far ahead of the mixer media is read on the I/O thread.
+     *
+     * @param numBlocks Look-ahead in render blocks; 0 reads media only
+     *                  when a block needs it
+     */
+    void setPrefetchBlocks(int numBlocks) noexcept { prefetchBlocks_ = std::max(0, numBlocks); }
+    int getPrefetchBlocks() const noexcept { return prefetchBlocks_; }
+
+    /**
+     * Reuse mixed blocks between renders.
+     *
+     * @param cache Cache shared by renders, created with getBlockSize();
+     *              must outlive the renderer. nullptr mixes every block.
+     */
+    void setBlockCache(RenderBlockCache* cache) noexcept;
+    RenderBlockCache* getBlockCache() const noexcept { return blockCache_; }
+
+    /** Shortest run of the timeline, in blocks, worth its own segment thread. */
+    static constexpr int minSegmentBlocks = 32;
+
+    /**
+     * Set how many threads share the range of one renderToWav().
+     *
+     * Long ranges are cut on the block grid into that many segments. Each
+     * is mixed by its own renderer and written straight to its byte offset
+     * in the pre-sized output file, and the header is written last. Tracks
+     * are then mixed serially within each segment. The file is hashed in a
+     * pass after the render because it is not written in order.
+     *
+     * @param numThreads Threads per render, including the calling thread;
+     *                   1 (the default) renders in one sweep
+     */
+    void setNumSegmentThreads(int numThreads);
+
+    /** Number of threads renderToWav() splits a range between, including the caller. */
+    int getNumSegmentThreads() const noexcept;
+
     /**
      * Render a time range from compiled EDL to WAV file.
      *
+     * Blocks are streamed straight into the WAV writer as they are mixed,
+     * so memory use is independent of the range duration. The file is
+     * hashed while it is written, so no second pass over it is needed.
+     * With segment threads (setNumSegmentThreads()) a long range is
+     * rendered in parallel slices instead; the file is the same.
+     *
      * @param compiledEdl The compiled EDL timeline
      * @param range Time range to render
      * @param outputPath Output WAV file path
      * @param bitDepth Output bit depth
      * @param progressCallback Optional progress callback (0.0 to 1.0)
+     * @param sha256 Receives the hex SHA-256 of the written file
      * @param error Output parameter for error message
      * @return true if rendering succeeded
      */
@@ -45,8 +158,78 @@ public:
                      const std::string& outputPath,
                      BitDepth bitDepth,
                      ProgressCallback progressCallback,
+                     std::string& sha256,
                      std::string& error);
 
+    /**
+     * Render a time range from compiled EDL to a file in any output format.
+     *
+     * WAV goes through renderToWav(). Compressed formats are encoded on a
+     * separate thread (PipelinedAudioWriter) while the next blocks are
+     * mixed, and the file is hashed once it is closed, since encoders
+     * rewrite their header at the end.
+     *
+     * @param compiledEdl The compiled EDL timeline
+     * @param range Time range to render
+     * @param outputPath Output file path
+     * @param format Output container and codec
+     * @param bitDepth Output bit depth; FLAC takes 16 or 24
+     * @param progressCallback Optional progress callback (0.0 to 1.0)
+     * @param sha256 Receives the hex SHA-256 of the written file
+     * @param error Output parameter for error message
+     * @return true if rendering succeeded
+     */
+    bool renderToFile(const EdlCompiler::CompiledEdl& compiledEdl,
+                      const audio_engine::TimeRange& range,
+                      const std::string& outputPath,
+                      OutputFormat format,
+                      BitDepth bitDepth,
+                      ProgressCallback progressCallback,
+                      std::string& sha256,
+                      std::string& error);
+
+    /** Lowercase name of an output format, as used in logs and cache keys. */
+    static const char* getFormatName(OutputFormat format) noexcept;
+
+    /** One output of renderWindowsToWav(). */
+    struct WindowOutput {
+        audio_engine::TimeRange range;
+        std::string outputPath;
+        BitDepth bitDepth = BitDepth::Float32;
+    };
+
+    /** How one output of renderWindowsToWav() ended. */
+    struct WindowResult {
+        bool success = false;
+        std::string sha256;
+        std::string error;
+    };
+
+    /** Called with each output's index as soon as its file is complete or has failed. */
+    using WindowCallback = std::function<void(size_t index, const WindowResult& result)>;
+
+    /**
+     * Render several time ranges of one timeline to WAV files in one pass.
+     *
+     * Ranges that overlap or lie less than a block apart are merged and
+     * mixed once, and each mixed block is written to every output it falls
+     * in, so media under shared parts is read and decoded once. Every file
+     * is bit-identical to renderToWav() of its own range, and an output
+     * that fails does not stop the others.
+     *
+     * @param compiledEdl The compiled EDL timeline
+     * @param windows Outputs to render; their paths must differ
+     * @param progressCallback Optional progress over all outputs (0.0 to 1.0)
+     * @param windowCallback Optional; told about each output as it finishes
+     * @param results Receives one result per window, in request order
+     * @return true if every output was written
+     */
+    bool renderWindowsToWav(const EdlCompiler::CompiledEdl& compiledEdl,
+                            const std::vector<WindowOutput>& windows,
+                            ProgressCallback progressCallback,
+                            WindowCallback windowCallback,
+                            std::vector<WindowResult>& results);
+
     /**
      * Render a time range from compiled EDL to audio buffer.
      *
@@ -63,46 +246,219 @@ public:
                        ProgressCallback progressCallback,
                        std::string& error);
 
+    /**
+     * Render a time range from compiled EDL block by block.
+     *
+     * @param compiledEdl The compiled EDL timeline
+     * @param range Time range to render
+     * @param blockCallback Called with each mixed block in order
+     * @param progressCallback Optional progress callback (0.0 to 1.0)
+     * @param error Output parameter for error message
+     * @return true if rendering succeeded
+     */
+    bool renderBlocks(const EdlCompiler::CompiledEdl& compiledEdl,
+                      const audio_engine::TimeRange& range,
+                      BlockCallback blockCallback,
+                      ProgressCallback progressCallback,
+                      std::string& error);
+
+    /**
+     * Write an already rendered buffer to a WAV file.
+     *
+     * @param buffer Audio to write
+     * @param sampleRate Output sample rate
+     * @param outputPath Output WAV file path
+     * @param bitDepth Output bit depth
+     * @param error Output parameter for error message
+     * @return true if the file was written
+     */
+    bool writeWavFile(const juce::AudioBuffer<float>& buffer, int sampleRate,
+                      const std::string& outputPath, BitDepth bitDepth, std::string& error);
+
+    /**
+     * Number of output channels a render of the compiled EDL produces.
+     */
+    static int getOutputChannelCount(const EdlCompiler::CompiledEdl& compiledEdl);
+
+    /** Number of frames renderBlocks() mixes per block. */
+    static constexpr int getBlockSize() noexcept { return blockSize_; }
+
 private:
     static constexpr int blockSize_ = 4096;
 
-    juce::AudioFormatManager formatManager_;
-    std::unordered_map<std::string, std::unique_ptr<juce::AudioFormatReader>> readerCache_;
+    // Cache handle of a media file, and its converter when it isn't at the EDL rate
+    struct MediaSource {
+        MediaPageCache::MediaHandle handle = MediaPageCache::invalidHandle;
+        const Resampler* resampler = nullptr;
+        const EdlCompiler::CompiledMedia* media = nullptr;
+    };
+
+    // Sources of the media of the timeline being rendered, by MediaIndex
+    using MediaHandleTable = std::vector<MediaSource>;
+
+    // Handles opened for one render, given back to the cache when it ends
+    class ScopedMediaHandles {
+    public:
+        ScopedMediaHandles(MediaPageCache& cache, MediaHandleTable handles)
+            : cache_(cache), handles_(std::move(handles)) {}
+
+        ~ScopedMediaHandles() {
+            for (const auto& source : handles_) {
+                cache_.releaseMedia(source.handle);
+            }
+        }
+
+        const MediaHandleTable& get() const noexcept { return handles_; }
+
+        ScopedMediaHandles(const ScopedMediaHandles&) = delete;
+        ScopedMediaHandles& operator=(const ScopedMediaHandles&) = delete;
+
+    private:
+        MediaPageCache& cache_;
+        const MediaHandleTable handles_;
+    };
+
+    /**
+     * Buffers reused by every block of a render, and by later renders.
+     *
+     * prepare() sizes everything for a full block before the block loop
+     * starts, so steady-state blocks never touch the heap; shorter blocks
+     * only shrink the buffers in place.
+     */
+    struct RenderScratch {
+        juce::AudioBuffer<float> mixBuffer;
+        std::vector<juce::AudioBuffer<float>> trackBuses;  // one per track when parallel, else one
+        std::vector<juce::AudioBuffer<float>> clipBuffers; // one per worker thread
+        std::vector<juce::AudioBuffer<float>> sourceBuffers; // media to resample, one per worker thread
+        std::vector<std::vector<float>> fadeGains;         // one per worker thread
+        std::vector<char> trackHasAudio;
+        std::vector<EdlCompiler::ClipCursor> cursors;
+        std::vector<EdlCompiler::ClipCursor> prefetchCursors; // run ahead of cursors
+        juce::AudioBuffer<float> outputBuffer;              // part of a grid block, when a range starts inside one
+        std::vector<RenderBlockCache::BlockPtr> cachedBlocks;
+
+        void prepare(int numChannels, int numSamples, int numTracks, int numBuses, int numWorkers,
+                     int numSourceSamples);
+    };
+
+    MediaPageCache& mediaCache_;
+    MediaPrefetcher prefetcher_;
+    int prefetchBlocks_ = defaultPrefetchBlocks;
+    RenderBlockCache* blockCache_ = nullptr;
+    std::unique_ptr<WorkerPool> workerPool_;
+    RenderScratch scratch_;
+
+    // Converters by (media rate, EDL rate), kept across renders; read-only while rendering
+    std::unordered_map<juce::int64, std::unique_ptr<Resampler>> resamplers_;
+
+    // Time-sliced renders: one renderer per segment thread, each with its own scratch
+    std::unique_ptr<WorkerPool> segmentPool_;
+    std::vector<std::unique_ptr<EdlRenderer>> segmentRenderers_;
+
+    /**
+     * Cut a range into segments for the segment threads.
+     *
+     * @return Segment boundaries, starting with rangeStart and ending with
+     *         rangeEnd; only those two if the range is too short to split
+     */
+    std::vector<int64_t> planSegments(int64_t rangeStart, int64_t rangeEnd) const;
+
+    bool renderToFlac(const EdlCompiler::CompiledEdl& compiledEdl,
+                      const audio_engine::TimeRange& range,
+                      const std::string& outputPath,
+                      BitDepth bitDepth,
+                      ProgressCallback progressCallback,
+                      std::string& sha256,
+                      std::string& error);
+
+    bool renderSegmentsToWav(const EdlCompiler::CompiledEdl& compiledEdl,
+                             const audio_engine::TimeRange& range,
+                             const std::vector<int64_t>& bounds,
+                             const std::string& outputPath,
+                             BitDepth bitDepth,
+                             ProgressCallback progressCallback,
+                             std::string& sha256,
+                             std::string& error);
 
     // Core rendering methods
     bool renderTimeRange(const EdlCompiler::CompiledEdl& compiledEdl,
                         const audio_engine::TimeRange& range,
-                        juce::AudioBuffer<float>& outputBuffer,
+                        BlockCallback blockCallback,
                         ProgressCallback progressCallback,
                         std::string& error);
 
-    void renderTrack(const EdlCompiler::CompiledTrack& track,
+    bool renderTrack(const EdlCompiler::CompiledTrack& track,
+                    EdlCompiler::ClipCursor& cursor,
                     int64_t rangeStart, int64_t rangeEnd,
-                    juce::AudioBuffer<float>& mixBuffer,
-                    int64_t bufferOffset);
+                    juce::AudioBuffer<float>& trackBus,
+                    int64_t bufferOffset,
+                    const MediaHandleTable& mediaHandles,
+                    juce::AudioBuffer<float>& clipBuffer,
+                    juce::AudioBuffer<float>& sourceBuffer,
+                    std::vector<float>& fadeGains);
 
-    void renderClip(const EdlCompiler::CompiledClip& clip,
+    void renderClip(const EdlCompiler::CompiledTrack& track, size_t clip,
                    int64_t rangeStart, int64_t rangeEnd,
+                   juce::AudioBuffer<float>& trackBus,
+                   int64_t bufferOffset,
+                   const MediaHandleTable& mediaHandles,
                    juce::AudioBuffer<float>& clipBuffer,
-                   int64_t bufferOffset);
+                   juce::AudioBuffer<float>& sourceBuffer,
+                   std::vector<float>& fadeGains);
+
+    /**
+     * Scale a clip's media samples and add them to the track bus.
+     *
+     * @param mixStart Timeline sample of clipBuffer's first sample
+     * @param mixEnd End of the samples to mix (exclusive)
+     * @param clipBuffer Media samples of [mixStart, mixEnd), from sample 0
+     * @param busStart Bus sample that mixStart lands on
+     * @param fadeGains Scratch for the fade curves
+     */
+    void mixClip(const EdlCompiler::CompiledTrack& track, size_t clip,
+                 int64_t mixStart, int64_t mixEnd,
+                 const juce::AudioBuffer<float>& clipBuffer,
+                 juce::AudioBuffer<float>& trackBus, int busStart,
+                 std::vector<float>& fadeGains);
+
+    /**
+     * Read and resample the media under part of a clip.
+     *
+     * @param startInMedia Media sample at the clip start
+     * @param firstOutput Clip-relative timeline sample of the first output
+     * @param sourceBuffer Scratch for the media span the filter needs
+     * @return false if the span lies past the end of the media
+     */
+    bool readResampled(int64_t startInMedia, const MediaSource& source,
+                       juce::int64 mediaLength, int64_t firstOutput,
+                       juce::AudioBuffer<float>& clipBuffer, int bufferStart, int numSamples,
+                       juce::AudioBuffer<float>& sourceBuffer);
 
     // Audio processing
-    void applyGain(juce::AudioBuffer<float>& buffer, float gainLinear);
-    void applyFade(juce::AudioBuffer<float>& buffer, const EdlCompiler::FadeSpec& fade,
-                  int64_t clipStart, int64_t clipEnd, int64_t renderStart, int64_t renderEnd,
-                  bool isFadeIn);
 
-    float calculateFadeGain(EdlCompiler::FadeShape shape, float position);
+    /**
+     * Evaluate a fade curve for a run of samples.
+     *
+     * @param fade The fade being applied
+     * @param fadeOffset Position of the first sample relative to the fade start
+     * @param isFadeIn true for a fade in, false for a fade out
+     * @param gains Receives numSamples gains
+     * @param numSamples Number of samples to evaluate
+     */
+    static void fillFadeGains(const EdlCompiler::FadeSpec& fade, int64_t fadeOffset, bool isFadeIn,
+                              float* gains, int numSamples);
     void addToMixBuffer(juce::AudioBuffer<float>& mixBuffer, const juce::AudioBuffer<float>& clipBuffer);
 
-    // File I/O
-    juce::AudioFormatReader* getReader(const std::string& filePath);
-    bool writeWavFile(const juce::AudioBuffer<float>& buffer, int sampleRate,
-                     const std::string& outputPath, BitDepth bitDepth, std::string& error);
+    // Queue the media every unmuted clip needs in [windowStart, windowEnd)
+    void requestPrefetch(const EdlCompiler::CompiledEdl& compiledEdl, int64_t windowStart, int64_t windowEnd,
+                         const MediaHandleTable& mediaHandles);
+
+    // File I/O; every handle in the table holds a reference until it is released
+    MediaHandleTable openMedia(const EdlCompiler::CompiledEdl& compiledEdl);
+    const Resampler* getResampler(double mediaSampleRate, int edlSampleRate);
+    std::unique_ptr<juce::FileOutputStream> createOutputFile(const std::string& outputPath, std::string& error);
 
     // Helper methods
-    std::vector<EdlCompiler::CompiledClip> getClipsInRange(const EdlCompiler::CompiledTrack& track,
-                                                          int64_t rangeStart, int64_t rangeEnd);
     void ensureBufferSize(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EdlRenderer)
@@ -1,27 +1,44 @@
 #include "EdlStore.h"
+#include "EdlCompiler.h"
+#include "util/MediaInfoCache.h"
+#include "util/Telemetry.h"
 #include <openssl/evp.h>
+#include <iostream>
 #include <sstream>
 #include <iomanip>
-#include <google/protobuf/util/json_util.h>
+#include <algorithm>
+#include <cstring>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 
 namespace juceaudioservice {
 
-EdlStore::EdlStore() {
-    formatManager_.registerBasicFormats();
-}
+namespace {
+
+// Hashed into every revision; bump it if the digest layout changes
+constexpr const char* revisionFormat = "edl-revision-v2";
+
+} // namespace
+
+EdlStore::EdlStore() = default;
 
 bool EdlStore::replace(const audio_engine::Edl& edl, Snapshot& out_snapshot, std::string& error) {
     std::lock_guard<std::mutex> lock(mutex_);
+    probedMedia_.clear();
 
     // Validate the EDL
-    if (!validateEdl(edl, error)) {
-        return false;
+    {
+        Telemetry::ScopedTimer timer(Telemetry::Stage::Validate);
+        if (!validateEdl(edl, error)) {
+            return false;
+        }
     }
 
     // Create new snapshot
     Snapshot newSnapshot;
     newSnapshot.edl = edl;
-    newSnapshot.revision = calculateRevision(edl);
+    RevisionDigests digests = digestEdl(edl);
+    newSnapshot.revision = combineRevision(digests);
     countTracksAndClips(edl, newSnapshot.track_count, newSnapshot.clip_count);
 
     // Update revision if it was empty or different content
@@ -29,23 +46,146 @@ bool EdlStore::replace(const audio_engine::Edl& edl, Snapshot& out_snapshot, std
         newSnapshot.edl.set_revision(newSnapshot.revision);
     }
 
+    // Compile once per revision; renders share the result
+    auto compiled = std::make_shared<CompiledEdl>();
+    {
+        Telemetry::ScopedTimer timer(Telemetry::Stage::Compile);
+        EdlCompiler compiler;
+        if (!compiler.compile(newSnapshot, *compiled, error)) {
+            error = "Compilation failed: " + error;
+            return false;
+        }
+    }
+    newSnapshot.compiled = std::move(compiled);
+
     // Store the new snapshot
     current_ = newSnapshot;
+    digests_ = std::move(digests);
     out_snapshot = newSnapshot;
 
     return true;
 }
 
+bool EdlStore::patch(const audio_engine::PatchEdlRequest& request, PatchResult& result, std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!current_) {
+        error = "No EDL currently loaded";
+        return false;
+    }
+
+    audio_engine::Edl& edl = current_->edl;
+    if (request.edl_id() != edl.id()) {
+        error = "EDL ID mismatch: patch targets '" + request.edl_id() +
+               "' but current is '" + edl.id() + "'";
+        return false;
+    }
+
+    if (!request.base_revision().empty() && request.base_revision() != current_->revision) {
+        error = "Stale base revision " + request.base_revision() + ", current is " + current_->revision;
+        result.stale_base = true;
+        return false;
+    }
+
+    if (request.edits().empty()) {
+        error = "Patch must contain at least one edit";
+        return false;
+    }
+
+    // Stage and validate every edit before touching the stored EDL
+    probedMedia_.clear();
+    PatchState state;
+    {
+        Telemetry::ScopedTimer timer(Telemetry::Stage::Validate);
+        for (int i = 0; i < request.edits_size(); ++i) {
+            if (!applyEdit(edl, request.edits(i), state, error)) {
+                error = "Edit " + std::to_string(i) + ": " + error;
+                return false;
+            }
+        }
+    }
+
+    int trackCount = edl.tracks_size() - static_cast<int>(state.removedTrackIds.size()) +
+                     static_cast<int>(state.addedTrackIds.size());
+    if (trackCount <= 0) {
+        error = "EDL must contain at least one track";
+        return false;
+    }
+
+    // commitPatch keeps untouched tracks in order, drops removed ones and appends added ones,
+    // so the digests of untouched tracks can be carried over by position
+    std::vector<const Digest*> keptDigests;
+    keptDigests.reserve(static_cast<size_t>(edl.tracks_size()));
+    for (int i = 0; i < edl.tracks_size(); ++i) {
+        const std::string& trackId = edl.tracks(i).id();
+        if (state.removedTrackIds.count(trackId) > 0) {
+            continue;
+        }
+        const bool touched = state.stagedTracks.count(trackId) > 0;
+        keptDigests.push_back(touched ? nullptr : &digests_.tracks[static_cast<size_t>(i)]);
+    }
+
+    result.base_revision = current_->revision;
+    commitPatch(edl, state, current_->clip_count);
+
+    // Rehash only what the patch changed
+    std::string scratch;
+    std::vector<Digest> trackDigests;
+    trackDigests.reserve(static_cast<size_t>(edl.tracks_size()));
+    for (int i = 0; i < edl.tracks_size(); ++i) {
+        const auto kept = static_cast<size_t>(i) < keptDigests.size() ? keptDigests[static_cast<size_t>(i)] : nullptr;
+        trackDigests.push_back(kept ? *kept : digestMessage(edl.tracks(i), scratch));
+    }
+    digests_.tracks = std::move(trackDigests);
+
+    for (int i = static_cast<int>(digests_.media.size()); i < edl.media_size(); ++i) {
+        digests_.media.push_back(digestMessage(edl.media(i), scratch));
+    }
+
+    current_->track_count = edl.tracks_size();
+    current_->revision = combineRevision(digests_);
+    edl.set_revision(current_->revision);
+
+    result.edl_id = edl.id();
+    result.revision = current_->revision;
+    result.track_count = current_->track_count;
+    result.clip_count = current_->clip_count;
+    result.dirty_track_ids.clear();
+    for (const auto& trackId : state.touchedTrackIds) {
+        if (state.removedTrackIds.count(trackId) == 0) {
+            result.dirty_track_ids.push_back(trackId);
+        }
+    }
+
+    recompileAfterPatch(*current_, result.dirty_track_ids);
+    return true;
+}
+
 std::optional<EdlStore::Snapshot> EdlStore::get() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return current_;
 }
 
+std::shared_ptr<const CompiledEdl> EdlStore::getCompiled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_ ? current_->compiled : nullptr;
+}
+
 bool EdlStore::hasEdl() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return current_.has_value();
 }
 
+bool EdlStore::visit(const std::function<void(const Snapshot&)>& fn) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_) {
+        return false;
+    }
+
+    fn(*current_);
+    return true;
+}
+
 bool EdlStore::validateEdl(const audio_engine::Edl& edl, std::string& error) {
     // Check EDL ID
     if (edl.id().empty()) {
@@ -86,46 +226,53 @@ bool EdlStore::validateMedia(const audio_engine::Edl& edl, std::string& error) {
     }
 
     for (const auto& media : edl.media()) {
-        if (media.id().empty()) {
-            error = "Media ID cannot be empty";
+        if (!validateMediaRef(media, error)) {
             return false;
         }
+    }
 
-        if (media.path().empty()) {
-            error = "Media path cannot be empty for media ID: " + media.id();
-            return false;
-        }
+    return true;
+}
 
-        // Check if file exists
-        juce::File file(media.path());
-        if (!file.existsAsFile()) {
-            error = "Media file not found: " + media.path();
-            return false;
-        }
+bool EdlStore::validateMediaRef(const audio_engine::AudioRef& media, std::string& error) {
+    if (media.id().empty()) {
+        error = "Media ID cannot be empty";
+        return false;
+    }
 
-        // Validate audio format and get properties
-        std::unique_ptr<juce::AudioFormatReader> reader(formatManager_.createReaderFor(file));
-        if (!reader) {
-            error = "Unsupported or unreadable audio file: " + media.path();
-            return false;
-        }
+    if (media.path().empty()) {
+        error = "Media path cannot be empty for media ID: " + media.id();
+        return false;
+    }
 
-        // Check sample rate consistency
-        int32_t fileSampleRate = static_cast<int32_t>(reader->sampleRate);
-        if (media.sample_rate() != 0 && media.sample_rate() != fileSampleRate) {
-            error = "Media sample rate mismatch for " + media.id() +
-                   ": specified " + std::to_string(media.sample_rate()) +
-                   " but file is " + std::to_string(fileSampleRate);
-            return false;
-        }
+    // Check if file exists
+    juce::File file(media.path());
+    if (!file.existsAsFile()) {
+        error = "Media file not found: " + media.path();
+        return false;
+    }
 
-        // All media must match EDL sample rate
-        if (fileSampleRate != edl.sample_rate()) {
-            error = "Media sample rate mismatch for " + media.id() +
-                   ": file is " + std::to_string(fileSampleRate) +
-                   " but EDL requires " + std::to_string(edl.sample_rate());
-            return false;
-        }
+    // Validate audio format and get properties
+    MediaInfoCache::Info info;
+    if (!MediaInfoCache::getInstance().probe(file, info)) {
+        error = "Unsupported or unreadable audio file: " + media.path();
+        return false;
+    }
+    probedMedia_[media.path()] = info;
+
+    // Check sample rate consistency
+    int32_t fileSampleRate = static_cast<int32_t>(info.sampleRate);
+    if (media.sample_rate() != 0 && media.sample_rate() != fileSampleRate) {
+        error = "Media sample rate mismatch for " + media.id() +
+               ": specified " + std::to_string(media.sample_rate()) +
+               " but file is " + std::to_string(fileSampleRate);
+        return false;
+    }
+
+    // Media at other rates is resampled to the EDL rate while rendering
+    if (fileSampleRate <= 0) {
+        error = "Media has no sample rate: " + media.path();
+        return false;
     }
 
     return true;
@@ -154,6 +301,11 @@ bool EdlStore::validateTracks(const audio_engine::Edl& edl, std::string& error)
 }
 
 bool EdlStore::validateClip(const audio_engine::Clip& clip, const audio_engine::Edl& edl, std::string& error) {
+    return validateClip(clip, findMediaById(edl, clip.media_id()), edl.sample_rate(), error);
+}
+
+bool EdlStore::validateClip(const audio_engine::Clip& clip, const audio_engine::AudioRef* media,
+                            int32_t edlSampleRate, std::string& error) {
     if (clip.id().empty()) {
         error = "Clip ID cannot be empty";
         return false;
@@ -164,8 +316,7 @@ bool EdlStore::validateClip(const audio_engine::Clip& clip, const audio_engine::
         return false;
     }
 
-    // Find the referenced media
-    const audio_engine::AudioRef* media = findMediaById(edl, clip.media_id());
+    // Check the referenced media
     if (!media) {
         error = "Media not found for clip " + clip.id() + ": " + clip.media_id();
         return false;
@@ -187,9 +338,17 @@ bool EdlStore::validateClip(const audio_engine::Clip& clip, const audio_engine::
         return false;
     }
 
-    // Check bounds against media length
-    juce::int64 mediaLength = getMediaLengthInSamples(*media);
-    if (clip.start_in_media() + clip.duration() > mediaLength) {
+    // Check bounds against media length. start_in_media counts media samples and duration
+    // counts timeline samples, so convert the duration when the media is resampled
+    const MediaInfoCache::Info mediaInfo = probeMedia(*media);
+    const juce::int64 mediaLength = mediaInfo.lengthInSamples;
+    const auto mediaSampleRate = static_cast<juce::int64>(mediaInfo.sampleRate);
+    juce::int64 mediaDuration = clip.duration();
+    if (mediaSampleRate > 0 && edlSampleRate > 0 && mediaSampleRate != edlSampleRate) {
+        mediaDuration = (clip.duration() * mediaSampleRate + edlSampleRate - 1) / edlSampleRate;
+    }
+
+    if (clip.start_in_media() + mediaDuration > mediaLength) {
         error = "Clip extends beyond media end for clip " + clip.id() +
                ": start=" + std::to_string(clip.start_in_media()) +
                " duration=" + std::to_string(clip.duration()) +
@@ -225,34 +384,318 @@ bool EdlStore::validateFade(const audio_engine::Fade& fade, const std::string& f
     return true;
 }
 
+bool EdlStore::applyEdit(const audio_engine::Edl& edl, const audio_engine::EdlEdit& edit,
+                         PatchState& state, std::string& error) {
+    switch (edit.op_case()) {
+        case audio_engine::EdlEdit::kAddClip:
+        case audio_engine::EdlEdit::kModifyClip: {
+            const bool isAdd = edit.op_case() == audio_engine::EdlEdit::kAddClip;
+            const audio_engine::Clip& clip = isAdd ? edit.add_clip() : edit.modify_clip();
+
+            audio_engine::Track* track = stageTrack(edl, edit.track_id(), state, error);
+            if (!track) {
+                return false;
+            }
+
+            if (!validateClip(clip, findStagedMedia(edl, state, clip.media_id()), edl.sample_rate(), error)) {
+                return false;
+            }
+
+            int index = -1;
+            for (int i = 0; i < track->clips_size(); ++i) {
+                if (track->clips(i).id() == clip.id()) {
+                    index = i;
+                    break;
+                }
+            }
+
+            if (isAdd) {
+                if (index >= 0) {
+                    error = "Clip already exists on track " + edit.track_id() + ": " + clip.id();
+                    return false;
+                }
+                *track->add_clips() = clip;
+            } else {
+                if (index < 0) {
+                    error = "Clip not found on track " + edit.track_id() + ": " + clip.id();
+                    return false;
+                }
+                *track->mutable_clips(index) = clip;
+            }
+            return true;
+        }
+
+        case audio_engine::EdlEdit::kRemoveClipId: {
+            audio_engine::Track* track = stageTrack(edl, edit.track_id(), state, error);
+            if (!track) {
+                return false;
+            }
+
+            for (int i = 0; i < track->clips_size(); ++i) {
+                if (track->clips(i).id() == edit.remove_clip_id()) {
+                    track->mutable_clips()->DeleteSubrange(i, 1);
+                    return true;
+                }
+            }
+
+            error = "Clip not found on track " + edit.track_id() + ": " + edit.remove_clip_id();
+            return false;
+        }
+
+        case audio_engine::EdlEdit::kAddTrack: {
+            const audio_engine::Track& track = edit.add_track();
+            if (track.id().empty()) {
+                error = "Track ID cannot be empty";
+                return false;
+            }
+
+            bool existing = findTrackById(edl, track.id()) != nullptr || state.addedTrackIds.count(track.id()) > 0;
+            if (existing || state.removedTrackIds.count(track.id()) > 0) {
+                error = "Track already exists: " + track.id();
+                return false;
+            }
+
+            for (const auto& clip : track.clips()) {
+                if (!validateClip(clip, findStagedMedia(edl, state, clip.media_id()), edl.sample_rate(), error)) {
+                    return false;
+                }
+            }
+
+            state.stagedTracks[track.id()] = track;
+            state.touchedTrackIds.push_back(track.id());
+            state.addedTrackIds.insert(track.id());
+            return true;
+        }
+
+        case audio_engine::EdlEdit::kModifyTrack: {
+            audio_engine::Track* track = stageTrack(edl, edit.track_id(), state, error);
+            if (!track) {
+                return false;
+            }
+
+            track->set_gain_db(edit.modify_track().gain_db());
+            track->set_muted(edit.modify_track().muted());
+            return true;
+        }
+
+        case audio_engine::EdlEdit::kRemoveTrack: {
+            const std::string& trackId = edit.track_id();
+            if (state.addedTrackIds.erase(trackId) > 0) {
+                state.stagedTracks.erase(trackId);
+                state.touchedTrackIds.erase(std::find(state.touchedTrackIds.begin(),
+                                                      state.touchedTrackIds.end(), trackId));
+                return true;
+            }
+
+            if (state.removedTrackIds.count(trackId) > 0 || !findTrackById(edl, trackId)) {
+                error = "Track not found: " + trackId;
+                return false;
+            }
+
+            state.stagedTracks.erase(trackId);
+            state.removedTrackIds.insert(trackId);
+            return true;
+        }
+
+        case audio_engine::EdlEdit::kAddMedia: {
+            const audio_engine::AudioRef& media = edit.add_media();
+            if (!media.id().empty() && findStagedMedia(edl, state, media.id())) {
+                error = "Media already exists: " + media.id();
+                return false;
+            }
+
+            if (!validateMediaRef(media, error)) {
+                return false;
+            }
+
+            state.addedMedia.push_back(media);
+            return true;
+        }
+
+        case audio_engine::EdlEdit::OP_NOT_SET:
+            break;
+    }
+
+    error = "Edit has no operation";
+    return false;
+}
+
+audio_engine::Track* EdlStore::stageTrack(const audio_engine::Edl& edl, const std::string& trackId,
+                                          PatchState& state, std::string& error) {
+    auto it = state.stagedTracks.find(trackId);
+    if (it != state.stagedTracks.end()) {
+        return &it->second;
+    }
+
+    const audio_engine::Track* track = state.removedTrackIds.count(trackId) == 0 ? findTrackById(edl, trackId) : nullptr;
+    if (!track) {
+        error = "Track not found: " + trackId;
+        return nullptr;
+    }
+
+    // Copy on first touch; untouched tracks are never copied
+    state.touchedTrackIds.push_back(trackId);
+    return &(state.stagedTracks[trackId] = *track);
+}
+
+const audio_engine::Track* EdlStore::findTrackById(const audio_engine::Edl& edl, const std::string& trackId) {
+    for (const auto& track : edl.tracks()) {
+        if (track.id() == trackId) {
+            return &track;
+        }
+    }
+    return nullptr;
+}
+
+const audio_engine::AudioRef* EdlStore::findStagedMedia(const audio_engine::Edl& edl, const PatchState& state,
+                                                        const std::string& mediaId) {
+    if (const auto* media = findMediaById(edl, mediaId)) {
+        return media;
+    }
+
+    for (const auto& media : state.addedMedia) {
+        if (media.id() == mediaId) {
+            return &media;
+        }
+    }
+    return nullptr;
+}
+
+void EdlStore::commitPatch(audio_engine::Edl& edl, PatchState& state, int& clipCount) {
+    for (auto& media : state.addedMedia) {
+        edl.add_media()->Swap(&media);
+    }
+
+    // Swap staged copies into place and drop removed tracks, keeping track order
+    auto* tracks = edl.mutable_tracks();
+    for (int i = tracks->size() - 1; i >= 0; --i) {
+        audio_engine::Track* track = tracks->Mutable(i);
+
+        if (state.removedTrackIds.count(track->id()) > 0) {
+            clipCount -= track->clips_size();
+            tracks->DeleteSubrange(i, 1);
+            continue;
+        }
+
+        auto staged = state.stagedTracks.find(track->id());
+        if (staged != state.stagedTracks.end()) {
+            clipCount += staged->second.clips_size() - track->clips_size();
+            track->Swap(&staged->second);
+            state.stagedTracks.erase(staged);
+        }
+    }
+
+    for (const auto& trackId : state.touchedTrackIds) {
+        if (state.addedTrackIds.count(trackId) > 0) {
+            auto& staged = state.stagedTracks[trackId];
+            clipCount += staged.clips_size();
+            edl.add_tracks()->Swap(&staged);
+        }
+    }
+}
+
+void EdlStore::recompileAfterPatch(Snapshot& snapshot, const std::vector<std::string>& dirtyTrackIds) {
+    // Rebuild only the dirty tracks; the rest are shared with the previous revision
+    Telemetry::ScopedTimer timer(Telemetry::Stage::Compile);
+    auto compiled = std::make_shared<CompiledEdl>();
+    EdlCompiler compiler;
+    std::string error;
+
+    bool success = snapshot.compiled
+        ? compiler.compileIncremental(snapshot, *snapshot.compiled, dirtyTrackIds, *compiled, error)
+        : compiler.compile(snapshot, *compiled, error);
+
+    if (success) {
+        snapshot.compiled = std::move(compiled);
+    } else {
+        // Validated edits always compile; renders report the missing timeline
+        std::cerr << "[EDL][Compile] Failed after patch: " << error << std::endl;
+        snapshot.compiled.reset();
+    }
+}
+
 std::string EdlStore::calculateRevision(const audio_engine::Edl& edl) {
-    // Convert to JSON for stable hashing
-    std::string jsonString;
-    auto status = google::protobuf::util::MessageToJsonString(edl, &jsonString);
-    (void)status; // Suppress unused variable warning
+    return combineRevision(digestEdl(edl));
+}
+
+EdlStore::RevisionDigests EdlStore::digestEdl(const audio_engine::Edl& edl) {
+    RevisionDigests digests;
+    std::string scratch;
+
+    digests.header = digestHeader(edl, scratch);
+
+    digests.media.reserve(static_cast<size_t>(edl.media_size()));
+    for (const auto& media : edl.media()) {
+        digests.media.push_back(digestMessage(media, scratch));
+    }
 
-    std::string hash = calculateSHA256(jsonString);
-    return hash.substr(0, 12); // First 12 characters
+    digests.tracks.reserve(static_cast<size_t>(edl.tracks_size()));
+    for (const auto& track : edl.tracks()) {
+        digests.tracks.push_back(digestMessage(track, scratch));
+    }
+
+    return digests;
 }
 
-std::string EdlStore::calculateSHA256(const std::string& data) {
-    unsigned char hash[32]; // SHA256 produces 32 bytes
-    unsigned int hashLen = 0;
+EdlStore::Digest EdlStore::digestHeader(const audio_engine::Edl& edl, std::string& scratch) {
+    // Every Edl field except revision, media and tracks; a new top-level field must be added here
+    audio_engine::Edl header;
+    header.set_id(edl.id());
+    header.set_sample_rate(edl.sample_rate());
+    return digestMessage(header, scratch);
+}
 
+EdlStore::Digest EdlStore::digestMessage(const google::protobuf::MessageLite& message, std::string& scratch) {
+    // The wire encoding of set fields is fixed by the protobuf spec, so these bytes are the same on every run
+    scratch.clear();
+    {
+        google::protobuf::io::StringOutputStream stream(&scratch);
+        google::protobuf::io::CodedOutputStream coded(&stream);
+        coded.SetSerializationDeterministic(true);
+        message.SerializeToCodedStream(&coded);
+    }
+
+    Digest digest{};
+    EVP_Digest(scratch.data(), scratch.size(), digest.data(), nullptr, EVP_sha256(), nullptr);
+    return digest;
+}
+
+std::string EdlStore::combineRevision(const RevisionDigests& digests) {
     EVP_MD_CTX* ctx = EVP_MD_CTX_new();
     if (!ctx) return "";
 
-    if (EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr) != 1 ||
-        EVP_DigestUpdate(ctx, data.c_str(), data.size()) != 1 ||
-        EVP_DigestFinal_ex(ctx, hash, &hashLen) != 1) {
-        EVP_MD_CTX_free(ctx);
-        return "";
+    // Counts keep a digest from being read as part of the other list
+    auto addCount = [ctx](size_t count) {
+        const uint64_t value = count;
+        unsigned char bytes[8];
+        for (int i = 0; i < 8; ++i) {
+            bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+        }
+        EVP_DigestUpdate(ctx, bytes, sizeof(bytes));
+    };
+
+    EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr);
+    EVP_DigestUpdate(ctx, revisionFormat, std::strlen(revisionFormat) + 1);
+    EVP_DigestUpdate(ctx, digests.header.data(), digests.header.size());
+
+    addCount(digests.media.size());
+    for (const auto& digest : digests.media) {
+        EVP_DigestUpdate(ctx, digest.data(), digest.size());
     }
 
+    addCount(digests.tracks.size());
+    for (const auto& digest : digests.tracks) {
+        EVP_DigestUpdate(ctx, digest.data(), digest.size());
+    }
+
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int hashLen = 0;
+    const bool finished = EVP_DigestFinal_ex(ctx, hash, &hashLen) == 1;
     EVP_MD_CTX_free(ctx);
+    if (!finished) return "";
 
     std::stringstream ss;
-    for (unsigned int i = 0; i < hashLen; ++i) {
+    for (unsigned int i = 0; i < 6; ++i) { // First 12 hex characters
         ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
     }
     return ss.str();
@@ -267,13 +710,18 @@ const audio_engine::AudioRef* EdlStore::findMediaById(const audio_engine::Edl& e
     return nullptr;
 }
 
-juce::int64 EdlStore::getMediaLengthInSamples(const audio_engine::AudioRef& media) {
-    juce::File file(media.path());
-    std::unique_ptr<juce::AudioFormatReader> reader(formatManager_.createReaderFor(file));
-    if (!reader) {
-        return 0;
+MediaInfoCache::Info EdlStore::probeMedia(const audio_engine::AudioRef& media) {
+    auto it = probedMedia_.find(media.path());
+    if (it != probedMedia_.end()) {
+        return it->second;
+    }
+
+    MediaInfoCache::Info info;
+    if (!MediaInfoCache::getInstance().probe(juce::File(media.path()), info)) {
+        info = MediaInfoCache::Info();
     }
-    return reader->lengthInSamples;
+    probedMedia_.emplace(media.path(), info);
+    return info;
 }
 
 void EdlStore::countTracksAndClips(const audio_engine::Edl& edl, int& trackCount, int& clipCount) {
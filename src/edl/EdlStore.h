@@ -1,10 +1,16 @@
 #pragma once
 
+#include <array>
+#include <functional>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "audio_engine.pb.h"
+#include "CompiledEdl.h"
+#include "util/MediaInfoCache.h"
 #include <juce_core/juce_core.h>
 #include <juce_audio_formats/juce_audio_formats.h>
 
@@ -15,6 +21,9 @@ namespace juceaudioservice {
  *
  * Manages the current active EDL, validates incoming EDL data,
  * and provides atomic read/write operations for concurrent access.
+ *
+ * Each applied revision is compiled once, when it is applied, and the
+ * immutable result is shared by every render of that revision.
  */
 class EdlStore {
 public:
@@ -23,6 +32,17 @@ public:
         std::string revision;
         int track_count;
         int clip_count;
+        std::shared_ptr<const CompiledEdl> compiled; // timeline of this revision
+    };
+
+    struct PatchResult {
+        std::string edl_id;
+        std::string revision;
+        std::string base_revision;              // revision the edits were applied to
+        int track_count = 0;
+        int clip_count = 0;
+        std::vector<std::string> dirty_track_ids; // added or modified tracks, in edit order
+        bool stale_base = false;                  // rejected because base_revision was not current
     };
 
     EdlStore();
@@ -38,6 +58,26 @@ public:
      */
     bool replace(const audio_engine::Edl& edl, Snapshot& out_snapshot, std::string& error);
 
+    /**
+     * Apply a list of edits to the current EDL.
+     *
+     * Only the edited clips, tracks and media are validated, and only the
+     * touched tracks are copied, so an edit costs O(clips on the touched
+     * tracks) rather than O(EDL). Edits are applied in order and all or
+     * nothing: if any edit fails, the stored EDL is unchanged.
+     *
+     * The new revision is the content hash, recomputed from the per-track
+     * digests carried over from the previous revision plus those of the
+     * touched tracks. It equals the revision UpdateEdl would assign to the
+     * same content, whatever edits led to it.
+     *
+     * @param request The edits and the EDL/revision they apply to
+     * @param result Output parameter for the new revision and dirty tracks
+     * @param error Output parameter for validation error message
+     * @return true if all edits were applied
+     */
+    bool patch(const audio_engine::PatchEdlRequest& request, PatchResult& result, std::string& error);
+
     /**
      * Get the current EDL snapshot.
      *
@@ -45,6 +85,16 @@ public:
      */
     std::optional<Snapshot> get() const;
 
+    /**
+     * Get the compiled timeline of the current revision.
+     *
+     * The result is immutable and refcounted, so it stays valid for as
+     * long as the caller holds it, even if the EDL is replaced or patched.
+     *
+     * @return Compiled EDL, or nullptr if none is loaded
+     */
+    std::shared_ptr<const CompiledEdl> getCompiled() const;
+
     /**
      * Check if an EDL is currently loaded.
      *
@@ -52,24 +102,85 @@ public:
      */
     bool hasEdl() const;
 
+    /**
+     * Call a function with the current snapshot, without copying it.
+     *
+     * The store lock is held while fn runs, so fn must not call back
+     * into the store.
+     *
+     * @return false if no EDL is loaded (fn is not called)
+     */
+    bool visit(const std::function<void(const Snapshot&)>& fn) const;
+
+    /**
+     * Content revision of an EDL.
+     *
+     * Hashes the deterministic protobuf encoding of the header, each media
+     * reference and each track, then hashes those digests in EDL order.
+     * The result depends only on content (not on the revision field), is
+     * the same on every run, and matches what replace() and patch() assign.
+     *
+     * @param edl The EDL to hash
+     * @return 12 lowercase hex characters
+     */
+    static std::string calculateRevision(const audio_engine::Edl& edl);
+
 private:
+    using Digest = std::array<unsigned char, 32>;
+
+    // Hashes a revision is made of, kept so a patch rehashes only what it changed
+    struct RevisionDigests {
+        Digest header{};
+        std::vector<Digest> media;  // in EDL order
+        std::vector<Digest> tracks; // in EDL order
+    };
+
+    // Edits staged by patch(); the stored EDL is only touched once all edits validate
+    struct PatchState {
+        std::unordered_map<std::string, audio_engine::Track> stagedTracks; // touched or added tracks
+        std::vector<std::string> touchedTrackIds;                          // in first-touch order
+        std::unordered_set<std::string> addedTrackIds;
+        std::unordered_set<std::string> removedTrackIds;
+        std::vector<audio_engine::AudioRef> addedMedia;
+    };
+
     mutable std::mutex mutex_;
     std::optional<Snapshot> current_;
-    juce::AudioFormatManager formatManager_;
+    RevisionDigests digests_; // of current_
+
+    // Media probed during the current replace/patch, by path, so each
+    // file is looked up once per validation however many clips use it
+    std::unordered_map<std::string, MediaInfoCache::Info> probedMedia_;
 
     // Validation methods
     bool validateEdl(const audio_engine::Edl& edl, std::string& error);
     bool validateSampleRate(int32_t sampleRate, std::string& error);
     bool validateMedia(const audio_engine::Edl& edl, std::string& error);
     bool validateTracks(const audio_engine::Edl& edl, std::string& error);
+    bool validateMediaRef(const audio_engine::AudioRef& media, std::string& error);
     bool validateClip(const audio_engine::Clip& clip, const audio_engine::Edl& edl, std::string& error);
+    bool validateClip(const audio_engine::Clip& clip, const audio_engine::AudioRef* media,
+                      int32_t edlSampleRate, std::string& error);
     bool validateFade(const audio_engine::Fade& fade, const std::string& fadeType, std::string& error);
 
+    // Patch helpers
+    bool applyEdit(const audio_engine::Edl& edl, const audio_engine::EdlEdit& edit,
+                   PatchState& state, std::string& error);
+    audio_engine::Track* stageTrack(const audio_engine::Edl& edl, const std::string& trackId,
+                                    PatchState& state, std::string& error);
+    const audio_engine::Track* findTrackById(const audio_engine::Edl& edl, const std::string& trackId);
+    const audio_engine::AudioRef* findStagedMedia(const audio_engine::Edl& edl, const PatchState& state,
+                                                  const std::string& mediaId);
+    void commitPatch(audio_engine::Edl& edl, PatchState& state, int& clipCount);
+    void recompileAfterPatch(Snapshot& snapshot, const std::vector<std::string>& dirtyTrackIds);
+
     // Helper methods
-    std::string calculateRevision(const audio_engine::Edl& edl);
-    std::string calculateSHA256(const std::string& data);
+    static RevisionDigests digestEdl(const audio_engine::Edl& edl);
+    static Digest digestHeader(const audio_engine::Edl& edl, std::string& scratch);
+    static Digest digestMessage(const google::protobuf::MessageLite& message, std::string& scratch);
+    static std::string combineRevision(const RevisionDigests& digests);
     const audio_engine::AudioRef* findMediaById(const audio_engine::Edl& edl, const std::string& mediaId);
-    juce::int64 getMediaLengthInSamples(const audio_engine::AudioRef& media);
+    MediaInfoCache::Info probeMedia(const audio_engine::AudioRef& media);
     void countTracksAndClips(const audio_engine::Edl& edl, int& trackCount, int& clipCount);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EdlStore)
@@ -0,0 +1,397 @@
+#include "MediaPageCache.h"
+#include "util/MediaInfoCache.h"
+#include "util/MediaReader.h"
+#include <algorithm>
+#include <optional>
+
+namespace juceaudioservice {
+
+MediaPageCache& MediaPageCache::getInstance() {
+    static MediaPageCache instance;
+    return instance;
+}
+
+MediaPageCache::MediaPageCache(size_t byteBudget)
+    : byteBudget_(byteBudget) {
+    formatManager_.registerBasicFormats();
+}
+
+void MediaPageCache::setByteBudget(size_t byteBudget) {
+    byteBudget_ = byteBudget;
+
+    const size_t shardBudget = byteBudget / numShards;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        evictLocked(shard, shardBudget);
+    }
+}
+
+MediaPageCache::MediaHandle MediaPageCache::openMedia(const std::string& path) {
+    const juce::File file(path);
+    MediaInfoCache::Info probed;
+    if (!MediaInfoCache::getInstance().probe(file, probed)) {
+        return invalidHandle;
+    }
+
+    auto isCurrent = [&probed](const Media& media) {
+        return media.modificationTime == probed.modificationTime && media.fileSize == probed.fileSize;
+    };
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mediaMutex_);
+        auto it = mediaByPath_.find(path);
+        if (it != mediaByPath_.end()) {
+            Media& media = *media_.at(it->second);
+            if (isCurrent(media)) {
+                ++media.refCount;
+                return it->second;
+            }
+        }
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    {
+        std::lock_guard<std::mutex> lock(formatManagerMutex_);
+        reader = createMediaReader(formatManager_, file);
+    }
+
+    if (!reader) {
+        return invalidHandle;
+    }
+
+    MediaHandle superseded = invalidHandle;
+    MediaHandle handle = invalidHandle;
+    {
+        std::unique_lock<std::shared_mutex> lock(mediaMutex_);
+        auto it = mediaByPath_.find(path);
+        if (it != mediaByPath_.end()) {
+            Media& media = *media_.at(it->second);
+            if (isCurrent(media)) {
+                ++media.refCount; // Opened by another thread meanwhile
+                return it->second;
+            }
+            superseded = it->second;
+        }
+
+        auto media = std::make_shared<Media>();
+        media->path = path;
+        media->info.numChannels = static_cast<int>(reader->numChannels);
+        media->info.lengthInSamples = reader->lengthInSamples;
+        media->info.sampleRate = reader->sampleRate;
+        media->modificationTime = probed.modificationTime;
+        media->fileSize = probed.fileSize;
+        media->mapped = dynamic_cast<juce::MemoryMappedAudioFormatReader*>(reader.get()) != nullptr;
+        media->reader = std::move(reader);
+        media->refCount = 1;
+
+        handle = nextHandle_++;
+        media_.emplace(handle, std::move(media));
+        mediaByPath_[path] = handle;
+
+        // Changed on disk: the old version goes as soon as no render holds it
+        if (superseded != invalidHandle && media_.at(superseded)->refCount.load() == 0) {
+            closeMediaLocked(superseded);
+        } else {
+            superseded = invalidHandle;
+        }
+    }
+
+    if (superseded != invalidHandle) {
+        dropPages(superseded);
+    }
+    return handle;
+}
+
+void MediaPageCache::releaseMedia(MediaHandle handle) {
+    if (handle == invalidHandle) {
+        return;
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> lock(mediaMutex_);
+        auto it = media_.find(handle);
+        if (it == media_.end()) {
+            return;
+        }
+
+        Media& media = *it->second;
+        jassert(media.refCount.load() > 0);
+        if (--media.refCount > 0 || mediaByPath_.at(media.path) == handle) {
+            return;
+        }
+        closeMediaLocked(handle);
+    }
+
+    dropPages(handle);
+}
+
+bool MediaPageCache::getMediaInfo(MediaHandle handle, MediaInfo& info) const {
+    MediaPtr media = getMedia(handle);
+    if (!media) {
+        return false;
+    }
+
+    info = media->info;
+    return true;
+}
+
+bool MediaPageCache::read(MediaHandle handle, juce::AudioBuffer<float>& dest, int destStartSample,
+                          int numSamples, juce::int64 sourceStartSample) {
+    MediaPtr media = getMedia(handle);
+    if (!media) {
+        return false;
+    }
+
+    const int destChannels = dest.getNumChannels();
+    const int sourceChannels = media->info.numChannels;
+    const juce::int64 length = media->info.lengthInSamples;
+
+    auto clearRange = [&dest, destChannels](int start, int count) {
+        for (int ch = 0; ch < destChannels; ++ch) {
+            juce::FloatVectorOperations::clear(dest.getWritePointer(ch, start), count);
+        }
+    };
+
+    int done = 0;
+    while (done < numSamples) {
+        const juce::int64 position = sourceStartSample + done;
+        const int remaining = numSamples - done;
+
+        if (position < 0) {
+            int count = static_cast<int>(std::min<juce::int64>(remaining, -position));
+            clearRange(destStartSample + done, count);
+            done += count;
+            continue;
+        }
+
+        if (position >= length || sourceChannels <= 0) {
+            clearRange(destStartSample + done, remaining);
+            break;
+        }
+
+        const juce::int64 pageIndex = position / pageSize;
+        const int offsetInPage = static_cast<int>(position % pageSize);
+        const int count = std::min(remaining, pageSize - offsetInPage);
+
+        PagePtr page = getPage(*media, handle, pageIndex, false);
+
+        // Pages are zero past the end of the media, like the reader itself
+        for (int ch = 0; ch < destChannels; ++ch) {
+            const int sourceChannel = std::min(ch, sourceChannels - 1);
+            juce::FloatVectorOperations::copy(dest.getWritePointer(ch, destStartSample + done),
+                                              page->getChannel(sourceChannel) + offsetInPage, count);
+        }
+
+        done += count;
+    }
+
+    return true;
+}
+
+void MediaPageCache::prefetchPage(MediaHandle handle, juce::int64 pageIndex) {
+    MediaPtr media = getMedia(handle);
+    if (!media || media->info.numChannels <= 0 || pageIndex < 0 ||
+        pageIndex * pageSize >= media->info.lengthInSamples) {
+        return;
+    }
+
+    getPage(*media, handle, pageIndex, true);
+}
+
+MediaPageCache::Stats MediaPageCache::getStats() const {
+    Stats stats;
+    stats.hits = hits_.load();
+    stats.misses = misses_.load();
+    stats.prefetched = prefetched_.load();
+    stats.evictions = evictions_.load();
+    stats.byteBudget = byteBudget_.load();
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mediaMutex_);
+        stats.numMedia = media_.size();
+    }
+
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.bytesUsed += shard.bytesUsed;
+    }
+
+    return stats;
+}
+
+std::vector<MediaPageCache::MediaUsage> MediaPageCache::getMediaUsage() const {
+    std::shared_lock<std::shared_mutex> lock(mediaMutex_);
+
+    std::vector<MediaUsage> usage;
+    std::unordered_map<std::string, size_t> byPath;
+    auto add = [&usage, &byPath](const std::string& path, uint64_t bytesRead, uint64_t pagesDecoded) {
+        auto [it, inserted] = byPath.emplace(path, usage.size());
+        if (inserted) {
+            usage.push_back({path, 0, 0});
+        }
+        usage[it->second].bytesRead += bytesRead;
+        usage[it->second].pagesDecoded += pagesDecoded;
+    };
+
+    // Closed versions still count, so the totals never go backwards
+    for (const auto& [path, closed] : closedUsage_) {
+        add(path, closed.bytesRead, closed.pagesDecoded);
+    }
+    for (const auto& [handle, media] : media_) {
+        add(media->path, media->bytesRead.load(), media->pagesDecoded.load());
+    }
+    return usage;
+}
+
+void MediaPageCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.lru.clear();
+        shard.bytesUsed = 0;
+    }
+}
+
+MediaPageCache::MediaPtr MediaPageCache::getMedia(MediaHandle handle) const {
+    std::shared_lock<std::shared_mutex> lock(mediaMutex_);
+    auto it = media_.find(handle);
+    return it != media_.end() ? it->second : nullptr;
+}
+
+void MediaPageCache::closeMediaLocked(MediaHandle handle) {
+    auto it = media_.find(handle);
+    const Media& media = *it->second;
+
+    auto& closed = closedUsage_[media.path];
+    closed.path = media.path;
+    closed.bytesRead += media.bytesRead.load();
+    closed.pagesDecoded += media.pagesDecoded.load();
+
+    // A read still holding the entry keeps the reader until it returns
+    media_.erase(it);
+}
+
+void MediaPageCache::dropPages(MediaHandle handle) {
+    // Handles are never reused, so these pages could only age out of the LRU
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+            if (static_cast<MediaHandle>((*it)->key >> 40) == handle) {
+                shard.bytesUsed -= (*it)->getSizeInBytes();
+                shard.index.erase((*it)->key);
+                it = shard.lru.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+MediaPageCache::PagePtr MediaPageCache::getPage(Media& media, MediaHandle handle, juce::int64 pageIndex,
+                                                bool prefetching) {
+    const uint64_t key = makeKey(handle, pageIndex);
+    Shard& shard = getShard(key);
+
+    std::optional<std::promise<PagePtr>> decoded; // only created on a miss: a promise allocates
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            if (!prefetching) {
+                ++hits_;
+            }
+            return *it->second;
+        }
+
+        auto pendingIt = shard.pending.find(key);
+        if (pendingIt != shard.pending.end()) {
+            if (prefetching) {
+                return nullptr;
+            }
+
+            // Another thread (usually the prefetcher) is decoding it: wait rather than read it twice
+            auto inFlight = pendingIt->second;
+            lock.unlock();
+            ++hits_;
+            return inFlight.get();
+        }
+
+        decoded.emplace();
+        shard.pending.emplace(key, decoded->get_future().share());
+    }
+
+    ++(prefetching ? prefetched_ : misses_);
+
+    // Decode without holding the shard lock so other pages stay available
+    PagePtr page;
+    try {
+        page = decodePage(media, key, pageIndex);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.pending.erase(key);
+        decoded->set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.pending.erase(key);
+        shard.lru.push_front(page);
+        shard.index.emplace(key, shard.lru.begin());
+        shard.bytesUsed += page->getSizeInBytes();
+        evictLocked(shard, byteBudget_.load() / numShards);
+    }
+
+    decoded->set_value(page);
+    return page;
+}
+
+MediaPageCache::PagePtr MediaPageCache::decodePage(Media& media, uint64_t key, juce::int64 pageIndex) {
+    auto page = std::make_shared<Page>();
+    page->key = key;
+    page->numChannels = media.info.numChannels;
+
+    const juce::int64 pageStart = pageIndex * pageSize;
+    page->numSamples = static_cast<int>(std::min<juce::int64>(pageSize, media.info.lengthInSamples - pageStart));
+    page->samples.assign(static_cast<size_t>(page->numChannels) * pageSize, 0.0f);
+
+    std::vector<float*> channels(static_cast<size_t>(page->numChannels));
+    for (int ch = 0; ch < page->numChannels; ++ch) {
+        channels[static_cast<size_t>(ch)] = page->samples.data() + static_cast<size_t>(ch) * pageSize;
+    }
+
+    juce::AudioBuffer<float> pageBuffer(channels.data(), page->numChannels, page->numSamples);
+
+    std::lock_guard<std::mutex> lock(media.readerMutex);
+
+    // Touching a mapping past the end of a file truncated since it was mapped raises SIGBUS;
+    // such a file reads as silence until openMedia() picks up the new version
+    if (media.mapped && !media.truncated && juce::File(media.path).getSize() < media.fileSize) {
+        media.truncated = true;
+    }
+    if (media.truncated) {
+        return page;
+    }
+
+    media.reader->read(&pageBuffer, 0, page->numSamples, pageStart, true, true);
+
+    const auto bytesPerFrame = static_cast<uint64_t>(media.reader->numChannels) *
+                               static_cast<uint64_t>(std::max(1u, media.reader->bitsPerSample / 8));
+    media.bytesRead += bytesPerFrame * static_cast<uint64_t>(std::max(0, page->numSamples));
+    ++media.pagesDecoded;
+
+    return page;
+}
+
+void MediaPageCache::evictLocked(Shard& shard, size_t shardBudget) {
+    while (shard.bytesUsed > shardBudget && !shard.lru.empty()) {
+        const PagePtr& victim = shard.lru.back();
+        shard.bytesUsed -= victim->getSizeInBytes();
+        shard.index.erase(victim->key);
+        shard.lru.pop_back();
+        ++evictions_;
+    }
+}
+
+} // namespace juceaudioservice
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+namespace juceaudioservice {
+
+/**
+ * Process-wide cache of decoded media, shared by all renders.
+ *
+ * Media files are decoded in fixed-size pages of float samples keyed by
+ * (media handle, page index). Pages live in sharded LRU lists under a
+ * configurable byte budget, so repeated renders over the same takes are
+ * served from RAM. All methods are thread-safe; each media reader is only
+ * ever used by one thread at a time.
+ */
+class MediaPageCache {
+public:
+    using MediaHandle = int;
+    static constexpr MediaHandle invalidHandle = -1;
+
+    static constexpr int pageSize = 16384;                        // frames per page
+    static constexpr size_t defaultByteBudget = 256 * 1024 * 1024;
+
+    struct MediaInfo {
+        int numChannels = 0;
+        juce::int64 lengthInSamples = 0;
+        double sampleRate = 0.0;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;       // reads served without decoding on the reading thread
+        uint64_t misses = 0;     // reads that had to decode the page themselves
+        uint64_t prefetched = 0; // pages decoded ahead of use by prefetchPage()
+        uint64_t evictions = 0;
+        size_t bytesUsed = 0;
+        size_t byteBudget = 0;
+        size_t numMedia = 0;     // open readers, including superseded ones still in use
+    };
+
+    /** How much of one media file has been decoded into the cache. */
+    struct MediaUsage {
+        std::string path;
+        uint64_t bytesRead = 0;    // encoded bytes decoded, estimated from the format's bit depth
+        uint64_t pagesDecoded = 0;
+    };
+
+    /** The cache shared by every renderer in the process. */
+    static MediaPageCache& getInstance();
+
+    explicit MediaPageCache(size_t byteBudget = defaultByteBudget);
+    ~MediaPageCache() = default;
+
+    /** Change the byte budget, evicting pages if the cache is over it. */
+    void setByteBudget(size_t byteBudget);
+    size_t getByteBudget() const noexcept { return byteBudget_.load(); }
+
+    /**
+     * Resolve a media file to a handle, opening a reader on first use.
+     *
+     * The file is checked against MediaInfoCache on every call; if it has
+     * changed on disk it is reopened under a new handle, so stale pages are
+     * never served. Every successful call takes a reference that
+     * releaseMedia() gives back. A superseded version is closed, and its
+     * pages dropped, once no reference to it is left; handles are never
+     * reused.
+     *
+     * @param path Media file path
+     * @return Handle for read(), or invalidHandle if the file can't be read
+     */
+    MediaHandle openMedia(const std::string& path);
+
+    /**
+     * Give back a reference taken by openMedia().
+     *
+     * Reads through a closed handle fail like reads through an invalid one.
+     *
+     * @param handle Handle returned by openMedia(); invalidHandle is ignored
+     */
+    void releaseMedia(MediaHandle handle);
+
+    /** Get the format of an opened media file. */
+    bool getMediaInfo(MediaHandle handle, MediaInfo& info) const;
+
+    /**
+     * Copy decoded samples into a buffer.
+     *
+     * Channels are mapped like AudioFormatReader::read with both reader
+     * channels enabled: extra destination channels repeat the last source
+     * channel. Samples past the end of the media are zero.
+     *
+     * @return false if the handle is invalid
+     */
+    bool read(MediaHandle handle, juce::AudioBuffer<float>& dest, int destStartSample,
+              int numSamples, juce::int64 sourceStartSample);
+
+    /**
+     * Decode a page ahead of use unless it is cached or already being decoded.
+     *
+     * Meant for a prefetch thread: a read() that needs the page meanwhile
+     * waits for this decode instead of reading the file a second time.
+     * Cached pages are marked as recently used so they survive until read.
+     *
+     * @param handle Media to read
+     * @param pageIndex Page number (source sample / pageSize)
+     */
+    void prefetchPage(MediaHandle handle, juce::int64 pageIndex);
+
+    /** Hit/miss counters and current memory use. */
+    Stats getStats() const;
+
+    /** Decode totals per media path, including files reopened after a change. */
+    std::vector<MediaUsage> getMediaUsage() const;
+
+    /** Drop all cached pages (media handles stay valid). */
+    void clear();
+
+private:
+    struct Media {
+        std::string path;
+        MediaInfo info;
+        juce::int64 modificationTime = 0;
+        juce::int64 fileSize = 0;
+        std::atomic<int> refCount{0}; // changed under a shared lock, tested under the exclusive one
+        std::mutex readerMutex;
+        std::unique_ptr<juce::AudioFormatReader> reader;
+        bool mapped = false;    // reader reads a mapping of the file, guarded by readerMutex
+        bool truncated = false; // file shrank under the mapping, guarded by readerMutex
+        std::atomic<uint64_t> bytesRead{0};
+        std::atomic<uint64_t> pagesDecoded{0};
+    };
+
+    using MediaPtr = std::shared_ptr<Media>; // held by reads, so closing never pulls a reader from under one
+
+    struct Page {
+        uint64_t key = 0;
+        int numChannels = 0;
+        int numSamples = 0;
+        std::vector<float> samples; // channel-major, pageSize per channel
+
+        const float* getChannel(int channel) const noexcept {
+            return samples.data() + static_cast<size_t>(channel) * pageSize;
+        }
+
+        size_t getSizeInBytes() const noexcept { return samples.size() * sizeof(float); }
+    };
+
+    using PagePtr = std::shared_ptr<const Page>;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<PagePtr> lru; // front = most recently used
+        std::unordered_map<uint64_t, std::list<PagePtr>::iterator> index;
+        std::unordered_map<uint64_t, std::shared_future<PagePtr>> pending; // pages being decoded
+        size_t bytesUsed = 0;
+    };
+
+    static constexpr int numShards = 16;
+
+    juce::AudioFormatManager formatManager_;
+    std::mutex formatManagerMutex_;
+
+    mutable std::shared_mutex mediaMutex_;
+    std::unordered_map<MediaHandle, MediaPtr> media_;
+    std::unordered_map<std::string, MediaHandle> mediaByPath_; // current version of each path
+    std::unordered_map<std::string, MediaUsage> closedUsage_;  // totals of closed versions
+    MediaHandle nextHandle_ = 0;
+
+    std::array<Shard, numShards> shards_;
+    std::atomic<size_t> byteBudget_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> prefetched_{0};
+    std::atomic<uint64_t> evictions_{0};
+
+    static uint64_t makeKey(MediaHandle handle, juce::int64 pageIndex) noexcept {
+        return (static_cast<uint64_t>(handle) << 40) | static_cast<uint64_t>(pageIndex);
+    }
+
+    Shard& getShard(uint64_t key) noexcept { return shards_[static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 60)]; }
+    MediaPtr getMedia(MediaHandle handle) const;
+    PagePtr getPage(Media& media, MediaHandle handle, juce::int64 pageIndex, bool prefetching);
+    PagePtr decodePage(Media& media, uint64_t key, juce::int64 pageIndex);
+    void evictLocked(Shard& shard, size_t shardBudget);
+    void closeMediaLocked(MediaHandle handle);
+    void dropPages(MediaHandle handle);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MediaPageCache)
+};
+
+} // namespace juceaudioservice
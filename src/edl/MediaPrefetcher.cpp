@@ -0,0 +1,110 @@
+#include "MediaPrefetcher.h"
+#include <algorithm>
+
+namespace juceaudioservice {
+
+MediaPrefetcher::MediaPrefetcher(MediaPageCache& cache, int maxQueuedPages)
+    : cache_(cache),
+      queue_(static_cast<size_t>(std::max(1, maxQueuedPages))) {
+}
+
+MediaPrefetcher::~MediaPrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        count_ = 0;
+    }
+    available_.notify_all();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+int MediaPrefetcher::request(MediaPageCache::MediaHandle handle, juce::int64 sourceStart, juce::int64 numSamples) {
+    if (handle == MediaPageCache::invalidHandle || numSamples <= 0) {
+        return 0;
+    }
+
+    const juce::int64 firstPage = std::max<juce::int64>(0, sourceStart) / MediaPageCache::pageSize;
+    const juce::int64 lastPage = (sourceStart + numSamples - 1) / MediaPageCache::pageSize;
+    if (lastPage < firstPage) {
+        return 0;
+    }
+
+    int dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return 0;
+        }
+
+        if (!thread_.joinable()) {
+            thread_ = std::thread([this] { ioLoop(); });
+        }
+
+        for (juce::int64 pageIndex = firstPage; pageIndex <= lastPage; ++pageIndex) {
+            const PageRequest pageRequest{ handle, pageIndex };
+            if (isQueuedLocked(pageRequest)) {
+                continue;
+            }
+
+            if (count_ == queue_.size()) {
+                ++dropped;
+                continue;
+            }
+
+            queue_[(head_ + count_) % queue_.size()] = pageRequest;
+            ++count_;
+        }
+    }
+
+    available_.notify_one();
+    return dropped;
+}
+
+void MediaPrefetcher::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    count_ = 0;
+}
+
+int MediaPrefetcher::getNumQueued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(count_);
+}
+
+bool MediaPrefetcher::isQueuedLocked(const PageRequest& request) const {
+    // Consecutive blocks mostly ask for the same pages, and those sit at the back of the queue
+    for (size_t i = count_; i > 0; --i) {
+        const auto& queued = queue_[(head_ + i - 1) % queue_.size()];
+        if (queued.handle == request.handle && queued.pageIndex == request.pageIndex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MediaPrefetcher::ioLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        available_.wait(lock, [this] { return stopping_ || count_ > 0; });
+        if (stopping_) {
+            return;
+        }
+
+        const PageRequest pageRequest = queue_[head_];
+        head_ = (head_ + 1) % queue_.size();
+        --count_;
+
+        // Decode outside the lock so the mixer can keep queueing; on failure the mixer reads it itself
+        lock.unlock();
+        try {
+            cache_.prefetchPage(pageRequest.handle, pageRequest.pageIndex);
+        } catch (...) {
+        }
+        lock.lock();
+    }
+}
+
+} // namespace juceaudioservice
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "MediaPageCache.h"
+
+namespace juceaudioservice {
+
+/**
+ * Background I/O stage that decodes media pages ahead of the mixer.
+ *
+ * The renderer queues the media ranges its next blocks will need; a
+ * dedicated thread decodes those pages into the MediaPageCache while the
+ * current block is mixed, so reads from slow storage overlap with DSP.
+ * The queue has a fixed number of slots: requests that do not fit are
+ * dropped, and the mixer simply reads those pages itself.
+ */
+class MediaPrefetcher {
+public:
+    static constexpr int defaultMaxQueuedPages = 256;
+
+    /**
+     * Create a prefetcher. The I/O thread starts with the first request.
+     *
+     * @param cache Cache to decode pages into; must outlive the prefetcher
+     * @param maxQueuedPages Number of page requests that may wait for the I/O thread
+     */
+    explicit MediaPrefetcher(MediaPageCache& cache, int maxQueuedPages = defaultMaxQueuedPages);
+
+    /** Drops queued requests and joins the I/O thread. */
+    ~MediaPrefetcher();
+
+    /**
+     * Queue the pages covering a range of a media file.
+     *
+     * Never blocks on I/O and, once the I/O thread is running, never
+     * allocates. Pages that are already queued are not queued again.
+     *
+     * @param handle Media to read
+     * @param sourceStart First source sample needed
+     * @param numSamples Number of source samples needed
+     * @return Number of pages dropped because the queue was full
+     */
+    int request(MediaPageCache::MediaHandle handle, juce::int64 sourceStart, juce::int64 numSamples);
+
+    /** Drop every queued request; a page being decoded is still finished. */
+    void cancel();
+
+    /** Number of page requests waiting for the I/O thread. */
+    int getNumQueued() const;
+
+private:
+    struct PageRequest {
+        MediaPageCache::MediaHandle handle = MediaPageCache::invalidHandle;
+        juce::int64 pageIndex = 0;
+    };
+
+    MediaPageCache& cache_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<PageRequest> queue_; // ring of fixed capacity
+    size_t head_ = 0;
+    size_t count_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    bool isQueuedLocked(const PageRequest& request) const;
+    void ioLoop();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MediaPrefetcher)
+};
+
+} // namespace juceaudioservice
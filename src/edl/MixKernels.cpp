@@ -0,0 +1,102 @@
+#include "MixKernels.h"
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace juceaudioservice {
+
+namespace {
+
+constexpr size_t numFeatureSets = MixKernels::allFeatures + 1;
+
+template <unsigned Features>
+inline float scaleSample(float sample, float clipGain, const float* fadeIn, const float* fadeOut,
+                         float trackGain, int i) noexcept {
+    // One rounding per factor, in the order of the old separate passes
+    float value = sample;
+    if constexpr ((Features & MixKernels::ClipGain) != 0) {
+        value = value * clipGain;
+    }
+    if constexpr ((Features & MixKernels::FadeIn) != 0) {
+        value = value * fadeIn[i];
+    }
+    if constexpr ((Features & MixKernels::FadeOut) != 0) {
+        value = value * fadeOut[i];
+    }
+    if constexpr ((Features & MixKernels::TrackGain) != 0) {
+        value = value * trackGain;
+    }
+    return value;
+}
+
+template <unsigned Features>
+void mixChannel(const float* source, float* dest, const MixKernels::Span& span) noexcept {
+    const float clipGain = span.clipGain;
+    const float trackGain = span.trackGain;
+    const float* fadeIn = span.fadeIn;
+    const float* fadeOut = span.fadeOut;
+
+    for (int i = 0; i < span.numSamples; ++i) {
+        // Built with -ffp-contract=off, so this add never becomes a fused multiply-add
+        const float value = scaleSample<Features>(source[i], clipGain, fadeIn, fadeOut, trackGain, i);
+        dest[i] += value;
+    }
+}
+
+// Channels is 1, 2 or 0 for any count
+template <int Channels, unsigned Features>
+void mixSpan(const MixKernels::Span& span) {
+    if constexpr (Channels == 2) {
+        // Both channels in one loop, so each fade gain is loaded once
+        const float* source0 = span.source[0] + span.sourceStart;
+        const float* source1 = span.source[1] + span.sourceStart;
+        float* dest0 = span.dest[0] + span.destStart;
+        float* dest1 = span.dest[1] + span.destStart;
+        const float clipGain = span.clipGain;
+        const float trackGain = span.trackGain;
+        const float* fadeIn = span.fadeIn;
+        const float* fadeOut = span.fadeOut;
+
+        for (int i = 0; i < span.numSamples; ++i) {
+            const float value0 = scaleSample<Features>(source0[i], clipGain, fadeIn, fadeOut, trackGain, i);
+            const float value1 = scaleSample<Features>(source1[i], clipGain, fadeIn, fadeOut, trackGain, i);
+            dest0[i] += value0;
+            dest1[i] += value1;
+        }
+    } else {
+        const int numChannels = Channels > 0 ? Channels : span.numChannels;
+        for (int ch = 0; ch < numChannels; ++ch) {
+            mixChannel<Features>(span.source[ch] + span.sourceStart, span.dest[ch] + span.destStart, span);
+        }
+    }
+}
+
+template <int Channels, unsigned... Features>
+constexpr std::array<MixKernels::Kernel, numFeatureSets> makeKernels(std::integer_sequence<unsigned, Features...>) {
+    return { { &mixSpan<Channels, Features>... } };
+}
+
+template <int Channels>
+constexpr std::array<MixKernels::Kernel, numFeatureSets> makeKernels() {
+    return makeKernels<Channels>(std::make_integer_sequence<unsigned, numFeatureSets>{});
+}
+
+constexpr std::array<MixKernels::Kernel, numFeatureSets> monoKernels = makeKernels<1>();
+constexpr std::array<MixKernels::Kernel, numFeatureSets> stereoKernels = makeKernels<2>();
+constexpr std::array<MixKernels::Kernel, numFeatureSets> anyKernels = makeKernels<0>();
+
+} // namespace
+
+MixKernels::Kernel MixKernels::select(int numChannels, unsigned features) noexcept {
+    const size_t index = features & allFeatures;
+    switch (numChannels) {
+        case 1:
+            return monoKernels[index];
+        case 2:
+            return stereoKernels[index];
+        default:
+            return anyKernels[index];
+    }
+}
+
+} // namespace juceaudioservice
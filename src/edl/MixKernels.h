@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+namespace juceaudioservice {
+
+/**
+ * Fused loops that add one clip's samples into a track bus.
+ *
+ * A kernel takes media samples that have already been read (and resampled
+ * if needed), scales them by the clip gain, the fade curves and the track
+ * gain, and adds them to the bus, all in one pass over the block. Kernels
+ * are specialised on the bus channel count (mono, stereo or any) and on
+ * which of those factors apply, so the inner loops carry no branches and
+ * vectorise.
+ *
+ * The factors are applied one at a time in the order the mixer always
+ * used (clip gain, fade in, fade out, track gain) rather than folded
+ * together, so the output is bit-identical to scaling in separate passes.
+ */
+class MixKernels {
+public:
+    // What a clip's samples are scaled by; EdlCompiler records these per clip
+    enum Feature : uint8_t {
+        ClipGain = 1 << 0,
+        FadeIn = 1 << 1,
+        FadeOut = 1 << 2,
+        TrackGain = 1 << 3,
+        allFeatures = ClipGain | FadeIn | FadeOut | TrackGain
+    };
+
+    struct Span {
+        const float* const* source = nullptr; // numChannels channels of media samples
+        int sourceStart = 0;                  // first sample of the span in source
+        float* const* dest = nullptr;         // numChannels channels of the bus
+        int destStart = 0;                    // first sample of the span in dest
+        int numChannels = 0;
+        int numSamples = 0;
+        float clipGain = 1.0f;
+        float trackGain = 1.0f;
+        const float* fadeIn = nullptr;        // numSamples gains, used with FadeIn
+        const float* fadeOut = nullptr;       // numSamples gains, used with FadeOut
+    };
+
+    using Kernel = void (*)(const Span& span);
+
+    /**
+     * Pick the kernel for a span.
+     *
+     * @param numChannels Channels of the bus
+     * @param features Feature bits that apply to the whole span
+     * @return A kernel; never null
+     */
+    static Kernel select(int numChannels, unsigned features) noexcept;
+
+    MixKernels() = delete;
+};
+
+} // namespace juceaudioservice
@@ -0,0 +1,169 @@
+#include "RenderBlockCache.h"
+#include "EdlCompiler.h"
+#include "TimelineDiff.h"
+#include "util/Telemetry.h"
+#include <algorithm>
+
+namespace juceaudioservice {
+
+RenderBlockCache::RenderBlockCache(int blockSize, size_t byteBudget)
+    : blockSize_(std::max(1, blockSize)),
+      byteBudget_(byteBudget) {
+}
+
+void RenderBlockCache::acquire(const CompiledEdl& compiledEdl, int numChannels, int64_t firstBlock,
+                               int64_t numBlocks, std::vector<BlockPtr>& blocks) {
+    blocks.assign(static_cast<size_t>(std::max<int64_t>(0, numBlocks)), nullptr);
+
+    // The files as they are now, not as they were at compile time; stat outside the lock
+    CompiledEdl current = compiledEdl;
+    EdlCompiler::identifyMedia(current.media);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& generation = switchGenerationLocked(current, numChannels);
+    generation.lastUsed = ++useCounter_;
+
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        auto it = generation.blocks.find(firstBlock + static_cast<int64_t>(i));
+        if (it != generation.blocks.end()) {
+            blocks[i] = it->second;
+            ++reused_;
+        }
+    }
+}
+
+void RenderBlockCache::store(const CompiledEdl& compiledEdl, int64_t blockIndex,
+                             const juce::AudioBuffer<float>& mix) {
+    if (mix.getNumSamples() < blockSize_) {
+        return;
+    }
+
+    // Copy outside the lock; mixes are much larger than the bookkeeping
+    auto block = std::make_shared<Block>(mix.getNumChannels(), blockSize_);
+    for (int ch = 0; ch < mix.getNumChannels(); ++ch) {
+        block->copyFrom(ch, 0, mix, ch, 0, blockSize_);
+    }
+
+    const size_t bytes = getBlockBytes(mix.getNumChannels());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++rendered_;
+
+    auto it = generations_.find(compiledEdl.edl_id);
+    if (it == generations_.end() || it->second.compiled.revision != compiledEdl.revision ||
+        it->second.numChannels != mix.getNumChannels() || it->second.blocks.count(blockIndex) != 0) {
+        return;
+    }
+
+    if (!makeRoomLocked(bytes, compiledEdl.edl_id)) {
+        return;
+    }
+
+    it->second.blocks.emplace(blockIndex, std::move(block));
+    bytesUsed_ += bytes;
+}
+
+void RenderBlockCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generations_.clear();
+    bytesUsed_ = 0;
+}
+
+RenderBlockCache::Stats RenderBlockCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Stats stats;
+    stats.reused = reused_;
+    stats.rendered = rendered_;
+    stats.invalidated = invalidated_;
+    stats.evicted = evicted_;
+    stats.bytesUsed = bytesUsed_;
+    for (const auto& [edlId, generation] : generations_) {
+        stats.numBlocks += generation.blocks.size();
+    }
+    return stats;
+}
+
+size_t RenderBlockCache::getBlockBytes(int numChannels) const noexcept {
+    return static_cast<size_t>(numChannels) * static_cast<size_t>(blockSize_) * sizeof(float);
+}
+
+bool RenderBlockCache::sameMediaVersions(const std::vector<CompiledMedia>& a, const std::vector<CompiledMedia>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const CompiledMedia& x, const CompiledMedia& y) {
+        return x.path == y.path && x.file_size == y.file_size && x.modification_time == y.modification_time;
+    });
+}
+
+RenderBlockCache::Generation& RenderBlockCache::switchGenerationLocked(const CompiledEdl& compiledEdl,
+                                                                       int numChannels) {
+    auto& generation = generations_[compiledEdl.edl_id];
+    if (generation.compiled.revision == compiledEdl.revision && generation.numChannels == numChannels &&
+        sameMediaVersions(generation.compiled.media, compiledEdl.media)) {
+        return generation;
+    }
+
+    const size_t blockBytes = getBlockBytes(generation.numChannels);
+    const size_t before = generation.blocks.size();
+
+    if (generation.numChannels != numChannels) {
+        generation.blocks.clear();
+    } else if (!generation.blocks.empty()) {
+        // Keep only the blocks no change between the two revisions reaches
+        const TimelineDiff diff = TimelineDiff::between(generation.compiled, compiledEdl);
+        if (diff.everything) {
+            generation.blocks.clear();
+        } else if (!diff.intervals.empty()) {
+            for (auto it = generation.blocks.begin(); it != generation.blocks.end();) {
+                const int64_t start = it->first * blockSize_;
+                if (diff.touches(start, start + blockSize_)) {
+                    it = generation.blocks.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    const size_t dropped = before - generation.blocks.size();
+    bytesUsed_ -= dropped * blockBytes;
+    invalidated_ += dropped;
+
+    if (before > 0) {
+        requestLog() << "[EDL][BlockCache] " << compiledEdl.edl_id << ": revision " << generation.compiled.revision
+                     << " -> " << compiledEdl.revision << ", kept " << generation.blocks.size() << " of " << before
+                     << " blocks" << std::endl;
+    }
+
+    generation.compiled = compiledEdl;
+    generation.numChannels = numChannels;
+    return generation;
+}
+
+bool RenderBlockCache::makeRoomLocked(size_t bytes, const std::string& keepEdlId) {
+    if (bytes > byteBudget_) {
+        return false;
+    }
+
+    // Whole EDLs go, least recently rendered first; the one being rendered is never evicted
+    while (bytesUsed_ + bytes > byteBudget_) {
+        auto oldest = generations_.end();
+        for (auto it = generations_.begin(); it != generations_.end(); ++it) {
+            if (it->first != keepEdlId && !it->second.blocks.empty() &&
+                (oldest == generations_.end() || it->second.lastUsed < oldest->second.lastUsed)) {
+                oldest = it;
+            }
+        }
+
+        if (oldest == generations_.end()) {
+            return false;
+        }
+
+        bytesUsed_ -= oldest->second.blocks.size() * getBlockBytes(oldest->second.numChannels);
+        evicted_ += oldest->second.blocks.size();
+        generations_.erase(oldest);
+    }
+
+    return true;
+}
+
+} // namespace juceaudioservice
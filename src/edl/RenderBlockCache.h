@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CompiledEdl.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+
+namespace juceaudioservice {
+
+/**
+ * Mixed render blocks kept between renders, so re-rendering after an
+ * edit only re-mixes the blocks the edit touched.
+ *
+ * Blocks are aligned to the timeline: block k covers samples
+ * [k * blockSize, (k + 1) * blockSize). For each EDL the cache holds the
+ * blocks of one revision. When a render asks for a newer (or older)
+ * revision, the blocks no change touched are carried over to it, found by
+ * diffing the two compilations (see TimelineDiff), and the rest are
+ * dropped. Carried-over blocks are shared, not copied. A generation is
+ * also keyed by the size and modification time of its media files, so
+ * when a file is rewritten in place the blocks that read it are dropped
+ * even if the EDL's revision did not change.
+ *
+ * Memory use is capped by a byte budget; when it is reached, the blocks
+ * of the least recently rendered EDL go first. All methods are
+ * thread-safe, so one cache can serve every renderer in the process.
+ */
+class RenderBlockCache {
+public:
+    using Block = juce::AudioBuffer<float>;
+    using BlockPtr = std::shared_ptr<const Block>;
+
+    static constexpr size_t defaultByteBudget = 512ull * 1024 * 1024;
+
+    struct Stats {
+        uint64_t reused = 0;   // blocks served from the cache
+        uint64_t rendered = 0; // blocks handed to store()
+        uint64_t invalidated = 0; // blocks dropped because an edit touched them
+        uint64_t evicted = 0;
+        size_t numBlocks = 0;
+        size_t bytesUsed = 0;
+    };
+
+    /**
+     * @param blockSize Frames per block
+     * @param byteBudget Total size of the blocks to keep
+     */
+    RenderBlockCache(int blockSize, size_t byteBudget = defaultByteBudget);
+    ~RenderBlockCache() = default;
+
+    int getBlockSize() const noexcept { return blockSize_; }
+
+    /**
+     * Look up the blocks of a render.
+     *
+     * Moves the EDL's cached blocks to this compilation's revision first.
+     *
+     * @param compiledEdl Timeline about to be rendered
+     * @param numChannels Channels of the mix; blocks with another layout are dropped
+     * @param firstBlock Index of the first block of the render
+     * @param numBlocks Number of blocks of the render
+     * @param blocks Receives numBlocks entries, null where a block has to be mixed
+     */
+    void acquire(const CompiledEdl& compiledEdl, int numChannels, int64_t firstBlock, int64_t numBlocks,
+                 std::vector<BlockPtr>& blocks);
+
+    /**
+     * Keep a freshly mixed block.
+     *
+     * Ignored if the EDL has since moved to another revision, or if the
+     * block does not fit the budget.
+     *
+     * @param compiledEdl Timeline the block was mixed from
+     * @param blockIndex Index of the block
+     * @param mix The mix; its first getBlockSize() samples are copied
+     */
+    void store(const CompiledEdl& compiledEdl, int64_t blockIndex, const juce::AudioBuffer<float>& mix);
+
+    /** Drop every block. */
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    // The blocks of one EDL, all mixed from `compiled`
+    struct Generation {
+        CompiledEdl compiled; // shares tracks with the store's copy; media stamped at acquire()
+        int numChannels = 0;
+        std::unordered_map<int64_t, BlockPtr> blocks;
+        uint64_t lastUsed = 0;
+    };
+
+    const int blockSize_;
+    const size_t byteBudget_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Generation> generations_; // by EDL id
+    uint64_t useCounter_ = 0;
+    size_t bytesUsed_ = 0;
+    uint64_t reused_ = 0;
+    uint64_t rendered_ = 0;
+    uint64_t invalidated_ = 0;
+    uint64_t evicted_ = 0;
+
+    size_t getBlockBytes(int numChannels) const noexcept;
+    static bool sameMediaVersions(const std::vector<CompiledMedia>& a, const std::vector<CompiledMedia>& b);
+    Generation& switchGenerationLocked(const CompiledEdl& compiledEdl, int numChannels);
+    bool makeRoomLocked(size_t bytes, const std::string& keepEdlId);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderBlockCache)
+};
+
+} // namespace juceaudioservice
@@ -0,0 +1,305 @@
+#include "RenderCache.h"
+#include "util/HashingOutputStream.h"
+#include "util/MediaInfoCache.h"
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace juceaudioservice {
+
+namespace {
+
+// Part of every key; bump it when a renderer change alters the output for the same inputs
+constexpr const char* keyVersion = "render-cache-v3";
+
+constexpr const char* hashExtension = ".sha256";
+constexpr const char* tempExtension = ".tmp";
+
+bool isHexDigest(const juce::String& text) {
+    return text.length() == 64 && text.containsOnly("0123456789abcdef");
+}
+
+// A digest plus the extension of its format, as built by makeKey()
+bool isCacheKey(const juce::String& text) {
+    const int dot = text.lastIndexOfChar('.');
+    const juce::String extension = text.substring(dot + 1);
+    return dot > 0 && isHexDigest(text.substring(0, dot)) && extension.isNotEmpty() &&
+           extension.containsOnly("abcdefghijklmnopqrstuvwxyz0123456789");
+}
+
+} // namespace
+
+RenderCache::RenderCache(const juce::File& directory, juce::int64 maxBytes)
+    : directory_(directory),
+      maxBytes_(std::max<juce::int64>(0, maxBytes)) {
+    directory_.createDirectory();
+    loadIndex();
+}
+
+std::string RenderCache::makeKey(const CompiledEdl& compiledEdl, const audio_engine::TimeRange& range,
+                                 int bitsPerSample, const std::string& format) {
+    HashingOutputStream digest(std::make_unique<juce::MemoryOutputStream>());
+
+    // Fields are NUL-separated so adjacent values can't run into each other
+    auto addField = [&digest](const std::string& field) {
+        digest.write(field.data(), field.size());
+        digest.writeByte(0);
+    };
+
+    addField(keyVersion);
+    addField(compiledEdl.edl_id);
+    addField(compiledEdl.revision);
+    addField(std::to_string(compiledEdl.sample_rate));
+    addField(std::to_string(range.start_samples()));
+    addField(std::to_string(range.duration_samples()));
+    addField(std::to_string(bitsPerSample));
+    addField(format);
+
+    // The revision covers the EDL, not the files it names, so identify those too
+    std::vector<const CompiledMedia*> media;
+    media.reserve(compiledEdl.media.size());
+    for (const auto& entry : compiledEdl.media) {
+        media.push_back(&entry);
+    }
+    std::sort(media.begin(), media.end(), [](const CompiledMedia* a, const CompiledMedia* b) {
+        return a->id < b->id;
+    });
+
+    for (const CompiledMedia* entry : media) {
+        addField(entry->id);
+        addField(entry->path);
+
+        MediaInfoCache::Info info;
+        if (MediaInfoCache::getInstance().probe(juce::File(entry->path), info)) {
+            addField(std::to_string(info.fileSize));
+            addField(std::to_string(info.modificationTime));
+        } else {
+            addField("missing");
+        }
+    }
+
+    // The key names the cached file, so FLAC renders are not stored as .wav
+    return digest.getHexDigest() + "." + format;
+}
+
+bool RenderCache::fetch(const std::string& key, const std::string& outputPath, std::string& sha256) {
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++misses_;
+            return false;
+        }
+
+        lru_.splice(lru_.begin(), lru_, it->second);
+        entry = *it->second;
+    }
+
+    // The output of an earlier hit may share this file; drop the entry if it was written to since
+    const juce::File renderFile = getRenderFile(key);
+    if (!renderFile.existsAsFile() || renderFile.getSize() != entry.size ||
+        renderFile.getLastModificationTime().toMilliseconds() != entry.modificationTime) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            removeLocked(it->second);
+        }
+        ++misses_;
+        return false;
+    }
+
+    juce::File outputFile(outputPath);
+    outputFile.getParentDirectory().createDirectory();
+    if (outputFile.exists()) {
+        outputFile.deleteFile();
+    }
+
+    if (!linkOrCopy(renderFile, outputFile)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++misses_;
+        return false;
+    }
+
+    // Recency survives restarts through the sidecar's modification time
+    getHashFile(key).setLastModificationTime(juce::Time::getCurrentTime());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++hits_;
+    }
+
+    sha256 = entry.sha256;
+    return true;
+}
+
+bool RenderCache::store(const std::string& key, const std::string& renderedPath, const std::string& sha256) {
+    const juce::File renderedFile(renderedPath);
+    if (!isCacheKey(key) || !isHexDigest(sha256) || !renderedFile.existsAsFile()) {
+        return false;
+    }
+
+    const juce::int64 size = renderedFile.getSize();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (size > maxBytes_) {
+            return false;
+        }
+    }
+
+    // Link or copy under a temporary name so a half-copied file is never indexed
+    const juce::File tempFile = directory_.getNonexistentChildFile(key, tempExtension, false);
+    if (!linkOrCopy(renderedFile, tempFile)) {
+        tempFile.deleteFile();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto existing = index_.find(key);
+    if (existing != index_.end()) {
+        removeLocked(existing->second);
+    }
+
+    const juce::File renderFile = getRenderFile(key);
+    if (!tempFile.moveFileTo(renderFile) || !getHashFile(key).replaceWithText(juce::String(sha256) + "\n")) {
+        tempFile.deleteFile();
+        renderFile.deleteFile();
+        getHashFile(key).deleteFile();
+        return false;
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.sha256 = sha256;
+    entry.size = renderFile.getSize();
+    entry.modificationTime = renderFile.getLastModificationTime().toMilliseconds();
+
+    lru_.push_front(entry);
+    index_[key] = lru_.begin();
+    bytesUsed_ += entry.size;
+
+    evictLocked();
+    return true;
+}
+
+void RenderCache::setMaxBytes(juce::int64 maxBytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxBytes_ = std::max<juce::int64>(0, maxBytes);
+    evictLocked();
+}
+
+RenderCache::Stats RenderCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Stats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.numEntries = static_cast<int>(lru_.size());
+    stats.bytesUsed = bytesUsed_;
+    stats.maxBytes = maxBytes_;
+    return stats;
+}
+
+juce::File RenderCache::getRenderFile(const std::string& key) const {
+    return directory_.getChildFile(juce::String(key));
+}
+
+juce::File RenderCache::getHashFile(const std::string& key) const {
+    return directory_.getChildFile(juce::String(key) + hashExtension);
+}
+
+void RenderCache::loadIndex() {
+    struct Found {
+        Entry entry;
+        juce::int64 lastUsed = 0;
+    };
+
+    std::vector<Found> found;
+
+    for (const auto& file : directory_.findChildFiles(juce::File::findFiles, false)) {
+        const juce::String key = file.getFileNameWithoutExtension();
+
+        // Leftovers of a store that was interrupted
+        if (file.hasFileExtension(tempExtension)) {
+            file.deleteFile();
+            continue;
+        }
+
+        if (!file.hasFileExtension(hashExtension)) {
+            continue;
+        }
+
+        // Including sidecars of the .wav-only layout, whose keys were bare digests
+        if (!isCacheKey(key)) {
+            file.deleteFile();
+            continue;
+        }
+
+        const juce::File renderFile = getRenderFile(key.toStdString());
+        const juce::String sha256 = file.loadFileAsString().trim();
+        if (!renderFile.existsAsFile() || !isHexDigest(sha256)) {
+            file.deleteFile();
+            continue;
+        }
+
+        Found item;
+        item.entry.key = key.toStdString();
+        item.entry.sha256 = sha256.toStdString();
+        item.entry.size = renderFile.getSize();
+        item.entry.modificationTime = renderFile.getLastModificationTime().toMilliseconds();
+        item.lastUsed = file.getLastModificationTime().toMilliseconds();
+        found.push_back(std::move(item));
+    }
+
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) {
+        return a.lastUsed > b.lastUsed;
+    });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& item : found) {
+        bytesUsed_ += item.entry.size;
+        lru_.push_back(std::move(item.entry));
+        index_[lru_.back().key] = std::prev(lru_.end());
+    }
+
+    // Renders without a sidecar can never be hits
+    for (const auto& file : directory_.findChildFiles(juce::File::findFiles, false)) {
+        if (!file.hasFileExtension(hashExtension) && index_.count(file.getFileName().toStdString()) == 0) {
+            file.deleteFile();
+        }
+    }
+
+    evictLocked();
+}
+
+void RenderCache::removeLocked(EntryList::iterator entry) {
+    getRenderFile(entry->key).deleteFile();
+    getHashFile(entry->key).deleteFile();
+
+    bytesUsed_ -= entry->size;
+    index_.erase(entry->key);
+    lru_.erase(entry);
+}
+
+void RenderCache::evictLocked() {
+    while (bytesUsed_ > maxBytes_ && !lru_.empty()) {
+        removeLocked(std::prev(lru_.end()));
+        ++evictions_;
+    }
+}
+
+bool RenderCache::linkOrCopy(const juce::File& source, const juce::File& destination) {
+    std::error_code error;
+    std::filesystem::create_hard_link(source.getFullPathName().toStdString(),
+                                      destination.getFullPathName().toStdString(), error);
+    if (!error) {
+        return true;
+    }
+
+    // Different filesystem, or one without hard links
+    return source.copyFileTo(destination);
+}
+
+} // namespace juceaudioservice
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "CompiledEdl.h"
+#include "audio_engine.pb.h"
+#include <juce_core/juce_core.h>
+
+namespace juceaudioservice {
+
+/**
+ * On-disk cache of finished EDL window renders.
+ *
+ * Entries are keyed by a digest of everything that determines the output
+ * file: the EDL id and content revision, the render range, the bit depth,
+ * the output format and the identity (path, size, modification time) of every media file.
+ * Each entry is the rendered file, named after its key (<digest>.wav or
+ * <digest>.flac), plus a sidecar holding its SHA-256, so a hit can answer
+ * a RenderEdlWindow without rendering or hashing.
+ *
+ * Files are hard-linked into and out of the cache where the filesystem
+ * allows, and copied otherwise. Because an output path may then share its
+ * file with the cache, entries are checked against their recorded size
+ * and modification time on every hit and dropped if they were changed.
+ * Total size is capped; the least recently used entries are evicted
+ * first, and entries left by earlier runs are picked up on start.
+ * All methods are thread-safe.
+ */
+class RenderCache {
+public:
+    static constexpr juce::int64 defaultMaxBytes = 1024ll * 1024 * 1024;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        int numEntries = 0;
+        juce::int64 bytesUsed = 0;
+        juce::int64 maxBytes = 0;
+    };
+
+    /**
+     * Open the cache in a directory, creating it if needed.
+     *
+     * @param directory Where cached renders are kept
+     * @param maxBytes Total size of cached renders to keep
+     */
+    explicit RenderCache(const juce::File& directory, juce::int64 maxBytes = defaultMaxBytes);
+    ~RenderCache() = default;
+
+    /**
+     * Build the cache key of a render.
+     *
+     * @param compiledEdl Timeline being rendered
+     * @param range Time range being rendered
+     * @param bitsPerSample Output bit depth
+     * @param format Output format name, e.g. "wav" or "flac"
+     * @return Lowercase hex digest plus "." and the format name; also the cached file's name
+     */
+    static std::string makeKey(const CompiledEdl& compiledEdl, const audio_engine::TimeRange& range,
+                               int bitsPerSample, const std::string& format = "wav");
+
+    /**
+     * Place a cached render at an output path.
+     *
+     * @param key Key from makeKey()
+     * @param outputPath Where the rendered file should appear; replaced if it exists
+     * @param sha256 Receives the SHA-256 of the file on a hit
+     * @return false on a miss
+     */
+    bool fetch(const std::string& key, const std::string& outputPath, std::string& sha256);
+
+    /**
+     * Add a finished render to the cache.
+     *
+     * @param key Key from makeKey()
+     * @param renderedPath The rendered file; left in place
+     * @param sha256 SHA-256 of the rendered file
+     * @return false if the render could not be stored or the key is not from makeKey()
+     */
+    bool store(const std::string& key, const std::string& renderedPath, const std::string& sha256);
+
+    /** Change the size cap, evicting entries if the cache is over it. */
+    void setMaxBytes(juce::int64 maxBytes);
+
+    const juce::File& getDirectory() const noexcept { return directory_; }
+
+    /** Hit/miss counters and current disk use. */
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::string sha256;
+        juce::int64 size = 0;
+        juce::int64 modificationTime = 0; // ms since epoch of the render file when it was stored
+    };
+
+    using EntryList = std::list<Entry>;
+
+    const juce::File directory_;
+
+    mutable std::mutex mutex_;
+    EntryList lru_; // front = most recently used
+    std::unordered_map<std::string, EntryList::iterator> index_;
+    juce::int64 bytesUsed_ = 0;
+    juce::int64 maxBytes_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+
+    juce::File getRenderFile(const std::string& key) const;
+    juce::File getHashFile(const std::string& key) const;
+
+    void loadIndex();
+    void removeLocked(EntryList::iterator entry); // also deletes the files
+    void evictLocked();
+
+    static bool linkOrCopy(const juce::File& source, const juce::File& destination);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderCache)
+};
+
+} // namespace juceaudioservice
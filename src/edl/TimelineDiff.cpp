@@ -0,0 +1,190 @@
+#include "TimelineDiff.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace juceaudioservice {
+
+namespace {
+
+bool sameMedia(const CompiledMedia& a, const CompiledMedia& b) {
+    return a.path == b.path && a.channels == b.channels && a.file_size == b.file_size &&
+           a.modification_time == b.modification_time;
+}
+
+bool sameFade(const FadeSpec& a, const FadeSpec& b) {
+    return a.length_samples == b.length_samples && (a.isEmpty() || a.shape == b.shape);
+}
+
+// Everything renderClip() reads; media indices point into each revision's own table
+bool sameClip(const CompiledEdl& aEdl, const CompiledTrack& a, size_t i,
+              const CompiledEdl& bEdl, const CompiledTrack& b, size_t j) {
+    return a.t0[i] == b.t0[j] && a.t1[i] == b.t1[j] && a.start_in_media[i] == b.start_in_media[j] &&
+           a.clip_gain[i] == b.clip_gain[j] && sameFade(a.fade_in[i], b.fade_in[j]) &&
+           sameFade(a.fade_out[i], b.fade_out[j]) &&
+           sameMedia(aEdl.media[a.media[i]], bEdl.media[b.media[j]]);
+}
+
+} // namespace
+
+TimelineDiff TimelineDiff::between(const CompiledEdl& before, const CompiledEdl& after) {
+    TimelineDiff diff;
+
+    if (before.sample_rate != after.sample_rate) {
+        diff.everything = true;
+        return diff;
+    }
+
+    std::unordered_map<std::string, size_t> beforeIndex;
+    beforeIndex.reserve(before.tracks.size());
+    for (size_t i = 0; i < before.tracks.size(); ++i) {
+        beforeIndex.emplace(before.tracks[i]->id, i);
+    }
+
+    // Shared tracks index both media tables; a file rewritten since `before` changes their clips on it
+    const size_t numShared = std::min(before.media.size(), after.media.size());
+    std::vector<char> mediaChanged(numShared, 0);
+    bool anyMediaChanged = false;
+    for (size_t m = 0; m < numShared; ++m) {
+        mediaChanged[m] = sameMedia(before.media[m], after.media[m]) ? 0 : 1;
+        anyMediaChanged = anyMediaChanged || mediaChanged[m] != 0;
+    }
+
+    // Buses are summed in track order, so tracks that swapped places change every mixed sample
+    size_t lastMatched = 0;
+    bool anyMatched = false;
+    std::vector<char> matched(before.tracks.size(), 0);
+
+    for (const auto& track : after.tracks) {
+        auto it = beforeIndex.find(track->id);
+        if (it == beforeIndex.end()) {
+            diff.addTrack(*track);
+            continue;
+        }
+
+        if (anyMatched && it->second < lastMatched) {
+            diff.everything = true;
+            diff.intervals.clear();
+            return diff;
+        }
+        lastMatched = it->second;
+        anyMatched = true;
+        matched[it->second] = 1;
+
+        const auto& previous = *before.tracks[it->second];
+        if (previous.muted && track->muted) {
+            continue;
+        }
+        if (&previous == track.get()) {
+            if (anyMediaChanged) {
+                diff.addClipsOnMedia(*track, mediaChanged);
+            }
+            continue;
+        }
+
+        if (previous.muted != track->muted || previous.gain_linear != track->gain_linear) {
+            diff.addTrack(previous);
+            diff.addTrack(*track);
+            continue;
+        }
+
+        diff.diffClips(before, previous, after, *track);
+    }
+
+    for (size_t i = 0; i < before.tracks.size(); ++i) {
+        if (!matched[i]) {
+            diff.addTrack(*before.tracks[i]);
+        }
+    }
+
+    diff.normalise();
+    return diff;
+}
+
+bool TimelineDiff::touches(int64_t start, int64_t end) const {
+    if (everything) {
+        return true;
+    }
+    if (start >= end) {
+        return false;
+    }
+
+    // First interval that ends after start; it overlaps if it also begins before end
+    auto it = std::upper_bound(intervals.begin(), intervals.end(), start,
+        [](int64_t position, const std::pair<int64_t, int64_t>& interval) {
+            return position < interval.second;
+        });
+    return it != intervals.end() && it->first < end;
+}
+
+void TimelineDiff::addClip(const CompiledTrack& track, size_t clip) {
+    if (track.t0[clip] < track.t1[clip]) {
+        intervals.emplace_back(track.t0[clip], track.t1[clip]);
+    }
+}
+
+void TimelineDiff::addTrack(const CompiledTrack& track) {
+    // Muted tracks never reach the mix
+    if (track.muted) {
+        return;
+    }
+    for (size_t i = 0; i < track.numClips(); ++i) {
+        addClip(track, i);
+    }
+}
+
+void TimelineDiff::addClipsOnMedia(const CompiledTrack& track, const std::vector<char>& mediaChanged) {
+    if (track.muted) {
+        return;
+    }
+    for (size_t i = 0; i < track.numClips(); ++i) {
+        if (track.media[i] < mediaChanged.size() && mediaChanged[track.media[i]]) {
+            addClip(track, i);
+        }
+    }
+}
+
+void TimelineDiff::diffClips(const CompiledEdl& beforeEdl, const CompiledTrack& before,
+                             const CompiledEdl& afterEdl, const CompiledTrack& after) {
+    // Both tracks are sorted by t0; clips left unpaired by the walk changed
+    const size_t numBefore = before.numClips();
+    const size_t numAfter = after.numClips();
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < numBefore && j < numAfter) {
+        if (sameClip(beforeEdl, before, i, afterEdl, after, j)) {
+            ++i;
+            ++j;
+        } else if (before.t0[i] < after.t0[j]) {
+            addClip(before, i++);
+        } else if (after.t0[j] < before.t0[i]) {
+            addClip(after, j++);
+        } else {
+            addClip(before, i++);
+            addClip(after, j++);
+        }
+    }
+
+    while (i < numBefore) {
+        addClip(before, i++);
+    }
+    while (j < numAfter) {
+        addClip(after, j++);
+    }
+}
+
+void TimelineDiff::normalise() {
+    std::sort(intervals.begin(), intervals.end());
+
+    size_t merged = 0;
+    for (const auto& interval : intervals) {
+        if (merged > 0 && interval.first <= intervals[merged - 1].second) {
+            intervals[merged - 1].second = std::max(intervals[merged - 1].second, interval.second);
+        } else {
+            intervals[merged++] = interval;
+        }
+    }
+    intervals.resize(merged);
+}
+
+} // namespace juceaudioservice
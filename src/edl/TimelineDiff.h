@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "CompiledEdl.h"
+
+namespace juceaudioservice {
+
+/**
+ * Timeline regions whose mix differs between two compiled revisions.
+ *
+ * Tracks are matched by id and their clips compared in timeline order.
+ * Every clip that was added, removed, moved or changed (gain, fades,
+ * media offset, or a media file rewritten in place) marks its span, as do
+ * all clips of a track whose gain or mute state changed. Tracks shared
+ * between the revisions are skipped without looking at their clips unless
+ * a media file changed, so after an incremental compile the cost is
+ * proportional to the tracks that were rebuilt.
+ *
+ * Outside the changed intervals both revisions mix the same clips in the
+ * same order, so a render of either is bit-identical there. Changes that
+ * can affect every sample (sample rate, track order) set `everything`.
+ */
+struct TimelineDiff {
+    bool everything = false;
+    std::vector<std::pair<int64_t, int64_t>> intervals; // [start, end), sorted and disjoint
+
+    /**
+     * Compare two compilations of the same EDL.
+     *
+     * @param before The earlier revision
+     * @param after The later revision
+     * @return The changed regions
+     */
+    static TimelineDiff between(const CompiledEdl& before, const CompiledEdl& after);
+
+    /** true if nothing changed. */
+    bool isEmpty() const noexcept { return !everything && intervals.empty(); }
+
+    /** true if [start, end) overlaps a changed region. */
+    bool touches(int64_t start, int64_t end) const;
+
+private:
+    void addClip(const CompiledTrack& track, size_t clip);
+    void addTrack(const CompiledTrack& track);
+    void addClipsOnMedia(const CompiledTrack& track, const std::vector<char>& mediaChanged);
+    void diffClips(const CompiledEdl& beforeEdl, const CompiledTrack& before,
+                   const CompiledEdl& afterEdl, const CompiledTrack& after);
+    void normalise();
+};
+
+} // namespace juceaudioservice
@@ -6,10 +6,19 @@
 #include <chrono>
 #include <iomanip>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 #include <grpcpp/grpcpp.h>
+#include <google/protobuf/util/json_util.h>
 #include "audio_engine.grpc.pb.h"
 #include "util/EdlJson.h"
+#include "util/HashingOutputStream.h"
+#include "util/WavStreamWriter.h"
+
+#include <juce_core/juce_core.h>
 
 using grpc::Channel;
 using grpc::ClientContext;
@@ -169,8 +178,47 @@ public:
         return true;
     }
 
+    bool PatchEdl(const std::string& patchPath) {
+        // Read JSON file
+        std::string jsonString, error;
+        if (!juceaudioservice::EdlJson::readJsonFromFile(patchPath, jsonString, error)) {
+            std::cout << "Failed to read patch file: " << error << std::endl;
+            return false;
+        }
+
+        // Parse JSON to patch request
+        audio_engine::PatchEdlRequest request;
+        if (!juceaudioservice::EdlJson::parsePatchFromJson(jsonString, request, error)) {
+            std::cout << "Failed to parse patch JSON: " << error << std::endl;
+            return false;
+        }
+
+        audio_engine::PatchEdlResponse response;
+        ClientContext context;
+
+        Status status = stub_->PatchEdl(&context, request, &response);
+
+        if (!status.ok()) {
+            std::cout << "PatchEdl RPC failed: " << status.error_message() << std::endl;
+            return false;
+        }
+
+        std::cout << "EDL patched successfully:" << std::endl;
+        std::cout << "  EDL ID: " << response.edl_id() << std::endl;
+        std::cout << "  Revision: " << response.revision() << std::endl;
+        std::cout << "  Track Count: " << response.track_count() << std::endl;
+        std::cout << "  Clip Count: " << response.clip_count() << std::endl;
+        std::cout << "  Dirty Tracks:";
+        for (const auto& trackId : response.dirty_track_ids()) {
+            std::cout << " " << trackId;
+        }
+        std::cout << std::endl;
+
+        return true;
+    }
+
     bool RenderEdlWindow(const std::string& edlId, double startSec, double durSec,
-                        const std::string& outputPath, int bitDepth = 16) {
+                        const std::string& outputPath, int bitDepth = 16, bool flac = false) {
         // Convert seconds to samples (assume 48kHz)
         const int sampleRate = 48000;
         int64_t startSamples = static_cast<int64_t>(startSec * sampleRate);
@@ -182,6 +230,7 @@ public:
         request.mutable_range()->set_duration_samples(durationSamples);
         request.set_out_path(outputPath);
         request.set_bit_depth(bitDepth);
+        request.set_format(flac ? audio_engine::RenderEdlWindowRequest::FLAC : audio_engine::RenderEdlWindowRequest::WAV);
 
         ClientContext context;
         std::unique_ptr<ClientReader<audio_engine::EngineEvent>> reader(
@@ -224,6 +273,211 @@ public:
         return success;
     }
 
+    struct WindowSpec {
+        double startSec = 0.0;
+        double durSec = 0.0;
+        std::string outputPath;
+        int bitDepth = 16;
+    };
+
+    bool RenderEdlWindows(const std::string& edlId, const std::vector<WindowSpec>& windows) {
+        // Convert seconds to samples (assume 48kHz)
+        const int sampleRate = 48000;
+
+        audio_engine::RenderEdlWindowsRequest request;
+        request.set_edl_id(edlId);
+        for (const auto& spec : windows) {
+            auto* window = request.add_windows();
+            window->mutable_range()->set_start_samples(static_cast<int64_t>(spec.startSec * sampleRate));
+            window->mutable_range()->set_duration_samples(static_cast<int64_t>(spec.durSec * sampleRate));
+            window->set_out_path(spec.outputPath);
+            window->set_bit_depth(spec.bitDepth);
+        }
+
+        ClientContext context;
+        std::unique_ptr<ClientReader<audio_engine::EngineEvent>> reader(
+            stub_->RenderEdlWindows(&context, request));
+
+        audio_engine::EngineEvent event;
+        int completed = 0;
+
+        while (reader->Read(&event)) {
+            if (event.has_progress()) {
+                const auto& progress = event.progress();
+                std::cout << "\rProgress: " << std::fixed << std::setprecision(1)
+                         << (progress.fraction() * 100.0) << "%";
+                if (!progress.eta().empty()) {
+                    std::cout << " (ETA: " << progress.eta() << ")";
+                }
+                std::cout.flush();
+            } else if (event.has_complete()) {
+                const auto& complete = event.complete();
+                std::cout << std::endl << "Window " << complete.window_index() << " completed: "
+                         << complete.out_path() << " (SHA256: " << complete.sha256() << ")" << std::endl;
+                ++completed;
+            } else if (event.has_edl_error()) {
+                const auto& error = event.edl_error();
+                std::cout << std::endl << "EDL Error";
+                if (!error.out_path().empty()) {
+                    std::cout << " (" << error.out_path() << ")";
+                }
+                std::cout << ": " << error.reason() << std::endl;
+            }
+        }
+
+        Status status = reader->Finish();
+        if (!status.ok()) {
+            std::cout << std::endl << "RenderEdlWindows RPC failed: " << status.error_message() << std::endl;
+            return false;
+        }
+
+        std::cout << completed << " of " << windows.size() << " windows rendered" << std::endl;
+        return completed == static_cast<int>(windows.size());
+    }
+
+    bool StreamEdlWindow(const std::string& edlId, double startSec, double durSec,
+                         const std::string& outputPath, bool int16, int chunkFrames) {
+        // Convert seconds to samples (assume 48kHz)
+        const int sampleRate = 48000;
+        int64_t startSamples = static_cast<int64_t>(startSec * sampleRate);
+        int64_t durationSamples = static_cast<int64_t>(durSec * sampleRate);
+
+        audio_engine::StreamEdlWindowRequest request;
+        request.set_edl_id(edlId);
+        request.mutable_range()->set_start_samples(startSamples);
+        request.mutable_range()->set_duration_samples(durationSamples);
+        request.set_encoding(int16 ? audio_engine::PcmHeader::INT16 : audio_engine::PcmHeader::FLOAT32);
+        request.set_chunk_frames(chunkFrames);
+
+        auto requestTime = std::chrono::steady_clock::now();
+
+        ClientContext context;
+        std::unique_ptr<ClientReader<audio_engine::PcmStreamMessage>> reader(
+            stub_->StreamEdlWindow(&context, request));
+
+        audio_engine::PcmStreamMessage message;
+        std::unique_ptr<juce::FileOutputStream> output;
+        std::unique_ptr<juceaudioservice::WavStreamWriter> wavWriter;
+        size_t frameBytes = 0;
+        int64_t totalFrames = 0;
+        int64_t framesReceived = 0;
+        int chunksReceived = 0;
+        bool failed = false;
+
+        while (!failed && reader->Read(&message)) {
+            if (message.has_header()) {
+                const auto& header = message.header();
+                const int bitsPerSample = header.encoding() == audio_engine::PcmHeader::INT16 ? 16 : 32;
+                frameBytes = static_cast<size_t>(header.channels()) * static_cast<size_t>(bitsPerSample / 8);
+                totalFrames = header.total_frames();
+
+                std::cout << "Streaming " << header.edl_id() << " @ " << header.revision() << ": "
+                          << header.channels() << " ch, " << header.sample_rate() << " Hz, "
+                          << (bitsPerSample == 16 ? "int16" : "float32") << ", "
+                          << totalFrames << " frames" << std::endl;
+
+                juce::File outputFile(juce::File::getCurrentWorkingDirectory().getChildFile(outputPath));
+                outputFile.deleteFile();
+                output = std::make_unique<juce::FileOutputStream>(outputFile);
+                if (output->failedToOpen()) {
+                    std::cout << "Error: cannot create output file: " << outputPath << std::endl;
+                    failed = true;
+                    break;
+                }
+
+                wavWriter = std::make_unique<juceaudioservice::WavStreamWriter>(
+                    *output, header.sample_rate(), header.channels(), bitsPerSample, totalFrames);
+                if (!wavWriter->isValid()) {
+                    std::cout << "Error: unsupported stream format" << std::endl;
+                    failed = true;
+                }
+            } else if (message.has_chunk()) {
+                const auto& chunk = message.chunk();
+                if (!wavWriter || chunk.start_frame() != framesReceived ||
+                    chunk.data().size() != static_cast<size_t>(chunk.num_frames()) * frameBytes) {
+                    std::cout << std::endl << "Error: malformed PCM chunk at frame " << chunk.start_frame() << std::endl;
+                    failed = true;
+                    break;
+                }
+
+                if (chunksReceived++ == 0) {
+                    auto firstChunkMs = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - requestTime).count();
+                    std::cout << "First audio after " << std::fixed << std::setprecision(1)
+                              << firstChunkMs << " ms" << std::endl;
+                }
+
+                if (!wavWriter->writeEncoded(chunk.data().data(), chunk.num_frames())) {
+                    std::cout << std::endl << "Error: failed to write " << outputPath << std::endl;
+                    failed = true;
+                    break;
+                }
+                framesReceived += chunk.num_frames();
+
+                std::cout << "\rReceived: " << std::fixed << std::setprecision(1)
+                          << (totalFrames > 0 ? 100.0 * framesReceived / totalFrames : 100.0) << "%";
+                std::cout.flush();
+            }
+        }
+
+        if (failed) {
+            context.TryCancel();
+        }
+
+        Status status = reader->Finish();
+        if (failed) {
+            return false;
+        }
+        if (!status.ok()) {
+            std::cout << std::endl << "StreamEdlWindow RPC failed: " << status.error_message() << std::endl;
+            return false;
+        }
+
+        if (!wavWriter || framesReceived != totalFrames || !wavWriter->finish()) {
+            std::cout << std::endl << "Error: stream ended after " << framesReceived << " of "
+                      << totalFrames << " frames" << std::endl;
+            return false;
+        }
+        output->flush();
+
+        auto totalMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - requestTime).count();
+        std::cout << std::endl << "Stream completed!" << std::endl;
+        std::cout << "  Output file: " << outputPath << std::endl;
+        std::cout << "  Chunks: " << chunksReceived << std::endl;
+        std::cout << "  Total time: " << std::fixed << std::setprecision(1) << totalMs << " ms" << std::endl;
+
+        return true;
+    }
+
+    bool GetStats(bool prometheus) {
+        audio_engine::GetStatsRequest request;
+        request.set_prometheus(prometheus);
+
+        audio_engine::GetStatsResponse response;
+        ClientContext context;
+        Status status = stub_->GetStats(&context, request, &response);
+
+        if (!status.ok()) {
+            std::cout << "GetStats RPC failed: " << status.error_message() << std::endl;
+            return false;
+        }
+
+        if (prometheus) {
+            std::cout << response.prometheus_text();
+            return true;
+        }
+
+        google::protobuf::util::JsonPrintOptions options;
+        options.add_whitespace = true;
+        options.always_print_primitive_fields = true;
+
+        std::string json;
+        google::protobuf::util::MessageToJsonString(response, &json, options);
+        std::cout << json << std::endl;
+        return true;
+    }
+
     bool Subscribe(const std::string& edlId) {
         audio_engine::SubscribeRequest request;
         request.set_session(edlId);
@@ -257,6 +511,360 @@ public:
     }
 };
 
+/**
+ * Renders one EDL window across several servers.
+ *
+ * The EDL is pushed to every worker with UpdateEdl, and all workers must
+ * report the same revision. The range is cut into shards on the renderer's
+ * block grid. One thread per worker takes shards from a shared queue,
+ * streams each with StreamEdlWindow and writes its frames at their offset
+ * in the output WAV, so no storage has to be shared. The header is written
+ * once every shard has arrived and the finished file is hashed, so the
+ * SHA-256 matches a RenderEdlWindow of the same range on one server.
+ */
+class ShardedRenderClient {
+private:
+    // The renderer's block size; shards on its grid reuse whole cached blocks
+    static constexpr int64_t shardAlignFrames = 4096;
+
+    struct Worker {
+        std::string address;
+        std::unique_ptr<audio_engine::AudioEngine::Stub> stub;
+    };
+
+    std::vector<Worker> workers_;
+
+    struct Shard {
+        int64_t start = 0;
+        int64_t end = 0;
+        audio_engine::PcmHeader header; // as sent by the worker that rendered it
+    };
+
+    struct RenderState {
+        const audio_engine::Edl& edl;
+        const std::string& revision;
+        int64_t rangeStart;
+        int64_t totalFrames;
+        bool int16;
+        const juce::File& outputFile;
+        int channels = 0; // from the first stream header; the other shards must match it, guarded by mutex
+
+        std::vector<Shard> shards;
+        std::atomic<size_t> nextShard{0};
+        std::atomic<bool> failed{false};
+
+        std::mutex mutex; // guards the fields below
+        std::string firstError;
+        int64_t framesReceived = 0;
+
+        RenderState(const audio_engine::Edl& edl_, const std::string& revision_, int64_t rangeStart_,
+                    int64_t totalFrames_, bool int16_, const juce::File& outputFile_)
+            : edl(edl_), revision(revision_), rangeStart(rangeStart_), totalFrames(totalFrames_),
+              int16(int16_), outputFile(outputFile_) {}
+    };
+
+public:
+    explicit ShardedRenderClient(const std::vector<std::string>& addresses) {
+        for (const auto& address : addresses) {
+            auto channel = grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
+            workers_.push_back({ address, audio_engine::AudioEngine::NewStub(channel) });
+        }
+    }
+
+    size_t getNumWorkers() const { return workers_.size(); }
+
+    bool PushEdl(const audio_engine::Edl& edl, std::string& revision) {
+        revision.clear();
+
+        for (const auto& worker : workers_) {
+            audio_engine::UpdateEdlRequest request;
+            request.mutable_edl()->CopyFrom(edl);
+            request.set_replace(true);
+
+            audio_engine::UpdateEdlResponse response;
+            ClientContext context;
+            Status status = worker.stub->UpdateEdl(&context, request, &response);
+
+            if (!status.ok()) {
+                std::cout << "UpdateEdl on " << worker.address << " failed: " << status.error_message() << std::endl;
+                return false;
+            }
+
+            // Revisions are content hashes, so workers holding the same EDL agree on them
+            if (revision.empty()) {
+                revision = response.revision();
+            } else if (response.revision() != revision) {
+                std::cout << "Error: " << worker.address << " reports revision " << response.revision()
+                          << ", expected " << revision << std::endl;
+                return false;
+            }
+        }
+
+        std::cout << "EDL " << edl.id() << " @ " << revision << " pushed to " << workers_.size()
+                  << " workers" << std::endl;
+        return true;
+    }
+
+    bool Render(const audio_engine::Edl& edl, const std::string& revision, double startSec, double durSec,
+                const std::string& outputPath, bool int16, int numShards) {
+        const int sampleRate = edl.sample_rate() > 0 ? edl.sample_rate() : 48000;
+
+        juce::File outputFile(juce::File::getCurrentWorkingDirectory().getChildFile(outputPath));
+        RenderState state(edl, revision, static_cast<int64_t>(startSec * sampleRate),
+                          static_cast<int64_t>(durSec * sampleRate), int16, outputFile);
+
+        if (state.totalFrames <= 0) {
+            std::cout << "Error: duration must be positive" << std::endl;
+            return false;
+        }
+
+        state.shards = planShards(state.rangeStart, state.rangeStart + state.totalFrames, numShards);
+        std::cout << "Rendering " << state.totalFrames << " frames in " << state.shards.size() << " shards on "
+                  << workers_.size() << " workers" << std::endl;
+
+        outputFile.getParentDirectory().createDirectory();
+        outputFile.deleteFile();
+        if (juce::FileOutputStream(outputFile).failedToOpen()) {
+            std::cout << "Error: cannot create output file: " << outputPath << std::endl;
+            return false;
+        }
+
+        const auto startTime = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        for (size_t w = 0; w < workers_.size(); ++w) {
+            threads.emplace_back([this, w, &state] { runWorker(workers_[w], state); });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (!state.failed.load() && !headersAgree(state)) {
+            state.firstError = "workers disagree on the stream format";
+            state.failed = true;
+        }
+
+        if (!state.failed.load() && !writeHeader(state)) {
+            state.firstError = "failed to write the WAV header to " + outputPath;
+            state.failed = true;
+        }
+
+        if (state.failed.load()) {
+            std::cout << std::endl << "Sharded render failed: " << state.firstError << std::endl;
+            outputFile.deleteFile();
+            return false;
+        }
+
+        // Shards land out of order, so the hash is taken over the finished file
+        const std::string sha256 = juceaudioservice::HashingOutputStream::hashFile(outputFile);
+        if (sha256.empty()) {
+            std::cout << std::endl << "Error: cannot hash " << outputPath << std::endl;
+            return false;
+        }
+
+        auto totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << std::endl << "Sharded render completed!" << std::endl;
+        std::cout << "  Output file: " << outputPath << std::endl;
+        std::cout << "  Duration: " << static_cast<double>(state.totalFrames) / sampleRate << " seconds" << std::endl;
+        std::cout << "  SHA256: " << sha256 << std::endl;
+        std::cout << "  Total time: " << std::fixed << std::setprecision(1) << totalMs << " ms" << std::endl;
+        return true;
+    }
+
+private:
+    static std::vector<Shard> planShards(int64_t rangeStart, int64_t rangeEnd, int numShards) {
+        std::vector<int64_t> bounds{rangeStart};
+        for (int i = 1; i < numShards; ++i) {
+            const int64_t target = rangeStart + (rangeEnd - rangeStart) * i / numShards;
+            int64_t bound = target - target % shardAlignFrames;
+            if (target % shardAlignFrames < 0) {
+                bound -= shardAlignFrames;
+            }
+            if (bound > bounds.back() && bound < rangeEnd) {
+                bounds.push_back(bound);
+            }
+        }
+        bounds.push_back(rangeEnd);
+
+        std::vector<Shard> shards(bounds.size() - 1);
+        for (size_t i = 0; i < shards.size(); ++i) {
+            shards[i].start = bounds[i];
+            shards[i].end = bounds[i + 1];
+        }
+        return shards;
+    }
+
+    static void fail(RenderState& state, const std::string& message) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.failed.exchange(true)) {
+            state.firstError = message;
+        }
+    }
+
+    static void runWorker(const Worker& worker, RenderState& state) {
+        juce::FileOutputStream output(state.outputFile);
+        if (!output.openedOk()) {
+            fail(state, "cannot open " + state.outputFile.getFullPathName().toStdString());
+            return;
+        }
+
+        while (!state.failed.load()) {
+            const size_t index = state.nextShard++;
+            if (index >= state.shards.size()) {
+                break;
+            }
+
+            std::string error;
+            if (!renderShard(worker, state, state.shards[index], output, error) && !error.empty()) {
+                fail(state, worker.address + ": " + error);
+            }
+        }
+    }
+
+    // Stream one shard and write it in place; error stays empty if another shard failed first
+    static bool renderShard(const Worker& worker, RenderState& state, Shard& shard,
+                            juce::FileOutputStream& output, std::string& error) {
+        audio_engine::StreamEdlWindowRequest request;
+        request.set_edl_id(state.edl.id());
+        request.mutable_range()->set_start_samples(shard.start);
+        request.mutable_range()->set_duration_samples(shard.end - shard.start);
+        request.set_encoding(state.int16 ? audio_engine::PcmHeader::INT16 : audio_engine::PcmHeader::FLOAT32);
+
+        ClientContext context;
+        std::unique_ptr<ClientReader<audio_engine::PcmStreamMessage>> reader(
+            worker.stub->StreamEdlWindow(&context, request));
+
+        audio_engine::PcmStreamMessage message;
+        size_t frameBytes = 0;
+        int64_t framesReceived = 0;
+
+        while (error.empty() && reader->Read(&message)) {
+            if (state.failed.load()) {
+                break;
+            }
+
+            if (message.has_header()) {
+                shard.header = message.header();
+                const int bitsPerSample = shard.header.encoding() == audio_engine::PcmHeader::INT16 ? 16 : 32;
+                frameBytes = static_cast<size_t>(shard.header.channels()) * static_cast<size_t>(bitsPerSample / 8);
+
+                // An edit between the push and this shard would splice two revisions together
+                if (shard.header.revision() != state.revision) {
+                    error = "streamed revision " + shard.header.revision() + ", expected " + state.revision;
+                } else if (frameBytes == 0 || shard.header.total_frames() != shard.end - shard.start) {
+                    error = "unexpected stream header";
+                } else if (acceptChannels(state, shard.header, error) &&
+                           !output.setPosition(juceaudioservice::WavStreamWriter::headerSize +
+                                               (shard.start - state.rangeStart) * static_cast<int64_t>(frameBytes))) {
+                    error = "cannot seek in the output file";
+                }
+            } else if (message.has_chunk()) {
+                const auto& chunk = message.chunk();
+                if (frameBytes == 0 || chunk.start_frame() != framesReceived ||
+                    chunk.data().size() != static_cast<size_t>(chunk.num_frames()) * frameBytes) {
+                    error = "malformed PCM chunk at frame " + std::to_string(shard.start + chunk.start_frame());
+                } else if (!output.write(chunk.data().data(), chunk.data().size())) {
+                    error = "failed to write the output file";
+                } else {
+                    framesReceived += chunk.num_frames();
+
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    state.framesReceived += chunk.num_frames();
+                    std::cout << "\rProgress: " << std::fixed << std::setprecision(1)
+                              << (100.0 * state.framesReceived / state.totalFrames) << "%";
+                    std::cout.flush();
+                }
+            }
+        }
+
+        const bool stopped = !error.empty() || state.failed.load();
+        if (stopped) {
+            context.TryCancel();
+        }
+
+        Status status = reader->Finish();
+        if (stopped) {
+            return false;
+        }
+        if (!status.ok()) {
+            error = "StreamEdlWindow failed: " + status.error_message();
+            return false;
+        }
+
+        output.flush();
+        if (framesReceived != shard.end - shard.start || output.getStatus().failed()) {
+            error = "shard at frame " + std::to_string(shard.start) + " ended after " +
+                    std::to_string(framesReceived) + " frames";
+            return false;
+        }
+        return true;
+    }
+
+    // The server counts channels from the probed media, so the first header sets them for every shard.
+    // It is also checked against what a WAV file can describe before any audio is written.
+    static bool acceptChannels(RenderState& state, const audio_engine::PcmHeader& header, std::string& error) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.channels == 0) {
+            juce::MemoryOutputStream headerCheck;
+            const int bitsPerSample = header.encoding() == audio_engine::PcmHeader::INT16 ? 16 : 32;
+            juceaudioservice::WavStreamWriter format(headerCheck, header.sample_rate(), header.channels(),
+                                                     bitsPerSample, state.totalFrames);
+            if (!format.isValid()) {
+                error = "cannot write " + std::to_string(state.totalFrames) + " frames of " +
+                        std::to_string(header.channels()) + "-channel audio at " +
+                        std::to_string(header.sample_rate()) + " Hz as WAV";
+                return false;
+            }
+            state.channels = header.channels();
+        } else if (header.channels() != state.channels) {
+            error = "streamed " + std::to_string(header.channels()) + " channels, expected " +
+                    std::to_string(state.channels);
+            return false;
+        }
+        return true;
+    }
+
+    static bool headersAgree(const RenderState& state) {
+        const auto& first = state.shards.front().header;
+        for (const auto& shard : state.shards) {
+            if (shard.header.sample_rate() != first.sample_rate() || shard.header.channels() != first.channels() ||
+                shard.header.encoding() != first.encoding()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool writeHeader(const RenderState& state) {
+        const auto& format = state.shards.front().header;
+        const int bitsPerSample = format.encoding() == audio_engine::PcmHeader::INT16 ? 16 : 32;
+
+        juce::FileOutputStream output(state.outputFile);
+        if (!output.openedOk() || !output.setPosition(0)) {
+            return false;
+        }
+
+        juceaudioservice::WavStreamWriter header(output, format.sample_rate(), format.channels(), bitsPerSample,
+                                                 state.totalFrames);
+        if (!header.writeHeader()) {
+            return false;
+        }
+
+        // Odd-sized data chunks end with a pad byte
+        const int64_t dataSize = state.totalFrames * format.channels() * (bitsPerSample / 8);
+        if ((dataSize & 1) != 0) {
+            const char pad = 0;
+            if (!output.setPosition(juceaudioservice::WavStreamWriter::headerSize + dataSize) ||
+                !output.write(&pad, 1)) {
+                return false;
+            }
+        }
+
+        output.flush();
+        return !output.getStatus().failed();
+    }
+};
+
 void printUsage(const char* programName) {
     std::cout << "Usage: " << programName << " [options] <command> [args...]" << std::endl;
     std::cout << std::endl;
@@ -272,8 +880,13 @@ void printUsage(const char* programName) {
     std::cout << std::endl;
     std::cout << "EDL Commands:" << std::endl;
     std::cout << "  edl-update --edl <path.json> [--replace]    Update EDL from JSON file" << std::endl;
-    std::cout << "  edl-render --edl-id <id> --start <sec> --dur <sec> --out <path> [--bit-depth 16|24|32]  Render EDL window" << std::endl;
+    std::cout << "  edl-patch --patch <path.json>               Apply clip/track edits from JSON file" << std::endl;
+    std::cout << "  edl-render --edl-id <id> --start <sec> --dur <sec> --out <path> [--bit-depth 16|24|32] [--format wav|flac]  Render EDL window" << std::endl;
+    std::cout << "  edl-render-batch --edl-id <id> --window <start>:<dur>:<path>[:<bits>] [--window ...]  Render several EDL windows in one pass" << std::endl;
+    std::cout << "  edl-stream --edl-id <id> --start <sec> --dur <sec> --out <path> [--format float|int16] [--chunk <frames>]  Stream EDL window PCM" << std::endl;
+    std::cout << "  edl-render-sharded --edl <path.json> --workers <addr>,<addr>... --start <sec> --dur <sec> --out <path> [--format float|int16] [--shards <n>]  Render one EDL window across several servers" << std::endl;
     std::cout << "  subscribe --edl-id <id>                     Subscribe to EDL events (NDJSON)" << std::endl;
+    std::cout << "  stats [--prometheus]                        Print render telemetry (JSON or Prometheus text)" << std::endl;
     std::cout << std::endl;
     std::cout << "Legacy format (still supported):" << std::endl;
     std::cout << "  load <file>" << std::endl;
@@ -286,7 +899,12 @@ void printUsage(const char* programName) {
     std::cout << "  " << programName << " render --path input.wav --out output.wav --start 1.0 --dur 5.0" << std::endl;
     std::cout << "  " << programName << " edl-update --edl fixtures/test_edl.json" << std::endl;
     std::cout << "  " << programName << " edl-render --edl-id abc123 --start 0 --dur 5 --out output.wav --bit-depth 24" << std::endl;
+    std::cout << "  " << programName << " edl-render --edl-id abc123 --start 0 --dur 5 --out output.flac --bit-depth 24 --format flac" << std::endl;
+    std::cout << "  " << programName << " edl-render-batch --edl-id abc123 --window 0:5:a.wav --window 4:5:b.wav:24" << std::endl;
+    std::cout << "  " << programName << " edl-stream --edl-id abc123 --start 0 --dur 5 --out streamed.wav --format int16" << std::endl;
+    std::cout << "  " << programName << " edl-render-sharded --edl fixtures/test_edl.json --workers node1:50051,node2:50051 --start 0 --dur 600 --out export.wav" << std::endl;
     std::cout << "  " << programName << " subscribe --edl-id abc123" << std::endl;
+    std::cout << "  " << programName << " stats" << std::endl;
 }
 
 // Helper function to find named argument value
@@ -448,12 +1066,29 @@ int main(int argc, char** argv) {
         if (!client.UpdateEdl(edlPath, replace)) {
             return 1;
         }
+    } else if (command == "edl-patch") {
+        std::string patchPath = getNamedArg(args, "--patch");
+
+        if (patchPath.empty()) {
+            std::cout << "Error: edl-patch command requires --patch <path.json>" << std::endl;
+            return 1;
+        }
+
+        if (patchPath != "-" && !std::filesystem::exists(patchPath)) {
+            std::cout << "Error: patch file does not exist: " << patchPath << std::endl;
+            return 1;
+        }
+
+        if (!client.PatchEdl(patchPath)) {
+            return 1;
+        }
     } else if (command == "edl-render") {
         std::string edlId = getNamedArg(args, "--edl-id");
         std::string startStr = getNamedArg(args, "--start");
         std::string durStr = getNamedArg(args, "--dur");
         std::string outputPath = getNamedArg(args, "--out");
         std::string bitDepthStr = getNamedArg(args, "--bit-depth", "16");
+        std::string format = getNamedArg(args, "--format", "wav");
 
         if (edlId.empty() || startStr.empty() || durStr.empty() || outputPath.empty()) {
             std::cout << "Error: edl-render command requires --edl-id <id> --start <sec> --dur <sec> --out <path>" << std::endl;
@@ -477,7 +1112,161 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        if (!client.RenderEdlWindow(edlId, startSec, durSec, outputPath, bitDepth)) {
+        if (format != "wav" && format != "flac") {
+            std::cout << "Error: format must be wav or flac" << std::endl;
+            return 1;
+        }
+
+        if (format == "flac" && bitDepth == 32) {
+            std::cout << "Error: FLAC output supports bit depth 16 or 24" << std::endl;
+            return 1;
+        }
+
+        if (!client.RenderEdlWindow(edlId, startSec, durSec, outputPath, bitDepth, format == "flac")) {
+            return 1;
+        }
+    } else if (command == "edl-render-batch") {
+        std::string edlId = getNamedArg(args, "--edl-id");
+        std::vector<AudioEngineClient::WindowSpec> windows;
+
+        for (size_t i = 0; i + 1 < args.size(); ++i) {
+            if (args[i] != "--window") {
+                continue;
+            }
+
+            // start:dur:path[:bits]; the path may itself contain colons
+            const std::string& value = args[i + 1];
+            const size_t first = value.find(':');
+            const size_t second = first == std::string::npos ? first : value.find(':', first + 1);
+            if (second == std::string::npos) {
+                std::cout << "Error: invalid window '" << value << "' (expected <start>:<dur>:<path>[:<bits>])" << std::endl;
+                return 1;
+            }
+
+            AudioEngineClient::WindowSpec spec;
+            spec.outputPath = value.substr(second + 1);
+            const size_t last = spec.outputPath.rfind(':');
+            try {
+                spec.startSec = std::stod(value.substr(0, first));
+                spec.durSec = std::stod(value.substr(first + 1, second - first - 1));
+                if (last != std::string::npos) {
+                    const std::string bits = spec.outputPath.substr(last + 1);
+                    if (bits == "16" || bits == "24" || bits == "32") {
+                        spec.bitDepth = std::stoi(bits);
+                        spec.outputPath.resize(last);
+                    }
+                }
+            } catch (...) {
+                std::cout << "Error: invalid numeric parameter in window '" << value << "'" << std::endl;
+                return 1;
+            }
+
+            windows.push_back(spec);
+        }
+
+        if (edlId.empty() || windows.empty()) {
+            std::cout << "Error: edl-render-batch command requires --edl-id <id> and at least one --window" << std::endl;
+            return 1;
+        }
+
+        if (!client.RenderEdlWindows(edlId, windows)) {
+            return 1;
+        }
+    } else if (command == "edl-stream") {
+        std::string edlId = getNamedArg(args, "--edl-id");
+        std::string startStr = getNamedArg(args, "--start");
+        std::string durStr = getNamedArg(args, "--dur");
+        std::string outputPath = getNamedArg(args, "--out");
+        std::string format = getNamedArg(args, "--format", "float");
+        std::string chunkStr = getNamedArg(args, "--chunk", "0");
+
+        if (edlId.empty() || startStr.empty() || durStr.empty() || outputPath.empty()) {
+            std::cout << "Error: edl-stream command requires --edl-id <id> --start <sec> --dur <sec> --out <path>" << std::endl;
+            return 1;
+        }
+
+        if (format != "float" && format != "int16") {
+            std::cout << "Error: format must be float or int16" << std::endl;
+            return 1;
+        }
+
+        double startSec, durSec;
+        int chunkFrames;
+
+        try {
+            startSec = std::stod(startStr);
+            durSec = std::stod(durStr);
+            chunkFrames = std::stoi(chunkStr);
+        } catch (...) {
+            std::cout << "Error: invalid numeric parameter" << std::endl;
+            return 1;
+        }
+
+        if (!client.StreamEdlWindow(edlId, startSec, durSec, outputPath, format == "int16", chunkFrames)) {
+            return 1;
+        }
+    } else if (command == "edl-render-sharded") {
+        std::string edlPath = getNamedArg(args, "--edl");
+        std::string workersStr = getNamedArg(args, "--workers");
+        std::string startStr = getNamedArg(args, "--start");
+        std::string durStr = getNamedArg(args, "--dur");
+        std::string outputPath = getNamedArg(args, "--out");
+        std::string format = getNamedArg(args, "--format", "float");
+        std::string shardsStr = getNamedArg(args, "--shards");
+
+        if (edlPath.empty() || workersStr.empty() || startStr.empty() || durStr.empty() || outputPath.empty()) {
+            std::cout << "Error: edl-render-sharded command requires --edl <path.json> --workers <addr>,... --start <sec> --dur <sec> --out <path>" << std::endl;
+            return 1;
+        }
+
+        if (format != "float" && format != "int16") {
+            std::cout << "Error: format must be float or int16" << std::endl;
+            return 1;
+        }
+
+        std::vector<std::string> workers;
+        std::stringstream workerList(workersStr);
+        for (std::string address; std::getline(workerList, address, ',');) {
+            if (!address.empty()) {
+                workers.push_back(address);
+            }
+        }
+        if (workers.empty()) {
+            std::cout << "Error: --workers requires at least one server address" << std::endl;
+            return 1;
+        }
+
+        double startSec, durSec;
+        int numShards = static_cast<int>(workers.size());
+
+        try {
+            startSec = std::stod(startStr);
+            durSec = std::stod(durStr);
+            if (!shardsStr.empty()) {
+                numShards = std::stoi(shardsStr);
+            }
+        } catch (...) {
+            std::cout << "Error: invalid numeric parameter" << std::endl;
+            return 1;
+        }
+
+        if (numShards <= 0) {
+            std::cout << "Error: shard count must be positive" << std::endl;
+            return 1;
+        }
+
+        std::string jsonString, error;
+        audio_engine::Edl edl;
+        if (!juceaudioservice::EdlJson::readJsonFromFile(edlPath, jsonString, error) ||
+            !juceaudioservice::EdlJson::parseFromJson(jsonString, edl, error)) {
+            std::cout << "Failed to load EDL: " << error << std::endl;
+            return 1;
+        }
+
+        ShardedRenderClient coordinator(workers);
+        std::string revision;
+        if (!coordinator.PushEdl(edl, revision) ||
+            !coordinator.Render(edl, revision, startSec, durSec, outputPath, format == "int16", numShards)) {
             return 1;
         }
     } else if (command == "subscribe") {
@@ -491,6 +1280,10 @@ int main(int argc, char** argv) {
         if (!client.Subscribe(edlId)) {
             return 1;
         }
+    } else if (command == "stats") {
+        if (!client.GetStats(hasNamedArg(args, "--prometheus"))) {
+            return 1;
+        }
     } else {
         std::cout << "Error: unknown command: " << command << std::endl;
         printUsage(argv[0]);
@@ -5,6 +5,9 @@
 #include <fstream>
 #include <thread>
 #include <chrono>
+#include <deque>
+#include <functional>
+#include <set>
 #include <sstream>
 #include <iomanip>
 
@@ -14,19 +17,26 @@
 
 #include "audio_engine.grpc.pb.h"
 #include "JuceAudioService/AudioFileSource.h"
-#include "JuceAudioService/OfflineRenderer.h"
 #include "edl/EdlStore.h"
 #include "edl/EdlCompiler.h"
 #include "edl/EdlRenderer.h"
+#include "edl/MediaPageCache.h"
+#include "edl/RenderBlockCache.h"
+#include "edl/RenderCache.h"
 #include "util/EdlJson.h"
+#include "util/EventBroadcaster.h"
+#include "util/HashingOutputStream.h"
+#include "util/MediaInfoCache.h"
+#include "util/MetricsHttpServer.h"
+#include "util/RenderScheduler.h"
+#include "util/Telemetry.h"
+#include "util/WavStreamWriter.h"
 
 #include <juce_core/juce_core.h>
 #include <juce_audio_formats/juce_audio_formats.h>
-#include <openssl/sha.h>
 #include <queue>
 #include <atomic>
 #include <condition_variable>
-#include <set>
 
 using grpc::Server;
 using grpc::ServerBuilder;
@@ -36,82 +46,42 @@ using grpc::Status;
 using grpc::StatusCode;
 
 namespace fs = std::filesystem;
+using juceaudioservice::requestLog;
+using juceaudioservice::Telemetry;
 
-// Event broadcasting system
-class EventBroadcaster {
-public:
-    using Subscriber = grpc::ServerWriter<audio_engine::EngineEvent>*;
-
-    void subscribe(Subscriber writer) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        subscribers_.insert(writer);
-    }
-
-    void unsubscribe(Subscriber writer) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        subscribers_.erase(writer);
-    }
+class AudioEngineServiceImpl final : public audio_engine::AudioEngine::Service {
+private:
+    // Runs a render job and returns once it has run; false if the scheduler turned it away
+    using RenderDispatch = std::function<bool(const juceaudioservice::RenderScheduler::Job&)>;
 
-    void broadcast(const audio_engine::EngineEvent& event) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (auto writer : subscribers_) {
-            if (writer) {
-                writer->Write(event);
-            }
-        }
-    }
+    // Bounds for StreamEdlWindow chunk_frames
+    static constexpr int minStreamChunkFrames = 64;
+    static constexpr int maxStreamChunkFrames = 65536;
 
-private:
-    std::mutex mutex_;
-    std::set<Subscriber> subscribers_;
-};
+    // Most windows one RenderEdlWindows call may ask for
+    static constexpr int maxBatchWindows = 256;
 
-class AudioEngineServiceImpl final : public audio_engine::AudioEngine::Service {
-private:
+    // Most recently loaded file; renders open their own source on it
+    std::mutex sourceMutex_;
     std::unique_ptr<juceaudioservice::AudioFileSource> currentAudioSource;
-    std::unique_ptr<juceaudioservice::OfflineRenderer> renderer;
+    std::string currentFilePath_;
 
     // EDL components
     juceaudioservice::EdlStore edlStore_;
-    juceaudioservice::EdlCompiler edlCompiler_;
-    juceaudioservice::EdlRenderer edlRenderer_;
-
-    // Event broadcasting
-    EventBroadcaster eventBroadcaster_;
-    std::atomic<bool> running_{true};
-
-    std::string calculateSHA256(const std::string& filePath) {
-        std::ifstream file(filePath, std::ios::binary);
-        if (!file.is_open()) {
-            std::cerr << "[gRPC] Failed to open file for SHA256: " << filePath << std::endl;
-            return "";
-        }
 
-        unsigned char hash[SHA256_DIGEST_LENGTH];
-        SHA256_CTX sha256;
-        SHA256_Init(&sha256);
+    // Render jobs run on the scheduler; each worker has its own EDL renderer
+    juceaudioservice::RenderScheduler renderScheduler_;
 
-        char buffer[8192];
-        while (file.read(buffer, sizeof(buffer))) {
-            SHA256_Update(&sha256, buffer, file.gcount());
-        }
-        if (file.gcount() > 0) {
-            SHA256_Update(&sha256, buffer, file.gcount());
-        }
-
-        if (file.bad()) {
-            std::cerr << "[gRPC] Error reading file for SHA256: " << filePath << std::endl;
-            return "";
-        }
+    // Mixed blocks shared by every renderer below; null when disabled
+    std::unique_ptr<juceaudioservice::RenderBlockCache> renderBlockCache_;
+    std::vector<std::unique_ptr<juceaudioservice::EdlRenderer>> edlRenderers_;
 
-        SHA256_Final(hash, &sha256);
+    // Finished RenderEdlWindow outputs; null when disabled
+    std::unique_ptr<juceaudioservice::RenderCache> renderCache_;
 
-        std::stringstream ss;
-        for (int i = 0; i < SHA256_DIGEST_LENGTH; ++i) {
-            ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
-        }
-        return ss.str();
-    }
+    // Fans events out to Subscribe streams; never waits on a slow client
+    juceaudioservice::EventBroadcaster eventBroadcaster_;
+    std::atomic<bool> running_{true};
 
     // Helper method to load a file into currentAudioSource
     Status loadFileInternal(const std::string& inputPath, std::string& resolvedPath) {
@@ -127,12 +97,9 @@ private:
                          "File not found: " + file.getFullPathName().toStdString());
         }
 
-        // Validate audio format using JUCE AudioFormatManager
-        juce::AudioFormatManager formatManager;
-        formatManager.registerBasicFormats();
-
-        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
-        if (!reader) {
+        // Validate audio format (cached until the file changes)
+        juceaudioservice::MediaInfoCache::Info mediaInfo;
+        if (!juceaudioservice::MediaInfoCache::getInstance().probe(file, mediaInfo)) {
             return Status(StatusCode::INVALID_ARGUMENT,
                          "Unsupported or unreadable audio file: " + file.getFullPathName().toStdString());
         }
@@ -149,99 +116,53 @@ private:
 
         // Store resolved path for caller
         resolvedPath = file.getFullPathName().toStdString();
+        currentFilePath_ = resolvedPath;
         return Status::OK;
     }
 
-public:
-    AudioEngineServiceImpl() : renderer(std::make_unique<juceaudioservice::OfflineRenderer>()) {
-        std::cout << "[gRPC] AudioEngine service initialized" << std::endl;
-    }
-
-    Status LoadFile(ServerContext* context, const audio_engine::LoadFileRequest* request,
-                   audio_engine::LoadFileResponse* response) override {
+    // Reject a render because the scheduler is saturated
+    Status renderQueueFull() {
+        Telemetry::getInstance().add(Telemetry::Counter::RendersRejected);
 
-        std::cout << "[gRPC] LoadFile request for: " << request->file_path() << std::endl;
-
-        const std::string& inputPath = request->file_path();
-        std::string resolvedPath;
+        auto stats = renderScheduler_.getStats();
+        requestLog() << "[gRPC] Render rejected: " << stats.running << " running, "
+                     << stats.queued << " queued" << std::endl;
+        return Status(StatusCode::RESOURCE_EXHAUSTED,
+                      "Render queue is full (" + std::to_string(renderScheduler_.getNumWorkers()) + " running, " +
+                      std::to_string(renderScheduler_.getMaxQueuedJobs()) + " queued); retry later");
+    }
 
-        // Use helper method to load the file
-        Status loadStatus = loadFileInternal(inputPath, resolvedPath);
-        if (!loadStatus.ok()) {
-            return loadStatus;
+    // Count a finished EDL render; seconds run from when its job started, so queueing is excluded
+    static void recordRender(bool success, juce::int64 frames, int sampleRate, double seconds) {
+        auto& telemetry = Telemetry::getInstance();
+        if (!success) {
+            telemetry.add(Telemetry::Counter::RendersFailed);
+            return;
         }
 
-        // Success - populate response with file info
-        response->set_success(true);
-        response->set_message("File loaded successfully");
-
-        auto* fileInfo = response->mutable_file_info();
-        fileInfo->set_path(resolvedPath);
-        fileInfo->set_sample_rate(static_cast<int32_t>(currentAudioSource->getSampleRate()));
-        fileInfo->set_num_channels(currentAudioSource->getNumChannels());
-
-        double sampleRate = currentAudioSource->getSampleRate();
-        if (sampleRate > 0) {
-            fileInfo->set_duration_seconds(static_cast<double>(currentAudioSource->getTotalLength()) / sampleRate);
+        telemetry.add(Telemetry::Counter::RendersCompleted);
+        telemetry.add(Telemetry::Counter::FramesRendered, static_cast<uint64_t>(std::max<juce::int64>(0, frames)));
+        telemetry.recordStage(Telemetry::Stage::Render, seconds);
+        if (seconds > 0.0 && sampleRate > 0) {
+            telemetry.recordRealtimeFactor(static_cast<double>(frames) / sampleRate / seconds);
         }
-
-        // Get file size from resolved path
-        juce::File file(resolvedPath);
-        fileInfo->set_file_size_bytes(file.getSize());
-
-        std::cout << "[gRPC] LoadFile successful: " << resolvedPath << " ("
-                  << fileInfo->duration_seconds() << "s, "
-                  << fileInfo->sample_rate() << "Hz, "
-                  << fileInfo->num_channels() << " channels)" << std::endl;
-
-        return Status::OK;
     }
 
-    Status Render(ServerContext* context, const audio_engine::RenderRequest* request,
-                 ServerWriter<audio_engine::RenderResponse>* writer) override {
-
-        std::cout << "[gRPC] Render request: " << request->input_file()
-                  << " -> " << request->output_file() << std::endl;
-
-        // Lazy-load if nothing is loaded yet
-        if (!currentAudioSource || !currentAudioSource->isLoaded()) {
-            const std::string& inputFile = request->input_file();
-            if (inputFile.empty()) {
-            audio_engine::RenderResponse response;
-            auto* error = response.mutable_error();
-            error->set_error_code("NO_FILE_LOADED");
-            error->set_error_message("No audio file is currently loaded and no input file provided.");
-            writer->Write(response);
-                std::cout << "[gRPC] Render failed: no file loaded and no input file provided" << std::endl;
-                return Status::OK;
-            }
-
-            // Attempt to lazy-load the input file
-            std::string resolvedPath;
-            Status loadStatus = loadFileInternal(inputFile, resolvedPath);
-            if (!loadStatus.ok()) {
-                audio_engine::RenderResponse response;
-                auto* error = response.mutable_error();
-                error->set_error_code("LAZY_LOAD_FAILED");
-                error->set_error_message("Failed to lazy-load input file: " + loadStatus.error_message());
-                writer->Write(response);
-                std::cout << "[gRPC] Render failed: lazy-load failed - " << loadStatus.error_message() << std::endl;
-                return Status::OK;
-            }
-
-            std::cout << "[gRPC] Lazy-loaded input for render: " << resolvedPath << std::endl;
-        }
+    // Render a loaded file to a float WAV, streaming progress to the client
+    template <typename Writer>
+    Status renderFile(grpc::ServerContextBase* context, const audio_engine::RenderRequest* request,
+                      Writer* writer, juceaudioservice::AudioFileSource& source) {
 
         auto startTime = std::chrono::steady_clock::now();
 
         try {
             // Get render parameters
-            double sampleRate = currentAudioSource->getSampleRate();
-            int numChannels = currentAudioSource->getNumChannels();
+            double sampleRate = source.getSampleRate();
+            int numChannels = source.getNumChannels();
 
             // Calculate start and end samples
             juce::int64 startSample = 0;
-            juce::int64 totalSamples = currentAudioSource->getTotalLength();
+            juce::int64 totalSamples = source.getTotalLength();
 
             if (request->has_start_time()) {
                 startSample = static_cast<juce::int64>(request->start_time() * sampleRate);
@@ -260,7 +181,7 @@ public:
                 error->set_error_code("INVALID_RANGE");
                 error->set_error_message("Invalid time range specified");
                 writer->Write(response);
-                std::cout << "[gRPC] Render failed: invalid time range" << std::endl;
+                requestLog() << "[gRPC] Render failed: invalid time range" << std::endl;
                 return Status::OK;
             }
 
@@ -271,44 +192,62 @@ public:
             progress->set_status_message("Starting render...");
             writer->Write(progressResponse);
 
-            // Set position and render
-            currentAudioSource->setPosition(startSample);
+            // Open the output before rendering so a bad path fails fast
+            juce::File outputFile(request->output_file());
+            if (outputFile.exists()) {
+                outputFile.deleteFile();
+            }
 
-            constexpr int blockSize = 44100; // 1 second at 44.1kHz
-            juce::AudioBuffer<float> outputBuffer;
+            // Hashed as it is written, so the SHA-256 needs no second pass over the file
+            std::unique_ptr<juce::OutputStream> outputStream(outputFile.createOutputStream());
+            std::unique_ptr<juceaudioservice::HashingOutputStream> hashingStream;
+            std::unique_ptr<juceaudioservice::WavStreamWriter> wavWriter;
+            if (outputStream) {
+                hashingStream = std::make_unique<juceaudioservice::HashingOutputStream>(std::move(outputStream));
+                wavWriter = std::make_unique<juceaudioservice::WavStreamWriter>(
+                    *hashingStream, static_cast<int>(sampleRate), numChannels, 32, numSamplesToRender);
+            }
 
-            // Render in chunks for progress updates
-            juce::int64 samplesRendered = 0;
+            if (!wavWriter || !wavWriter->isValid()) {
+                audio_engine::RenderResponse response;
+                auto* error = response.mutable_error();
+                error->set_error_code("FILE_WRITE_ERROR");
+                error->set_error_message("Cannot create output file: " + request->output_file());
+                writer->Write(response);
+                requestLog() << "[gRPC] Render failed: cannot create output file" << std::endl;
+                return Status::OK;
+            }
+
+            // Stream blocks from the source straight into the writer; memory use is one block
+            constexpr int blockSize = 65536;
+            const auto progressInterval = std::chrono::milliseconds(100);
+
+            juce::AudioBuffer<float> blockBuffer(numChannels, blockSize);
+            source.setPosition(startSample);
 
-            std::vector<float> allSamples;
-            allSamples.reserve(static_cast<size_t>(numSamplesToRender * numChannels));
+            juce::int64 samplesRendered = 0;
+            auto lastProgress = startTime;
 
             while (samplesRendered < numSamplesToRender && !context->IsCancelled()) {
-                juce::int64 samplesThisBlock = std::min(static_cast<juce::int64>(blockSize),
-                                                       numSamplesToRender - samplesRendered);
-
-                auto blockBuffer = renderer->renderWindow(
-                    *currentAudioSource,
-                    startSample + samplesRendered,
-                    static_cast<int>(samplesThisBlock),
-                    sampleRate,
-                    sampleRate,
-                    numChannels
-                );
-
-                // Append samples to output vector
-                for (int channel = 0; channel < numChannels; ++channel) {
-                    const float* channelData = blockBuffer.getReadPointer(channel);
-                    for (int sample = 0; sample < samplesThisBlock; ++sample) {
-                        allSamples.push_back(channelData[sample]);
-                    }
+                int samplesThisBlock = static_cast<int>(std::min(static_cast<juce::int64>(blockSize),
+                                                                 numSamplesToRender - samplesRendered));
+
+                source.getNextAudioBlock(juce::AudioSourceChannelInfo(&blockBuffer, 0, samplesThisBlock));
+
+                if (!wavWriter->write(blockBuffer, 0, samplesThisBlock)) {
+                    throw std::runtime_error("failed to write audio data to " + request->output_file());
                 }
 
                 samplesRendered += samplesThisBlock;
 
-                // Send progress update
-                double progressPercent = (static_cast<double>(samplesRendered) / numSamplesToRender) * 100.0;
+                // Progress goes out at a fixed rate, not once per block
                 auto now = std::chrono::steady_clock::now();
+                if (now - lastProgress < progressInterval && samplesRendered < numSamplesToRender) {
+                    continue;
+                }
+                lastProgress = now;
+
+                double progressPercent = (static_cast<double>(samplesRendered) / numSamplesToRender) * 100.0;
                 auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime).count() / 1000.0;
 
                 audio_engine::RenderResponse progressResp;
@@ -323,66 +262,30 @@ public:
                 }
 
                 writer->Write(progressResp);
-
-                // Small delay to prevent flooding
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
             }
 
             if (context->IsCancelled()) {
-                std::cout << "[gRPC] Render cancelled by client" << std::endl;
+                requestLog() << "[gRPC] Render cancelled by client" << std::endl;
+                hashingStream.reset();
+                outputFile.deleteFile();
                 return Status::CANCELLED;
             }
 
-            // Write output file (simplified WAV writer)
-            std::ofstream outFile(request->output_file(), std::ios::binary);
-            if (!outFile) {
-                audio_engine::RenderResponse response;
-                auto* error = response.mutable_error();
-                error->set_error_code("FILE_WRITE_ERROR");
-                error->set_error_message("Cannot create output file: " + request->output_file());
-                writer->Write(response);
-                std::cout << "[gRPC] Render failed: cannot create output file" << std::endl;
-                return Status::OK;
+            if (!wavWriter->finish()) {
+                throw std::runtime_error("failed to finish " + request->output_file());
             }
 
-            // Simple WAV header
-            uint32_t sampleRateInt = static_cast<uint32_t>(sampleRate);
-            uint32_t dataSize = static_cast<uint32_t>(allSamples.size() * sizeof(float));
-            uint32_t fileSize = 36 + dataSize;
-
-            outFile.write("RIFF", 4);
-            outFile.write(reinterpret_cast<const char*>(&fileSize), 4);
-            outFile.write("WAVE", 4);
-            outFile.write("fmt ", 4);
-
-            uint32_t fmtSize = 16;
-            uint16_t audioFormat = 3; // IEEE float
-            uint16_t numChannelsShort = static_cast<uint16_t>(numChannels);
-            uint32_t byteRate = sampleRateInt * numChannels * sizeof(float);
-            uint16_t blockAlign = static_cast<uint16_t>(numChannels * sizeof(float));
-            uint16_t bitsPerSample = 32;
-
-            outFile.write(reinterpret_cast<const char*>(&fmtSize), 4);
-            outFile.write(reinterpret_cast<const char*>(&audioFormat), 2);
-            outFile.write(reinterpret_cast<const char*>(&numChannelsShort), 2);
-            outFile.write(reinterpret_cast<const char*>(&sampleRateInt), 4);
-            outFile.write(reinterpret_cast<const char*>(&byteRate), 4);
-            outFile.write(reinterpret_cast<const char*>(&blockAlign), 2);
-            outFile.write(reinterpret_cast<const char*>(&bitsPerSample), 2);
-
-            outFile.write("data", 4);
-            outFile.write(reinterpret_cast<const char*>(&dataSize), 4);
-            outFile.write(reinterpret_cast<const char*>(allSamples.data()), dataSize);
-
-            outFile.close();
+            std::string sha256Hash = hashingStream->getHexDigest();
+            hashingStream.reset(); // Closes the file
+            if (sha256Hash.empty()) {
+                outputFile.deleteFile();
+                throw std::runtime_error("failed to hash " + request->output_file());
+            }
 
             // Calculate final duration and file size
             auto endTime = std::chrono::steady_clock::now();
             auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() / 1000.0;
 
-            // Calculate SHA256
-            std::string sha256Hash = calculateSHA256(request->output_file());
-
             // Send completion response
             audio_engine::RenderResponse completeResponse;
             auto* complete = completeResponse.mutable_complete();
@@ -398,8 +301,8 @@ public:
 
             writer->Write(completeResponse);
 
-            std::cout << "[gRPC] Render completed successfully: " << request->output_file()
-                      << " (" << totalDuration << "s, SHA256: " << sha256Hash.substr(0, 16) << "...)" << std::endl;
+            requestLog() << "[gRPC] Render completed successfully: " << request->output_file()
+                         << " (" << totalDuration << "s, SHA256: " << sha256Hash.substr(0, 16) << "...)" << std::endl;
 
         } catch (const std::exception& e) {
             audio_engine::RenderResponse response;
@@ -407,16 +310,155 @@ public:
             error->set_error_code("RENDER_ERROR");
             error->set_error_message("Render failed: " + std::string(e.what()));
             writer->Write(response);
-            std::cout << "[gRPC] Render failed with exception: " << e.what() << std::endl;
+            requestLog() << "[gRPC] Render failed with exception: " << e.what() << std::endl;
         }
 
         return Status::OK;
     }
 
-    Status UpdateEdl(ServerContext* context, const audio_engine::UpdateEdlRequest* request,
-                    audio_engine::UpdateEdlResponse* response) override {
+public:
+    AudioEngineServiceImpl(int renderThreads, int renderQueueSize,
+                           const juce::File& renderCacheDir, juce::int64 renderCacheBytes,
+                           size_t blockCacheBytes, int segmentThreads, int trackThreads)
+        : renderScheduler_(renderThreads, renderQueueSize) {
+        if (blockCacheBytes > 0) {
+            renderBlockCache_ = std::make_unique<juceaudioservice::RenderBlockCache>(
+                juceaudioservice::EdlRenderer::getBlockSize(), blockCacheBytes);
+            std::cout << "[gRPC] Block reuse cache: " << blockCacheBytes / (1024 * 1024) << " MB" << std::endl;
+        }
 
-        std::cout << "[gRPC] UpdateEdl request for EDL: " << request->edl().id() << std::endl;
+        for (int i = 0; i < renderScheduler_.getNumWorkers(); ++i) {
+            edlRenderers_.push_back(std::make_unique<juceaudioservice::EdlRenderer>());
+            edlRenderers_.back()->setBlockCache(renderBlockCache_.get());
+            edlRenderers_.back()->setNumSegmentThreads(segmentThreads);
+            edlRenderers_.back()->setNumWorkerThreads(trackThreads);
+        }
+
+        if (renderCacheBytes > 0) {
+            renderCache_ = std::make_unique<juceaudioservice::RenderCache>(renderCacheDir, renderCacheBytes);
+            auto stats = renderCache_->getStats();
+            std::cout << "[gRPC] Render cache: " << renderCacheDir.getFullPathName() << " ("
+                      << stats.numEntries << " entries, " << stats.bytesUsed / (1024 * 1024) << " of "
+                      << renderCacheBytes / (1024 * 1024) << " MB)" << std::endl;
+        }
+
+        std::cout << "[gRPC] AudioEngine service initialized (" << renderScheduler_.getNumWorkers()
+                  << " render threads, queue " << renderScheduler_.getMaxQueuedJobs() << ")" << std::endl;
+    }
+
+private:
+    friend class AudioEngineCallbackService;
+
+    // Handler bodies, shared by the sync service and AudioEngineCallbackService. Streaming
+    // bodies take the writer as a template parameter and run render jobs through dispatch.
+    Status loadFile(const audio_engine::LoadFileRequest* request, audio_engine::LoadFileResponse* response) {
+
+        requestLog() << "[gRPC] LoadFile request for: " << request->file_path() << std::endl;
+
+        const std::string& inputPath = request->file_path();
+        std::string resolvedPath;
+        std::lock_guard<std::mutex> lock(sourceMutex_);
+
+        // Use helper method to load the file
+        Status loadStatus = loadFileInternal(inputPath, resolvedPath);
+        if (!loadStatus.ok()) {
+            return loadStatus;
+        }
+
+        // Success - populate response with file info
+        response->set_success(true);
+        response->set_message("File loaded successfully");
+
+        auto* fileInfo = response->mutable_file_info();
+        fileInfo->set_path(resolvedPath);
+        fileInfo->set_sample_rate(static_cast<int32_t>(currentAudioSource->getSampleRate()));
+        fileInfo->set_num_channels(currentAudioSource->getNumChannels());
+
+        double sampleRate = currentAudioSource->getSampleRate();
+        if (sampleRate > 0) {
+            fileInfo->set_duration_seconds(static_cast<double>(currentAudioSource->getTotalLength()) / sampleRate);
+        }
+
+        // Get file size from resolved path
+        juce::File file(resolvedPath);
+        fileInfo->set_file_size_bytes(file.getSize());
+
+        requestLog() << "[gRPC] LoadFile successful: " << resolvedPath << " ("
+                     << fileInfo->duration_seconds() << "s, "
+                     << fileInfo->sample_rate() << "Hz, "
+                     << fileInfo->num_channels() << " channels)" << std::endl;
+
+        return Status::OK;
+    }
+
+    template <typename Writer>
+    Status render(grpc::ServerContextBase* context, const audio_engine::RenderRequest* request,
+                  Writer* writer, const RenderDispatch& dispatch) {
+
+        requestLog() << "[gRPC] Render request: " << request->input_file()
+                     << " -> " << request->output_file() << std::endl;
+
+        // Lazy-load if nothing is loaded yet
+        std::unique_lock<std::mutex> sourceLock(sourceMutex_);
+        if (!currentAudioSource || !currentAudioSource->isLoaded()) {
+            const std::string& inputFile = request->input_file();
+            if (inputFile.empty()) {
+            audio_engine::RenderResponse response;
+            auto* error = response.mutable_error();
+            error->set_error_code("NO_FILE_LOADED");
+            error->set_error_message("No audio file is currently loaded and no input file provided.");
+            writer->Write(response);
+                requestLog() << "[gRPC] Render failed: no file loaded and no input file provided" << std::endl;
+                return Status::OK;
+            }
+
+            // Attempt to lazy-load the input file
+            std::string resolvedPath;
+            Status loadStatus = loadFileInternal(inputFile, resolvedPath);
+            if (!loadStatus.ok()) {
+                audio_engine::RenderResponse response;
+                auto* error = response.mutable_error();
+                error->set_error_code("LAZY_LOAD_FAILED");
+                error->set_error_message("Failed to lazy-load input file: " + loadStatus.error_message());
+                writer->Write(response);
+                requestLog() << "[gRPC] Render failed: lazy-load failed - " << loadStatus.error_message() << std::endl;
+                return Status::OK;
+            }
+
+            requestLog() << "[gRPC] Lazy-loaded input for render: " << resolvedPath << std::endl;
+        }
+
+        std::string sourcePath = currentFilePath_;
+        sourceLock.unlock();
+
+        // Each job renders from its own source, so concurrent renders never share a read position
+        Status status;
+        bool accepted = dispatch([&](int) {
+            if (context->IsCancelled()) {
+                status = Status::CANCELLED;
+                return;
+            }
+
+            juceaudioservice::AudioFileSource source;
+            if (!source.loadFile(juce::File(sourcePath))) {
+                audio_engine::RenderResponse response;
+                auto* error = response.mutable_error();
+                error->set_error_code("FILE_LOAD_ERROR");
+                error->set_error_message("Failed to open audio file: " + sourcePath);
+                writer->Write(response);
+                requestLog() << "[gRPC] Render failed: cannot open " << sourcePath << std::endl;
+                return;
+            }
+
+            status = renderFile(context, request, writer, source);
+        });
+
+        return accepted ? status : renderQueueFull();
+    }
+
+    Status updateEdl(const audio_engine::UpdateEdlRequest* request, audio_engine::UpdateEdlResponse* response) {
+
+        requestLog() << "[gRPC] UpdateEdl request for EDL: " << request->edl().id() << std::endl;
 
         const auto& edl = request->edl();
 
@@ -424,12 +466,12 @@ public:
         juceaudioservice::EdlStore::Snapshot snapshot;
         std::string error;
 
-        std::cout << "[EDL][Validate] Starting validation for EDL: " << edl.id() << std::endl;
+        requestLog() << "[EDL][Validate] Starting validation for EDL: " << edl.id() << std::endl;
 
         bool success = edlStore_.replace(edl, snapshot, error);
 
         if (!success) {
-            std::cout << "[EDL][Validate] Failed for EDL " << edl.id() << ": " << error << std::endl;
+            requestLog() << "[EDL][Validate] Failed for EDL " << edl.id() << ": " << error << std::endl;
 
             // Broadcast error event
             audio_engine::EngineEvent errorEvent;
@@ -441,10 +483,10 @@ public:
             return Status(StatusCode::INVALID_ARGUMENT, error);
         }
 
-        std::cout << "[EDL][Apply] Successfully applied EDL: " << snapshot.edl.id()
-                  << " revision: " << snapshot.revision
-                  << " tracks: " << snapshot.track_count
-                  << " clips: " << snapshot.clip_count << std::endl;
+        requestLog() << "[EDL][Apply] Successfully applied EDL: " << snapshot.edl.id()
+                     << " revision: " << snapshot.revision
+                     << " tracks: " << snapshot.track_count
+                     << " clips: " << snapshot.clip_count << std::endl;
 
         // Populate response
         response->set_edl_id(snapshot.edl.id());
@@ -464,70 +506,110 @@ public:
         return Status::OK;
     }
 
-    Status RenderEdlWindow(ServerContext* context, const audio_engine::RenderEdlWindowRequest* request,
-                           ServerWriter<audio_engine::EngineEvent>* writer) override {
+    Status patchEdl(const audio_engine::PatchEdlRequest* request, audio_engine::PatchEdlResponse* response) {
 
-        std::cout << "[gRPC] RenderEdlWindow request for EDL: " << request->edl_id()
-                  << " range: " << request->range().start_samples() << "-"
-                  << (request->range().start_samples() + request->range().duration_samples()) << std::endl;
+        requestLog() << "[gRPC] PatchEdl request for EDL: " << request->edl_id()
+                     << " edits: " << request->edits_size() << std::endl;
+
+        juceaudioservice::EdlStore::PatchResult result;
+        std::string error;
+
+        if (!edlStore_.patch(*request, result, error)) {
+            requestLog() << "[EDL][Patch] Failed for EDL " << request->edl_id() << ": " << error << std::endl;
 
-        // Get current EDL snapshot
-        auto edlSnapshot = edlStore_.get();
-        if (!edlSnapshot) {
             audio_engine::EngineEvent errorEvent;
             auto* edlError = errorEvent.mutable_edl_error();
             edlError->set_edl_id(request->edl_id());
-            edlError->set_reason("No EDL currently loaded");
-            writer->Write(errorEvent);
-            return Status(StatusCode::NOT_FOUND, "No EDL currently loaded");
+            edlError->set_reason(error);
+            eventBroadcaster_.broadcast(errorEvent);
+
+            return Status(result.stale_base ? StatusCode::ABORTED : StatusCode::INVALID_ARGUMENT, error);
         }
 
-        if (edlSnapshot->edl.id() != request->edl_id()) {
-            audio_engine::EngineEvent errorEvent;
-            auto* edlError = errorEvent.mutable_edl_error();
-            edlError->set_edl_id(request->edl_id());
-            edlError->set_reason("EDL ID mismatch: requested '" + request->edl_id() +
-                               "' but current is '" + edlSnapshot->edl.id() + "'");
-            writer->Write(errorEvent);
-            return Status(StatusCode::NOT_FOUND, "EDL ID mismatch");
+        requestLog() << "[EDL][Patch] Applied " << request->edits_size() << " edits to EDL: " << result.edl_id
+                     << " revision: " << result.revision
+                     << " dirty tracks: " << result.dirty_track_ids.size() << std::endl;
+
+        // Populate response
+        response->set_edl_id(result.edl_id);
+        response->set_revision(result.revision);
+        response->set_track_count(result.track_count);
+        response->set_clip_count(result.clip_count);
+        for (const auto& trackId : result.dirty_track_ids) {
+            response->add_dirty_track_ids(trackId);
         }
 
-        // Compile EDL
-        juceaudioservice::EdlCompiler::CompiledEdl compiledEdl;
-        std::string error;
+        // Broadcast success event
+        audio_engine::EngineEvent appliedEvent;
+        auto* edlApplied = appliedEvent.mutable_edl_applied();
+        edlApplied->set_edl_id(result.edl_id);
+        edlApplied->set_revision(result.revision);
+        edlApplied->set_track_count(result.track_count);
+        edlApplied->set_clip_count(result.clip_count);
+        eventBroadcaster_.broadcast(appliedEvent);
 
-        std::cout << "[EDL][Compile] Starting compilation for render..." << std::endl;
+        return Status::OK;
+    }
 
-        if (!edlCompiler_.compile(*edlSnapshot, compiledEdl, error)) {
-            std::cout << "[EDL][Compile] Failed: " << error << std::endl;
+    // Get the compiled timeline of the current revision (built when it was applied), reporting why not to the client
+    template <typename Writer>
+    Status getCompiledForRender(const std::string& edlId, Writer* writer,
+                                std::shared_ptr<const juceaudioservice::EdlCompiler::CompiledEdl>& compiledEdl) {
+        compiledEdl = edlStore_.getCompiled();
+        if (!compiledEdl) {
+            bool hasEdl = edlStore_.hasEdl();
+            std::string reason = hasEdl ? "Compilation failed for current revision" : "No EDL currently loaded";
 
             audio_engine::EngineEvent errorEvent;
             auto* edlError = errorEvent.mutable_edl_error();
-            edlError->set_edl_id(request->edl_id());
-            edlError->set_reason("Compilation failed: " + error);
+            edlError->set_edl_id(edlId);
+            edlError->set_reason(reason);
+            writer->Write(errorEvent);
+            return Status(hasEdl ? StatusCode::INTERNAL : StatusCode::NOT_FOUND, reason);
+        }
+
+        if (compiledEdl->edl_id != edlId) {
+            audio_engine::EngineEvent errorEvent;
+            auto* edlError = errorEvent.mutable_edl_error();
+            edlError->set_edl_id(edlId);
+            edlError->set_reason("EDL ID mismatch: requested '" + edlId +
+                               "' but current is '" + compiledEdl->edl_id + "'");
             writer->Write(errorEvent);
-            return Status(StatusCode::INTERNAL, "EDL compilation failed: " + error);
+            return Status(StatusCode::NOT_FOUND, "EDL ID mismatch");
         }
 
-        // Determine bit depth
-        juceaudioservice::EdlRenderer::BitDepth bitDepth = juceaudioservice::EdlRenderer::BitDepth::Float32;
-        switch (request->bit_depth()) {
-            case 16: bitDepth = juceaudioservice::EdlRenderer::BitDepth::Int16; break;
-            case 24: bitDepth = juceaudioservice::EdlRenderer::BitDepth::Int24; break;
-            case 32: bitDepth = juceaudioservice::EdlRenderer::BitDepth::Float32; break;
+        return Status::OK;
+    }
+
+    static juceaudioservice::EdlRenderer::BitDepth parseBitDepth(int bitDepth) {
+        switch (bitDepth) {
+            case 16: return juceaudioservice::EdlRenderer::BitDepth::Int16;
+            case 24: return juceaudioservice::EdlRenderer::BitDepth::Int24;
+            case 32: return juceaudioservice::EdlRenderer::BitDepth::Float32;
             default:
-                std::cout << "[EDL][Render] Invalid bit depth " << request->bit_depth() << ", using 32-bit float" << std::endl;
-                break;
+                requestLog() << "[EDL][Render] Invalid bit depth " << bitDepth << ", using 32-bit float" << std::endl;
+                return juceaudioservice::EdlRenderer::BitDepth::Float32;
+        }
+    }
+
+    static juceaudioservice::EdlRenderer::OutputFormat parseFormat(audio_engine::RenderEdlWindowRequest::Format format) {
+        switch (format) {
+            case audio_engine::RenderEdlWindowRequest::FLAC: return juceaudioservice::EdlRenderer::OutputFormat::Flac;
+            case audio_engine::RenderEdlWindowRequest::WAV:
+            default: return juceaudioservice::EdlRenderer::OutputFormat::Wav;
         }
+    }
 
-        // Setup progress callback
-        auto progressCallback = [writer, this](double fraction) {
+    // Progress events with an ETA measured from now
+    template <typename Writer>
+    static juceaudioservice::EdlRenderer::ProgressCallback makeProgressCallback(Writer* writer) {
+        auto startTime = std::chrono::steady_clock::now();
+        return [writer, startTime](double fraction) {
             audio_engine::EngineEvent progressEvent;
             auto* progress = progressEvent.mutable_progress();
             progress->set_fraction(fraction);
 
             // Calculate ETA
-            static auto startTime = std::chrono::steady_clock::now();
             if (fraction > 0.01) { // Only calculate ETA after 1%
                 auto elapsed = std::chrono::steady_clock::now() - startTime;
                 auto totalTime = elapsed / fraction;
@@ -541,53 +623,374 @@ public:
 
             writer->Write(progressEvent);
         };
+    }
 
-        // Render to WAV file
-        std::cout << "[EDL][Render] Starting render to: " << request->out_path() << std::endl;
+    template <typename Writer>
+    Status renderEdlWindow(grpc::ServerContextBase* context, const audio_engine::RenderEdlWindowRequest* request,
+                           Writer* writer, const RenderDispatch& dispatch) {
 
-        bool renderSuccess = edlRenderer_.renderToWav(compiledEdl, request->range(),
-                                                     request->out_path(), bitDepth,
-                                                     progressCallback, error);
+        requestLog() << "[gRPC] RenderEdlWindow request for EDL: " << request->edl_id()
+                     << " range: " << request->range().start_samples() << "-"
+                     << (request->range().start_samples() + request->range().duration_samples()) << std::endl;
 
-        if (!renderSuccess) {
-            std::cout << "[EDL][Render] Failed: " << error << std::endl;
-            return Status(StatusCode::INTERNAL, "Render failed: " + error);
+        std::shared_ptr<const juceaudioservice::EdlCompiler::CompiledEdl> compiledEdl;
+        Status lookup = getCompiledForRender(request->edl_id(), writer, compiledEdl);
+        if (!lookup.ok()) {
+            return lookup;
         }
 
-        // Calculate output file info
-        juce::File outputFile(request->out_path());
-        double durationSeconds = static_cast<double>(request->range().duration_samples()) / compiledEdl.sample_rate;
-        std::string sha256Hash = calculateSHA256(request->out_path());
+        std::string error;
+        const auto bitDepth = parseBitDepth(request->bit_depth());
+        const auto format = parseFormat(request->format());
+
+        const double durationSeconds = static_cast<double>(request->range().duration_samples()) / compiledEdl->sample_rate;
+        auto sendComplete = [writer, request, durationSeconds](const std::string& sha256) {
+            audio_engine::EngineEvent completeEvent;
+            auto* complete = completeEvent.mutable_complete();
+            complete->set_out_path(request->out_path());
+            complete->set_duration_sec(durationSeconds);
+            complete->set_sha256(sha256);
+            writer->Write(completeEvent);
+        };
 
-        // Send completion event
-        audio_engine::EngineEvent completeEvent;
-        auto* complete = completeEvent.mutable_complete();
-        complete->set_out_path(request->out_path());
-        complete->set_duration_sec(durationSeconds);
-        complete->set_sha256(sha256Hash);
-        writer->Write(completeEvent);
+        // Identical requests for the same revision are answered from the render cache
+        std::string cacheKey;
+        if (renderCache_) {
+            cacheKey = juceaudioservice::RenderCache::makeKey(*compiledEdl, request->range(), static_cast<int>(bitDepth),
+                                                              juceaudioservice::EdlRenderer::getFormatName(format));
+
+            std::string cachedHash;
+            if (renderCache_->fetch(cacheKey, request->out_path(), cachedHash)) {
+                sendComplete(cachedHash);
+                requestLog() << "[EDL][Render] Served from render cache: " << request->out_path()
+                             << " (SHA256: " << cachedHash.substr(0, 16) << "...)" << std::endl;
+                return Status::OK;
+            }
+        }
+
+        auto progressCallback = makeProgressCallback(writer);
+
+        // Render to WAV file on a scheduler worker, with that worker's renderer
+        bool renderSuccess = false;
+        std::string sha256Hash;
+        bool accepted = dispatch([&](int workerIndex) {
+            if (context->IsCancelled()) {
+                error = "Cancelled before the render started";
+                return;
+            }
+
+            requestLog() << "[EDL][Render] Starting " << juceaudioservice::EdlRenderer::getFormatName(format)
+                         << " render to: " << request->out_path() << std::endl;
+            const auto jobStart = std::chrono::steady_clock::now();
+            renderSuccess = edlRenderers_[static_cast<size_t>(workerIndex)]->renderToFile(
+                *compiledEdl, request->range(), request->out_path(), format, bitDepth, progressCallback,
+                sha256Hash, error);
+            recordRender(renderSuccess, request->range().duration_samples(), compiledEdl->sample_rate,
+                         Telemetry::secondsSince(jobStart));
+        });
+
+        if (!accepted) {
+            return renderQueueFull();
+        }
 
-        std::cout << "[EDL][Render] Completed successfully: " << request->out_path()
-                  << " (" << durationSeconds << "s, SHA256: " << sha256Hash.substr(0, 16) << "...)" << std::endl;
+        if (!renderSuccess) {
+            requestLog() << "[EDL][Render] Failed: " << error << std::endl;
+            return Status(StatusCode::INTERNAL, "Render failed: " + error);
+        }
+
+        if (renderCache_ && !renderCache_->store(cacheKey, request->out_path(), sha256Hash)) {
+            requestLog() << "[EDL][Render] Not cached: " << request->out_path() << std::endl;
+        }
+
+        // Send completion event
+        sendComplete(sha256Hash);
+
+        requestLog() << "[EDL][Render] Completed successfully: " << request->out_path()
+                     << " (" << durationSeconds << "s, SHA256: " << sha256Hash.substr(0, 16) << "...)" << std::endl;
 
         return Status::OK;
     }
 
-    Status Subscribe(ServerContext* context, const audio_engine::SubscribeRequest* request,
-                    ServerWriter<audio_engine::EngineEvent>* writer) override {
+    // Render many windows of one revision in a single job; overlapping ranges are mixed once
+    template <typename Writer>
+    Status renderEdlWindows(grpc::ServerContextBase* context, const audio_engine::RenderEdlWindowsRequest* request,
+                            Writer* writer, const RenderDispatch& dispatch) {
+
+        requestLog() << "[gRPC] RenderEdlWindows request for EDL: " << request->edl_id()
+                     << " windows: " << request->windows_size() << std::endl;
+
+        if (request->windows_size() == 0) {
+            return Status(StatusCode::INVALID_ARGUMENT, "No windows requested");
+        }
+
+        if (request->windows_size() > maxBatchWindows) {
+            return Status(StatusCode::INVALID_ARGUMENT,
+                          "Too many windows: " + std::to_string(request->windows_size()) + " (limit " +
+                          std::to_string(maxBatchWindows) + ")");
+        }
+
+        std::set<std::string> outPaths;
+        for (const auto& window : request->windows()) {
+            if (!outPaths.insert(window.out_path()).second) {
+                return Status(StatusCode::INVALID_ARGUMENT, "Duplicate out_path: " + window.out_path());
+            }
+        }
+
+        std::shared_ptr<const juceaudioservice::EdlCompiler::CompiledEdl> compiledEdl;
+        Status lookup = getCompiledForRender(request->edl_id(), writer, compiledEdl);
+        if (!lookup.ok()) {
+            return lookup;
+        }
+
+        const int sampleRate = compiledEdl->sample_rate;
+        auto sendComplete = [writer, request, sampleRate](int windowIndex, const std::string& sha256) {
+            const auto& window = request->windows(windowIndex);
+
+            audio_engine::EngineEvent completeEvent;
+            auto* complete = completeEvent.mutable_complete();
+            complete->set_out_path(window.out_path());
+            complete->set_duration_sec(static_cast<double>(window.range().duration_samples()) / sampleRate);
+            complete->set_sha256(sha256);
+            complete->set_window_index(windowIndex);
+            writer->Write(completeEvent);
+        };
+
+        // Windows the render cache can answer are done now; the rest are rendered together
+        std::vector<juceaudioservice::EdlRenderer::WindowOutput> pending;
+        std::vector<int> pendingIndices;
+        std::vector<std::string> cacheKeys;
+        for (int i = 0; i < request->windows_size(); ++i) {
+            const auto& window = request->windows(i);
+
+            juceaudioservice::EdlRenderer::WindowOutput output;
+            output.range = window.range();
+            output.outputPath = window.out_path();
+            output.bitDepth = parseBitDepth(window.bit_depth());
+
+            std::string cacheKey;
+            if (renderCache_) {
+                cacheKey = juceaudioservice::RenderCache::makeKey(*compiledEdl, window.range(),
+                                                                  static_cast<int>(output.bitDepth));
+
+                std::string cachedHash;
+                if (renderCache_->fetch(cacheKey, window.out_path(), cachedHash)) {
+                    sendComplete(i, cachedHash);
+                    continue;
+                }
+            }
+
+            pending.push_back(std::move(output));
+            pendingIndices.push_back(i);
+            cacheKeys.push_back(std::move(cacheKey));
+        }
+
+        const size_t numCached = static_cast<size_t>(request->windows_size()) - pending.size();
+        if (pending.empty()) {
+            requestLog() << "[EDL][Render] Served " << numCached << " windows from render cache" << std::endl;
+            return Status::OK;
+        }
+
+        int numFailed = 0;
+        auto windowCallback = [&](size_t index, const juceaudioservice::EdlRenderer::WindowResult& result) {
+            const int windowIndex = pendingIndices[index];
+
+            if (!result.success) {
+                ++numFailed;
+
+                audio_engine::EngineEvent errorEvent;
+                auto* edlError = errorEvent.mutable_edl_error();
+                edlError->set_edl_id(request->edl_id());
+                edlError->set_reason(result.error);
+                edlError->set_out_path(pending[index].outputPath);
+                writer->Write(errorEvent);
+                return;
+            }
+
+            if (renderCache_ && !renderCache_->store(cacheKeys[index], pending[index].outputPath, result.sha256)) {
+                requestLog() << "[EDL][Render] Not cached: " << pending[index].outputPath << std::endl;
+            }
+            sendComplete(windowIndex, result.sha256);
+        };
+
+        auto progressCallback = makeProgressCallback(writer);
+
+        bool started = false;
+        bool accepted = dispatch([&](int workerIndex) {
+            if (context->IsCancelled()) {
+                return;
+            }
+            started = true;
+
+            juce::int64 totalFrames = 0;
+            for (const auto& output : pending) {
+                totalFrames += std::max<juce::int64>(0, output.range.duration_samples());
+            }
+
+            std::vector<juceaudioservice::EdlRenderer::WindowResult> results;
+            const auto jobStart = std::chrono::steady_clock::now();
+            bool success = edlRenderers_[static_cast<size_t>(workerIndex)]->renderWindowsToWav(
+                *compiledEdl, pending, progressCallback, windowCallback, results);
+            recordRender(success, totalFrames, sampleRate, Telemetry::secondsSince(jobStart));
+        });
+
+        if (!accepted) {
+            return renderQueueFull();
+        }
+
+        if (!started) {
+            return Status(StatusCode::CANCELLED, "Cancelled before the render started");
+        }
+
+        requestLog() << "[EDL][Render] Batch finished: " << (pending.size() - static_cast<size_t>(numFailed))
+                     << " rendered, " << numCached << " from cache, " << numFailed << " failed" << std::endl;
+
+        if (numFailed > 0) {
+            return Status(StatusCode::INTERNAL, std::to_string(numFailed) + " of " +
+                          std::to_string(request->windows_size()) + " windows failed");
+        }
+
+        return Status::OK;
+    }
+
+    template <typename Writer>
+    Status streamEdlWindow(grpc::ServerContextBase* context, const audio_engine::StreamEdlWindowRequest* request,
+                           Writer* writer, const RenderDispatch& dispatch) {
+
+        requestLog() << "[gRPC] StreamEdlWindow request for EDL: " << request->edl_id()
+                     << " range: " << request->range().start_samples() << "-"
+                     << (request->range().start_samples() + request->range().duration_samples()) << std::endl;
+
+        auto compiledEdl = edlStore_.getCompiled();
+        if (!compiledEdl) {
+            bool hasEdl = edlStore_.hasEdl();
+            return Status(hasEdl ? StatusCode::INTERNAL : StatusCode::NOT_FOUND,
+                          hasEdl ? "Compilation failed for current revision" : "No EDL currently loaded");
+        }
+
+        if (compiledEdl->edl_id != request->edl_id()) {
+            return Status(StatusCode::NOT_FOUND, "EDL ID mismatch");
+        }
+
+        if (request->range().duration_samples() <= 0) {
+            return Status(StatusCode::INVALID_ARGUMENT, "Range duration must be positive");
+        }
+
+        const bool int16 = request->encoding() == audio_engine::PcmHeader::INT16;
+        const int bitsPerSample = int16 ? 16 : 32;
+        const int numChannels = juceaudioservice::EdlRenderer::getOutputChannelCount(*compiledEdl);
+        const size_t frameBytes = static_cast<size_t>(numChannels) * static_cast<size_t>(bitsPerSample / 8);
+
+        // Small chunks cost a message each; large ones delay the first audio
+        int chunkFrames = request->chunk_frames();
+        if (chunkFrames <= 0) {
+            chunkFrames = juceaudioservice::EdlRenderer::getBlockSize();
+        }
+        chunkFrames = juce::jlimit(minStreamChunkFrames, maxStreamChunkFrames, chunkFrames);
+
+        audio_engine::PcmStreamMessage headerMessage;
+        auto* header = headerMessage.mutable_header();
+        header->set_edl_id(compiledEdl->edl_id);
+        header->set_revision(compiledEdl->revision);
+        header->set_sample_rate(compiledEdl->sample_rate);
+        header->set_channels(numChannels);
+        header->set_encoding(int16 ? audio_engine::PcmHeader::INT16 : audio_engine::PcmHeader::FLOAT32);
+        header->set_total_frames(request->range().duration_samples());
+
+        // One message is reused for every chunk; its byte buffer keeps its capacity
+        audio_engine::PcmStreamMessage chunkMessage;
+        auto* chunk = chunkMessage.mutable_chunk();
+        std::string* data = chunk->mutable_data();
+        data->reserve(static_cast<size_t>(chunkFrames) * frameBytes);
+
+        juce::int64 chunkStart = 0;
+        int pendingFrames = 0;
+        bool clientGone = false;
+
+        auto flushChunk = [&]() -> bool {
+            chunk->set_start_frame(chunkStart);
+            chunk->set_num_frames(pendingFrames);
+            if (!writer->Write(chunkMessage)) {
+                clientGone = true;
+                return false;
+            }
+            chunkStart += pendingFrames;
+            pendingFrames = 0;
+            data->clear();
+            return true;
+        };
+
+        auto blockCallback = [&](const juce::AudioBuffer<float>& block, int numSamples) -> bool {
+            if (context->IsCancelled()) {
+                clientGone = true;
+                return false;
+            }
+
+            for (int offset = 0; offset < numSamples;) {
+                const int count = std::min(chunkFrames - pendingFrames, numSamples - offset);
+                const size_t used = data->size();
+                data->resize(used + static_cast<size_t>(count) * frameBytes);
+                juceaudioservice::WavStreamWriter::encodeFrames(block, offset, count, numChannels,
+                                                                bitsPerSample, data->data() + used);
+                pendingFrames += count;
+                offset += count;
+
+                if (pendingFrames == chunkFrames && !flushChunk()) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        bool renderSuccess = false;
+        std::string error;
+        bool accepted = dispatch([&](int workerIndex) {
+            // Sent once the job is admitted, so a rejected stream ends with no messages at all
+            if (!writer->Write(headerMessage)) {
+                clientGone = true;
+                return;
+            }
+
+            const auto jobStart = std::chrono::steady_clock::now();
+            renderSuccess = edlRenderers_[static_cast<size_t>(workerIndex)]->renderBlocks(
+                *compiledEdl, request->range(), blockCallback, nullptr, error);
+
+            if (renderSuccess && pendingFrames > 0) {
+                renderSuccess = flushChunk();
+            }
+
+            // A client that stopped reading is not a render failure
+            if (!clientGone) {
+                recordRender(renderSuccess, chunkStart, compiledEdl->sample_rate, Telemetry::secondsSince(jobStart));
+            }
+        });
+
+        if (!accepted) {
+            return renderQueueFull();
+        }
+
+        if (clientGone) {
+            requestLog() << "[EDL][Stream] Client went away after " << chunkStart << " frames" << std::endl;
+            return Status(StatusCode::CANCELLED, "Client stopped reading");
+        }
 
-        std::cout << "[gRPC] Subscribe request for session: " << request->session() << std::endl;
+        if (!renderSuccess) {
+            requestLog() << "[EDL][Stream] Failed: " << error << std::endl;
+            return Status(StatusCode::INTERNAL, "Render failed: " + error);
+        }
 
-        // Register subscriber
-        eventBroadcaster_.subscribe(writer);
+        requestLog() << "[EDL][Stream] Streamed " << chunkStart << " frames" << std::endl;
+        return Status::OK;
+    }
+
+    // Events a new subscriber starts with: backend status, then the current EDL if there is one
+    std::vector<audio_engine::EngineEvent> makeSubscribeSnapshot() {
+        std::vector<audio_engine::EngineEvent> events;
 
-        // Send initial backend status
         audio_engine::EngineEvent statusEvent;
         auto* backend = statusEvent.mutable_backend();
         backend->set_status("ready");
-        writer->Write(statusEvent);
+        events.push_back(std::move(statusEvent));
 
-        // Send current EDL status if available
         auto edlSnapshot = edlStore_.get();
         if (edlSnapshot) {
             audio_engine::EngineEvent edlEvent;
@@ -596,20 +999,237 @@ public:
             edlApplied->set_revision(edlSnapshot->revision);
             edlApplied->set_track_count(edlSnapshot->track_count);
             edlApplied->set_clip_count(edlSnapshot->clip_count);
-            writer->Write(edlEvent);
+            events.push_back(std::move(edlEvent));
+        }
+
+        return events;
+    }
+
+    Status getStats(const audio_engine::GetStatsRequest* request, audio_engine::GetStatsResponse* response) {
+        const auto& telemetry = Telemetry::getInstance();
+
+        for (int i = 0; i < Telemetry::numStages; ++i) {
+            const auto stage = static_cast<Telemetry::Stage>(i);
+            const auto histogram = telemetry.getStage(stage);
+
+            auto* stats = response->add_stages();
+            stats->set_stage(Telemetry::getStageName(stage));
+            stats->set_count(histogram.count);
+            stats->set_total_sec(histogram.sum);
+            stats->set_p50_sec(histogram.quantile(0.50));
+            stats->set_p95_sec(histogram.quantile(0.95));
+            stats->set_p99_sec(histogram.quantile(0.99));
+        }
+
+        response->set_renders_completed(telemetry.get(Telemetry::Counter::RendersCompleted));
+        response->set_renders_failed(telemetry.get(Telemetry::Counter::RendersFailed));
+        response->set_renders_rejected(telemetry.get(Telemetry::Counter::RendersRejected));
+        response->set_frames_rendered(telemetry.get(Telemetry::Counter::FramesRendered));
+
+        const auto realtimeFactor = telemetry.getRealtimeFactor();
+        response->set_realtime_factor_p50(realtimeFactor.quantile(0.50));
+        response->set_realtime_factor_p10(realtimeFactor.quantile(0.10));
+
+        const auto schedulerStats = renderScheduler_.getStats();
+        response->set_renders_running(schedulerStats.running);
+        response->set_renders_queued(schedulerStats.queued);
+
+        const auto& mediaCache = juceaudioservice::MediaPageCache::getInstance();
+        const auto mediaStats = mediaCache.getStats();
+        const uint64_t mediaReads = mediaStats.hits + mediaStats.misses;
+        response->set_media_cache_hits(mediaStats.hits);
+        response->set_media_cache_misses(mediaStats.misses);
+        response->set_media_cache_hit_rate(mediaReads > 0 ? static_cast<double>(mediaStats.hits) / mediaReads : 0.0);
+        response->set_media_cache_bytes(mediaStats.bytesUsed);
+
+        for (const auto& usage : mediaCache.getMediaUsage()) {
+            auto* media = response->add_media();
+            media->set_path(usage.path);
+            media->set_bytes_read(usage.bytesRead);
+            media->set_pages_decoded(usage.pagesDecoded);
+        }
+
+        if (renderCache_) {
+            const auto renderCacheStats = renderCache_->getStats();
+            response->set_render_cache_hits(renderCacheStats.hits);
+            response->set_render_cache_misses(renderCacheStats.misses);
         }
 
-        std::cout << "[gRPC][Event] Subscriber registered for session: " << request->session() << std::endl;
+        if (renderBlockCache_) {
+            const auto blockStats = renderBlockCache_->getStats();
+            response->set_blocks_reused(blockStats.reused);
+            response->set_blocks_rendered(blockStats.rendered);
+        }
+
+        const auto eventStats = eventBroadcaster_.getStats();
+        response->set_active_subscribers(static_cast<int>(eventStats.subscribers));
+        response->set_events_dropped(eventStats.dropped);
+
+        if (request->prometheus()) {
+            response->set_prometheus_text(renderPrometheus());
+        }
+
+        return Status::OK;
+    }
+
+    // Sync handlers block a gRPC thread in the scheduler until their render finishes
+    RenderDispatch waitForRender() {
+        return [this](const juceaudioservice::RenderScheduler::Job& job) { return renderScheduler_.run(job); };
+    }
+
+public:
+    // Everything GetStats reports, as a Prometheus text exposition
+    std::string renderPrometheus() {
+        using juceaudioservice::PrometheusText;
+
+        const auto& telemetry = Telemetry::getInstance();
+        PrometheusText text;
+
+        for (int i = 0; i < Telemetry::numStages; ++i) {
+            const auto stage = static_cast<Telemetry::Stage>(i);
+            text.addHistogram("juce_audio_service_stage_seconds", "Seconds each render request spent in a stage",
+                              telemetry.getStage(stage), PrometheusText::label("stage", Telemetry::getStageName(stage)));
+        }
+        text.addHistogram("juce_audio_service_realtime_factor", "Seconds of audio rendered per second of render time",
+                          telemetry.getRealtimeFactor());
+
+        const std::string rendersHelp = "EDL render requests by result";
+        text.addCounter("juce_audio_service_renders_total", rendersHelp,
+                        static_cast<double>(telemetry.get(Telemetry::Counter::RendersCompleted)),
+                        PrometheusText::label("result", "completed"));
+        text.addCounter("juce_audio_service_renders_total", rendersHelp,
+                        static_cast<double>(telemetry.get(Telemetry::Counter::RendersFailed)),
+                        PrometheusText::label("result", "failed"));
+        text.addCounter("juce_audio_service_renders_total", rendersHelp,
+                        static_cast<double>(telemetry.get(Telemetry::Counter::RendersRejected)),
+                        PrometheusText::label("result", "rejected"));
+        text.addCounter("juce_audio_service_frames_rendered_total", "Sample frames rendered by EDL renders",
+                        static_cast<double>(telemetry.get(Telemetry::Counter::FramesRendered)));
+
+        const auto schedulerStats = renderScheduler_.getStats();
+        text.addGauge("juce_audio_service_renders_running", "Render jobs running now", schedulerStats.running);
+        text.addGauge("juce_audio_service_renders_queued", "Render jobs waiting for a worker", schedulerStats.queued);
+
+        const auto& mediaCache = juceaudioservice::MediaPageCache::getInstance();
+        const auto mediaStats = mediaCache.getStats();
+        text.addCounter("juce_audio_service_media_cache_hits_total", "Media page reads served from the cache",
+                        static_cast<double>(mediaStats.hits));
+        text.addCounter("juce_audio_service_media_cache_misses_total", "Media page reads that decoded in place",
+                        static_cast<double>(mediaStats.misses));
+        text.addGauge("juce_audio_service_media_cache_bytes", "Decoded media held in the page cache",
+                      static_cast<double>(mediaStats.bytesUsed));
+        for (const auto& usage : mediaCache.getMediaUsage()) {
+            text.addCounter("juce_audio_service_media_bytes_read_total", "Encoded media bytes decoded, per file",
+                            static_cast<double>(usage.bytesRead), PrometheusText::label("path", usage.path));
+        }
+
+        if (renderCache_) {
+            const auto renderCacheStats = renderCache_->getStats();
+            text.addCounter("juce_audio_service_render_cache_hits_total", "Window renders served from the render cache",
+                            static_cast<double>(renderCacheStats.hits));
+            text.addCounter("juce_audio_service_render_cache_misses_total", "Window renders not found in the render cache",
+                            static_cast<double>(renderCacheStats.misses));
+        }
+
+        if (renderBlockCache_) {
+            const auto blockStats = renderBlockCache_->getStats();
+            text.addCounter("juce_audio_service_blocks_reused_total", "Mixed blocks reused from an earlier render",
+                            static_cast<double>(blockStats.reused));
+            text.addCounter("juce_audio_service_blocks_rendered_total", "Mixed blocks rendered and cached",
+                            static_cast<double>(blockStats.rendered));
+        }
+
+        const auto eventStats = eventBroadcaster_.getStats();
+        text.addGauge("juce_audio_service_subscribers", "Open Subscribe streams",
+                      static_cast<double>(eventStats.subscribers));
+        text.addCounter("juce_audio_service_events_dropped_total", "Progress and heartbeat events not delivered",
+                        static_cast<double>(eventStats.dropped));
+
+        return text.getText();
+    }
 
-        // Keep connection alive with periodic heartbeats
-        auto lastHeartbeat = std::chrono::steady_clock::now();
+    Status LoadFile(ServerContext* context, const audio_engine::LoadFileRequest* request,
+                    audio_engine::LoadFileResponse* response) override {
+        return loadFile(request, response);
+    }
+
+    Status Render(ServerContext* context, const audio_engine::RenderRequest* request,
+                  ServerWriter<audio_engine::RenderResponse>* writer) override {
+        return render(context, request, writer, waitForRender());
+    }
+
+    Status UpdateEdl(ServerContext* context, const audio_engine::UpdateEdlRequest* request,
+                     audio_engine::UpdateEdlResponse* response) override {
+        return updateEdl(request, response);
+    }
+
+    Status PatchEdl(ServerContext* context, const audio_engine::PatchEdlRequest* request,
+                    audio_engine::PatchEdlResponse* response) override {
+        return patchEdl(request, response);
+    }
+
+    Status RenderEdlWindow(ServerContext* context, const audio_engine::RenderEdlWindowRequest* request,
+                           ServerWriter<audio_engine::EngineEvent>* writer) override {
+        return renderEdlWindow(context, request, writer, waitForRender());
+    }
+
+    Status RenderEdlWindows(ServerContext* context, const audio_engine::RenderEdlWindowsRequest* request,
+                            ServerWriter<audio_engine::EngineEvent>* writer) override {
+        return renderEdlWindows(context, request, writer, waitForRender());
+    }
+
+    Status StreamEdlWindow(ServerContext* context, const audio_engine::StreamEdlWindowRequest* request,
+                           ServerWriter<audio_engine::PcmStreamMessage>* writer) override {
+        return streamEdlWindow(context, request, writer, waitForRender());
+    }
+
+    Status GetStats(ServerContext* context, const audio_engine::GetStatsRequest* request,
+                    audio_engine::GetStatsResponse* response) override {
+        return getStats(request, response);
+    }
+
+    Status Subscribe(ServerContext* context, const audio_engine::SubscribeRequest* request,
+                    ServerWriter<audio_engine::EngineEvent>* writer) override {
+
+        requestLog() << "[gRPC] Subscribe request for session: " << request->session() << std::endl;
+
+        // Register first so events applied while the snapshot below is sent are queued, not missed
+        auto subscription = eventBroadcaster_.subscribe();
+
+        for (const auto& event : makeSubscribeSnapshot()) {
+            writer->Write(event);
+        }
+
+        requestLog() << "[gRPC][Event] Subscriber registered for session: " << request->session() << std::endl;
+
+        // Forward queued events as they arrive; heartbeats fill the gaps between them
+        auto lastWrite = std::chrono::steady_clock::now();
         const auto heartbeatInterval = std::chrono::seconds(2);
+        const auto cancelPollInterval = std::chrono::milliseconds(250);
+        Status result = Status::OK;
 
         while (!context->IsCancelled() && running_) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            juceaudioservice::EventBroadcaster::EventPtr event;
+            const auto outcome = subscription->next(event, cancelPollInterval);
+
+            using Result = juceaudioservice::EventBroadcaster::Subscription::Result;
+            if (outcome == Result::Closed) {
+                break;
+            }
+            if (outcome == Result::Overflowed) {
+                requestLog() << "[gRPC][Event] Subscriber for session " << request->session()
+                             << " fell too far behind; closing its stream" << std::endl;
+                result = Status(StatusCode::RESOURCE_EXHAUSTED, "Event queue overflowed; resubscribe to resync");
+                break;
+            }
 
             auto now = std::chrono::steady_clock::now();
-            if (now - lastHeartbeat >= heartbeatInterval) {
+            if (outcome == Result::Event) {
+                if (!writer->Write(*event)) {
+                    break; // Client disconnected
+                }
+                lastWrite = now;
+            } else if (now - lastWrite >= heartbeatInterval) {
                 audio_engine::EngineEvent heartbeatEvent;
                 auto* heartbeat = heartbeatEvent.mutable_heartbeat();
                 auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -620,28 +1240,431 @@ public:
                     break; // Client disconnected
                 }
 
-                lastHeartbeat = now;
+                lastWrite = now;
             }
         }
 
         // Unregister subscriber
-        eventBroadcaster_.unsubscribe(writer);
-        std::cout << "[gRPC][Event] Subscriber disconnected for session: " << request->session() << std::endl;
+        eventBroadcaster_.unsubscribe(subscription);
+        requestLog() << "[gRPC][Event] Subscriber disconnected for session: " << request->session() << std::endl;
 
-        return Status::OK;
+        return result;
     }
 };
 
-void RunServer(int port = 50051) {
+// Server-streaming reactor fed by a handler body running on a render worker. Write() queues
+// the message and, like ServerWriter::Write, holds the worker while the client is behind;
+// no gRPC thread waits on the stream.
+template <typename Message>
+class WorkerStreamReactor final : public grpc::ServerWriteReactor<Message> {
+public:
+    static constexpr size_t maxQueuedMessages = 8;
+
+    // Returns false once the client has gone away
+    bool Write(const Message& message) {
+        const Message* toStart = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            spaceAvailable_.wait(lock, [this] { return queue_.size() < maxQueuedMessages || broken_; });
+            if (broken_) {
+                return false;
+            }
+
+            queue_.push_back(message);
+            if (!writing_) {
+                writing_ = true;
+                toStart = &queue_.front();
+            }
+        }
+
+        if (toStart) {
+            this->StartWrite(toStart);
+        }
+        return true;
+    }
+
+    // Called once, when the handler body returns; the status follows the queued messages
+    void finish(const Status& status) {
+        bool finishNow = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finishStatus_ = status;
+            finishRequested_ = true;
+            finishNow = !writing_;
+        }
+
+        if (finishNow) {
+            this->Finish(status);
+        }
+    }
+
+    void OnWriteDone(bool ok) override {
+        const Message* toStart = nullptr;
+        bool finishNow = false;
+        Status status;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.pop_front();
+            if (!ok) {
+                broken_ = true;
+                queue_.clear();
+            }
+            spaceAvailable_.notify_all();
+
+            if (!queue_.empty()) {
+                toStart = &queue_.front();
+            } else {
+                writing_ = false;
+                finishNow = finishRequested_;
+                status = finishStatus_;
+            }
+        }
+
+        if (toStart) {
+            this->StartWrite(toStart);
+        } else if (finishNow) {
+            this->Finish(status);
+        }
+    }
+
+    void OnCancel() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        broken_ = true;
+        spaceAvailable_.notify_all();
+    }
+
+    void OnDone() override {
+        delete this;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable spaceAvailable_;
+    std::deque<Message> queue_; // front is being written while writing_ is set
+    bool writing_ = false;
+    bool broken_ = false;
+    bool finishRequested_ = false;
+    Status finishStatus_;
+};
+
+// Subscribe stream as a reactor: it is woken by the broadcaster and costs no thread while idle
+class SubscribeReactor final : public grpc::ServerWriteReactor<audio_engine::EngineEvent> {
+public:
+    SubscribeReactor(juceaudioservice::EventBroadcaster& broadcaster, std::string session)
+        : broadcaster_(broadcaster),
+          session_(std::move(session)) {
+        auto subscription = broadcaster_.subscribe(juceaudioservice::EventBroadcaster::defaultQueueCapacity,
+                                                   [this] { pump(); });
+        std::lock_guard<std::mutex> lock(mutex_);
+        subscription_ = std::move(subscription);
+    }
+
+    // Send the snapshot, then whatever was broadcast since the subscription was made
+    void start(std::vector<audio_engine::EngineEvent> snapshot) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& event : snapshot) {
+                pending_.push_back(std::make_shared<const audio_engine::EngineEvent>(std::move(event)));
+            }
+            started_ = true;
+        }
+        pump();
+    }
+
+    void OnWriteDone(bool ok) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            writing_ = false;
+            current_.reset();
+            if (!ok) {
+                cancelled_ = true; // Client disconnected
+            }
+        }
+        pump();
+    }
+
+    void OnCancel() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cancelled_ = true;
+        }
+        pump();
+    }
+
+    void OnDone() override {
+        broadcaster_.unsubscribe(subscription_);
+        requestLog() << "[gRPC][Event] Subscriber disconnected for session: " << session_ << std::endl;
+        delete this;
+    }
+
+private:
+    using Result = juceaudioservice::EventBroadcaster::Subscription::Result;
+
+    juceaudioservice::EventBroadcaster& broadcaster_;
+    const std::string session_;
+
+    std::mutex mutex_; // also makes this the subscription's only consumer
+    std::shared_ptr<juceaudioservice::EventBroadcaster::Subscription> subscription_;
+    std::deque<juceaudioservice::EventBroadcaster::EventPtr> pending_;
+    juceaudioservice::EventBroadcaster::EventPtr current_; // being written while writing_ is set
+    bool started_ = false;
+    bool writing_ = false;
+    bool cancelled_ = false;
+    bool finished_ = false;
+
+    // Start the next write, or finish; may run on a broadcasting thread, so it never blocks
+    void pump() {
+        const audio_engine::EngineEvent* toWrite = nullptr;
+        Status finishStatus;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!started_ || writing_ || finished_) {
+                return;
+            }
+
+            bool finish = false;
+            if (cancelled_) {
+                finish = true;
+                finishStatus = Status::CANCELLED;
+            } else if (!pending_.empty()) {
+                current_ = std::move(pending_.front());
+                pending_.pop_front();
+            } else {
+                switch (subscription_->next(current_, std::chrono::milliseconds(0))) {
+                    case Result::Event:
+                        break;
+                    case Result::Timeout:
+                        return;
+                    case Result::Closed:
+                        finish = true;
+                        break;
+                    case Result::Overflowed:
+                        requestLog() << "[gRPC][Event] Subscriber for session " << session_
+                                     << " fell too far behind; closing its stream" << std::endl;
+                        finish = true;
+                        finishStatus = Status(StatusCode::RESOURCE_EXHAUSTED,
+                                              "Event queue overflowed; resubscribe to resync");
+                        break;
+                }
+            }
+
+            if (finish) {
+                finished_ = true;
+            } else {
+                writing_ = true;
+                toWrite = current_.get();
+            }
+        }
+
+        if (toWrite) {
+            StartWrite(toWrite);
+        } else {
+            Finish(finishStatus);
+        }
+    }
+};
+
+// AudioEngine on the gRPC callback API (--server-mode callback). Streams are reactors: renders
+// run on the render scheduler's workers, unary calls on a small handler pool, and an idle
+// Subscribe holds no thread at all, so thousands of open streams cost memory rather than threads.
+class AudioEngineCallbackService final : public audio_engine::AudioEngine::CallbackService {
+public:
+    static constexpr int defaultHandlerThreads = 4;
+
+    AudioEngineCallbackService(AudioEngineServiceImpl& engine, int handlerThreads)
+        : engine_(engine),
+          handlerScheduler_(handlerThreads, maxQueuedHandlers) {
+        heartbeatThread_ = std::thread([this] { heartbeatLoop(); });
+        std::cout << "[gRPC] Callback mode: " << handlerScheduler_.getNumWorkers() << " handler threads"
+                  << std::endl;
+    }
+
+    ~AudioEngineCallbackService() override {
+        {
+            std::lock_guard<std::mutex> lock(heartbeatMutex_);
+            stopping_ = true;
+        }
+        heartbeatCondition_.notify_all();
+        heartbeatThread_.join();
+    }
+
+    grpc::ServerUnaryReactor* LoadFile(grpc::CallbackServerContext* context,
+                                       const audio_engine::LoadFileRequest* request,
+                                       audio_engine::LoadFileResponse* response) override {
+        return startUnary(context, [this, request, response] { return engine_.loadFile(request, response); });
+    }
+
+    grpc::ServerWriteReactor<audio_engine::RenderResponse>* Render(grpc::CallbackServerContext* context,
+                                                                   const audio_engine::RenderRequest* request) override {
+        return startRenderStream<audio_engine::RenderResponse>(
+            [this, context, request](auto* writer, const auto& dispatch) {
+                return engine_.render(context, request, writer, dispatch);
+            });
+    }
+
+    grpc::ServerUnaryReactor* UpdateEdl(grpc::CallbackServerContext* context,
+                                        const audio_engine::UpdateEdlRequest* request,
+                                        audio_engine::UpdateEdlResponse* response) override {
+        return startUnary(context, [this, request, response] { return engine_.updateEdl(request, response); });
+    }
+
+    grpc::ServerUnaryReactor* PatchEdl(grpc::CallbackServerContext* context,
+                                       const audio_engine::PatchEdlRequest* request,
+                                       audio_engine::PatchEdlResponse* response) override {
+        return startUnary(context, [this, request, response] { return engine_.patchEdl(request, response); });
+    }
+
+    grpc::ServerWriteReactor<audio_engine::EngineEvent>* RenderEdlWindow(
+        grpc::CallbackServerContext* context, const audio_engine::RenderEdlWindowRequest* request) override {
+        return startRenderStream<audio_engine::EngineEvent>(
+            [this, context, request](auto* writer, const auto& dispatch) {
+                return engine_.renderEdlWindow(context, request, writer, dispatch);
+            });
+    }
+
+    grpc::ServerWriteReactor<audio_engine::EngineEvent>* RenderEdlWindows(
+        grpc::CallbackServerContext* context, const audio_engine::RenderEdlWindowsRequest* request) override {
+        return startRenderStream<audio_engine::EngineEvent>(
+            [this, context, request](auto* writer, const auto& dispatch) {
+                return engine_.renderEdlWindows(context, request, writer, dispatch);
+            });
+    }
+
+    grpc::ServerWriteReactor<audio_engine::PcmStreamMessage>* StreamEdlWindow(
+        grpc::CallbackServerContext* context, const audio_engine::StreamEdlWindowRequest* request) override {
+        return startRenderStream<audio_engine::PcmStreamMessage>(
+            [this, context, request](auto* writer, const auto& dispatch) {
+                return engine_.streamEdlWindow(context, request, writer, dispatch);
+            });
+    }
+
+    grpc::ServerUnaryReactor* GetStats(grpc::CallbackServerContext* context,
+                                       const audio_engine::GetStatsRequest* request,
+                                       audio_engine::GetStatsResponse* response) override {
+        return startUnary(context, [this, request, response] { return engine_.getStats(request, response); });
+    }
+
+    grpc::ServerWriteReactor<audio_engine::EngineEvent>* Subscribe(grpc::CallbackServerContext* context,
+                                                                   const audio_engine::SubscribeRequest* request) override {
+        requestLog() << "[gRPC] Subscribe request for session: " << request->session() << std::endl;
+
+        // Subscribed before the snapshot is taken, so nothing applied in between is missed
+        auto* reactor = new SubscribeReactor(engine_.eventBroadcaster_, request->session());
+        reactor->start(engine_.makeSubscribeSnapshot());
+
+        requestLog() << "[gRPC][Event] Subscriber registered for session: " << request->session() << std::endl;
+        return reactor;
+    }
+
+private:
+    static constexpr int maxQueuedHandlers = 256;
+    static constexpr auto heartbeatInterval = std::chrono::seconds(2);
+
+    AudioEngineServiceImpl& engine_;
+
+    // Unary bodies take locks and compile EDLs, so they stay off gRPC's callback threads
+    juceaudioservice::RenderScheduler handlerScheduler_;
+
+    // One thread heartbeats every subscriber through the broadcaster
+    std::thread heartbeatThread_;
+    std::mutex heartbeatMutex_;
+    std::condition_variable heartbeatCondition_;
+    bool stopping_ = false;
+
+    template <typename Handler>
+    grpc::ServerUnaryReactor* startUnary(grpc::CallbackServerContext* context, Handler handler) {
+        auto* reactor = context->DefaultReactor();
+
+        bool accepted = handlerScheduler_.post([reactor, handler](int) {
+            Status status;
+            try {
+                status = handler();
+            } catch (const std::exception& e) {
+                status = Status(StatusCode::INTERNAL, e.what());
+            }
+            reactor->Finish(status);
+        });
+
+        if (!accepted) {
+            reactor->Finish(Status(StatusCode::RESOURCE_EXHAUSTED, "Server is busy; retry later"));
+        }
+        return reactor;
+    }
+
+    // Run a streaming body as one job on a render worker; its render step then runs in place
+    template <typename Message, typename Body>
+    grpc::ServerWriteReactor<Message>* startRenderStream(Body body) {
+        auto* reactor = new WorkerStreamReactor<Message>();
+
+        bool accepted = engine_.renderScheduler_.post([reactor, body](int workerIndex) {
+            AudioEngineServiceImpl::RenderDispatch runHere =
+                [workerIndex](const juceaudioservice::RenderScheduler::Job& job) {
+                    job(workerIndex);
+                    return true;
+                };
+
+            Status status;
+            try {
+                status = body(reactor, runHere);
+            } catch (const std::exception& e) {
+                status = Status(StatusCode::INTERNAL, e.what());
+            }
+            reactor->finish(status);
+        });
+
+        if (!accepted) {
+            reactor->finish(engine_.renderQueueFull());
+        }
+        return reactor;
+    }
+
+    void heartbeatLoop() {
+        std::unique_lock<std::mutex> lock(heartbeatMutex_);
+        while (!heartbeatCondition_.wait_for(lock, heartbeatInterval, [this] { return stopping_; })) {
+            audio_engine::EngineEvent heartbeatEvent;
+            auto* heartbeat = heartbeatEvent.mutable_heartbeat();
+            heartbeat->set_monotonic_ms(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+            engine_.eventBroadcaster_.broadcast(heartbeatEvent);
+        }
+    }
+};
+
+// How the server spends threads on calls; see --server-mode
+struct ServerThreading {
+    bool callback = false;      // callback API instead of the sync thread pool
+    int completionQueues = 0;   // sync mode: completion queues (0 = gRPC default)
+    int maxPollers = 0;         // sync mode: most threads serving calls at once (0 = gRPC default)
+    int handlerThreads = AudioEngineCallbackService::defaultHandlerThreads; // callback mode: unary handler threads
+};
+
+void RunServer(int port, int renderThreads, int renderQueueSize,
+               const juce::File& renderCacheDir, juce::int64 renderCacheBytes, size_t blockCacheBytes,
+               int segmentThreads, int trackThreads, const ServerThreading& threading, int metricsPort,
+               const std::string& metricsBind) {
     std::string server_address = "0.0.0.0:" + std::to_string(port);
-    AudioEngineServiceImpl service;
+    AudioEngineServiceImpl service(renderThreads, renderQueueSize, renderCacheDir, renderCacheBytes,
+                                   blockCacheBytes, segmentThreads, trackThreads);
 
     grpc::EnableDefaultHealthCheckService(true);
     grpc::reflection::InitProtoReflectionServerBuilderPlugin();
 
     ServerBuilder builder;
     builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
-    builder.RegisterService(&service);
+
+    std::unique_ptr<AudioEngineCallbackService> callbackService;
+    if (threading.callback) {
+        callbackService = std::make_unique<AudioEngineCallbackService>(service, threading.handlerThreads);
+        builder.RegisterService(callbackService.get());
+    } else {
+        if (threading.completionQueues > 0) {
+            builder.SetSyncServerOption(ServerBuilder::SyncServerOption::NUM_CQS, threading.completionQueues);
+        }
+        if (threading.maxPollers > 0) {
+            builder.SetSyncServerOption(ServerBuilder::SyncServerOption::MAX_POLLERS, threading.maxPollers);
+        }
+        builder.RegisterService(&service);
+    }
 
     std::unique_ptr<Server> server(builder.BuildAndStart());
     if (!server) {
@@ -650,6 +1673,17 @@ void RunServer(int port = 50051) {
     }
 
     std::cout << "[gRPC] Server is listening on " << server_address << std::endl;
+
+    juceaudioservice::MetricsHttpServer metricsServer([&service] { return service.renderPrometheus(); });
+    if (metricsPort > 0) {
+        std::string error;
+        if (metricsServer.start(metricsPort, metricsBind, error)) {
+            std::cout << "[gRPC] Serving metrics on http://" << metricsBind << ":" << metricsPort << "/metrics"
+                      << std::endl;
+        } else {
+            std::cerr << "[gRPC] Metrics endpoint disabled: " << error << std::endl;
+        }
+    }
     std::cout << "[gRPC] Listening" << std::endl;  // Required by smoke test script
 
     server->Wait();
@@ -660,12 +1694,41 @@ void printUsage(const char* programName) {
     std::cout << std::endl;
     std::cout << "Options:" << std::endl;
     std::cout << "  --port <port>       Server port (default: 50051)" << std::endl;
+    std::cout << "  --server-mode <mode>   sync (a thread per active call) or callback (reactors) (default: sync)" << std::endl;
+    std::cout << "  --cqs <n>              Sync mode: server completion queues (default: gRPC's)" << std::endl;
+    std::cout << "  --max-pollers <n>      Sync mode: most threads serving calls at once (default: gRPC's)" << std::endl;
+    std::cout << "  --handler-threads <n>  Callback mode: threads running unary calls (default: "
+              << AudioEngineCallbackService::defaultHandlerThreads << ")" << std::endl;
+    std::cout << "  --media-cache-mb <mb>  Decoded media cache budget (default: 256)" << std::endl;
+    std::cout << "  --render-threads <n>   Concurrent render jobs (default: CPU cores)" << std::endl;
+    std::cout << "  --render-queue <n>     Render jobs that may wait for a thread (default: 16)" << std::endl;
+    std::cout << "  --segment-threads <n>  Threads that split one long EDL window render (default: 1)" << std::endl;
+    std::cout << "  --track-threads <n>    Threads that mix the tracks of one EDL block in parallel (default: 1)" << std::endl;
+    std::cout << "  --render-cache-dir <dir>  Where finished EDL renders are cached (default: temp directory)" << std::endl;
+    std::cout << "  --render-cache-mb <mb>    Render cache size cap, 0 disables it (default: 1024)" << std::endl;
+    std::cout << "  --block-cache-mb <mb>     Keep mixed blocks so EDL edits re-mix only what changed (default: 0, off)" << std::endl;
+    std::cout << "  --metrics-port <port>     Serve Prometheus metrics over HTTP at /metrics (default: 0, off)" << std::endl;
+    std::cout << "  --metrics-bind <addr>     Address the metrics endpoint listens on (default: "
+              << juceaudioservice::MetricsHttpServer::defaultBindAddress << ", 0.0.0.0 for all interfaces)" << std::endl;
+    std::cout << "  --request-log <on|off>    Log a line per request and render stage (default: on)" << std::endl;
     std::cout << "  --help, -h          Show this help message" << std::endl;
     std::cout << std::endl;
 }
 
 int main(int argc, char** argv) {
     int port = 50051;
+    size_t mediaCacheMb = juceaudioservice::MediaPageCache::defaultByteBudget / (1024 * 1024);
+    int renderThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int renderQueueSize = 16;
+    juce::File renderCacheDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                    .getChildFile("juce_audio_service_render_cache");
+    juce::int64 renderCacheMb = juceaudioservice::RenderCache::defaultMaxBytes / (1024 * 1024);
+    size_t blockCacheMb = 0;
+    int segmentThreads = 1;
+    int trackThreads = 1;
+    int metricsPort = 0;
+    std::string metricsBind = juceaudioservice::MetricsHttpServer::defaultBindAddress;
+    ServerThreading threading;
 
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
@@ -681,6 +1744,137 @@ int main(int argc, char** argv) {
                 std::cerr << "Error: invalid port argument: " << argv[i] << std::endl;
                 return 1;
             }
+        } else if (arg == "--server-mode" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode != "sync" && mode != "callback") {
+                std::cerr << "Error: invalid server mode: " << mode << " (expected sync or callback)" << std::endl;
+                return 1;
+            }
+            threading.callback = mode == "callback";
+        } else if ((arg == "--cqs" || arg == "--max-pollers" || arg == "--handler-threads") && i + 1 < argc) {
+            try {
+                int value = std::stoi(argv[++i]);
+                if (value <= 0) {
+                    std::cerr << "Error: invalid " << arg.substr(2) << " count: " << value << std::endl;
+                    return 1;
+                }
+                if (arg == "--cqs") {
+                    threading.completionQueues = value;
+                } else if (arg == "--max-pollers") {
+                    threading.maxPollers = value;
+                } else {
+                    threading.handlerThreads = value;
+                }
+            } catch (...) {
+                std::cerr << "Error: invalid " << arg.substr(2) << " argument: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--media-cache-mb" && i + 1 < argc) {
+            try {
+                int value = std::stoi(argv[++i]);
+                if (value < 0) {
+                    std::cerr << "Error: invalid media cache size: " << value << std::endl;
+                    return 1;
+                }
+                mediaCacheMb = static_cast<size_t>(value);
+            } catch (...) {
+                std::cerr << "Error: invalid media cache size argument: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--render-threads" && i + 1 < argc) {
+            try {
+                renderThreads = std::stoi(argv[++i]);
+                if (renderThreads <= 0) {
+                    std::cerr << "Error: invalid render thread count: " << renderThreads << std::endl;
+                    return 1;
+                }
+            } catch (...) {
+                std::cerr << "Error: invalid render thread argument: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--render-queue" && i + 1 < argc) {
+            try {
+                renderQueueSize = std::stoi(argv[++i]);
+                if (renderQueueSize < 0) {
+                    std::cerr << "Error: invalid render queue size: " << renderQueueSize << std::endl;
+                    return 1;
+                }
+            } catch (...) {
+                std::cerr << "Error: invalid render queue argument: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--render-cache-dir" && i + 1 < argc) {
+            renderCacheDir = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        } else if (arg == "--render-cache-mb" && i + 1 < argc) {
+            try {
+                int value = std::stoi(argv[++i]);
+                if (value < 0) {
+                    std::cerr << "Error: invalid render cache size: " << value << std::endl;
+                    return 1;
+                }
+                renderCacheMb = value;
+            } catch (...) {
+                std::cerr << "Error: invalid render cache size argument: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--block-cache-mb" && i + 1 < argc) {
+            try {
+                int value = std::stoi(argv[++i]);
+                if (value < 0) {
+                    std::cerr << "Error: invalid block cache size: " << value << std::endl;
+                    return 1;
+                }
+                blockCacheMb = static_cast<size_t>(value);
+            } catch (...) {
+                std::cerr << "Error: invalid block cache size argument: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--segment-threads" && i + 1 < argc) {
+            try {
+                segmentThreads = std::stoi(argv[++i]);
+                if (segmentThreads <= 0) {
+                    std::cerr << "Error: invalid segment thread count: " << segmentThreads << std::endl;
+                    return 1;
+                }
+            } catch (...) {
+                std::cerr << "Error: invalid segment thread count argument: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--track-threads" && i + 1 < argc) {
+            try {
+                trackThreads = std::stoi(argv[++i]);
+                if (trackThreads <= 0) {
+                    std::cerr << "Error: invalid track thread count: " << trackThreads << std::endl;
+                    return 1;
+                }
+            } catch (...) {
+                std::cerr << "Error: invalid track thread count argument: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--metrics-port" && i + 1 < argc) {
+            try {
+                metricsPort = std::stoi(argv[++i]);
+                if (metricsPort < 0 || metricsPort > 65535) {
+                    std::cerr << "Error: invalid metrics port: " << metricsPort << std::endl;
+                    return 1;
+                }
+            } catch (...) {
+                std::cerr << "Error: invalid metrics port argument: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--metrics-bind" && i + 1 < argc) {
+            metricsBind = argv[++i];
+            if (metricsBind.empty()) {
+                std::cerr << "Error: empty metrics bind address" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--request-log" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode != "on" && mode != "off") {
+                std::cerr << "Error: invalid request log setting: " << mode << " (expected on or off)" << std::endl;
+                return 1;
+            }
+            Telemetry::setRequestLogging(mode == "on");
         } else if (arg == "--help" || arg == "-h") {
             printUsage(argv[0]);
             return 0;
@@ -691,10 +1885,15 @@ int main(int argc, char** argv) {
         }
     }
 
+    // Size the decoded media cache shared by all renders
+    juceaudioservice::MediaPageCache::getInstance().setByteBudget(mediaCacheMb * 1024 * 1024);
+
     // Initialize JUCE
 
     try {
-        RunServer(port);
+        RunServer(port, renderThreads, renderQueueSize, renderCacheDir, renderCacheMb * 1024 * 1024,
+                  blockCacheMb * 1024 * 1024, segmentThreads, trackThreads, threading, metricsPort,
+                  metricsBind);
     } catch (const std::exception& e) {
         std::cerr << "[gRPC] Server error: " << e.what() << std::endl;
         return 1;
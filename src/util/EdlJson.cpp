@@ -20,6 +20,21 @@ bool EdlJson::parseFromJson(const std::string& jsonString, audio_engine::Edl& ed
     return true;
 }
 
+bool EdlJson::parsePatchFromJson(const std::string& jsonString, audio_engine::PatchEdlRequest& request,
+                                 std::string& error) {
+    google::protobuf::util::JsonParseOptions options;
+    options.ignore_unknown_fields = false;
+    options.case_insensitive_enum_parsing = true;
+
+    auto status = google::protobuf::util::JsonStringToMessage(jsonString, &request, options);
+    if (!status.ok()) {
+        error = "JSON parse error: " + std::string(status.message());
+        return false;
+    }
+
+    return true;
+}
+
 bool EdlJson::toJson(const audio_engine::Edl& edl, std::string& jsonString, std::string& error) {
     google::protobuf::util::JsonPrintOptions options;
     options.add_whitespace = true;
@@ -23,6 +23,17 @@ public:
      */
     static bool parseFromJson(const std::string& jsonString, audio_engine::Edl& edl, std::string& error);
 
+    /**
+     * Parse a PatchEdl request from JSON string.
+     *
+     * @param jsonString JSON representation of the patch
+     * @param request Output parameter for parsed request
+     * @param error Output parameter for parse error message
+     * @return true if parsing succeeded
+     */
+    static bool parsePatchFromJson(const std::string& jsonString, audio_engine::PatchEdlRequest& request,
+                                   std::string& error);
+
     /**
      * Convert EDL to JSON string.
      *
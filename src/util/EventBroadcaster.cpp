@@ -0,0 +1,192 @@
+#include "EventBroadcaster.h"
+#include <algorithm>
+
+namespace juceaudioservice {
+
+namespace {
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+EventBroadcaster::Subscription::Subscription(size_t capacity, ReadyCallback onReady)
+    : ring_(roundUpToPowerOfTwo(capacity)),
+      mask_(ring_.size() - 1),
+      onReady_(std::move(onReady)) {
+}
+
+EventBroadcaster::Subscription::Result EventBroadcaster::Subscription::next(EventPtr& event,
+                                                                           std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while (true) {
+        // Events queued behind a lost one would leave the client out of step; report it first
+        if (overflowed_.load(std::memory_order_acquire)) {
+            return Result::Overflowed;
+        }
+        if (pop(event)) {
+            return Result::Event;
+        }
+        if (closed_.load(std::memory_order_acquire)) {
+            return Result::Closed;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        waiting_.store(true, std::memory_order_relaxed);
+
+        // Pairs with the fence in wakeConsumer(): either it sees waiting_, or the predicate sees its event
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        const bool woken = wake_.wait_until(lock, deadline, [this] {
+            return hasEvents() || overflowed_.load(std::memory_order_acquire) ||
+                   closed_.load(std::memory_order_acquire);
+        });
+        waiting_.store(false, std::memory_order_relaxed);
+
+        if (!woken) {
+            return Result::Timeout;
+        }
+    }
+}
+
+bool EventBroadcaster::Subscription::push(const EventPtr& event, bool disposable) {
+    if (overflowed_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t used = tail - head_.load(std::memory_order_acquire);
+
+    // Keep half the queue for events the client can't do without
+    if (disposable && used >= ring_.size() / 2) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (used >= ring_.size()) {
+        overflowed_.store(true, std::memory_order_release);
+        wakeConsumer();
+        return false;
+    }
+
+    ring_[tail & mask_] = event;
+    tail_.store(tail + 1, std::memory_order_release);
+    wakeConsumer();
+    return true;
+}
+
+bool EventBroadcaster::Subscription::pop(EventPtr& event) {
+    size_t head = head_.load(std::memory_order_relaxed);
+
+    while (head != tail_.load(std::memory_order_acquire)) {
+        event = std::move(ring_[head & mask_]);
+        head_.store(++head, std::memory_order_release);
+
+        if (!isDisposable(*event)) {
+            return true;
+        }
+
+        // The producer doesn't touch a published slot until head moves past it, so peeking is safe
+        if (head == tail_.load(std::memory_order_acquire) ||
+            ring_[head & mask_]->evt_case() != event->evt_case()) {
+            return true;
+        }
+
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    event.reset();
+    return false;
+}
+
+bool EventBroadcaster::Subscription::hasEvents() const noexcept {
+    return head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_acquire);
+}
+
+void EventBroadcaster::Subscription::wakeConsumer() {
+    if (onReady_) {
+        onReady_();
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // The lock is only contended while the consumer is going to sleep, never while it writes
+    if (waiting_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wake_.notify_one();
+    }
+}
+
+std::shared_ptr<EventBroadcaster::Subscription> EventBroadcaster::subscribe(size_t capacity, ReadyCallback onReady) {
+    auto subscription = std::make_shared<Subscription>(std::max<size_t>(capacity, 2), std::move(onReady));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscription->closed_.store(closed_, std::memory_order_relaxed);
+    subscribers_.push_back(subscription);
+    return subscription;
+}
+
+void EventBroadcaster::unsubscribe(const std::shared_ptr<Subscription>& subscription) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = std::find(subscribers_.begin(), subscribers_.end(), subscription);
+    if (it == subscribers_.end()) {
+        return;
+    }
+
+    droppedByGone_ += subscription->getNumDropped();
+    if (subscription->hasOverflowed()) {
+        ++overflows_;
+    }
+    subscribers_.erase(it);
+}
+
+void EventBroadcaster::broadcast(const audio_engine::EngineEvent& event) {
+    // One copy, made before taking the lock, shared by every queue
+    const auto shared = std::make_shared<const audio_engine::EngineEvent>(event);
+    const bool disposable = isDisposable(event);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++broadcasts_;
+    for (const auto& subscription : subscribers_) {
+        subscription->push(shared, disposable);
+    }
+}
+
+void EventBroadcaster::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    for (const auto& subscription : subscribers_) {
+        subscription->closed_.store(true, std::memory_order_release);
+        subscription->wakeConsumer();
+    }
+}
+
+EventBroadcaster::Stats EventBroadcaster::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Stats stats;
+    stats.subscribers = subscribers_.size();
+    stats.broadcasts = broadcasts_;
+    stats.dropped = droppedByGone_;
+    stats.overflows = overflows_;
+    for (const auto& subscription : subscribers_) {
+        stats.dropped += subscription->getNumDropped();
+        if (subscription->hasOverflowed()) {
+            ++stats.overflows;
+        }
+    }
+    return stats;
+}
+
+bool EventBroadcaster::isDisposable(const audio_engine::EngineEvent& event) noexcept {
+    return event.has_progress() || event.has_heartbeat();
+}
+
+} // namespace juceaudioservice
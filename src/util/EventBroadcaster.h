@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "audio_engine.pb.h"
+
+namespace juceaudioservice {
+
+/**
+ * Fans EngineEvents out to Subscribe streams without ever waiting on them.
+ *
+ * Every subscriber has its own bounded single-producer, single-consumer
+ * ring, drained by the thread serving its stream. broadcast() shares one
+ * copy of the event between all rings, so it costs one enqueue per
+ * subscriber and never blocks on a client: a slow connection only ever
+ * fills its own queue.
+ *
+ * Progress and heartbeat events are disposable. They are dropped once a
+ * queue is half full, and a queued one is skipped when a newer event of
+ * the same kind is already behind it. Any other event that finds its
+ * queue full overflows the subscription; the stream should then be ended
+ * so the client can resubscribe and resynchronise.
+ */
+class EventBroadcaster {
+public:
+    using EventPtr = std::shared_ptr<const audio_engine::EngineEvent>;
+
+    /**
+     * Told that a subscription has something for next() to return.
+     *
+     * Called on the broadcasting thread with the broadcaster locked: it
+     * must not block or call back into the broadcaster.
+     */
+    using ReadyCallback = std::function<void()>;
+
+    static constexpr size_t defaultQueueCapacity = 256;
+
+    /** One subscriber's queue; use it from one thread only. */
+    class Subscription {
+    public:
+        enum class Result {
+            Event,      // an event was returned
+            Timeout,    // nothing arrived in time
+            Closed,     // the broadcaster was closed
+            Overflowed  // events were lost; end the stream
+        };
+
+        Subscription(size_t capacity, ReadyCallback onReady);
+
+        /**
+         * Wait for the next event.
+         *
+         * @param event Receives the event when the result is Event
+         * @param timeout Longest time to wait
+         */
+        Result next(EventPtr& event, std::chrono::milliseconds timeout);
+
+        /** Progress and heartbeat events dropped or skipped so far. */
+        uint64_t getNumDropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+        bool hasOverflowed() const noexcept { return overflowed_.load(std::memory_order_acquire); }
+
+    private:
+        friend class EventBroadcaster;
+
+        std::vector<EventPtr> ring_;
+        const size_t mask_;
+
+        alignas(64) std::atomic<size_t> head_{0}; // next slot to read; written by the consumer
+        alignas(64) std::atomic<size_t> tail_{0}; // next slot to fill; written by the producer
+
+        std::atomic<bool> overflowed_{false};
+        std::atomic<bool> closed_{false};
+        std::atomic<bool> waiting_{false};
+        std::atomic<uint64_t> dropped_{0};
+
+        // Only for sleeping; never held while events are copied or written
+        std::mutex wakeMutex_;
+        std::condition_variable wake_;
+        const ReadyCallback onReady_;
+
+        bool push(const EventPtr& event, bool disposable); // producer; calls are serialised
+        bool pop(EventPtr& event);                          // consumer
+        bool hasEvents() const noexcept;
+        void wakeConsumer();
+
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+    };
+
+    struct Stats {
+        size_t subscribers = 0;
+        uint64_t broadcasts = 0;
+        uint64_t dropped = 0;    // disposable events not delivered, over all subscribers
+        uint64_t overflows = 0;  // subscriptions that lost an event that mattered
+    };
+
+    EventBroadcaster() = default;
+
+    /**
+     * Start a subscription.
+     *
+     * A consumer that can't block in next() passes onReady and calls
+     * next() with a zero timeout whenever it fires; the callback is never
+     * called again once unsubscribe() returns.
+     *
+     * @param capacity Events the queue holds; rounded up to a power of two
+     * @param onReady Optional wake-up callback
+     */
+    std::shared_ptr<Subscription> subscribe(size_t capacity = defaultQueueCapacity, ReadyCallback onReady = {});
+
+    void unsubscribe(const std::shared_ptr<Subscription>& subscription);
+
+    /** Queue an event for every subscriber; never waits for any of them. */
+    void broadcast(const audio_engine::EngineEvent& event);
+
+    /** End every subscription, including later ones; their next() returns Closed. */
+    void close();
+
+    Stats getStats() const;
+
+private:
+    mutable std::mutex mutex_; // serialises producers and guards the list, for enqueues only
+    std::vector<std::shared_ptr<Subscription>> subscribers_;
+    uint64_t broadcasts_ = 0;
+    uint64_t droppedByGone_ = 0;
+    uint64_t overflows_ = 0;
+    bool closed_ = false;
+
+    static bool isDisposable(const audio_engine::EngineEvent& event) noexcept;
+
+    EventBroadcaster(const EventBroadcaster&) = delete;
+    EventBroadcaster& operator=(const EventBroadcaster&) = delete;
+};
+
+} // namespace juceaudioservice
@@ -0,0 +1,118 @@
+#include "HashingOutputStream.h"
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <openssl/evp.h>
+
+namespace juceaudioservice {
+
+namespace {
+
+std::string toHex(const unsigned char* hash, unsigned int hashLen) {
+    std::stringstream ss;
+    for (unsigned int i = 0; i < hashLen; ++i) {
+        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
+    }
+    return ss.str();
+}
+
+} // namespace
+
+HashingOutputStream::HashingOutputStream(std::unique_ptr<juce::OutputStream> destination)
+    : destination_(std::move(destination)),
+      context_(EVP_MD_CTX_new()) {
+
+    if (context_ && EVP_DigestInit_ex(context_, EVP_sha256(), nullptr) != 1) {
+        EVP_MD_CTX_free(context_);
+        context_ = nullptr;
+    }
+}
+
+HashingOutputStream::~HashingOutputStream() {
+    if (context_) {
+        EVP_MD_CTX_free(context_);
+    }
+}
+
+void HashingOutputStream::flush() {
+    destination_->flush();
+}
+
+bool HashingOutputStream::setPosition(juce::int64 newPosition) {
+    // Anything else would rewrite bytes that are already hashed
+    return newPosition == getPosition();
+}
+
+juce::int64 HashingOutputStream::getPosition() {
+    return destination_->getPosition();
+}
+
+bool HashingOutputStream::write(const void* dataToWrite, size_t numberOfBytes) {
+    if (!destination_->write(dataToWrite, numberOfBytes)) {
+        return false;
+    }
+
+    if (!finished_ && context_) {
+        const auto start = std::chrono::steady_clock::now();
+        if (EVP_DigestUpdate(context_, dataToWrite, numberOfBytes) != 1) {
+            EVP_MD_CTX_free(context_);
+            context_ = nullptr;
+        }
+        hashSeconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return true;
+}
+
+std::string HashingOutputStream::getHexDigest() {
+    if (finished_) {
+        return digest_;
+    }
+
+    destination_->flush();
+    finished_ = true;
+
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int hashLen = 0;
+    if (!context_ || EVP_DigestFinal_ex(context_, hash, &hashLen) != 1) {
+        return digest_;
+    }
+
+    digest_ = toHex(hash, hashLen);
+    return digest_;
+}
+
+std::string HashingOutputStream::hashFile(const juce::File& file) {
+    juce::FileInputStream input(file);
+    if (!input.openedOk()) {
+        return {};
+    }
+
+    EVP_MD_CTX* context = EVP_MD_CTX_new();
+    if (!context || EVP_DigestInit_ex(context, EVP_sha256(), nullptr) != 1) {
+        EVP_MD_CTX_free(context);
+        return {};
+    }
+
+    std::vector<char> chunk(1 << 20);
+    bool ok = true;
+    while (ok && !input.isExhausted()) {
+        const int bytesRead = input.read(chunk.data(), static_cast<int>(chunk.size()));
+        if (bytesRead < 0) {
+            ok = false;
+        } else if (bytesRead > 0) {
+            ok = EVP_DigestUpdate(context, chunk.data(), static_cast<size_t>(bytesRead)) == 1;
+        } else {
+            break;
+        }
+    }
+
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int hashLen = 0;
+    ok = ok && EVP_DigestFinal_ex(context, hash, &hashLen) == 1;
+    EVP_MD_CTX_free(context);
+
+    return ok ? toHex(hash, hashLen) : std::string();
+}
+
+} // namespace juceaudioservice
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <juce_core/juce_core.h>
+
+// OpenSSL's digest context, kept opaque so users of the stream don't pull in OpenSSL
+struct evp_md_ctx_st;
+
+namespace juceaudioservice {
+
+/**
+ * Output stream that forwards to another stream and SHA-256 hashes every
+ * byte on the way through.
+ *
+ * Hashing while writing saves reading the file back afterwards. Only
+ * sequential output can be hashed, so setPosition() fails for any position
+ * other than the current one; pair it with writers that never seek, such
+ * as WavStreamWriter.
+ */
+class HashingOutputStream : public juce::OutputStream {
+public:
+    /**
+     * @param destination Stream the bytes are forwarded to (owned)
+     */
+    explicit HashingOutputStream(std::unique_ptr<juce::OutputStream> destination);
+    ~HashingOutputStream() override;
+
+    void flush() override;
+    bool setPosition(juce::int64 newPosition) override;
+    juce::int64 getPosition() override;
+    bool write(const void* dataToWrite, size_t numberOfBytes) override;
+
+    /**
+     * Finish the hash of everything written so far.
+     *
+     * Flushes the destination first. Later writes are still forwarded but
+     * no longer hashed.
+     *
+     * @return Lowercase hex SHA-256, or an empty string if hashing failed
+     */
+    std::string getHexDigest();
+
+    /** Seconds spent hashing so far, for telemetry. */
+    double getHashSeconds() const noexcept { return hashSeconds_; }
+
+    /**
+     * Hash a file that could not be written sequentially.
+     *
+     * @param file File to read
+     * @return Lowercase hex SHA-256, or an empty string if the file could not be read
+     */
+    static std::string hashFile(const juce::File& file);
+
+private:
+    std::unique_ptr<juce::OutputStream> destination_;
+    evp_md_ctx_st* context_ = nullptr;
+    std::string digest_;
+    bool finished_ = false;
+    double hashSeconds_ = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HashingOutputStream)
+};
+
+} // namespace juceaudioservice
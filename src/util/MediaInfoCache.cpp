@@ -0,0 +1,72 @@
+#include "MediaInfoCache.h"
+
+namespace juceaudioservice {
+
+MediaInfoCache& MediaInfoCache::getInstance() {
+    static MediaInfoCache instance;
+    return instance;
+}
+
+MediaInfoCache::MediaInfoCache() {
+    formatManager_.registerBasicFormats();
+}
+
+bool MediaInfoCache::probe(const juce::File& file, Info& info) {
+    if (!file.existsAsFile()) {
+        return false;
+    }
+
+    const std::string path = file.getFullPathName().toStdString();
+    const juce::int64 modificationTime = file.getLastModificationTime().toMilliseconds();
+    const juce::int64 fileSize = file.getSize();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(path);
+        if (it != entries_.end() && it->second.modificationTime == modificationTime &&
+            it->second.fileSize == fileSize) {
+            ++hits_;
+            info = it->second;
+            return true;
+        }
+    }
+
+    ++misses_;
+
+    // Opened without the lock, so a slow file never stalls lookups of others; the
+    // format list is only written by the constructor, so concurrent use is read-only
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager_.createReaderFor(file));
+
+    if (!reader) {
+        return false;
+    }
+
+    Info probed;
+    probed.sampleRate = reader->sampleRate;
+    probed.numChannels = static_cast<int>(reader->numChannels);
+    probed.lengthInSamples = reader->lengthInSamples;
+    probed.bitsPerSample = reader->bitsPerSample;
+    probed.usesFloatingPointData = reader->usesFloatingPointData;
+    probed.modificationTime = modificationTime;
+    probed.fileSize = fileSize;
+
+    // A concurrent probe of the same file may have stored first; either entry is stat-checked on use
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[path] = probed;
+    info = probed;
+    return true;
+}
+
+MediaInfoCache::Stats MediaInfoCache::getStats() const {
+    Stats stats;
+    stats.hits = hits_.load();
+    stats.misses = misses_.load();
+    return stats;
+}
+
+void MediaInfoCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+} // namespace juceaudioservice
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+namespace juceaudioservice {
+
+/**
+ * Process-wide cache of media file metadata.
+ *
+ * Opening a reader to learn a file's sample rate or length costs a file
+ * open and a header parse. This cache remembers the result per path and
+ * only probes the file again when its modification time or size changes,
+ * so repeated validation costs one stat per file. Thread-safe; the lock
+ * only covers the table, never a file open, so probes of different files
+ * run in parallel.
+ */
+class MediaInfoCache {
+public:
+    struct Info {
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        juce::int64 lengthInSamples = 0;
+        unsigned int bitsPerSample = 0;
+        bool usesFloatingPointData = false;
+        juce::int64 modificationTime = 0; // ms since epoch, identifies the probed version
+        juce::int64 fileSize = 0;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    /** The cache shared by the store, the renderers and the server. */
+    static MediaInfoCache& getInstance();
+
+    MediaInfoCache();
+    ~MediaInfoCache() = default;
+
+    /**
+     * Get the metadata of a media file.
+     *
+     * @param file Media file to probe
+     * @param info Output parameter for the file's metadata
+     * @return false if the file is missing or no format can read it
+     *         (failures are not cached)
+     */
+    bool probe(const juce::File& file, Info& info);
+
+    /** Hit/miss counters. */
+    Stats getStats() const;
+
+    /** Forget all cached metadata. */
+    void clear();
+
+private:
+    juce::AudioFormatManager formatManager_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Info> entries_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MediaInfoCache)
+};
+
+} // namespace juceaudioservice
@@ -0,0 +1,18 @@
+#include "MediaReader.h"
+
+namespace juceaudioservice {
+
+std::unique_ptr<juce::AudioFormatReader> createMediaReader(juce::AudioFormatManager& formatManager,
+                                                           const juce::File& file) {
+    if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension())) {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader(format->createMemoryMappedReader(file));
+        if (mappedReader && mappedReader->mapEntireFile()) {
+            return mappedReader;
+        }
+    }
+
+    // Compressed format, or the file couldn't be mapped
+    return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file));
+}
+
+} // namespace juceaudioservice
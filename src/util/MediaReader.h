@@ -0,0 +1,23 @@
+#pragma once
+
+#include <memory>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+namespace juceaudioservice {
+
+/**
+ * Open a reader for a media file, memory-mapped when the format allows it.
+ *
+ * Uncompressed formats such as WAV are mapped in full, so reads become
+ * page faults on the mapping instead of buffered stream I/O and seeks.
+ * Formats without a memory-mapped reader (FLAC, Ogg, ...) fall back to the
+ * regular buffered reader. Both paths decode to identical samples.
+ *
+ * @param formatManager Format manager with the formats to try registered
+ * @param file Media file to open
+ * @return Reader for the file, or nullptr if no format can read it
+ */
+std::unique_ptr<juce::AudioFormatReader> createMediaReader(juce::AudioFormatManager& formatManager,
+                                                           const juce::File& file);
+
+} // namespace juceaudioservice
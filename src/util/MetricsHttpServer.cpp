@@ -0,0 +1,97 @@
+#include "MetricsHttpServer.h"
+#include <memory>
+
+namespace juceaudioservice {
+
+namespace {
+
+constexpr int requestTimeoutMs = 2000;
+constexpr int maxRequestBytes = 8192;
+
+bool writeAll(juce::StreamingSocket& socket, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        const int n = socket.write(data.data() + written, static_cast<int>(data.size() - written));
+        if (n <= 0) {
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+MetricsHttpServer::MetricsHttpServer(Renderer renderer)
+    : renderer_(std::move(renderer)) {
+}
+
+MetricsHttpServer::~MetricsHttpServer() {
+    stop();
+}
+
+bool MetricsHttpServer::start(int port, const std::string& bindAddress, std::string& error) {
+    if (running_) {
+        error = "Metrics listener already running";
+        return false;
+    }
+
+    if (!listener_.createListener(port, juce::String(bindAddress))) {
+        error = "Cannot listen on metrics address " + bindAddress + ":" + std::to_string(port);
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread([this] { serve(); });
+    return true;
+}
+
+void MetricsHttpServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    // Closing the listener wakes the blocked accept
+    listener_.close();
+    thread_.join();
+}
+
+void MetricsHttpServer::serve() {
+    while (running_) {
+        std::unique_ptr<juce::StreamingSocket> connection(listener_.waitForNextConnection());
+        if (connection == nullptr) {
+            continue; // listener closed, or a failed accept
+        }
+        handle(*connection);
+    }
+}
+
+void MetricsHttpServer::handle(juce::StreamingSocket& connection) {
+    // Only the request line matters; read until the end of the headers
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < maxRequestBytes) {
+        if (connection.waitUntilReady(true, requestTimeoutMs) != 1) {
+            return;
+        }
+
+        const int n = connection.read(buffer, static_cast<int>(sizeof(buffer)), false);
+        if (n <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    const size_t lineEnd = request.find("\r\n");
+    const std::string requestLine = request.substr(0, lineEnd);
+    const bool isMetrics = requestLine.rfind("GET /metrics ", 0) == 0 || requestLine.rfind("GET /metrics?", 0) == 0;
+
+    std::string body = isMetrics ? renderer_() : std::string("Not found; metrics are at /metrics\n");
+    std::string response = std::string(isMetrics ? "HTTP/1.0 200 OK\r\n" : "HTTP/1.0 404 Not Found\r\n") +
+                           (isMetrics ? "Content-Type: text/plain; version=0.0.4\r\n" : "Content-Type: text/plain\r\n") +
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n" +
+                           "Connection: close\r\n\r\n" + body;
+    writeAll(connection, response);
+}
+
+} // namespace juceaudioservice
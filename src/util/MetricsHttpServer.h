@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <juce_core/juce_core.h>
+
+namespace juceaudioservice {
+
+/**
+ * Minimal HTTP listener serving GET /metrics for Prometheus scrapers.
+ *
+ * One thread accepts connections and answers them in turn; anything but
+ * a GET of /metrics gets a 404. Scrapes are infrequent and small, so this
+ * is deliberately not a general-purpose web server. The listener binds
+ * to loopback unless given another address, since the metrics are not
+ * authenticated.
+ */
+class MetricsHttpServer {
+public:
+    /** Produces the exposition text; called on the listener thread for each scrape. */
+    using Renderer = std::function<std::string()>;
+
+    static constexpr const char* defaultBindAddress = "127.0.0.1";
+
+    explicit MetricsHttpServer(Renderer renderer);
+
+    /** Stops listening and joins the thread. */
+    ~MetricsHttpServer();
+
+    /**
+     * Start listening.
+     *
+     * @param port TCP port to listen on
+     * @param bindAddress Local address to listen on, e.g. "0.0.0.0" for every interface
+     * @param error Receives the reason on failure
+     * @return false if the address and port could not be bound
+     */
+    bool start(int port, const std::string& bindAddress, std::string& error);
+
+    void stop();
+
+private:
+    const Renderer renderer_;
+    juce::StreamingSocket listener_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    void serve();
+    void handle(juce::StreamingSocket& connection);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MetricsHttpServer)
+};
+
+} // namespace juceaudioservice
@@ -0,0 +1,120 @@
+#include "PipelinedAudioWriter.h"
+#include "Telemetry.h"
+#include <algorithm>
+#include <chrono>
+
+namespace juceaudioservice {
+
+PipelinedAudioWriter::PipelinedAudioWriter(std::unique_ptr<juce::AudioFormatWriter> writer, int maxBlockSamples,
+                                           int queueBlocks)
+    : writer_(std::move(writer)),
+      numChannels_(writer_ ? writer_->getNumChannels() : 0),
+      slots_(static_cast<size_t>(std::max(1, queueBlocks))) {
+    jassert(writer_ != nullptr);
+
+    for (auto& slot : slots_) {
+        slot.buffer.setSize(std::max(1, numChannels_), std::max(1, maxBlockSamples));
+    }
+
+    if (writer_) {
+        thread_ = std::thread([this] { encodeLoop(); });
+    } else {
+        failed_ = true;
+    }
+}
+
+PipelinedAudioWriter::~PipelinedAudioWriter() {
+    finish();
+}
+
+bool PipelinedAudioWriter::write(const juce::AudioBuffer<float>& block, int numSamples) {
+    const int blockChannels = block.getNumChannels();
+
+    for (int offset = 0; offset < numSamples;) {
+        Slot* slot = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            slotFreed_.wait(lock, [this] { return failed_ || finishing_ || count_ < slots_.size(); });
+            if (failed_ || finishing_) {
+                return false;
+            }
+            slot = &slots_[(head_ + count_) % slots_.size()];
+        }
+
+        // Only this thread fills slots, and the encoder does not touch a slot until it is queued
+        const int count = std::min(slot->buffer.getNumSamples(), numSamples - offset);
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            if (ch < blockChannels) {
+                slot->buffer.copyFrom(ch, 0, block, ch, offset, count);
+            } else {
+                slot->buffer.clear(ch, 0, count);
+            }
+        }
+        slot->numSamples = count;
+        offset += count;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++count_;
+        }
+        blockQueued_.notify_one();
+    }
+
+    return true;
+}
+
+bool PipelinedAudioWriter::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finishing_ = true;
+    }
+    blockQueued_.notify_all();
+    slotFreed_.notify_all();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // Deleting the writer flushes it and closes its stream
+    writer_.reset();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !failed_;
+}
+
+double PipelinedAudioWriter::getEncodeSeconds() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return encodeSeconds_;
+}
+
+void PipelinedAudioWriter::encodeLoop() {
+    while (true) {
+        Slot* slot = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            blockQueued_.wait(lock, [this] { return count_ > 0 || finishing_; });
+            if (count_ == 0) {
+                return; // finishing, and everything queued is encoded
+            }
+            slot = &slots_[head_];
+        }
+
+        const auto encodeStart = std::chrono::steady_clock::now();
+        const bool written = writer_->writeFromAudioSampleBuffer(slot->buffer, 0, slot->numSamples);
+        const double seconds = Telemetry::secondsSince(encodeStart);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            encodeSeconds_ += seconds;
+            head_ = (head_ + 1) % slots_.size();
+            --count_;
+            if (!written) {
+                failed_ = true;
+                count_ = 0;
+            }
+        }
+        slotFreed_.notify_one();
+    }
+}
+
+} // namespace juceaudioservice
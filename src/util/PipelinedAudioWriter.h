@@ -0,0 +1,93 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+namespace juceaudioservice {
+
+/**
+ * Runs an audio format writer on its own thread, behind a queue of blocks.
+ *
+ * Compressing encoders (FLAC) cost about as much per block as mixing it.
+ * The render loop copies each block into a free queue slot and goes on to
+ * the next one while the encoder thread compresses the queued blocks in
+ * order. The slots are allocated up front. When the queue is full, write()
+ * waits for a slot, so the output is never dropped or reordered.
+ *
+ * Unlike juce::AudioFormatWriter::ThreadedWriter, which returns false
+ * when its FIFO is full, this writer suits offline renders that mix
+ * faster than real time.
+ */
+class PipelinedAudioWriter {
+public:
+    static constexpr int defaultQueueBlocks = 8;
+
+    /**
+     * Start the encoder thread.
+     *
+     * @param writer Writer to run; owns its output stream
+     * @param maxBlockSamples Longest block write() will be given without splitting
+     * @param queueBlocks Number of blocks that may wait for the encoder
+     */
+    PipelinedAudioWriter(std::unique_ptr<juce::AudioFormatWriter> writer, int maxBlockSamples,
+                         int queueBlocks = defaultQueueBlocks);
+
+    /** Calls finish(). */
+    ~PipelinedAudioWriter();
+
+    /**
+     * Queue samples for encoding.
+     *
+     * Buffer channels beyond the writer's are ignored and missing ones are
+     * encoded as silence.
+     *
+     * @param block Source audio; copied before this returns
+     * @param numSamples Number of samples from the start of block
+     * @return false once an earlier block failed to encode
+     */
+    bool write(const juce::AudioBuffer<float>& block, int numSamples);
+
+    /**
+     * Encode everything still queued, stop the thread and close the writer.
+     *
+     * The writer is closed on the calling thread, so formats that finish
+     * their header on close have done so when this returns.
+     *
+     * @return false if any block failed to encode
+     */
+    bool finish();
+
+    /** Seconds the encoder thread spent encoding, for telemetry; final once finish() returned. */
+    double getEncodeSeconds() const;
+
+private:
+    struct Slot {
+        juce::AudioBuffer<float> buffer;
+        int numSamples = 0;
+    };
+
+    std::unique_ptr<juce::AudioFormatWriter> writer_;
+    const int numChannels_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable blockQueued_;
+    std::condition_variable slotFreed_;
+    std::vector<Slot> slots_; // ring of fixed capacity
+    size_t head_ = 0;          // oldest queued slot
+    size_t count_ = 0;
+    bool finishing_ = false;
+    bool failed_ = false;
+    double encodeSeconds_ = 0.0;
+    std::thread thread_;
+
+    void encodeLoop();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PipelinedAudioWriter)
+};
+
+} // namespace juceaudioservice
@@ -0,0 +1,131 @@
+#include "RenderScheduler.h"
+#include <algorithm>
+#include <memory>
+
+namespace juceaudioservice {
+
+RenderScheduler::RenderScheduler(int numWorkers, int maxQueuedJobs)
+    : maxQueuedJobs_(std::max(0, maxQueuedJobs)) {
+    numWorkers = std::max(1, numWorkers);
+    threads_.reserve(static_cast<size_t>(numWorkers));
+
+    for (int i = 0; i < numWorkers; ++i) {
+        threads_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+RenderScheduler::~RenderScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    jobAvailable_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+bool RenderScheduler::run(const Job& job) {
+    Ticket ticket;
+    ticket.job = &job;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!admitLocked()) {
+        return false;
+    }
+
+    queue_.push_back(&ticket);
+    jobAvailable_.notify_one();
+
+    jobFinished_.wait(lock, [&ticket] { return ticket.done; });
+    lock.unlock();
+
+    if (ticket.exception) {
+        std::rethrow_exception(ticket.exception);
+    }
+    return true;
+}
+
+bool RenderScheduler::post(Job job) {
+    auto ticket = std::make_unique<Ticket>();
+    ticket->postedJob = std::move(job);
+    ticket->job = &ticket->postedJob;
+    ticket->posted = true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!admitLocked()) {
+        return false;
+    }
+
+    queue_.push_back(ticket.release());
+    jobAvailable_.notify_one();
+    return true;
+}
+
+RenderScheduler::Stats RenderScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Stats stats;
+    stats.running = running_;
+    stats.queued = static_cast<int>(queue_.size());
+    stats.completed = completed_;
+    stats.rejected = rejected_;
+    return stats;
+}
+
+bool RenderScheduler::admitLocked() {
+    // Admission control: a slot is either a free worker or a free queue entry
+    const int inFlight = running_ + static_cast<int>(queue_.size());
+    if (stopping_ || inFlight >= getNumWorkers() + maxQueuedJobs_) {
+        ++rejected_;
+        return false;
+    }
+    return true;
+}
+
+void RenderScheduler::workerLoop(int workerIndex) {
+    for (;;) {
+        Ticket* ticket = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobAvailable_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+
+            // Accepted jobs always run, even while shutting down
+            if (queue_.empty()) {
+                return;
+            }
+
+            ticket = queue_.front();
+            queue_.pop_front();
+            ++running_;
+        }
+
+        std::exception_ptr exception;
+        try {
+            (*ticket->job)(workerIndex);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        // Nobody waits on a posted ticket, so the worker frees it
+        const bool posted = ticket->posted;
+        if (posted) {
+            delete ticket;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!posted) {
+                ticket->exception = exception;
+                ticket->done = true;
+            }
+            --running_;
+            ++completed_;
+        }
+        jobFinished_.notify_all();
+    }
+}
+
+} // namespace juceaudioservice
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace juceaudioservice {
+
+/**
+ * Bounded queue of render jobs executed on a fixed set of worker threads.
+ *
+ * At most getNumWorkers() jobs run at once and at most getMaxQueuedJobs()
+ * more wait for a worker; further submissions are rejected instead of
+ * piling up, so callers can apply backpressure. Each job is told which
+ * worker runs it, letting callers keep one render context per worker
+ * without any locking.
+ */
+class RenderScheduler {
+public:
+    /** Job body: workerIndex is in [0, getNumWorkers()). */
+    using Job = std::function<void(int workerIndex)>;
+
+    struct Stats {
+        int running = 0;
+        int queued = 0;
+        uint64_t completed = 0;
+        uint64_t rejected = 0;
+    };
+
+    /**
+     * Create a scheduler.
+     *
+     * @param numWorkers Number of jobs that run concurrently (values below 1 are treated as 1)
+     * @param maxQueuedJobs Number of jobs that may wait for a worker (values below 0 are treated as 0)
+     */
+    RenderScheduler(int numWorkers, int maxQueuedJobs);
+
+    /** Runs every accepted job to completion, then joins the workers. */
+    ~RenderScheduler();
+
+    int getNumWorkers() const noexcept { return static_cast<int>(threads_.size()); }
+    int getMaxQueuedJobs() const noexcept { return maxQueuedJobs_; }
+
+    /**
+     * Run a job on a worker and wait for it to finish.
+     *
+     * Exceptions thrown by the job are rethrown to the caller.
+     *
+     * @param job The job to run
+     * @return false without running the job if every worker is busy and
+     *         the queue is full
+     */
+    bool run(const Job& job);
+
+    /**
+     * Queue a job on a worker and return without waiting for it.
+     *
+     * Admission is the same as run(). The job owns whatever it needs to
+     * report its result; exceptions it throws are discarded.
+     *
+     * @param job The job to run
+     * @return false without queueing the job if every worker is busy and
+     *         the queue is full
+     */
+    bool post(Job job);
+
+    /** Current load and lifetime counters. */
+    Stats getStats() const;
+
+private:
+    struct Ticket {
+        const Job* job = nullptr;
+        std::exception_ptr exception;
+        bool done = false;
+        Job postedJob;   // owned copy for post(); the worker deletes the ticket
+        bool posted = false;
+    };
+
+    std::vector<std::thread> threads_;
+    const int maxQueuedJobs_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable jobAvailable_;
+    std::condition_variable jobFinished_;
+
+    std::deque<Ticket*> queue_;
+    int running_ = 0;
+    uint64_t completed_ = 0;
+    uint64_t rejected_ = 0;
+    bool stopping_ = false;
+
+    bool admitLocked();
+    void workerLoop(int workerIndex);
+
+    RenderScheduler(const RenderScheduler&) = delete;
+    RenderScheduler& operator=(const RenderScheduler&) = delete;
+};
+
+} // namespace juceaudioservice
@@ -0,0 +1,235 @@
+#include "Resampler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace juceaudioservice {
+
+namespace {
+
+constexpr int zeroCrossings = 24;     // per side, at the lower of the two rates
+constexpr double passband = 0.95;     // cutoff relative to the lower Nyquist frequency
+constexpr double kaiserBeta = 9.0;    // about 90 dB stopband attenuation
+constexpr juce::int64 maxDownFactor = 1 << 20;
+
+double besselI0(double x) {
+    // Power series; converges quickly for the beta values used here
+    double sum = 1.0;
+    double term = 1.0;
+    const double halfX = x * 0.5;
+    for (int k = 1; k < 64; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1.0e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+// Best fraction up/down for the ratio with up <= Resampler::maxPhases, from its continued fraction
+bool approximateRatio(double ratio, int& up, int& down) {
+    juce::int64 h0 = 0, h1 = 1;
+    juce::int64 k0 = 1, k1 = 0;
+    double x = ratio;
+
+    for (int i = 0; i < 64; ++i) {
+        const double a = std::floor(x);
+        const juce::int64 h2 = static_cast<juce::int64>(a) * h1 + h0;
+        const juce::int64 k2 = static_cast<juce::int64>(a) * k1 + k0;
+        if (h2 > Resampler::maxPhases || k2 > maxDownFactor) {
+            break;
+        }
+
+        h0 = h1;
+        h1 = h2;
+        k0 = k1;
+        k1 = k2;
+
+        const double fraction = x - a;
+        if (fraction < 1.0e-9) {
+            break;
+        }
+        x = 1.0 / fraction;
+    }
+
+    if (h1 <= 0 || k1 <= 0) {
+        return false;
+    }
+
+    up = static_cast<int>(h1);
+    down = static_cast<int>(k1);
+    return true;
+}
+
+} // namespace
+
+bool Resampler::prepare(double inputRate, double outputRate) {
+    upFactor_ = 0;
+    downFactor_ = 0;
+    coefficients_.clear();
+
+    if (!(inputRate > 0.0) || !(outputRate > 0.0)) {
+        return false;
+    }
+
+    int up = 0;
+    int down = 0;
+    if (!approximateRatio(outputRate / inputRate, up, down)) {
+        return false;
+    }
+
+    upFactor_ = up;
+    downFactor_ = down;
+
+    if (up == down) {
+        upFactor_ = downFactor_ = 1;
+        tapsPerPhase_ = 1;
+        halfTaps_ = 1;
+        coefficients_.assign(1, 1.0f);
+        return true;
+    }
+
+    // Cutoff relative to the input Nyquist frequency, kept below the Nyquist frequency of the lower rate
+    const double cutoff = passband * std::min(1.0, static_cast<double>(up) / down);
+    const double halfWidth = zeroCrossings / cutoff; // kernel support on each side, in input samples
+
+    halfTaps_ = static_cast<int>(std::ceil(halfWidth));
+    tapsPerPhase_ = (2 * halfTaps_ + vectorWidth - 1) / vectorWidth * vectorWidth;
+    coefficients_.assign(static_cast<size_t>(up) * static_cast<size_t>(tapsPerPhase_), 0.0f);
+
+    const double windowNormalisation = 1.0 / besselI0(kaiserBeta);
+
+    for (int phase = 0; phase < up; ++phase) {
+        float* row = coefficients_.data() + static_cast<size_t>(phase) * static_cast<size_t>(tapsPerPhase_);
+        double sum = 0.0;
+
+        // Tap j weights input sample base - halfTaps + 1 + j; x is the output's distance from it
+        for (int j = 0; j < 2 * halfTaps_; ++j) {
+            const double x = static_cast<double>(phase) / up + halfTaps_ - 1 - j;
+            if (std::abs(x) >= halfWidth) {
+                continue;
+            }
+
+            const double u = x / halfWidth;
+            const double window = besselI0(kaiserBeta * std::sqrt(1.0 - u * u)) * windowNormalisation;
+            const double arg = juce::MathConstants<double>::pi * cutoff * x;
+            const double sinc = std::abs(arg) < 1.0e-12 ? 1.0 : std::sin(arg) / arg;
+            const double value = cutoff * sinc * window;
+
+            row[j] = static_cast<float>(value);
+            sum += value;
+        }
+
+        // Unity gain at DC for every phase, so a constant input stays constant
+        if (sum != 0.0) {
+            const float scale = static_cast<float>(1.0 / sum);
+            for (int j = 0; j < tapsPerPhase_; ++j) {
+                row[j] *= scale;
+            }
+        }
+    }
+
+    return true;
+}
+
+void Resampler::getInputRange(juce::int64 firstOutput, int numOutputs, juce::int64& firstInput, int& numInputs) const {
+    if (numOutputs <= 0 || !isPrepared()) {
+        firstInput = 0;
+        numInputs = 0;
+        return;
+    }
+
+    if (isIdentity()) {
+        firstInput = firstOutput;
+        numInputs = numOutputs;
+        return;
+    }
+
+    const juce::int64 firstBase = floorDiv(firstOutput * downFactor_, upFactor_);
+    const juce::int64 lastBase = floorDiv((firstOutput + numOutputs - 1) * downFactor_, upFactor_);
+    firstInput = firstBase - halfTaps_ + 1;
+    numInputs = static_cast<int>(lastBase - firstBase) + tapsPerPhase_;
+}
+
+int Resampler::getMaxInputSamples(int numOutputs) const {
+    if (numOutputs <= 0 || !isPrepared()) {
+        return 0;
+    }
+
+    if (isIdentity()) {
+        return numOutputs;
+    }
+
+    // floor() of the span can round up by at most one sample
+    return static_cast<int>((static_cast<juce::int64>(numOutputs - 1) * downFactor_) / upFactor_) + 1 + tapsPerPhase_;
+}
+
+juce::int64 Resampler::getFirstOutputAtOrAfter(juce::int64 inputPosition) const {
+    if (!isPrepared()) {
+        return 0;
+    }
+
+    // ceil(inputPosition * L / M)
+    return -floorDiv(-inputPosition * upFactor_, downFactor_);
+}
+
+void Resampler::process(const float* input, juce::int64 firstInput, int numInputs,
+                        float* output, juce::int64 firstOutput, int numOutputs) const {
+    if (numOutputs <= 0 || !isPrepared()) {
+        return;
+    }
+
+    if (isIdentity()) {
+        jassert(firstOutput >= firstInput && firstOutput + numOutputs <= firstInput + numInputs);
+        juce::FloatVectorOperations::copy(output, input + (firstOutput - firstInput), numOutputs);
+        return;
+    }
+
+    // Position of the first output: base input sample plus phase / L
+    const juce::int64 position = firstOutput * downFactor_;
+    juce::int64 base = floorDiv(position, upFactor_);
+    int phase = static_cast<int>(position - base * upFactor_);
+
+    const int baseStep = downFactor_ / upFactor_;
+    const int phaseStep = downFactor_ % upFactor_;
+
+    const float* coefficients = coefficients_.data();
+    const auto rowLength = static_cast<size_t>(tapsPerPhase_);
+
+    for (int i = 0; i < numOutputs; ++i) {
+        const juce::int64 start = base - halfTaps_ + 1 - firstInput;
+        jassert(start >= 0 && start + tapsPerPhase_ <= numInputs);
+        juce::ignoreUnused(numInputs);
+
+        output[i] = dotProduct(coefficients + static_cast<size_t>(phase) * rowLength, input + start, tapsPerPhase_);
+
+        base += baseStep;
+        phase += phaseStep;
+        if (phase >= upFactor_) {
+            phase -= upFactor_;
+            ++base;
+        }
+    }
+}
+
+float Resampler::dotProduct(const float* a, const float* b, int numSamples) noexcept {
+    // Independent lanes rather than one running sum, so the loop vectorises without -ffast-math
+    float lanes[vectorWidth] = {};
+    for (int i = 0; i < numSamples; i += vectorWidth) {
+        for (int lane = 0; lane < vectorWidth; ++lane) {
+            lanes[lane] += a[i + lane] * b[i + lane];
+        }
+    }
+
+    return ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+}
+
+juce::int64 Resampler::floorDiv(juce::int64 numerator, juce::int64 denominator) noexcept {
+    juce::int64 quotient = numerator / denominator;
+    if ((numerator % denominator != 0) && ((numerator < 0) != (denominator < 0))) {
+        --quotient;
+    }
+    return quotient;
+}
+
+} // namespace juceaudioservice
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+namespace juceaudioservice {
+
+/**
+ * Polyphase windowed-sinc sample-rate converter.
+ *
+ * The conversion ratio is reduced to a fraction L/M (exact for any pair
+ * of common integer rates) and a Kaiser-windowed sinc filter is
+ * precomputed for each of the L output phases, so every output sample is
+ * one dot product over a contiguous run of input. The dot products use
+ * fixed-width accumulators that the compiler turns into SIMD.
+ *
+ * Output sample n sits at input position n * M / L. Once prepared the
+ * converter holds no stream state: process() computes any run of output
+ * from the input span getInputRange() names, so results never depend on
+ * how a stream is cut into blocks and one converter can be shared by
+ * several threads. Callers that stream keep the input history themselves.
+ */
+class Resampler {
+public:
+    static constexpr int maxPhases = 1024;
+
+    Resampler() = default;
+
+    /**
+     * Build the filter tables for a conversion.
+     *
+     * @param inputRate Sample rate of the input
+     * @param outputRate Sample rate of the output
+     * @return false if either rate is not positive
+     */
+    bool prepare(double inputRate, double outputRate);
+
+    bool isPrepared() const noexcept { return upFactor_ > 0; }
+
+    /** true if input and output rates are equal; process() then copies. */
+    bool isIdentity() const noexcept { return upFactor_ == downFactor_; }
+
+    /** L: output samples per M input samples. */
+    int getUpFactor() const noexcept { return upFactor_; }
+
+    /** M: input samples per L output samples. */
+    int getDownFactor() const noexcept { return downFactor_; }
+
+    /** Input samples each output depends on. */
+    int getFilterLength() const noexcept { return tapsPerPhase_; }
+
+    /**
+     * Input span needed to compute a run of output.
+     *
+     * @param firstOutput Index of the first output sample
+     * @param numOutputs Number of output samples
+     * @param firstInput Receives the index of the first input sample needed (may be negative)
+     * @param numInputs Receives the number of input samples needed
+     */
+    void getInputRange(juce::int64 firstOutput, int numOutputs, juce::int64& firstInput, int& numInputs) const;
+
+    /** Upper bound of getInputRange()'s numInputs for any run of numOutputs samples. */
+    int getMaxInputSamples(int numOutputs) const;
+
+    /** Index of the first output sample at or after an input position. */
+    juce::int64 getFirstOutputAtOrAfter(juce::int64 inputPosition) const;
+
+    /**
+     * Compute a run of output from one channel of input.
+     *
+     * @param input Input samples, input[0] being input index firstInput
+     * @param firstInput Input index of input[0]
+     * @param numInputs Number of valid input samples; must cover getInputRange()
+     * @param output Receives numOutputs samples
+     * @param firstOutput Index of the first output sample
+     * @param numOutputs Number of output samples
+     */
+    void process(const float* input, juce::int64 firstInput, int numInputs,
+                 float* output, juce::int64 firstOutput, int numOutputs) const;
+
+private:
+    static constexpr int vectorWidth = 8;
+
+    int upFactor_ = 0;
+    int downFactor_ = 0;
+    int tapsPerPhase_ = 0;            // multiple of vectorWidth
+    int halfTaps_ = 0;
+    std::vector<float> coefficients_; // upFactor_ rows of tapsPerPhase_
+
+    static float dotProduct(const float* a, const float* b, int numSamples) noexcept;
+    static juce::int64 floorDiv(juce::int64 numerator, juce::int64 denominator) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Resampler)
+};
+
+} // namespace juceaudioservice
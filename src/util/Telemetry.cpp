@@ -0,0 +1,207 @@
+#include "Telemetry.h"
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace juceaudioservice {
+
+namespace {
+
+constexpr double stageFirstBound = 100.0e-6; // seconds; buckets reach about 7 minutes
+constexpr double realtimeFactorFirstBound = 0.125;
+
+std::string formatValue(double value, int precision = std::numeric_limits<double>::max_digits10) {
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+
+    std::ostringstream ss;
+    ss.precision(precision);
+    ss << value;
+    return ss.str();
+}
+
+} // namespace
+
+std::atomic<bool> Telemetry::requestLogging_{true};
+
+Histogram::Histogram(double firstBound, double growth)
+    : firstBound_(firstBound),
+      logGrowth_(std::log(growth)) {
+}
+
+void Histogram::record(double value) noexcept {
+    int bucket = 0;
+    if (value > firstBound_) {
+        bucket = static_cast<int>(std::ceil(std::log(value / firstBound_) / logGrowth_ - 1.0e-9));
+        bucket = std::min(std::max(bucket, 0), numBuckets - 1);
+    }
+
+    buckets_[static_cast<size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot snapshot;
+    for (int i = 0; i < numBuckets; ++i) {
+        snapshot.buckets[static_cast<size_t>(i)] = buckets_[static_cast<size_t>(i)].load(std::memory_order_relaxed);
+        snapshot.bounds[static_cast<size_t>(i)] = i == numBuckets - 1
+            ? std::numeric_limits<double>::infinity()
+            : firstBound_ * std::exp(logGrowth_ * i);
+        snapshot.count += snapshot.buckets[static_cast<size_t>(i)]; // matches the buckets even mid-record()
+    }
+
+    snapshot.sum = sum_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+double Histogram::Snapshot::quantile(double q) const noexcept {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    const double rank = std::min(std::max(q, 0.0), 1.0) * static_cast<double>(count);
+    double seen = 0.0;
+    for (int i = 0; i < numBuckets; ++i) {
+        const double inBucket = static_cast<double>(buckets[static_cast<size_t>(i)]);
+        if (inBucket > 0.0 && seen + inBucket >= rank) {
+            const double lower = i == 0 ? 0.0 : bounds[static_cast<size_t>(i - 1)];
+            if (i == numBuckets - 1) {
+                return lower; // open-ended bucket: report its lower edge
+            }
+            const double upper = bounds[static_cast<size_t>(i)];
+            return lower + (upper - lower) * ((rank - seen) / inBucket);
+        }
+        seen += inBucket;
+    }
+    return bounds[numBuckets - 2];
+}
+
+Telemetry& Telemetry::getInstance() {
+    static Telemetry instance;
+    return instance;
+}
+
+Telemetry::Telemetry()
+    : stages_{{{stageFirstBound, 2.0}, {stageFirstBound, 2.0}, {stageFirstBound, 2.0},
+               {stageFirstBound, 2.0}, {stageFirstBound, 2.0}, {stageFirstBound, 2.0}}},
+      realtimeFactor_(realtimeFactorFirstBound, 2.0) {
+    static_assert(numStages == 6, "initialise a histogram per stage");
+}
+
+void Telemetry::recordStage(Stage stage, double seconds) noexcept {
+    stages_[static_cast<size_t>(stage)].record(seconds);
+}
+
+void Telemetry::recordRealtimeFactor(double factor) noexcept {
+    realtimeFactor_.record(factor);
+}
+
+void Telemetry::add(Counter counter, uint64_t amount) noexcept {
+    counters_[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t Telemetry::get(Counter counter) const noexcept {
+    return counters_[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Telemetry::getStage(Stage stage) const {
+    return stages_[static_cast<size_t>(stage)].snapshot();
+}
+
+Histogram::Snapshot Telemetry::getRealtimeFactor() const {
+    return realtimeFactor_.snapshot();
+}
+
+const char* Telemetry::getStageName(Stage stage) noexcept {
+    switch (stage) {
+        case Stage::Validate: return "validate";
+        case Stage::Compile: return "compile";
+        case Stage::Mix: return "mix";
+        case Stage::Write: return "write";
+        case Stage::Hash: return "hash";
+        case Stage::Render: return "render";
+        case Stage::count: break;
+    }
+    return "unknown";
+}
+
+double Telemetry::secondsSince(std::chrono::steady_clock::time_point start) noexcept {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Telemetry::setRequestLogging(bool enabled) noexcept {
+    requestLogging_.store(enabled, std::memory_order_relaxed);
+}
+
+bool Telemetry::isRequestLogging() noexcept {
+    return requestLogging_.load(std::memory_order_relaxed);
+}
+
+std::ostream& requestLog() {
+    // Per thread, since a stream without a buffer records each dropped write in its state
+    thread_local std::ostream discard(nullptr);
+    return Telemetry::isRequestLogging() ? std::cout : discard;
+}
+
+void PrometheusText::addCounter(const std::string& name, const std::string& help, double value,
+                                const std::string& labels) {
+    beginFamily(name, help, "counter");
+    addSample(name, labels, value);
+}
+
+void PrometheusText::addGauge(const std::string& name, const std::string& help, double value,
+                              const std::string& labels) {
+    beginFamily(name, help, "gauge");
+    addSample(name, labels, value);
+}
+
+void PrometheusText::addHistogram(const std::string& name, const std::string& help,
+                                  const Histogram::Snapshot& histogram, const std::string& labels) {
+    beginFamily(name, help, "histogram");
+
+    const std::string prefix = labels.empty() ? std::string() : labels + ",";
+    uint64_t cumulative = 0;
+    for (int i = 0; i < Histogram::numBuckets; ++i) {
+        cumulative += histogram.buckets[static_cast<size_t>(i)];
+        addSample(name + "_bucket", prefix + label("le", formatValue(histogram.bounds[static_cast<size_t>(i)], 6)),
+                  static_cast<double>(cumulative));
+    }
+    addSample(name + "_sum", labels, histogram.sum);
+    addSample(name + "_count", labels, static_cast<double>(histogram.count));
+}
+
+std::string PrometheusText::label(const std::string& name, const std::string& value) {
+    std::string result = name + "=\"";
+    for (char c : value) {
+        switch (c) {
+            case '\\': result += "\\\\"; break;
+            case '"': result += "\\\""; break;
+            case '\n': result += "\\n"; break;
+            default: result += c; break;
+        }
+    }
+    return result + "\"";
+}
+
+void PrometheusText::beginFamily(const std::string& name, const std::string& help, const char* type) {
+    if (name == lastFamily_) {
+        return;
+    }
+
+    lastFamily_ = name;
+    text_ += "# HELP " + name + " " + help + "\n";
+    text_ += "# TYPE " + name + " " + type + "\n";
+}
+
+void PrometheusText::addSample(const std::string& name, const std::string& labels, double value) {
+    text_ += name;
+    if (!labels.empty()) {
+        text_ += "{" + labels + "}";
+    }
+    text_ += " " + formatValue(value) + "\n";
+}
+
+} // namespace juceaudioservice
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace juceaudioservice {
+
+/**
+ * Histogram over fixed exponential buckets.
+ *
+ * Bucket i counts values up to firstBound * growth^i; the last bucket
+ * takes everything above. record() is a few relaxed atomic adds, so it
+ * can be called from render threads without a lock.
+ */
+class Histogram {
+public:
+    static constexpr int numBuckets = 24;
+
+    struct Snapshot {
+        uint64_t count = 0;
+        double sum = 0.0;
+        std::array<uint64_t, numBuckets> buckets{}; // counts per bucket, not cumulative
+        std::array<double, numBuckets> bounds{};    // upper bound of each bucket; the last is infinite
+
+        /** Estimate a quantile by interpolating inside its bucket; 0 if empty. */
+        double quantile(double q) const noexcept;
+    };
+
+    /**
+     * @param firstBound Upper bound of the first bucket
+     * @param growth Ratio between consecutive bucket bounds
+     */
+    Histogram(double firstBound, double growth);
+
+    void record(double value) noexcept;
+
+    Snapshot snapshot() const;
+
+private:
+    const double firstBound_;
+    const double logGrowth_;
+    std::array<std::atomic<uint64_t>, numBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<double> sum_{0.0};
+
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+};
+
+/**
+ * Process-wide render telemetry.
+ *
+ * Stage histograms hold one sample per request: the total seconds that
+ * request spent validating, compiling, mixing, writing or hashing, and
+ * the wall time of the whole render. Gauges such as queue depth live
+ * with their owners and are read when stats are reported.
+ */
+class Telemetry {
+public:
+    enum class Stage {
+        Validate,
+        Compile,
+        Mix,
+        Write,
+        Hash,
+        Render, // whole render request, queueing excluded
+        count
+    };
+
+    enum class Counter {
+        RendersCompleted,
+        RendersFailed,
+        RendersRejected,
+        FramesRendered,
+        count
+    };
+
+    static constexpr int numStages = static_cast<int>(Stage::count);
+    static constexpr int numCounters = static_cast<int>(Counter::count);
+
+    /** Adds the time from construction to destruction to a stage. */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Stage stage) : stage_(stage), start_(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() { getInstance().recordStage(stage_, secondsSince(start_)); }
+
+    private:
+        const Stage stage_;
+        const std::chrono::steady_clock::time_point start_;
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    };
+
+    /** The telemetry shared by everything in the process. */
+    static Telemetry& getInstance();
+
+    Telemetry();
+
+    void recordStage(Stage stage, double seconds) noexcept;
+
+    /** Seconds of audio rendered per second of wall time, one sample per render. */
+    void recordRealtimeFactor(double factor) noexcept;
+
+    void add(Counter counter, uint64_t amount = 1) noexcept;
+
+    uint64_t get(Counter counter) const noexcept;
+
+    Histogram::Snapshot getStage(Stage stage) const;
+    Histogram::Snapshot getRealtimeFactor() const;
+
+    /** Lowercase stage name used in stats and metric labels. */
+    static const char* getStageName(Stage stage) noexcept;
+
+    static double secondsSince(std::chrono::steady_clock::time_point start) noexcept;
+
+    /** Turn per-request log lines on or off; on by default. */
+    static void setRequestLogging(bool enabled) noexcept;
+    static bool isRequestLogging() noexcept;
+
+private:
+    std::array<Histogram, numStages> stages_;
+    Histogram realtimeFactor_;
+    std::array<std::atomic<uint64_t>, numCounters> counters_{};
+
+    static std::atomic<bool> requestLogging_;
+
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+};
+
+/**
+ * Stream for per-request log lines: std::cout, or a sink that drops them
+ * when request logging is off.
+ */
+std::ostream& requestLog();
+
+/**
+ * Builds a Prometheus text exposition (format 0.0.4).
+ *
+ * Each metric family is written once with its HELP and TYPE lines; call
+ * the add functions of one family back to back, varying only the labels.
+ */
+class PrometheusText {
+public:
+    /**
+     * @param name Metric name
+     * @param help One-line description
+     * @param value Current value
+     * @param labels Rendered label set such as stage="mix", or empty
+     */
+    void addCounter(const std::string& name, const std::string& help, double value, const std::string& labels = {});
+    void addGauge(const std::string& name, const std::string& help, double value, const std::string& labels = {});
+    void addHistogram(const std::string& name, const std::string& help, const Histogram::Snapshot& histogram,
+                      const std::string& labels = {});
+
+    /** Quote a label value, escaping as the format requires. */
+    static std::string label(const std::string& name, const std::string& value);
+
+    const std::string& getText() const noexcept { return text_; }
+
+private:
+    std::string text_;
+    std::string lastFamily_;
+
+    void beginFamily(const std::string& name, const std::string& help, const char* type);
+    void addSample(const std::string& name, const std::string& labels, double value);
+};
+
+} // namespace juceaudioservice
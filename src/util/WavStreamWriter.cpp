@@ -0,0 +1,217 @@
+#include "WavStreamWriter.h"
+#include <algorithm>
+#include <limits>
+
+namespace juceaudioservice {
+
+namespace {
+
+constexpr int maxFramesPerChunk = 4096;
+
+// JUNK in a RIFF file, ds64 in an RF64 one: RIFF size, data size and frame count (64-bit), table length
+constexpr int ds64ChunkSize = 28;
+
+using FloatSource = juce::AudioData::Pointer<juce::AudioData::Float32, juce::AudioData::NativeEndian,
+                                             juce::AudioData::NonInterleaved, juce::AudioData::Const>;
+using IntScratch = juce::AudioData::Pointer<juce::AudioData::Int32, juce::AudioData::NativeEndian,
+                                            juce::AudioData::NonInterleaved, juce::AudioData::NonConst>;
+using IntSource = juce::AudioData::Pointer<juce::AudioData::Int32, juce::AudioData::NativeEndian,
+                                           juce::AudioData::NonInterleaved, juce::AudioData::Const>;
+
+template <typename SampleFormat>
+using InterleavedDest = juce::AudioData::Pointer<SampleFormat, juce::AudioData::LittleEndian,
+                                                 juce::AudioData::Interleaved, juce::AudioData::NonConst>;
+
+} // namespace
+
+WavStreamWriter::WavStreamWriter(juce::OutputStream& output, int sampleRate, int numChannels,
+                                 int bitsPerSample, juce::int64 lengthInSamples)
+    : output_(output),
+      sampleRate_(sampleRate),
+      numChannels_(numChannels),
+      bitsPerSample_(bitsPerSample),
+      lengthInSamples_(lengthInSamples) {
+
+    // The fmt chunk stores the frame size in 16 bits and the byte rate in 32
+    const bool supportedFormat = (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32) &&
+                                 numChannels > 0 && numChannels * (bitsPerSample / 8) <= 0xffff &&
+                                 sampleRate > 0 &&
+                                 static_cast<juce::uint64>(sampleRate) * static_cast<juce::uint64>(numChannels) *
+                                         static_cast<juce::uint64>(bitsPerSample / 8) <=
+                                     std::numeric_limits<juce::uint32>::max();
+
+    // Beyond 4 GB the sizes go in the ds64 chunk, which holds 64-bit sizes
+    valid_ = supportedFormat && lengthInSamples >= 0 &&
+             getDataSize() < static_cast<juce::uint64>(std::numeric_limits<juce::int64>::max()) - headerSize;
+
+    if (valid_) {
+        frameScratch_.resize(static_cast<size_t>(maxFramesPerChunk) * static_cast<size_t>(numChannels) *
+                             static_cast<size_t>(bitsPerSample / 8));
+    }
+}
+
+juce::uint64 WavStreamWriter::getDataSize() const noexcept {
+    return static_cast<juce::uint64>(std::max<juce::int64>(0, lengthInSamples_)) *
+           static_cast<juce::uint64>(std::max(0, numChannels_)) * static_cast<juce::uint64>(bitsPerSample_ / 8);
+}
+
+bool WavStreamWriter::writeHeader() {
+    if (!valid_) {
+        return false;
+    }
+
+    const juce::uint64 dataSize = getDataSize();
+    const juce::uint64 padding = dataSize & 1; // chunks are word aligned
+    const juce::uint64 riffSize = static_cast<juce::uint64>(headerSize - 8) + dataSize + padding;
+    const bool isRF64 = riffSize >= std::numeric_limits<juce::uint32>::max();
+
+    const auto bytesPerSample = static_cast<juce::uint32>(bitsPerSample_ / 8);
+    const auto blockAlign = static_cast<juce::uint32>(numChannels_) * bytesPerSample;
+    const auto byteRate = static_cast<juce::uint32>(sampleRate_) * blockAlign;
+    const bool isFloat = bitsPerSample_ == 32;
+
+    // RF64 stores 0xffffffff in the 32-bit size fields and the real sizes in ds64
+    auto size32 = [isRF64](juce::uint64 size) {
+        return static_cast<int>(isRF64 ? std::numeric_limits<juce::uint32>::max() : static_cast<juce::uint32>(size));
+    };
+
+    bool ok = output_.write(isRF64 ? "RF64" : "RIFF", 4)
+           && output_.writeInt(size32(riffSize))
+           && output_.write("WAVE", 4);
+
+    if (isRF64) {
+        ok = ok && output_.write("ds64", 4)
+                && output_.writeInt(ds64ChunkSize)
+                && output_.writeInt64(static_cast<juce::int64>(riffSize))
+                && output_.writeInt64(static_cast<juce::int64>(dataSize))
+                && output_.writeInt64(lengthInSamples_)
+                && output_.writeInt(0); // no table entries
+    } else {
+        ok = ok && output_.write("JUNK", 4)
+                && output_.writeInt(ds64ChunkSize)
+                && output_.writeRepeatedByte(0, ds64ChunkSize);
+    }
+
+    ok = ok && output_.write("fmt ", 4)
+            && output_.writeInt(16)
+            && output_.writeShort(static_cast<short>(isFloat ? 3 : 1)) // IEEE float or PCM
+            && output_.writeShort(static_cast<short>(numChannels_))
+            && output_.writeInt(sampleRate_)
+            && output_.writeInt(static_cast<int>(byteRate))
+            && output_.writeShort(static_cast<short>(blockAlign))
+            && output_.writeShort(static_cast<short>(bitsPerSample_))
+            && output_.write("data", 4)
+            && output_.writeInt(size32(dataSize));
+
+    headerWritten_ = true;
+    return ok;
+}
+
+void WavStreamWriter::encodeFrames(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                   int numChannels, int bitsPerSample, void* dest) {
+    const int bytesPerSample = bitsPerSample / 8;
+    const int frameBytes = numChannels * bytesPerSample;
+    const int sourceChannels = std::min(buffer.getNumChannels(), numChannels);
+
+    int intScratch[maxFramesPerChunk];
+
+    for (int done = 0; done < numSamples;) {
+        const int count = std::min(maxFramesPerChunk, numSamples - done);
+        char* frames = static_cast<char*>(dest) + static_cast<size_t>(done) * frameBytes;
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            char* channelDest = frames + ch * bytesPerSample;
+
+            if (ch >= sourceChannels) {
+                // Missing channels are silent in every format
+                for (int i = 0; i < count; ++i) {
+                    std::fill_n(channelDest + static_cast<size_t>(i) * frameBytes, bytesPerSample, 0);
+                }
+                continue;
+            }
+
+            const float* source = buffer.getReadPointer(ch, startSample + done);
+
+            if (bitsPerSample == 32) {
+                InterleavedDest<juce::AudioData::Float32>(channelDest, numChannels)
+                    .convertSamples(FloatSource(source), count);
+                continue;
+            }
+
+            // Like AudioFormatWriter: quantize to 32-bit first, then narrow
+            IntScratch(intScratch).convertSamples(FloatSource(source), count);
+
+            if (bitsPerSample == 16) {
+                InterleavedDest<juce::AudioData::Int16>(channelDest, numChannels)
+                    .convertSamples(IntSource(intScratch), count);
+            } else {
+                InterleavedDest<juce::AudioData::Int24>(channelDest, numChannels)
+                    .convertSamples(IntSource(intScratch), count);
+            }
+        }
+
+        done += count;
+    }
+}
+
+bool WavStreamWriter::write(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) {
+    if (!valid_ || numSamples < 0 || samplesWritten_ + numSamples > lengthInSamples_) {
+        return false;
+    }
+
+    if (!headerWritten_ && !writeHeader()) {
+        return false;
+    }
+
+    const size_t frameBytes = static_cast<size_t>(numChannels_) * static_cast<size_t>(bitsPerSample_ / 8);
+
+    for (int done = 0; done < numSamples;) {
+        const int count = std::min(maxFramesPerChunk, numSamples - done);
+        encodeFrames(buffer, startSample + done, count, numChannels_, bitsPerSample_, frameScratch_.data());
+
+        if (!output_.write(frameScratch_.data(), static_cast<size_t>(count) * frameBytes)) {
+            return false;
+        }
+        done += count;
+    }
+
+    samplesWritten_ += numSamples;
+    return true;
+}
+
+bool WavStreamWriter::writeEncoded(const void* frames, int numFrames) {
+    if (!valid_ || numFrames < 0 || samplesWritten_ + numFrames > lengthInSamples_) {
+        return false;
+    }
+
+    if (!headerWritten_ && !writeHeader()) {
+        return false;
+    }
+
+    const size_t frameBytes = static_cast<size_t>(numChannels_) * static_cast<size_t>(bitsPerSample_ / 8);
+    if (!output_.write(frames, static_cast<size_t>(numFrames) * frameBytes)) {
+        return false;
+    }
+
+    samplesWritten_ += numFrames;
+    return true;
+}
+
+bool WavStreamWriter::finish() {
+    if (!valid_ || (!headerWritten_ && !writeHeader())) {
+        return false;
+    }
+
+    if (samplesWritten_ != lengthInSamples_) {
+        return false;
+    }
+
+    if ((getDataSize() & 1) != 0 && !output_.writeByte(0)) {
+        return false;
+    }
+
+    output_.flush();
+    return true;
+}
+
+} // namespace juceaudioservice
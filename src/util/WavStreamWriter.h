@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+namespace juceaudioservice {
+
+/**
+ * WAV writer for output whose length is known before the first sample.
+ *
+ * juce::WavAudioFormat writes a placeholder header and seeks back to fix
+ * it up when closed. This writer emits the final header up front and then
+ * the interleaved frames strictly in order, so the destination is never
+ * seeked and can be hashed or streamed while it is written. Samples are
+ * quantized exactly like juce::WavAudioFormat.
+ *
+ * Like juce::WavAudioFormat, the header reserves a JUNK chunk after the
+ * RIFF header. When the file would pass the 4 GB RIFF limit it is written
+ * as RF64 instead, and that chunk becomes the ds64 chunk holding the
+ * 64-bit sizes, so the header has the same size either way.
+ */
+class WavStreamWriter {
+public:
+    /** Bytes before the first frame; frame n starts at headerSize + n * frame size. */
+    static constexpr int headerSize = 80;
+
+    /**
+     * @param output Destination; must outlive the writer
+     * @param sampleRate Sample rate stored in the header
+     * @param numChannels Number of interleaved channels
+     * @param bitsPerSample 16 or 24 for integer PCM, 32 for float
+     * @param lengthInSamples Exact number of frames that will be written
+     */
+    WavStreamWriter(juce::OutputStream& output, int sampleRate, int numChannels,
+                    int bitsPerSample, juce::int64 lengthInSamples);
+
+    /** false if the format or the length is unsupported. */
+    bool isValid() const noexcept { return valid_; }
+
+    /**
+     * Append frames, writing the header first if needed.
+     *
+     * Buffer channels beyond the writer's are ignored and missing ones are
+     * written as silence.
+     *
+     * @param buffer Source audio
+     * @param startSample First sample of the buffer to write
+     * @param numSamples Number of frames to write
+     * @return false on a stream error or when writing past the declared length
+     */
+    bool write(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /**
+     * Append frames that are already interleaved in this writer's format.
+     *
+     * @param frames numFrames frames of little-endian samples
+     * @param numFrames Number of frames to write
+     * @return false on a stream error or when writing past the declared length
+     */
+    bool writeEncoded(const void* frames, int numFrames);
+
+    /**
+     * Complete the file.
+     *
+     * @return false unless exactly the declared number of frames was written
+     */
+    bool finish();
+
+    juce::int64 getSamplesWritten() const noexcept { return samplesWritten_; }
+
+    /**
+     * Write only the header, at the output's current position.
+     *
+     * For callers that place the frames themselves (encodeFrames() at
+     * headerSize plus the frame offset); write() and finish() then must
+     * not be used.
+     *
+     * @return false on a stream error or if the format is invalid
+     */
+    bool writeHeader();
+
+    /**
+     * Interleave and quantize samples the way they are stored in a WAV file.
+     *
+     * @param buffer Source audio; missing channels are encoded as silence
+     * @param startSample First sample of the buffer to encode
+     * @param numSamples Number of frames to encode
+     * @param numChannels Number of interleaved output channels
+     * @param bitsPerSample 16 or 24 for integer PCM, 32 for float
+     * @param dest Receives numSamples * numChannels * bitsPerSample / 8 bytes
+     */
+    static void encodeFrames(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                             int numChannels, int bitsPerSample, void* dest);
+
+private:
+    juce::OutputStream& output_;
+    const int sampleRate_;
+    const int numChannels_;
+    const int bitsPerSample_;
+    const juce::int64 lengthInSamples_;
+    juce::int64 samplesWritten_ = 0;
+    bool headerWritten_ = false;
+    bool valid_ = false;
+
+    std::vector<char> frameScratch_; // interleaved output bytes
+
+    juce::uint64 getDataSize() const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavStreamWriter)
+};
+
+} // namespace juceaudioservice
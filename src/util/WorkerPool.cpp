@@ -0,0 +1,102 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+namespace juceaudioservice {
+
+WorkerPool::WorkerPool(int numThreads) {
+    const int numWorkers = std::max(1, numThreads) - 1;
+    threads_.reserve(static_cast<size_t>(numWorkers));
+
+    for (int i = 0; i < numWorkers; ++i) {
+        threads_.emplace_back([this, i] { workerLoop(i + 1); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkerPool::parallelFor(int numTasks, const Task& task) {
+    if (numTasks <= 0) {
+        return;
+    }
+
+    if (threads_.empty() || numTasks == 1) {
+        for (int i = 0; i < numTasks; ++i) {
+            task(i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        numTasks_ = numTasks;
+        nextTask_.store(0, std::memory_order_relaxed);
+        activeWorkers_ = static_cast<int>(threads_.size());
+        ++generation_;
+    }
+    workAvailable_.notify_all();
+
+    // The caller works alongside the pool
+    runTasks(task, numTasks, 0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    workFinished_.wait(lock, [this] { return activeWorkers_ == 0; });
+    task_ = nullptr;
+}
+
+void WorkerPool::workerLoop(int workerIndex) {
+    uint64_t seenGeneration = 0;
+
+    for (;;) {
+        const Task* task = nullptr;
+        int numTasks = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [this, seenGeneration] {
+                return stopping_ || generation_ != seenGeneration;
+            });
+
+            if (stopping_) {
+                return;
+            }
+
+            seenGeneration = generation_;
+            task = task_;
+            numTasks = numTasks_;
+        }
+
+        runTasks(*task, numTasks, workerIndex);
+
+        bool lastWorker = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lastWorker = (--activeWorkers_ == 0);
+        }
+        if (lastWorker) {
+            workFinished_.notify_one();
+        }
+    }
+}
+
+void WorkerPool::runTasks(const Task& task, int numTasks, int workerIndex) {
+    for (;;) {
+        const int index = nextTask_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= numTasks) {
+            return;
+        }
+        task(index, workerIndex);
+    }
+}
+
+} // namespace juceaudioservice
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace juceaudioservice {
+
+/**
+ * Fixed-size pool of worker threads for fork/join style loops.
+ *
+ * parallelFor distributes task indices over the workers and the calling
+ * thread, and returns once every task has finished. Dispatch does not
+ * allocate, so the pool can be driven from a steady-state render loop.
+ */
+class WorkerPool {
+public:
+    /** Task body: (taskIndex, workerIndex). workerIndex 0 is the calling thread. */
+    using Task = std::function<void(int taskIndex, int workerIndex)>;
+
+    /**
+     * Create a pool.
+     *
+     * @param numThreads Total number of threads taking part in parallelFor,
+     *                   including the caller (values below 1 are treated as 1)
+     */
+    explicit WorkerPool(int numThreads);
+    ~WorkerPool();
+
+    /** Number of threads that execute tasks, including the caller. */
+    int getNumThreads() const noexcept { return static_cast<int>(threads_.size()) + 1; }
+
+    /**
+     * Run task(i, worker) for every i in [0, numTasks) and wait for completion.
+     *
+     * Only one parallelFor may be in flight per pool at a time.
+     */
+    void parallelFor(int numTasks, const Task& task);
+
+private:
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable workFinished_;
+
+    const Task* task_ = nullptr;
+    int numTasks_ = 0;
+    int activeWorkers_ = 0;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+    std::atomic<int> nextTask_{0};
+
+    void workerLoop(int workerIndex);
+    void runTasks(const Task& task, int numTasks, int workerIndex);
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+};
+
+} // namespace juceaudioservice
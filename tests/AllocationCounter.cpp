@@ -0,0 +1,85 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<bool> countingAllThreads{false};
+thread_local bool countingThisThread = false; // constant-initialised, so reading it never allocates
+std::atomic<uint64_t> allocationCount{0};
+std::atomic<uint64_t> allocatedBytes{0};
+
+void* countedAlloc(std::size_t size) noexcept {
+    if (countingThisThread || countingAllThreads.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+} // namespace
+
+namespace testhelpers {
+
+void AllocationCounter::setCountingAllThreads(bool enabled) noexcept {
+    countingAllThreads.store(enabled, std::memory_order_relaxed);
+}
+
+void AllocationCounter::setCountingThisThread(bool enabled) noexcept {
+    countingThisThread = enabled;
+}
+
+uint64_t AllocationCounter::getCount() noexcept {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocationCounter::getBytes() noexcept {
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::reset() noexcept {
+    allocationCount.store(0, std::memory_order_relaxed);
+    allocatedBytes.store(0, std::memory_order_relaxed);
+}
+
+} // namespace testhelpers
+
+// Aligned allocations are left to the library
+void* operator new(std::size_t size) {
+    if (void* memory = countedAlloc(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* memory = countedAlloc(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+namespace testhelpers {
+
+/**
+ * Counts heap allocations made through the global operator new.
+ *
+ * AllocationCounter.cpp replaces the global operator new and delete, so
+ * it is linked into each executable that counts allocations and never
+ * into a library. Counting is off until enabled, either for every thread
+ * or only for the calling one.
+ */
+struct AllocationCounter {
+    /** Count allocations on every thread while enabled. */
+    static void setCountingAllThreads(bool enabled) noexcept;
+
+    /** Count allocations made by the calling thread while enabled. */
+    static void setCountingThisThread(bool enabled) noexcept;
+
+    /** Allocations counted since the last reset(). */
+    static uint64_t getCount() noexcept;
+
+    /** Bytes requested by the counted allocations since the last reset(). */
+    static uint64_t getBytes() noexcept;
+
+    static void reset() noexcept;
+};
+
+} // namespace testhelpers
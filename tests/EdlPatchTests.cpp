@@ -0,0 +1,491 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "edl/EdlStore.h"
+#include "edl/EdlCompiler.h"
+#include "edl/EdlRenderer.h"
+#include "util/MediaInfoCache.h"
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "TestHelpers.h"
+
+using testhelpers::buffersIdentical;
+using testhelpers::fixturePath;
+
+static const testhelpers::ClipFades clipFades{ 800, 1600, audio_engine::Fade::EQUAL_POWER };
+
+static audio_engine::Clip makeClip(const std::string& id, const std::string& mediaId,
+                                   int64_t startInMedia, int64_t startInTimeline, int64_t duration) {
+    return testhelpers::makeClip(id, mediaId, startInMedia, startInTimeline, duration, clipFades);
+}
+
+static audio_engine::Edl makeTestEdl(int numTracks) {
+    testhelpers::TestEdlLayout layout;
+    layout.numTracks = numTracks;
+    layout.clipsPerTrack = 4;
+    layout.clipSpacing = 5000;
+    layout.trackOffset = 211;
+    layout.mediaStep = 500;
+    layout.clipDuration = 6000;
+    layout.fades = clipFades;
+    layout.trackGainDb = [](int t) { return -1.0f * static_cast<float>(t % 3); };
+    return testhelpers::makeTestEdl("patch-test", layout);
+}
+
+static audio_engine::Track* findTrack(audio_engine::Edl& edl, const std::string& id) {
+    for (auto& track : *edl.mutable_tracks()) {
+        if (track.id() == id) {
+            return &track;
+        }
+    }
+    return nullptr;
+}
+
+bool testPatchMatchesFullCompile() {
+    std::cout << "Testing incremental patch matches a full replace..." << std::endl;
+
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    if (!store.replace(makeTestEdl(6), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+
+    juceaudioservice::EdlCompiler compiler;
+    juceaudioservice::EdlCompiler::CompiledEdl base;
+    if (!compiler.compile(snapshot, base, error)) {
+        std::cout << "ERROR: EDL compilation failed: " << error << std::endl;
+        return false;
+    }
+
+    auto storedBase = store.getCompiled();
+
+    // Nudge a clip, delete one, add one, retrim a track and add a new track
+    audio_engine::PatchEdlRequest request;
+    request.set_edl_id("patch-test");
+    request.set_base_revision(snapshot.revision);
+
+    auto moved = makeClip("t2c3", "voice", 1500, 15900, 6000);
+    moved.set_gain_db(-4.0f);
+
+    auto* edit = request.add_edits();
+    edit->set_track_id("t2");
+    *edit->mutable_modify_clip() = moved;
+
+    edit = request.add_edits();
+    edit->set_track_id("t4");
+    edit->set_remove_clip_id("t4c1");
+
+    edit = request.add_edits();
+    edit->set_track_id("t0");
+    *edit->mutable_add_clip() = makeClip("t0c4", "voice", 3000, 2500, 7000);
+
+    edit = request.add_edits();
+    edit->set_track_id("t5");
+    edit->mutable_modify_track()->set_gain_db(-6.0f);
+
+    audio_engine::Track newTrack;
+    newTrack.set_id("t6");
+    *newTrack.add_clips() = makeClip("t6c0", "voice", 0, 100, 9000);
+    *newTrack.add_clips() = makeClip("t6c1", "voice", 9000, 8000, 9000);
+    *request.add_edits()->mutable_add_track() = newTrack;
+
+    juceaudioservice::EdlStore::PatchResult patchResult;
+    if (!store.patch(request, patchResult, error)) {
+        std::cout << "ERROR: patch failed: " << error << std::endl;
+        return false;
+    }
+
+    bool result = true;
+    const std::vector<std::string> expectedDirty = { "t2", "t4", "t0", "t5", "t6" };
+    if (patchResult.dirty_track_ids != expectedDirty) {
+        std::cout << "ERROR: unexpected dirty tracks" << std::endl;
+        result = false;
+    }
+
+    if (patchResult.track_count != 7 || patchResult.clip_count != 6 * 4 - 1 + 1 + 2) {
+        std::cout << "ERROR: unexpected counts: " << patchResult.track_count << " tracks, "
+                  << patchResult.clip_count << " clips" << std::endl;
+        result = false;
+    }
+
+    if (patchResult.base_revision != snapshot.revision || patchResult.revision == snapshot.revision) {
+        std::cout << "ERROR: patch did not advance the revision" << std::endl;
+        result = false;
+    }
+
+    auto patched = store.get();
+    juceaudioservice::EdlCompiler::CompiledEdl incremental;
+    if (!patched || !compiler.compileIncremental(*patched, base, patchResult.dirty_track_ids, incremental, error)) {
+        std::cout << "ERROR: incremental compile failed: " << error << std::endl;
+        return false;
+    }
+
+    // Untouched tracks must be shared, not rebuilt
+    if (incremental.tracks.size() != 7 ||
+        incremental.tracks[1] != base.tracks[1] || incremental.tracks[3] != base.tracks[3] ||
+        incremental.tracks[2] == base.tracks[2]) {
+        std::cout << "ERROR: incremental compile did not reuse the untouched tracks" << std::endl;
+        result = false;
+    }
+
+    // The store recompiled the patched revision the same way
+    auto stored = store.getCompiled();
+    if (!storedBase || !stored || stored->revision != patchResult.revision ||
+        stored->tracks.size() != 7 || stored->tracks[1] != storedBase->tracks[1] ||
+        stored != store.getCompiled()) {
+        std::cout << "ERROR: store did not keep the compiled patch revision" << std::endl;
+        result = false;
+    }
+
+    // Apply the same edits by hand and compile from scratch
+    audio_engine::Edl expectedEdl = makeTestEdl(6);
+    for (auto& clip : *findTrack(expectedEdl, "t2")->mutable_clips()) {
+        if (clip.id() == "t2c3") {
+            clip = moved;
+        }
+    }
+    findTrack(expectedEdl, "t4")->mutable_clips()->DeleteSubrange(1, 1);
+    *findTrack(expectedEdl, "t0")->add_clips() = makeClip("t0c4", "voice", 3000, 2500, 7000);
+    findTrack(expectedEdl, "t5")->set_gain_db(-6.0f);
+    *expectedEdl.add_tracks() = newTrack;
+
+    juceaudioservice::EdlStore expectedStore;
+    juceaudioservice::EdlStore::Snapshot expectedSnapshot;
+    juceaudioservice::EdlCompiler::CompiledEdl full;
+    if (!expectedStore.replace(expectedEdl, expectedSnapshot, error) ||
+        !compiler.compile(expectedSnapshot, full, error)) {
+        std::cout << "ERROR: expected EDL failed: " << error << std::endl;
+        return false;
+    }
+
+    // Revisions follow content: the rehashed tracks agree with a full hash and with a replace
+    if (juceaudioservice::EdlStore::calculateRevision(patched->edl) != patchResult.revision ||
+        expectedSnapshot.revision != patchResult.revision) {
+        std::cout << "ERROR: patch revision differs from the revision of the same content" << std::endl;
+        result = false;
+    }
+
+    audio_engine::TimeRange range;
+    range.set_start_samples(0);
+    range.set_duration_samples(30000);
+
+    juceaudioservice::EdlRenderer renderer;
+    juce::AudioBuffer<float> incrementalRender, fullRender;
+    if (!renderer.renderToBuffer(incremental, range, incrementalRender, nullptr, error) ||
+        !renderer.renderToBuffer(full, range, fullRender, nullptr, error)) {
+        std::cout << "ERROR: render failed: " << error << std::endl;
+        return false;
+    }
+
+    if (!buffersIdentical(incrementalRender, fullRender)) {
+        std::cout << "ERROR: patched render differs from a full replace" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Incremental patch test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testFailedPatchLeavesEdlUnchanged() {
+    std::cout << "Testing failed patches leave the EDL unchanged..." << std::endl;
+
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    if (!store.replace(makeTestEdl(2), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+
+    // A valid edit followed by a clip past the end of its media
+    audio_engine::PatchEdlRequest request;
+    request.set_edl_id("patch-test");
+
+    auto* edit = request.add_edits();
+    edit->set_track_id("t0");
+    edit->set_remove_clip_id("t0c0");
+
+    edit = request.add_edits();
+    edit->set_track_id("t1");
+    *edit->mutable_add_clip() = makeClip("t1c9", "voice", 20000, 0, 10000);
+
+    bool result = true;
+    juceaudioservice::EdlStore::PatchResult patchResult;
+    if (store.patch(request, patchResult, error)) {
+        std::cout << "ERROR: invalid patch was accepted" << std::endl;
+        result = false;
+    }
+
+    auto current = store.get();
+    if (!current || current->revision != snapshot.revision ||
+        current->edl.SerializeAsString() != snapshot.edl.SerializeAsString()) {
+        std::cout << "ERROR: failed patch modified the EDL" << std::endl;
+        result = false;
+    }
+
+    // Stale base revisions are reported as such
+    request.mutable_edits()->DeleteSubrange(1, 1);
+    request.set_base_revision("000000000000");
+    patchResult = {};
+    if (store.patch(request, patchResult, error) || !patchResult.stale_base) {
+        std::cout << "ERROR: stale base revision was not rejected" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Failed patch test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testRevisionsAreStableContentHashes() {
+    std::cout << "Testing revisions are stable hashes of EDL content..." << std::endl;
+
+    audio_engine::Edl edl;
+    edl.set_id("revision-golden");
+    edl.set_sample_rate(48000);
+
+    auto* media = edl.add_media();
+    media->set_id("m0");
+    media->set_path("/media/m0.wav");
+    media->set_sample_rate(48000);
+    media->set_channels(2);
+
+    auto* track = edl.add_tracks();
+    track->set_id("t0");
+    track->set_gain_db(-3.0f);
+
+    auto* clip = track->add_clips();
+    clip->set_id("c0");
+    clip->set_media_id("m0");
+    clip->set_start_in_media(0);
+    clip->set_start_in_timeline(480);
+    clip->set_duration(48000);
+    clip->set_gain_db(-1.5f);
+    clip->mutable_fade_in()->set_duration_samples(256);
+    clip->mutable_fade_in()->set_shape(audio_engine::Fade::EQUAL_POWER);
+
+    bool result = true;
+
+    // Pinned: stored revisions and render cache keys must survive restarts and upgrades
+    const std::string revision = juceaudioservice::EdlStore::calculateRevision(edl);
+    if (revision != "06c407ae6a2f") {
+        std::cout << "ERROR: revision format changed: got " << revision << std::endl;
+        result = false;
+    }
+
+    edl.set_revision("client-supplied");
+    if (juceaudioservice::EdlStore::calculateRevision(edl) != revision) {
+        std::cout << "ERROR: revision depends on the revision field" << std::endl;
+        result = false;
+    }
+
+    auto* second = edl.add_tracks();
+    second->set_id("t1");
+    const std::string twoTracks = juceaudioservice::EdlStore::calculateRevision(edl);
+    edl.mutable_tracks()->SwapElements(0, 1);
+    if (twoTracks == revision || juceaudioservice::EdlStore::calculateRevision(edl) == twoTracks) {
+        std::cout << "ERROR: revision ignores tracks or their order" << std::endl;
+        result = false;
+    }
+
+    // A patch that is undone returns to the original revision
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    if (!store.replace(makeTestEdl(3), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+
+    auto original = makeClip("t1c2", "voice", 1000, 10211, 6000);
+    auto louder = original;
+    louder.set_gain_db(2.0f);
+
+    juceaudioservice::EdlStore::PatchResult patchResult;
+    std::vector<std::string> revisions;
+    for (const auto& version : { louder, original }) {
+        audio_engine::PatchEdlRequest request;
+        request.set_edl_id("patch-test");
+        auto* edit = request.add_edits();
+        edit->set_track_id("t1");
+        *edit->mutable_modify_clip() = version;
+
+        if (!store.patch(request, patchResult, error)) {
+            std::cout << "ERROR: patch failed: " << error << std::endl;
+            return false;
+        }
+        revisions.push_back(patchResult.revision);
+    }
+
+    if (revisions[0] == snapshot.revision || revisions[1] != snapshot.revision) {
+        std::cout << "ERROR: undoing an edit did not restore the revision" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Revision hash test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testIncrementalCompileKeepsMediaIndices() {
+    std::cout << "Testing shared tracks keep their media after an incremental compile..." << std::endl;
+
+    // t0 reads "alt" and t1 "voice", so the base table is [alt, voice]
+    audio_engine::Edl edl = makeTestEdl(2);
+    testhelpers::addMedia(edl, "alt", "test_voice.wav");
+    for (auto& clip : *findTrack(edl, "t0")->mutable_clips()) {
+        clip.set_media_id("alt");
+    }
+
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    juceaudioservice::EdlCompiler compiler;
+    juceaudioservice::EdlCompiler::CompiledEdl base;
+    if (!store.replace(edl, snapshot, error) || !compiler.compile(snapshot, base, error)) {
+        std::cout << "ERROR: EDL setup failed: " << error << std::endl;
+        return false;
+    }
+
+    bool result = true;
+    if (base.media.size() != 2 || base.media[0].id != "alt" || base.media[1].id != "voice") {
+        std::cout << "ERROR: media not listed in first-use order" << std::endl;
+        result = false;
+    }
+
+    // Move t0 to "voice" and add a track on new media; a full compile would renumber everything
+    audio_engine::PatchEdlRequest request;
+    request.set_edl_id("patch-test");
+
+    auto* edit = request.add_edits();
+    edit->mutable_add_media()->set_id("third");
+    edit->mutable_add_media()->set_path(fixturePath("test_voice.wav"));
+    edit->mutable_add_media()->set_channels(1);
+
+    audio_engine::Track newTrack;
+    newTrack.set_id("t2");
+    *newTrack.add_clips() = makeClip("t2c0", "third", 2000, 700, 6000);
+    *newTrack.add_clips() = makeClip("t2c1", "voice", 0, 9000, 6000);
+    *request.add_edits()->mutable_add_track() = newTrack;
+
+    for (const auto& clip : findTrack(edl, "t0")->clips()) {
+        auto moved = clip;
+        moved.set_media_id("voice");
+        edit = request.add_edits();
+        edit->set_track_id("t0");
+        *edit->mutable_modify_clip() = moved;
+    }
+
+    juceaudioservice::EdlStore::PatchResult patchResult;
+    if (!store.patch(request, patchResult, error)) {
+        std::cout << "ERROR: patch failed: " << error << std::endl;
+        return false;
+    }
+
+    auto patched = store.get();
+    juceaudioservice::EdlCompiler::CompiledEdl incremental;
+    juceaudioservice::EdlCompiler::CompiledEdl full;
+    if (!patched || !compiler.compileIncremental(*patched, base, patchResult.dirty_track_ids, incremental, error) ||
+        !compiler.compile(*patched, full, error)) {
+        std::cout << "ERROR: compile failed: " << error << std::endl;
+        return false;
+    }
+
+    // The shared track still names "voice" through the appended table
+    if (incremental.tracks[1] != base.tracks[1] || incremental.media.size() != 3 ||
+        incremental.media[incremental.tracks[1]->media[0]].id != "voice" ||
+        incremental.media[incremental.tracks[2]->media[0]].id != "third") {
+        std::cout << "ERROR: incremental media table does not match the shared tracks" << std::endl;
+        result = false;
+    }
+
+    audio_engine::TimeRange range;
+    range.set_start_samples(0);
+    range.set_duration_samples(24000);
+
+    juceaudioservice::EdlRenderer renderer;
+    juce::AudioBuffer<float> incrementalRender, fullRender;
+    if (!renderer.renderToBuffer(incremental, range, incrementalRender, nullptr, error) ||
+        !renderer.renderToBuffer(full, range, fullRender, nullptr, error)) {
+        std::cout << "ERROR: render failed: " << error << std::endl;
+        return false;
+    }
+
+    if (!buffersIdentical(incrementalRender, fullRender)) {
+        std::cout << "ERROR: incremental render differs from a full compile" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Media index test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testValidationProbesEachMediaOnce() {
+    std::cout << "Testing validation probes each media file once..." << std::endl;
+
+    auto& mediaInfo = juceaudioservice::MediaInfoCache::getInstance();
+    auto before = mediaInfo.getStats();
+
+    // 24 clips, all on the same file
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    if (!store.replace(makeTestEdl(6), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+
+    auto afterFirst = mediaInfo.getStats();
+    if (!store.replace(makeTestEdl(6), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+    auto afterSecond = mediaInfo.getStats();
+
+    bool result = true;
+    uint64_t firstProbes = (afterFirst.hits + afterFirst.misses) - (before.hits + before.misses);
+    if (firstProbes != 1) {
+        std::cout << "ERROR: expected 1 media probe, got " << firstProbes << std::endl;
+        result = false;
+    }
+
+    if (afterSecond.misses != afterFirst.misses || afterSecond.hits != afterFirst.hits + 1) {
+        std::cout << "ERROR: second validation did not reuse the cached probe" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Media probe test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+int main() {
+    std::cout << "Running EDL patch tests..." << std::endl;
+
+    bool allTestsPassed = true;
+
+    if (!testPatchMatchesFullCompile()) {
+        allTestsPassed = false;
+    }
+
+    if (!testFailedPatchLeavesEdlUnchanged()) {
+        allTestsPassed = false;
+    }
+
+    if (!testRevisionsAreStableContentHashes()) {
+        allTestsPassed = false;
+    }
+
+    if (!testIncrementalCompileKeepsMediaIndices()) {
+        allTestsPassed = false;
+    }
+
+    if (!testValidationProbesEachMediaOnce()) {
+        allTestsPassed = false;
+    }
+
+    std::cout << "All EDL patch tests " << (allTestsPassed ? "PASSED" : "FAILED") << std::endl;
+    return allTestsPassed ? 0 : 1;
+}
@@ -0,0 +1,439 @@
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "edl/EdlStore.h"
+#include "edl/EdlCompiler.h"
+#include "edl/EdlPlaybackSource.h"
+#include "edl/EdlRenderer.h"
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include "AllocationCounter.h"
+#include "TestHelpers.h"
+
+using testhelpers::AllocationCounter;
+
+using CompiledPtr = std::shared_ptr<const juceaudioservice::EdlCompiler::CompiledEdl>;
+
+static constexpr int callbackSize = 128;
+static constexpr int sampleRate = 48000;
+
+// Three tracks of overlapping faded clips; trackGainDb tells two timelines apart
+static audio_engine::Edl makeTestEdl(float trackGainDb) {
+    testhelpers::TestEdlLayout layout;
+    layout.numTracks = 3;
+    layout.clipsPerTrack = 5;
+    layout.clipSpacing = 7000;
+    layout.trackOffset = 331;
+    layout.mediaStep = 1000;
+    layout.clipDuration = 9000;
+    layout.fades = { 1200, 2500 };
+    layout.mediaSampleRate = sampleRate;
+    layout.trackGainDb = [trackGainDb](int) { return trackGainDb; };
+    return testhelpers::makeTestEdl("playback-test", layout);
+}
+
+static CompiledPtr compileTestEdl(float trackGainDb) {
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    std::string error;
+    if (!store.replace(makeTestEdl(trackGainDb), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return nullptr;
+    }
+
+    auto compiled = std::make_shared<juceaudioservice::EdlCompiler::CompiledEdl>();
+    juceaudioservice::EdlCompiler compiler;
+    if (!compiler.compile(snapshot, *compiled, error)) {
+        std::cout << "ERROR: EDL compilation failed: " << error << std::endl;
+        return nullptr;
+    }
+
+    return compiled;
+}
+
+static bool renderOffline(const CompiledPtr& compiled, int numSamples, juce::AudioBuffer<float>& output) {
+    audio_engine::TimeRange range;
+    range.set_start_samples(0);
+    range.set_duration_samples(numSamples);
+
+    juceaudioservice::EdlRenderer renderer;
+    std::string error;
+    if (!renderer.renderToBuffer(*compiled, range, output, nullptr, error)) {
+        std::cout << "ERROR: offline render failed: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Stand in for a device that only calls back once audio is due: wait for the render thread
+static bool waitForFrames(const juceaudioservice::EdlPlaybackSource& source, int frames) {
+    // Nothing is rendered past the end of the timeline
+    const juce::int64 remaining = source.getTotalLength() - source.getNextReadPosition();
+    frames = static_cast<int>(std::clamp<juce::int64>(remaining, 0, frames));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (source.getStats().bufferedFrames < frames) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            std::cout << "ERROR: render thread did not fill the ring buffer" << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return true;
+}
+
+static bool frameMatches(const juce::AudioBuffer<float>& block, int blockIndex,
+                         const juce::AudioBuffer<float>& reference, juce::int64 position) {
+    for (int ch = 0; ch < block.getNumChannels(); ++ch) {
+        if (std::memcmp(block.getReadPointer(ch, blockIndex),
+                        reference.getReadPointer(ch, static_cast<int>(position)), sizeof(float)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Pull callbacks from startPosition and compare them to an offline render
+static bool playAndCompare(juceaudioservice::EdlPlaybackSource& source, const juce::AudioBuffer<float>& reference,
+                           juce::int64 startPosition, int numBlocks) {
+    juce::AudioBuffer<float> block(2, callbackSize);
+
+    for (int b = 0; b < numBlocks; ++b) {
+        const juce::int64 position = startPosition + static_cast<juce::int64>(b) * callbackSize;
+        if (source.getNextReadPosition() != position) {
+            std::cout << "ERROR: playhead at " << source.getNextReadPosition() << ", expected " << position << std::endl;
+            return false;
+        }
+
+        if (!waitForFrames(source, callbackSize)) {
+            return false;
+        }
+
+        juce::AudioSourceChannelInfo info(block);
+        source.getNextAudioBlock(info);
+
+        for (int i = 0; i < callbackSize; ++i) {
+            if (!frameMatches(block, i, reference, position + i)) {
+                std::cout << "ERROR: playback differs from offline render at sample " << (position + i) << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Keep calling back through a seek, like a device would, until audio from the new position plays
+static bool playThroughSeek(juceaudioservice::EdlPlaybackSource& source, const juce::AudioBuffer<float>& reference,
+                            juce::int64 target) {
+    juce::AudioBuffer<float> block(2, callbackSize);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (source.getNextReadPosition() == target) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            std::cout << "ERROR: seek to " << target << " never played" << std::endl;
+            return false;
+        }
+
+        juce::AudioSourceChannelInfo info(block);
+        source.getNextAudioBlock(info);
+
+        const int played = static_cast<int>(source.getNextReadPosition() - target);
+        for (int i = 0; i < played; ++i) {
+            if (!frameMatches(block, i, reference, target + i)) {
+                std::cout << "ERROR: sample " << (target + i) << " after the seek differs" << std::endl;
+                return false;
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    return true;
+}
+
+bool testPlaybackMatchesOfflineRender() {
+    std::cout << "Testing playback matches offline render..." << std::endl;
+
+    auto compiled = compileTestEdl(0.0f);
+    juce::AudioBuffer<float> reference;
+    if (!compiled || !renderOffline(compiled, 48000, reference)) {
+        return false;
+    }
+
+    juceaudioservice::EdlPlaybackSource source(2, 4096);
+    source.setTimeline(compiled);
+    source.prepareToPlay(callbackSize, sampleRate);
+
+    if (source.getTotalLength() != 7000 * 4 + 331 * 2 + 9000) {
+        std::cout << "ERROR: unexpected timeline length " << source.getTotalLength() << std::endl;
+        return false;
+    }
+
+    bool ok = playAndCompare(source, reference, 0, 48000 / callbackSize);
+    source.releaseResources();
+
+    if (ok && source.getStats().underruns != 0) {
+        std::cout << "ERROR: " << source.getStats().underruns << " underruns" << std::endl;
+        ok = false;
+    }
+
+    if (ok) {
+        std::cout << "✓ " << source.getStats().framesPlayed << " frames played sample-exact" << std::endl;
+    }
+    return ok;
+}
+
+bool testSeekPlaysFromNewPosition() {
+    std::cout << "Testing seek while playing..." << std::endl;
+
+    auto compiled = compileTestEdl(0.0f);
+    juce::AudioBuffer<float> reference;
+    if (!compiled || !renderOffline(compiled, 48000, reference)) {
+        return false;
+    }
+
+    juceaudioservice::EdlPlaybackSource source(2, 4096);
+    source.setTimeline(compiled);
+    source.prepareToPlay(callbackSize, sampleRate);
+
+    bool ok = playAndCompare(source, reference, 0, 16);
+
+    // The new position is reported at once, before the audio thread has seen it
+    source.setNextReadPosition(20011);
+    if (ok && source.getNextReadPosition() != 20011) {
+        std::cout << "ERROR: pending seek not reported" << std::endl;
+        ok = false;
+    }
+
+    ok = ok && playThroughSeek(source, reference, 20011);
+    ok = ok && playAndCompare(source, reference, source.getNextReadPosition(), 64);
+    source.releaseResources();
+
+    if (ok && source.getStats().underruns != 0) {
+        std::cout << "ERROR: " << source.getStats().underruns << " underruns" << std::endl;
+        ok = false;
+    }
+
+    if (ok) {
+        std::cout << "✓ Seek plays from the requested sample" << std::endl;
+    }
+    return ok;
+}
+
+bool testTimelineSwapIsGapless() {
+    std::cout << "Testing timeline swap during playback..." << std::endl;
+
+    auto before = compileTestEdl(0.0f);
+    auto after = compileTestEdl(-6.0f);
+    juce::AudioBuffer<float> referenceBefore;
+    juce::AudioBuffer<float> referenceAfter;
+    if (!before || !after || !renderOffline(before, 48000, referenceBefore) ||
+        !renderOffline(after, 48000, referenceAfter)) {
+        return false;
+    }
+
+    juceaudioservice::EdlPlaybackSource source(2, 4096);
+    source.setTimeline(before);
+    source.prepareToPlay(callbackSize, sampleRate);
+
+    const int swapBlock = 40;
+    juce::int64 swapPosition = 0;
+    juce::int64 firstNewFrame = -1;
+    juce::AudioBuffer<float> block(2, callbackSize);
+    bool ok = true;
+
+    // Every frame must come from one of the two timelines, and once the edit is heard it stays heard
+    for (int b = 0; ok && b < 48000 / callbackSize; ++b) {
+        if (b == swapBlock) {
+            swapPosition = source.getNextReadPosition();
+            source.setTimeline(after);
+        }
+
+        ok = waitForFrames(source, callbackSize);
+        const juce::int64 position = source.getNextReadPosition();
+        if (ok && position != static_cast<juce::int64>(b) * callbackSize) {
+            std::cout << "ERROR: playhead jumped to " << position << std::endl;
+            ok = false;
+        }
+
+        juce::AudioSourceChannelInfo info(block);
+        source.getNextAudioBlock(info);
+
+        for (int i = 0; ok && i < callbackSize; ++i) {
+            const bool isBefore = frameMatches(block, i, referenceBefore, position + i);
+            const bool isAfter = frameMatches(block, i, referenceAfter, position + i);
+
+            if (!isBefore && !isAfter) {
+                std::cout << "ERROR: sample " << (position + i) << " matches neither timeline" << std::endl;
+                ok = false;
+            } else if (isAfter && !isBefore && firstNewFrame < 0) {
+                firstNewFrame = position + i;
+            } else if (isBefore && !isAfter && firstNewFrame >= 0) {
+                std::cout << "ERROR: old timeline heard again at sample " << (position + i) << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    source.releaseResources();
+
+    if (ok && (firstNewFrame < swapPosition || firstNewFrame > swapPosition + source.getLookaheadFrames())) {
+        std::cout << "ERROR: edit at " << swapPosition << " first heard at " << firstNewFrame
+                  << " (look-ahead " << source.getLookaheadFrames() << ")" << std::endl;
+        ok = false;
+    }
+
+    if (ok && source.getStats().underruns != 0) {
+        std::cout << "ERROR: " << source.getStats().underruns << " underruns" << std::endl;
+        ok = false;
+    }
+
+    if (ok) {
+        std::cout << "✓ Edit heard " << (firstNewFrame - swapPosition) << " frames after the swap, no gaps" << std::endl;
+    }
+    return ok;
+}
+
+bool testAudioCallbackDoesNotAllocate() {
+    std::cout << "Testing audio callback does not allocate..." << std::endl;
+
+    auto compiled = compileTestEdl(0.0f);
+    if (!compiled) {
+        return false;
+    }
+
+    juceaudioservice::EdlPlaybackSource source(2, 4096);
+    source.setTimeline(compiled);
+    source.prepareToPlay(callbackSize, sampleRate);
+
+    juce::AudioBuffer<float> block(2, callbackSize);
+    bool ok = true;
+
+    // Includes a seek and an edit, both handled off the audio thread
+    for (int b = 0; ok && b < 200; ++b) {
+        if (b == 50) {
+            source.setNextReadPosition(12000);
+        }
+        if (b == 100) {
+            source.setTimeline(compileTestEdl(-3.0f));
+        }
+
+        // While the seek is pending callbacks play silence instead of waiting for audio
+        const bool seeking = b >= 50 && source.getNextReadPosition() == 12000;
+        ok = seeking || waitForFrames(source, callbackSize);
+
+        juce::AudioSourceChannelInfo info(block);
+        AllocationCounter::reset();
+        AllocationCounter::setCountingThisThread(true);
+        source.getNextAudioBlock(info);
+        source.getNextReadPosition();
+        AllocationCounter::setCountingThisThread(false);
+
+        if (ok && AllocationCounter::getCount() != 0) {
+            std::cout << "ERROR: callback " << b << " made " << AllocationCounter::getCount() << " allocations"
+                      << std::endl;
+            ok = false;
+        }
+    }
+
+    source.releaseResources();
+
+    if (ok) {
+        std::cout << "✓ 200 callbacks without heap allocation" << std::endl;
+    }
+    return ok;
+}
+
+bool testPlaybackStopsAtTimelineEnd() {
+    std::cout << "Testing playback past the end of the timeline..." << std::endl;
+
+    auto compiled = compileTestEdl(0.0f);
+    if (!compiled) {
+        return false;
+    }
+
+    juceaudioservice::EdlPlaybackSource source(2, 4096);
+    source.setTimeline(compiled);
+    source.prepareToPlay(callbackSize, sampleRate);
+
+    const juce::int64 length = source.getTotalLength();
+    const int numBlocks = static_cast<int>(length / callbackSize) + 20;
+    juce::AudioBuffer<float> block(2, callbackSize);
+    bool ok = true;
+
+    for (int b = 0; ok && b < numBlocks; ++b) {
+        ok = waitForFrames(source, callbackSize);
+        const juce::int64 position = source.getNextReadPosition();
+
+        juce::AudioSourceChannelInfo info(block);
+        source.getNextAudioBlock(info);
+
+        // The playhead keeps moving over silence once the timeline has ended
+        if (ok && source.getNextReadPosition() != position + callbackSize) {
+            std::cout << "ERROR: playhead stopped at " << source.getNextReadPosition() << std::endl;
+            ok = false;
+        }
+
+        if (ok && position >= length && block.getMagnitude(0, callbackSize) != 0.0f) {
+            std::cout << "ERROR: audio after the end of the timeline at " << position << std::endl;
+            ok = false;
+        }
+    }
+
+    // Nothing is rendered ahead once the end is reached
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    if (ok && source.getStats().bufferedFrames != 0) {
+        std::cout << "ERROR: " << source.getStats().bufferedFrames << " frames rendered past the end" << std::endl;
+        ok = false;
+    }
+
+    source.releaseResources();
+
+    if (ok && source.getStats().underruns != 0) {
+        std::cout << "ERROR: " << source.getStats().underruns << " underruns" << std::endl;
+        ok = false;
+    }
+
+    if (ok) {
+        std::cout << "✓ Silence past the end, nothing rendered beyond it" << std::endl;
+    }
+    return ok;
+}
+
+int main() {
+    std::cout << "Running EDL playback tests..." << std::endl;
+
+    bool allTestsPassed = true;
+
+    if (!testPlaybackMatchesOfflineRender()) {
+        allTestsPassed = false;
+    }
+
+    if (!testSeekPlaysFromNewPosition()) {
+        allTestsPassed = false;
+    }
+
+    if (!testTimelineSwapIsGapless()) {
+        allTestsPassed = false;
+    }
+
+    if (!testAudioCallbackDoesNotAllocate()) {
+        allTestsPassed = false;
+    }
+
+    if (!testPlaybackStopsAtTimelineEnd()) {
+        allTestsPassed = false;
+    }
+
+    std::cout << "All EDL playback tests " << (allTestsPassed ? "PASSED" : "FAILED") << std::endl;
+    return allTestsPassed ? 0 : 1;
+}
@@ -0,0 +1,1272 @@
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "edl/EdlStore.h"
+#include "edl/EdlCompiler.h"
+#include "edl/EdlRenderer.h"
+#include "edl/MediaPageCache.h"
+#include "util/HashingOutputStream.h"
+#include "util/MediaReader.h"
+#include "util/WavStreamWriter.h"
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include "AllocationCounter.h"
+#include "TestHelpers.h"
+
+using testhelpers::AllocationCounter;
+using testhelpers::buffersIdentical;
+using testhelpers::fixturePath;
+
+// Multi-track EDL with overlapping clips on two files, gains and fades
+static audio_engine::Edl makeTestEdl(int numTracks) {
+    testhelpers::TestEdlLayout layout;
+    layout.numTracks = numTracks;
+    layout.clipsPerTrack = 6;
+    layout.clipSpacing = 7000;
+    layout.trackOffset = 331;
+    layout.mediaStep = 1000;
+    layout.clipDuration = 9000;
+    layout.fades = { 1200, 2500, audio_engine::Fade::EQUAL_POWER };
+    layout.mediaSampleRate = 48000;
+    layout.trackGainDb = [](int t) { return -1.5f * static_cast<float>(t % 4); };
+    layout.adjustClip = [](audio_engine::Clip& clip, int t, int c) {
+        clip.set_media_id((t + c) % 2 == 0 ? "voice" : "test_voice");
+        clip.set_gain_db(c % 3 == 0 ? 0.0f : -3.0f);
+    };
+
+    auto edl = testhelpers::makeTestEdl("renderer-test", layout);
+    testhelpers::addMedia(edl, "test_voice", "test_voice.wav", 48000);
+    return edl;
+}
+
+static bool compileTestEdl(int numTracks, juceaudioservice::EdlStore& store,
+                           juceaudioservice::EdlStore::Snapshot& snapshot,
+                           juceaudioservice::EdlCompiler::CompiledEdl& compiled) {
+    std::string error;
+    if (!store.replace(makeTestEdl(numTracks), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+
+    juceaudioservice::EdlCompiler compiler;
+    if (!compiler.compile(snapshot, compiled, error)) {
+        std::cout << "ERROR: EDL compilation failed: " << error << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// A bed spanning the whole timeline under many short, dense clips
+static juceaudioservice::EdlCompiler::CompiledTrack makeBedTrack() {
+    juceaudioservice::EdlCompiler::CompiledTrack track;
+    track.id = "bed";
+
+    auto addClip = [&track](int64_t t0, int64_t t1) {
+        track.t0.push_back(t0);
+        track.t1.push_back(t1);
+        track.max_end.push_back(track.max_end.empty() ? t1 : std::max(track.max_end.back(), t1));
+    };
+
+    addClip(0, 2000000);
+    for (int64_t c = 0; c < 3000; ++c) {
+        addClip(600 * c + 10, 600 * c + 500);
+    }
+    return track;
+}
+
+// Clips that intersect [rangeStart, rangeEnd), by brute force
+static std::vector<uint32_t> clipsIntersecting(const juceaudioservice::EdlCompiler::CompiledTrack& track,
+                                               int64_t rangeStart, int64_t rangeEnd) {
+    std::vector<uint32_t> clips;
+    for (size_t i = 0; i < track.numClips(); ++i) {
+        if (track.t0[i] < rangeEnd && track.t1[i] > rangeStart) {
+            clips.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return clips;
+}
+
+bool testClipCursorHandlesLongClips() {
+    std::cout << "Testing clip cursor under a long bed clip and backward seeks..." << std::endl;
+
+    const auto track = makeBedTrack();
+    juceaudioservice::EdlCompiler::ClipCursor cursor;
+    bool result = true;
+
+    // Forward, block by block: the bed stays one entry and ended clips leave
+    const int64_t blockSize = 4096;
+    size_t largestActive = 0;
+    for (int64_t start = 0; start < 1900000 && result; start += blockSize) {
+        cursor.seek(track, start, start + blockSize);
+        largestActive = std::max(largestActive, cursor.active.size());
+        if (cursor.active != clipsIntersecting(track, start, start + blockSize)) {
+            std::cout << "ERROR: forward seek to " << start << " found the wrong clips" << std::endl;
+            result = false;
+        }
+    }
+
+    // The bed plus the short clips a block can touch
+    if (largestActive > 1 + static_cast<size_t>(blockSize / 600 + 2)) {
+        std::cout << "ERROR: " << largestActive << " clips active in one block; ended clips are kept" << std::endl;
+        result = false;
+    }
+
+    // Backward seeks, shorter ranges and jumps that skip whole clips
+    const std::vector<std::pair<int64_t, int64_t>> ranges = {
+        { 1000000, 1004096 }, { 600, 610 }, { 500, 1100 }, { 0, 5 }, { 1799990, 1800020 },
+        { 1799990, 1799995 }, { 900000, 900001 }, { 1999999, 2000100 }, { 30, 4126 },
+    };
+    for (const auto& [start, end] : ranges) {
+        cursor.seek(track, start, end);
+        if (cursor.active != clipsIntersecting(track, start, end)) {
+            std::cout << "ERROR: seek to [" << start << ", " << end << ") found the wrong clips" << std::endl;
+            result = false;
+        }
+    }
+
+    // A different track repositions the cursor even when moving forward
+    const auto other = makeBedTrack();
+    cursor.seek(other, 1000000, 1000100);
+    if (cursor.track != &other || cursor.active != clipsIntersecting(other, 1000000, 1000100)) {
+        std::cout << "ERROR: cursor kept state from the previous track" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Clip cursor test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testParallelRenderMatchesSerial() {
+    std::cout << "Testing parallel track render matches serial render..." << std::endl;
+
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    juceaudioservice::EdlCompiler::CompiledEdl compiled;
+    if (!compileTestEdl(12, store, snapshot, compiled)) {
+        return false;
+    }
+
+    // Unaligned start and a duration that ends mid-block
+    audio_engine::TimeRange range;
+    range.set_start_samples(517);
+    range.set_duration_samples(44100);
+
+    std::string error;
+    juce::AudioBuffer<float> serial;
+    juceaudioservice::EdlRenderer serialRenderer;
+    if (!serialRenderer.renderToBuffer(compiled, range, serial, nullptr, error)) {
+        std::cout << "ERROR: serial render failed: " << error << std::endl;
+        return false;
+    }
+
+    bool result = true;
+    for (int threads : { 2, 3, 8 }) {
+        juce::AudioBuffer<float> parallel;
+        juceaudioservice::EdlRenderer parallelRenderer;
+        parallelRenderer.setNumWorkerThreads(threads);
+
+        if (!parallelRenderer.renderToBuffer(compiled, range, parallel, nullptr, error)) {
+            std::cout << "ERROR: parallel render failed: " << error << std::endl;
+            return false;
+        }
+
+        if (!buffersIdentical(serial, parallel)) {
+            std::cout << "ERROR: " << threads << "-thread render differs from serial render" << std::endl;
+            result = false;
+        }
+    }
+
+    if (serial.getMagnitude(0, 0, serial.getNumSamples()) <= 0.0f) {
+        std::cout << "ERROR: render produced silence" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Parallel render test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testMediaCacheServesRepeatedRenders() {
+    std::cout << "Testing media page cache serves repeated renders..." << std::endl;
+
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    juceaudioservice::EdlCompiler::CompiledEdl compiled;
+    if (!compileTestEdl(4, store, snapshot, compiled)) {
+        return false;
+    }
+
+    audio_engine::TimeRange range;
+    range.set_start_samples(2000);
+    range.set_duration_samples(30000);
+
+    std::string error;
+    juceaudioservice::MediaPageCache cache;
+    juceaudioservice::EdlRenderer renderer(cache);
+
+    juce::AudioBuffer<float> first;
+    if (!renderer.renderToBuffer(compiled, range, first, nullptr, error)) {
+        std::cout << "ERROR: first render failed: " << error << std::endl;
+        return false;
+    }
+    auto afterFirst = cache.getStats();
+
+    juce::AudioBuffer<float> second;
+    if (!renderer.renderToBuffer(compiled, range, second, nullptr, error)) {
+        std::cout << "ERROR: second render failed: " << error << std::endl;
+        return false;
+    }
+    auto afterSecond = cache.getStats();
+
+    bool result = true;
+    if (afterFirst.misses == 0 || afterFirst.bytesUsed == 0) {
+        std::cout << "ERROR: first render did not populate the cache" << std::endl;
+        result = false;
+    }
+
+    if (afterSecond.misses != afterFirst.misses || afterSecond.hits <= afterFirst.hits) {
+        std::cout << "ERROR: second render was not served from the cache (misses "
+                  << afterFirst.misses << " -> " << afterSecond.misses << ")" << std::endl;
+        result = false;
+    }
+
+    if (!buffersIdentical(first, second)) {
+        std::cout << "ERROR: cached render differs from first render" << std::endl;
+        result = false;
+    }
+
+    // A budget too small to hold any page must evict but render the same audio
+    juceaudioservice::MediaPageCache tinyCache(1);
+    juceaudioservice::EdlRenderer tinyRenderer(tinyCache);
+    tinyRenderer.setNumWorkerThreads(3);
+
+    juce::AudioBuffer<float> evicted;
+    if (!tinyRenderer.renderToBuffer(compiled, range, evicted, nullptr, error)) {
+        std::cout << "ERROR: small-cache render failed: " << error << std::endl;
+        return false;
+    }
+
+    if (tinyCache.getStats().evictions == 0) {
+        std::cout << "ERROR: small cache did not evict pages" << std::endl;
+        result = false;
+    }
+
+    if (!buffersIdentical(first, evicted)) {
+        std::cout << "ERROR: small-cache render differs from cached render" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Media cache test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testRewrittenMediaIsClosed() {
+    std::cout << "Testing superseded media versions are closed..." << std::endl;
+
+    // Private copies of the fixtures, so rewriting them leaves the others alone
+    auto voiceCopy = juce::File::createTempFile(".wav");
+    auto testVoiceCopy = juce::File::createTempFile(".wav");
+    if (!juce::File(fixturePath("voice.wav")).copyFileTo(voiceCopy) ||
+        !juce::File(fixturePath("test_voice.wav")).copyFileTo(testVoiceCopy)) {
+        std::cout << "ERROR: could not copy the fixtures" << std::endl;
+        return false;
+    }
+
+    audio_engine::Edl edl = makeTestEdl(2);
+    edl.mutable_media(0)->set_path(voiceCopy.getFullPathName().toStdString());
+    edl.mutable_media(1)->set_path(testVoiceCopy.getFullPathName().toStdString());
+
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    juceaudioservice::EdlCompiler::CompiledEdl compiled;
+    juceaudioservice::EdlCompiler compiler;
+    if (!store.replace(edl, snapshot, error) || !compiler.compile(snapshot, compiled, error)) {
+        std::cout << "ERROR: EDL setup failed: " << error << std::endl;
+        return false;
+    }
+
+    audio_engine::TimeRange range;
+    range.set_start_samples(0);
+    range.set_duration_samples(40000);
+
+    juceaudioservice::MediaPageCache cache;
+    juceaudioservice::EdlRenderer renderer(cache);
+    juce::AudioBuffer<float> output;
+    bool result = renderer.renderToBuffer(compiled, range, output, nullptr, error);
+    const size_t numMedia = cache.getStats().numMedia;
+    uint64_t pagesDecoded = 0;
+
+    // Each rewrite opens a new version; the one it replaces must not linger
+    for (int rewrite = 1; rewrite <= 4 && result; ++rewrite) {
+        const char* source = rewrite % 2 == 1 ? "test_voice.wav" : "voice.wav";
+        if (!juce::File(fixturePath(source)).copyFileTo(voiceCopy) ||
+            !voiceCopy.setLastModificationTime(juce::Time(juce::Time::currentTimeMillis() + 10000 * rewrite))) {
+            std::cout << "ERROR: could not rewrite the media file" << std::endl;
+            result = false;
+            break;
+        }
+
+        juceaudioservice::MediaPageCache expectedCache;
+        juceaudioservice::EdlRenderer fresh(expectedCache);
+        juce::AudioBuffer<float> expected;
+        if (!renderer.renderToBuffer(compiled, range, output, nullptr, error) ||
+            !fresh.renderToBuffer(compiled, range, expected, nullptr, error)) {
+            std::cout << "ERROR: render failed: " << error << std::endl;
+            result = false;
+        } else if (!buffersIdentical(expected, output)) {
+            std::cout << "ERROR: render after rewrite " << rewrite << " read a stale version" << std::endl;
+            result = false;
+        }
+
+        if (cache.getStats().numMedia != numMedia) {
+            std::cout << "ERROR: " << cache.getStats().numMedia << " media open after rewrite " << rewrite
+                      << ", expected " << numMedia << std::endl;
+            result = false;
+        }
+
+        // Per-file totals include the closed versions
+        for (const auto& usage : cache.getMediaUsage()) {
+            if (usage.path == voiceCopy.getFullPathName().toStdString()) {
+                if (usage.pagesDecoded <= pagesDecoded) {
+                    std::cout << "ERROR: decode totals went backwards after rewrite " << rewrite << std::endl;
+                    result = false;
+                }
+                pagesDecoded = usage.pagesDecoded;
+            }
+        }
+    }
+
+    // A file cut short under its mapping reads as silence instead of faulting
+    const auto handle = cache.openMedia(testVoiceCopy.getFullPathName().toStdString());
+    cache.clear();
+    {
+        juce::FileOutputStream truncating(testVoiceCopy);
+        if (!truncating.openedOk() || !truncating.setPosition(64) || truncating.truncate().failed()) {
+            std::cout << "ERROR: could not truncate the media file" << std::endl;
+            result = false;
+        }
+    }
+
+    juce::AudioBuffer<float> truncated(1, 4096);
+    if (!cache.read(handle, truncated, 0, truncated.getNumSamples(), 8192) ||
+        truncated.getMagnitude(0, truncated.getNumSamples()) != 0.0f) {
+        std::cout << "ERROR: reading a truncated file did not return silence" << std::endl;
+        result = false;
+    }
+    cache.releaseMedia(handle);
+
+    voiceCopy.deleteFile();
+    testVoiceCopy.deleteFile();
+
+    std::cout << "Superseded media test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testPrefetchReadsAheadOfMixer() {
+    std::cout << "Testing media prefetch runs ahead of the mixer..." << std::endl;
+
+    // Clips spread over both pages of each file, so later blocks need pages the first one does not
+    audio_engine::Edl edl = makeTestEdl(1);
+    auto* track = edl.mutable_tracks(0);
+    track->clear_clips();
+    const struct { const char* media; int64_t sourceStart; int64_t timelineStart; } layout[] = {
+        { "voice", 0, 0 }, { "voice", 17000, 8192 }, { "test_voice", 17000, 16384 }, { "test_voice", 0, 24576 }
+    };
+    for (const auto& entry : layout) {
+        auto* clip = track->add_clips();
+        clip->set_id("clip" + std::to_string(track->clips_size()));
+        clip->set_media_id(entry.media);
+        clip->set_start_in_media(entry.sourceStart);
+        clip->set_start_in_timeline(entry.timelineStart);
+        clip->set_duration(4000);
+    }
+
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    juceaudioservice::EdlCompiler::CompiledEdl compiled;
+    juceaudioservice::EdlCompiler compiler;
+    std::string error;
+    if (!store.replace(edl, snapshot, error) || !compiler.compile(snapshot, compiled, error)) {
+        std::cout << "ERROR: EDL setup failed: " << error << std::endl;
+        return false;
+    }
+
+    audio_engine::TimeRange range;
+    range.set_start_samples(0);
+    range.set_duration_samples(30000);
+
+    // A slow consumer gives the I/O thread time to get ahead, as mixing does on slow storage
+    auto renderWithPrefetch = [&](int prefetchBlocks, juce::AudioBuffer<float>& output,
+                                  juceaudioservice::MediaPageCache::Stats& stats) {
+        juceaudioservice::MediaPageCache cache;
+        juceaudioservice::EdlRenderer renderer(cache);
+        renderer.setPrefetchBlocks(prefetchBlocks);
+
+        output.setSize(2, static_cast<int>(range.duration_samples()));
+        int written = 0;
+        auto slowCopy = [&output, &written](const juce::AudioBuffer<float>& block, int numSamples) {
+            for (int ch = 0; ch < output.getNumChannels(); ++ch) {
+                output.copyFrom(ch, written, block, ch, 0, numSamples);
+            }
+            written += numSamples;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            return true;
+        };
+
+        bool rendered = renderer.renderBlocks(compiled, range, slowCopy, nullptr, error);
+        stats = cache.getStats();
+        if (!rendered) {
+            std::cout << "ERROR: render failed: " << error << std::endl;
+        }
+        return rendered;
+    };
+
+    juce::AudioBuffer<float> direct;
+    juce::AudioBuffer<float> prefetched;
+    juceaudioservice::MediaPageCache::Stats directStats;
+    juceaudioservice::MediaPageCache::Stats prefetchStats;
+    if (!renderWithPrefetch(0, direct, directStats) || !renderWithPrefetch(8, prefetched, prefetchStats)) {
+        return false;
+    }
+
+    bool result = true;
+    if (!buffersIdentical(direct, prefetched)) {
+        std::cout << "ERROR: prefetched render differs from direct render" << std::endl;
+        result = false;
+    }
+
+    if (directStats.prefetched != 0 || prefetchStats.prefetched == 0) {
+        std::cout << "ERROR: unexpected prefetch counts " << directStats.prefetched << " / "
+                  << prefetchStats.prefetched << std::endl;
+        result = false;
+    }
+
+    // Only the page of the first block should still be read by the mixer itself
+    if (directStats.misses != 4 || prefetchStats.misses != 1) {
+        std::cout << "ERROR: mixer still decoded " << prefetchStats.misses << " pages with prefetch ("
+                  << directStats.misses << " without)" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Prefetch test " << (result ? "passed" : "failed") << " (mixer decoded "
+              << prefetchStats.misses << " of " << directStats.misses << " pages)" << std::endl;
+    return result;
+}
+
+bool testMemoryMappedReaderMatchesBuffered() {
+    std::cout << "Testing memory-mapped media reader matches buffered reader..." << std::endl;
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    juce::File file(fixturePath("voice.wav"));
+    auto mapped = juceaudioservice::createMediaReader(formatManager, file);
+    std::unique_ptr<juce::AudioFormatReader> buffered(formatManager.createReaderFor(file));
+
+    if (!mapped || !buffered) {
+        std::cout << "ERROR: failed to open " << file.getFullPathName() << std::endl;
+        return false;
+    }
+
+    bool result = true;
+    if (dynamic_cast<juce::MemoryMappedAudioFormatReader*>(mapped.get()) == nullptr) {
+        std::cout << "ERROR: WAV media was not memory-mapped" << std::endl;
+        result = false;
+    }
+
+    // Read across the end of the file so the zero padding is compared too
+    const int numSamples = 5000;
+    const juce::int64 start = buffered->lengthInSamples - 3000;
+    juce::AudioBuffer<float> mappedSamples(2, numSamples);
+    juce::AudioBuffer<float> bufferedSamples(2, numSamples);
+    mapped->read(&mappedSamples, 0, numSamples, start, true, true);
+    buffered->read(&bufferedSamples, 0, numSamples, start, true, true);
+
+    if (!buffersIdentical(mappedSamples, bufferedSamples)) {
+        std::cout << "ERROR: memory-mapped samples differ from buffered samples" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Memory-mapped reader test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+static bool renderMatchesPerSampleFades(int clipStart) {
+    // One clip with fades spanning several blocks
+    audio_engine::Edl edl;
+    edl.set_id("fade-test");
+    edl.set_sample_rate(48000);
+
+    auto* voice = edl.add_media();
+    voice->set_id("voice");
+    voice->set_path(fixturePath("voice.wav"));
+    voice->set_channels(1);
+
+    const int duration = 20000;
+    const int fadeInLength = 5000;
+    const int fadeOutLength = 9000;
+
+    auto* clip = edl.add_tracks()->add_clips();
+    clip->set_id("c0");
+    clip->set_media_id("voice");
+    clip->set_start_in_media(0);
+    clip->set_start_in_timeline(clipStart);
+    clip->set_duration(duration);
+    clip->mutable_fade_in()->set_duration_samples(fadeInLength);
+    clip->mutable_fade_in()->set_shape(audio_engine::Fade::LINEAR);
+    clip->mutable_fade_out()->set_duration_samples(fadeOutLength);
+    clip->mutable_fade_out()->set_shape(audio_engine::Fade::EQUAL_POWER);
+
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    juceaudioservice::EdlCompiler compiler;
+    juceaudioservice::EdlCompiler::CompiledEdl compiled;
+    if (!store.replace(edl, snapshot, error) || !compiler.compile(snapshot, compiled, error)) {
+        std::cout << "ERROR: EDL setup failed: " << error << std::endl;
+        return false;
+    }
+
+    audio_engine::TimeRange range;
+    range.set_start_samples(0);
+    range.set_duration_samples(clipStart + duration);
+
+    juce::AudioBuffer<float> rendered;
+    juceaudioservice::EdlRenderer renderer;
+    if (!renderer.renderToBuffer(compiled, range, rendered, nullptr, error)) {
+        std::cout << "ERROR: render failed: " << error << std::endl;
+        return false;
+    }
+
+    // Reference: the source samples with each fade evaluated sample by sample
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    auto reader = juceaudioservice::createMediaReader(formatManager, juce::File(fixturePath("voice.wav")));
+    if (!reader) {
+        std::cout << "ERROR: failed to open fixture" << std::endl;
+        return false;
+    }
+
+    juce::AudioBuffer<float> expected(rendered.getNumChannels(), clipStart + duration);
+    expected.clear();
+    reader->read(&expected, clipStart, duration, 0, true, true);
+
+    for (int ch = 0; ch < expected.getNumChannels(); ++ch) {
+        float* samples = expected.getWritePointer(ch, clipStart);
+
+        for (int i = 0; i < fadeInLength; ++i) {
+            float position = std::max(0.0f, std::min(1.0f, static_cast<float>(i) / static_cast<float>(fadeInLength)));
+            samples[i] *= position;
+        }
+
+        const int fadeOutStart = duration - fadeOutLength;
+        for (int i = fadeOutStart; i < duration; ++i) {
+            float position = 1.0f - static_cast<float>(i - fadeOutStart) / static_cast<float>(fadeOutLength);
+            samples[i] *= std::sqrt(std::max(0.0f, std::min(1.0f, position)));
+        }
+    }
+
+    if (!buffersIdentical(rendered, expected)) {
+        std::cout << "ERROR: faded render differs from per-sample fade evaluation (clip at "
+                  << clipStart << ")" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool testFadeCurvesMatchPerSampleEvaluation() {
+    std::cout << "Testing block fade curves match per-sample evaluation..." << std::endl;
+
+    // At the timeline origin, and starting inside the first block so the fades are offset in it
+    bool result = true;
+    for (const int clipStart : { 0, 777 }) {
+        if (!renderMatchesPerSampleFades(clipStart)) {
+            result = false;
+        }
+    }
+
+    std::cout << "Fade curve test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testSteadyStateRenderDoesNotAllocate() {
+    std::cout << "Testing steady-state render blocks do not allocate..." << std::endl;
+
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    juceaudioservice::EdlCompiler::CompiledEdl compiled;
+    if (!compileTestEdl(12, store, snapshot, compiled)) {
+        return false;
+    }
+
+    // Ends on a short block so the resize to a partial block is covered
+    audio_engine::TimeRange range;
+    range.set_start_samples(300);
+    range.set_duration_samples(40000);
+
+    bool result = true;
+    for (int threads : { 1, 3 }) {
+        std::string error;
+        juceaudioservice::MediaPageCache cache;
+        juceaudioservice::EdlRenderer renderer(cache);
+        renderer.setNumWorkerThreads(threads);
+
+        // Warm the page cache; decoding new pages legitimately allocates
+        juce::AudioBuffer<float> warmup;
+        if (!renderer.renderToBuffer(compiled, range, warmup, nullptr, error)) {
+            std::cout << "ERROR: warm-up render failed: " << error << std::endl;
+            return false;
+        }
+
+        // Count from the end of the first block to the end of the last one
+        int64_t samplesSeen = 0;
+        AllocationCounter::reset();
+        auto countBlock = [&samplesSeen, &range](const juce::AudioBuffer<float>&, int numSamples) {
+            samplesSeen += numSamples;
+            AllocationCounter::setCountingAllThreads(samplesSeen < range.duration_samples());
+            return true;
+        };
+
+        bool rendered = renderer.renderBlocks(compiled, range, countBlock, nullptr, error);
+        AllocationCounter::setCountingAllThreads(false);
+
+        if (!rendered) {
+            std::cout << "ERROR: render failed: " << error << std::endl;
+            return false;
+        }
+
+        if (AllocationCounter::getCount() != 0) {
+            std::cout << "ERROR: " << threads << "-thread render made " << AllocationCounter::getCount()
+                      << " heap allocations after the first block" << std::endl;
+            result = false;
+        }
+    }
+
+    std::cout << "Steady-state allocation test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testWavHeaderSwitchesToRF64() {
+    std::cout << "Testing WAV headers switch to RF64 past 4 GB..." << std::endl;
+
+    using juceaudioservice::WavStreamWriter;
+    bool result = true;
+
+    auto writeHeader = [&result](juce::int64 frames, juce::MemoryOutputStream& stream) {
+        WavStreamWriter writer(stream, 48000, 2, 32, frames);
+        if (!writer.isValid() || !writer.writeHeader() ||
+            stream.getDataSize() != static_cast<size_t>(WavStreamWriter::headerSize)) {
+            std::cout << "ERROR: header for " << frames << " frames is not " << WavStreamWriter::headerSize
+                      << " bytes" << std::endl;
+            result = false;
+            return static_cast<const char*>(nullptr);
+        }
+        return static_cast<const char*>(stream.getData());
+    };
+
+    // Small files reserve the ds64 space as a JUNK chunk
+    juce::MemoryOutputStream smallStream;
+    if (const char* header = writeHeader(1001, smallStream)) {
+        const juce::uint32 dataSize = 1001 * 8;
+        if (std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 12, "JUNK", 4) != 0 ||
+            juce::ByteOrder::littleEndianInt(header + 4) != WavStreamWriter::headerSize - 8 + dataSize ||
+            std::memcmp(header + 72, "data", 4) != 0 || juce::ByteOrder::littleEndianInt(header + 76) != dataSize) {
+            std::cout << "ERROR: malformed RIFF header" << std::endl;
+            result = false;
+        }
+    }
+
+    // 600M stereo float frames are 4.8 GB: the real sizes move into ds64
+    const juce::int64 frames = 600000000;
+    const juce::uint64 dataSize = static_cast<juce::uint64>(frames) * 8;
+    juce::MemoryOutputStream largeStream;
+    if (const char* header = writeHeader(frames, largeStream)) {
+        if (std::memcmp(header, "RF64", 4) != 0 || juce::ByteOrder::littleEndianInt(header + 4) != 0xffffffffu ||
+            std::memcmp(header + 12, "ds64", 4) != 0 ||
+            juce::ByteOrder::littleEndianInt64(header + 20) != WavStreamWriter::headerSize - 8 + dataSize ||
+            juce::ByteOrder::littleEndianInt64(header + 28) != dataSize ||
+            juce::ByteOrder::littleEndianInt64(header + 36) != static_cast<juce::uint64>(frames) ||
+            juce::ByteOrder::littleEndianInt(header + 76) != 0xffffffffu) {
+            std::cout << "ERROR: malformed RF64 header" << std::endl;
+            result = false;
+        }
+    }
+
+    // The byte rate field is 32-bit, so a format whose rate overflows it is refused
+    juce::MemoryOutputStream overflowStream;
+    if (WavStreamWriter(overflowStream, 2000000000, 8, 32, 10).isValid()) {
+        std::cout << "ERROR: a byte rate beyond 32 bits was accepted" << std::endl;
+        result = false;
+    }
+
+    std::cout << "RF64 header test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testWavHashedWhileWriting() {
+    std::cout << "Testing WAV renders are hashed while they are written..." << std::endl;
+
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    juceaudioservice::EdlCompiler::CompiledEdl compiled;
+    if (!compileTestEdl(3, store, snapshot, compiled)) {
+        return false;
+    }
+
+    // Odd frame count so the 24-bit data chunk needs its pad byte
+    audio_engine::TimeRange range;
+    range.set_start_samples(100);
+    range.set_duration_samples(12345);
+
+    std::string error;
+    juceaudioservice::EdlRenderer renderer;
+    juce::AudioBuffer<float> expected;
+    if (!renderer.renderToBuffer(compiled, range, expected, nullptr, error)) {
+        std::cout << "ERROR: buffer render failed: " << error << std::endl;
+        return false;
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    bool result = true;
+    for (auto bitDepth : { juceaudioservice::EdlRenderer::BitDepth::Int24,
+                           juceaudioservice::EdlRenderer::BitDepth::Float32 }) {
+        auto outputFile = juce::File::createTempFile(".wav");
+        std::string sha256;
+        if (!renderer.renderToWav(compiled, range, outputFile.getFullPathName().toStdString(), bitDepth,
+                                  nullptr, sha256, error)) {
+            std::cout << "ERROR: WAV render failed: " << error << std::endl;
+            return false;
+        }
+
+        // Hash the file contents as written to disk
+        juce::MemoryBlock contents;
+        outputFile.loadFileAsData(contents);
+        juceaudioservice::HashingOutputStream rehash(std::make_unique<juce::MemoryOutputStream>());
+        rehash.write(contents.getData(), contents.getSize());
+
+        if (sha256.size() != 64 || sha256 != rehash.getHexDigest()) {
+            std::cout << "ERROR: streamed SHA-256 does not match the file" << std::endl;
+            result = false;
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(outputFile));
+        if (!reader || reader->lengthInSamples != range.duration_samples() ||
+            static_cast<int>(reader->numChannels) != expected.getNumChannels()) {
+            std::cout << "ERROR: rendered WAV is not readable with the expected format" << std::endl;
+            result = false;
+        } else if (bitDepth == juceaudioservice::EdlRenderer::BitDepth::Float32) {
+            juce::AudioBuffer<float> readBack(expected.getNumChannels(), expected.getNumSamples());
+            reader->read(&readBack, 0, readBack.getNumSamples(), 0, true, true);
+
+            if (!buffersIdentical(readBack, expected)) {
+                std::cout << "ERROR: float WAV samples differ from the buffer render" << std::endl;
+                result = false;
+            }
+        }
+
+        reader.reset();
+        outputFile.deleteFile();
+    }
+
+    std::cout << "Streamed hash test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testBatchWindowsMatchSingleRenders() {
+    std::cout << "Testing batch window renders match single-window renders..." << std::endl;
+
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    juceaudioservice::EdlCompiler::CompiledEdl compiled;
+    if (!compileTestEdl(3, store, snapshot, compiled)) {
+        return false;
+    }
+
+    using BitDepth = juceaudioservice::EdlRenderer::BitDepth;
+
+    // Two overlapping windows, one a short gap away, one far off and one invalid
+    struct Spec {
+        int64_t start;
+        int64_t duration;
+        BitDepth bitDepth;
+    };
+    const std::vector<Spec> specs = {
+        { 5000, 20000, BitDepth::Int16 },
+        { 100, 12345, BitDepth::Float32 },
+        { 26000, 3000, BitDepth::Int24 },
+        { 40000, 2500, BitDepth::Float32 },
+        { 1000, 0, BitDepth::Float32 },
+    };
+
+    std::vector<juceaudioservice::EdlRenderer::WindowOutput> windows;
+    std::vector<juce::File> files;
+    for (const auto& spec : specs) {
+        files.push_back(juce::File::createTempFile(".wav"));
+
+        juceaudioservice::EdlRenderer::WindowOutput window;
+        window.range.set_start_samples(spec.start);
+        window.range.set_duration_samples(spec.duration);
+        window.outputPath = files.back().getFullPathName().toStdString();
+        window.bitDepth = spec.bitDepth;
+        windows.push_back(window);
+    }
+
+    juceaudioservice::EdlRenderer renderer;
+    std::vector<int> completions(windows.size(), 0);
+    double lastProgress = 0.0;
+    bool progressMonotonic = true;
+    std::vector<juceaudioservice::EdlRenderer::WindowResult> results;
+
+    bool allSucceeded = renderer.renderWindowsToWav(
+        compiled, windows,
+        [&](double fraction) {
+            progressMonotonic = progressMonotonic && fraction >= lastProgress - 1.0e-9 && fraction <= 1.0 + 1.0e-9;
+            lastProgress = fraction;
+        },
+        [&](size_t index, const juceaudioservice::EdlRenderer::WindowResult&) { ++completions[index]; },
+        results);
+
+    bool result = true;
+
+    if (allSucceeded || results.size() != windows.size() || results.back().success) {
+        std::cout << "ERROR: the zero-length window should fail on its own" << std::endl;
+        result = false;
+    }
+
+    if (!progressMonotonic) {
+        std::cout << "ERROR: batch progress went backwards or past 1" << std::endl;
+        result = false;
+    }
+
+    for (size_t i = 0; i < completions.size(); ++i) {
+        if (completions[i] != 1) {
+            std::cout << "ERROR: window " << i << " was reported " << completions[i] << " times" << std::endl;
+            result = false;
+        }
+    }
+
+    // Every valid window must be byte-identical to rendering it alone
+    for (size_t i = 0; i + 1 < windows.size() && i < results.size(); ++i) {
+        if (!results[i].success) {
+            std::cout << "ERROR: window " << i << " failed: " << results[i].error << std::endl;
+            result = false;
+            continue;
+        }
+
+        auto singleFile = juce::File::createTempFile(".wav");
+        std::string sha256;
+        std::string error;
+        if (!renderer.renderToWav(compiled, windows[i].range, singleFile.getFullPathName().toStdString(),
+                                  windows[i].bitDepth, nullptr, sha256, error)) {
+            std::cout << "ERROR: single render failed: " << error << std::endl;
+            result = false;
+        } else {
+            juce::MemoryBlock batchContents;
+            juce::MemoryBlock singleContents;
+            files[i].loadFileAsData(batchContents);
+            singleFile.loadFileAsData(singleContents);
+
+            if (sha256 != results[i].sha256 || batchContents != singleContents) {
+                std::cout << "ERROR: window " << i << " differs from its single-window render" << std::endl;
+                result = false;
+            }
+        }
+        singleFile.deleteFile();
+    }
+
+    for (auto& file : files) {
+        file.deleteFile();
+    }
+
+    std::cout << "Batch window render test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testMixedRateMediaIsResampled() {
+    std::cout << "Testing media at another sample rate is resampled to the EDL rate..." << std::endl;
+
+    // One second of a 1 kHz sine at 96 kHz, used in a 48 kHz EDL
+    const double mediaRate = 96000.0;
+    const double frequency = 1000.0;
+    const float amplitude = 0.5f;
+    auto mediaFile = juce::File::createTempFile(".wav");
+    {
+        juce::AudioBuffer<float> sine(1, static_cast<int>(mediaRate));
+        for (int i = 0; i < sine.getNumSamples(); ++i) {
+            sine.setSample(0, i, amplitude * static_cast<float>(
+                std::sin(juce::MathConstants<double>::twoPi * frequency * i / mediaRate)));
+        }
+
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(
+            new juce::FileOutputStream(mediaFile), mediaRate, 1, 32, {}, 0));
+        if (!writer || !writer->writeFromAudioSampleBuffer(sine, 0, sine.getNumSamples())) {
+            std::cout << "ERROR: failed to write the 96 kHz media" << std::endl;
+            return false;
+        }
+    }
+
+    // start_in_media counts 96 kHz samples; the duration counts 48 kHz timeline samples
+    auto makeEdl = [&mediaFile](int64_t duration) {
+        audio_engine::Edl edl;
+        edl.set_id("mixed-rate-test");
+        edl.set_sample_rate(48000);
+
+        auto* media = edl.add_media();
+        media->set_id("sine96");
+        media->set_path(mediaFile.getFullPathName().toStdString());
+        media->set_sample_rate(96000);
+        media->set_channels(1);
+
+        auto* track = edl.add_tracks();
+        track->set_id("track");
+        auto* clip = track->add_clips();
+        clip->set_id("clip");
+        clip->set_media_id("sine96");
+        clip->set_start_in_media(9600);
+        clip->set_start_in_timeline(0);
+        clip->set_duration(duration);
+        return edl;
+    };
+
+    bool result = true;
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+
+    // 43200 timeline samples use the media up to its last sample; one more runs past it
+    if (store.replace(makeEdl(43201), snapshot, error)) {
+        std::cout << "ERROR: clip running past the end of the resampled media was accepted" << std::endl;
+        result = false;
+    }
+
+    if (!store.replace(makeEdl(43200), snapshot, error)) {
+        std::cout << "ERROR: mixed-rate EDL was rejected: " << error << std::endl;
+        mediaFile.deleteFile();
+        return false;
+    }
+
+    juceaudioservice::EdlCompiler compiler;
+    juceaudioservice::EdlCompiler::CompiledEdl compiled;
+    if (!compiler.compile(snapshot, compiled, error)) {
+        std::cout << "ERROR: EDL compilation failed: " << error << std::endl;
+        mediaFile.deleteFile();
+        return false;
+    }
+
+    juceaudioservice::MediaPageCache cache;
+    juceaudioservice::EdlRenderer renderer(cache);
+
+    audio_engine::TimeRange fullRange;
+    fullRange.set_start_samples(0);
+    fullRange.set_duration_samples(24000);
+
+    juce::AudioBuffer<float> full;
+    if (!renderer.renderToBuffer(compiled, fullRange, full, nullptr, error)) {
+        std::cout << "ERROR: render failed: " << error << std::endl;
+        mediaFile.deleteFile();
+        return false;
+    }
+
+    // Output sample n plays media time 0.1 s + n / 48 kHz
+    float maxError = 0.0f;
+    for (int i = 0; i < full.getNumSamples(); ++i) {
+        const double time = 9600.0 / mediaRate + i / 48000.0;
+        const auto expected = amplitude * static_cast<float>(
+            std::sin(juce::MathConstants<double>::twoPi * frequency * time));
+        maxError = std::max(maxError, std::abs(full.getSample(0, i) - expected));
+    }
+
+    if (maxError > 1.0e-3f) {
+        std::cout << "ERROR: resampled clip deviates from the ideal sine by " << maxError << std::endl;
+        result = false;
+    }
+
+    // A render starting mid-block reads its own filter context and matches the full render exactly
+    audio_engine::TimeRange partRange;
+    partRange.set_start_samples(517);
+    partRange.set_duration_samples(10000);
+
+    juce::AudioBuffer<float> part;
+    if (!renderer.renderToBuffer(compiled, partRange, part, nullptr, error)) {
+        std::cout << "ERROR: partial render failed: " << error << std::endl;
+        result = false;
+    } else {
+        for (int ch = 0; ch < part.getNumChannels() && result; ++ch) {
+            if (std::memcmp(part.getReadPointer(ch), full.getReadPointer(ch, 517),
+                            sizeof(float) * static_cast<size_t>(part.getNumSamples())) != 0) {
+                std::cout << "ERROR: partial render differs from the full render" << std::endl;
+                result = false;
+            }
+        }
+    }
+
+    mediaFile.deleteFile();
+
+    std::cout << "Mixed-rate media test " << (result ? "passed" : "failed")
+              << " (max error " << maxError << ")" << std::endl;
+    return result;
+}
+
+bool testSegmentedRenderMatchesSequential() {
+    std::cout << "Testing time-sliced WAV renders match sequential renders..." << std::endl;
+
+    // Clips spread over the whole range so every segment has audio and some straddle a segment bound
+    audio_engine::Edl edl = makeTestEdl(3);
+    auto* track = edl.mutable_tracks(0);
+    for (int c = 0; c < 12; ++c) {
+        auto* clip = track->add_clips();
+        clip->set_id("spread" + std::to_string(c));
+        clip->set_media_id(c % 2 == 0 ? "voice" : "test_voice");
+        clip->set_start_in_media(500 * c);
+        clip->set_start_in_timeline(60000 + 37000 * c);
+        clip->set_duration(9000);
+        clip->mutable_fade_in()->set_duration_samples(700);
+        clip->mutable_fade_in()->set_shape(audio_engine::Fade::LINEAR);
+    }
+
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    juceaudioservice::EdlCompiler::CompiledEdl compiled;
+    juceaudioservice::EdlCompiler compiler;
+    if (!store.replace(edl, snapshot, error) || !compiler.compile(snapshot, compiled, error)) {
+        std::cout << "ERROR: EDL setup failed: " << error << std::endl;
+        return false;
+    }
+
+    // Long enough for four segments; odd frame count so the 24-bit data chunk needs its pad byte
+    audio_engine::TimeRange range;
+    range.set_start_samples(100);
+    range.set_duration_samples(4 * juceaudioservice::EdlRenderer::minSegmentBlocks *
+                               juceaudioservice::EdlRenderer::getBlockSize() + 12345);
+
+    juceaudioservice::EdlRenderer sequential;
+    juceaudioservice::EdlRenderer segmented;
+    segmented.setNumSegmentThreads(4);
+
+    bool result = true;
+    for (auto bitDepth : { juceaudioservice::EdlRenderer::BitDepth::Int24,
+                           juceaudioservice::EdlRenderer::BitDepth::Float32 }) {
+        auto sequentialFile = juce::File::createTempFile(".wav");
+        auto segmentedFile = juce::File::createTempFile(".wav");
+        std::string sequentialHash;
+        std::string segmentedHash;
+
+        std::mutex progressMutex;
+        double lastProgress = 0.0;
+        bool progressMonotonic = true;
+        auto progress = [&](double fraction) {
+            std::lock_guard<std::mutex> lock(progressMutex);
+            progressMonotonic = progressMonotonic && fraction >= lastProgress && fraction <= 1.0 + 1.0e-9;
+            lastProgress = fraction;
+        };
+
+        if (!sequential.renderToWav(compiled, range, sequentialFile.getFullPathName().toStdString(), bitDepth,
+                                    nullptr, sequentialHash, error) ||
+            !segmented.renderToWav(compiled, range, segmentedFile.getFullPathName().toStdString(), bitDepth,
+                                   progress, segmentedHash, error)) {
+            std::cout << "ERROR: WAV render failed: " << error << std::endl;
+            return false;
+        }
+
+        juce::MemoryBlock sequentialContents;
+        juce::MemoryBlock segmentedContents;
+        sequentialFile.loadFileAsData(sequentialContents);
+        segmentedFile.loadFileAsData(segmentedContents);
+
+        if (sequentialContents != segmentedContents) {
+            std::cout << "ERROR: segmented WAV differs from the sequential render" << std::endl;
+            result = false;
+        }
+
+        if (segmentedHash.size() != 64 || segmentedHash != sequentialHash) {
+            std::cout << "ERROR: segmented SHA-256 does not match the sequential render" << std::endl;
+            result = false;
+        }
+
+        if (!progressMonotonic || std::abs(lastProgress - 1.0) > 1.0e-9) {
+            std::cout << "ERROR: segmented progress went backwards or did not reach 1" << std::endl;
+            result = false;
+        }
+
+        sequentialFile.deleteFile();
+        segmentedFile.deleteFile();
+    }
+
+    std::cout << "Segmented render test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testFlacRenderIsLossless() {
+    std::cout << "Testing FLAC renders decode to the WAV render's samples..." << std::endl;
+
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    juceaudioservice::EdlCompiler::CompiledEdl compiled;
+    if (!compileTestEdl(3, store, snapshot, compiled)) {
+        return false;
+    }
+
+    // Several encoder queues' worth of blocks, ending inside a block
+    audio_engine::TimeRange range;
+    range.set_start_samples(100);
+    range.set_duration_samples(12 * juceaudioservice::EdlRenderer::getBlockSize() + 777);
+
+    using OutputFormat = juceaudioservice::EdlRenderer::OutputFormat;
+    using BitDepth = juceaudioservice::EdlRenderer::BitDepth;
+
+    juceaudioservice::EdlRenderer renderer;
+    auto wavFile = juce::File::createTempFile(".wav");
+    auto flacFile = juce::File::createTempFile(".flac");
+    std::string wavHash;
+    std::string flacHash;
+    std::string error;
+
+    double lastProgress = 0.0;
+    if (!renderer.renderToFile(compiled, range, wavFile.getFullPathName().toStdString(), OutputFormat::Wav,
+                               BitDepth::Int24, nullptr, wavHash, error) ||
+        !renderer.renderToFile(compiled, range, flacFile.getFullPathName().toStdString(), OutputFormat::Flac,
+                               BitDepth::Int24, [&](double fraction) { lastProgress = fraction; }, flacHash,
+                               error)) {
+        std::cout << "ERROR: render failed: " << error << std::endl;
+        return false;
+    }
+
+    bool result = true;
+
+    if (std::abs(lastProgress - 1.0) > 1.0e-9) {
+        std::cout << "ERROR: FLAC render progress did not reach 1" << std::endl;
+        result = false;
+    }
+
+    if (flacHash.size() != 64 || flacHash != juceaudioservice::HashingOutputStream::hashFile(flacFile)) {
+        std::cout << "ERROR: FLAC SHA-256 does not match the file" << std::endl;
+        result = false;
+    }
+
+    if (flacFile.getSize() >= wavFile.getSize()) {
+        std::cout << "ERROR: FLAC file (" << flacFile.getSize() << " bytes) is not smaller than the WAV file ("
+                  << wavFile.getSize() << " bytes)" << std::endl;
+        result = false;
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> wavReader(formatManager.createReaderFor(wavFile));
+    std::unique_ptr<juce::AudioFormatReader> flacReader(formatManager.createReaderFor(flacFile));
+
+    if (!wavReader || !flacReader || flacReader->lengthInSamples != range.duration_samples() ||
+        flacReader->numChannels != wavReader->numChannels || flacReader->bitsPerSample != 24) {
+        std::cout << "ERROR: FLAC file is not readable with the expected format" << std::endl;
+        result = false;
+    } else {
+        const int numChannels = static_cast<int>(wavReader->numChannels);
+        const int numSamples = static_cast<int>(range.duration_samples());
+        juce::AudioBuffer<float> wavSamples(numChannels, numSamples);
+        juce::AudioBuffer<float> flacSamples(numChannels, numSamples);
+        wavReader->read(&wavSamples, 0, numSamples, 0, true, true);
+        flacReader->read(&flacSamples, 0, numSamples, 0, true, true);
+
+        if (!buffersIdentical(wavSamples, flacSamples)) {
+            std::cout << "ERROR: FLAC samples differ from the 24-bit WAV render" << std::endl;
+            result = false;
+        }
+    }
+
+    wavReader.reset();
+    flacReader.reset();
+
+    // FLAC has no float samples
+    std::string floatHash;
+    if (renderer.renderToFile(compiled, range, flacFile.getFullPathName().toStdString(), OutputFormat::Flac,
+                              BitDepth::Float32, nullptr, floatHash, error)) {
+        std::cout << "ERROR: 32-bit float FLAC render should fail" << std::endl;
+        result = false;
+    }
+
+    wavFile.deleteFile();
+    flacFile.deleteFile();
+
+    std::cout << "FLAC render test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+int main() {
+    std::cout << "Running EDL renderer tests..." << std::endl;
+
+    bool allTestsPassed = true;
+
+    if (!testClipCursorHandlesLongClips()) {
+        allTestsPassed = false;
+    }
+
+    if (!testParallelRenderMatchesSerial()) {
+        allTestsPassed = false;
+    }
+
+    if (!testMediaCacheServesRepeatedRenders()) {
+        allTestsPassed = false;
+    }
+
+    if (!testRewrittenMediaIsClosed()) {
+        allTestsPassed = false;
+    }
+
+    if (!testPrefetchReadsAheadOfMixer()) {
+        allTestsPassed = false;
+    }
+
+    if (!testMemoryMappedReaderMatchesBuffered()) {
+        allTestsPassed = false;
+    }
+
+    if (!testFadeCurvesMatchPerSampleEvaluation()) {
+        allTestsPassed = false;
+    }
+
+    if (!testSteadyStateRenderDoesNotAllocate()) {
+        allTestsPassed = false;
+    }
+
+    if (!testWavHeaderSwitchesToRF64()) {
+        allTestsPassed = false;
+    }
+
+    if (!testWavHashedWhileWriting()) {
+        allTestsPassed = false;
+    }
+
+    if (!testMixedRateMediaIsResampled()) {
+        allTestsPassed = false;
+    }
+
+    if (!testBatchWindowsMatchSingleRenders()) {
+        allTestsPassed = false;
+    }
+
+    if (!testSegmentedRenderMatchesSequential()) {
+        allTestsPassed = false;
+    }
+
+    if (!testFlacRenderIsLossless()) {
+        allTestsPassed = false;
+    }
+
+    std::cout << "All EDL renderer tests " << (allTestsPassed ? "PASSED" : "FAILED") << std::endl;
+    return allTestsPassed ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/EventBroadcaster.h"
+
+using juceaudioservice::EventBroadcaster;
+using Result = EventBroadcaster::Subscription::Result;
+
+namespace {
+
+audio_engine::EngineEvent makeApplied(int revision) {
+    audio_engine::EngineEvent event;
+    event.mutable_edl_applied()->set_edl_id("edl");
+    event.mutable_edl_applied()->set_revision(std::to_string(revision));
+    return event;
+}
+
+audio_engine::EngineEvent makeProgress(double fraction) {
+    audio_engine::EngineEvent event;
+    event.mutable_progress()->set_fraction(fraction);
+    return event;
+}
+
+} // namespace
+
+bool testEventsReachEverySubscriberInOrder() {
+    std::cout << "Testing events reach every subscriber in order..." << std::endl;
+
+    EventBroadcaster broadcaster;
+    auto first = broadcaster.subscribe();
+    auto second = broadcaster.subscribe();
+
+    for (int i = 0; i < 10; ++i) {
+        broadcaster.broadcast(makeApplied(i));
+    }
+
+    bool result = true;
+    for (const auto& subscription : {first, second}) {
+        for (int i = 0; i < 10; ++i) {
+            EventBroadcaster::EventPtr event;
+            if (subscription->next(event, std::chrono::milliseconds(0)) != Result::Event ||
+                event->edl_applied().revision() != std::to_string(i)) {
+                std::cout << "ERROR: event " << i << " missing or out of order" << std::endl;
+                result = false;
+                break;
+            }
+        }
+    }
+
+    EventBroadcaster::EventPtr event;
+    if (first->next(event, std::chrono::milliseconds(10)) != Result::Timeout) {
+        std::cout << "ERROR: drained subscription did not time out" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Fan-out test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testSlowSubscriberDoesNotBlockOthers() {
+    std::cout << "Testing a subscriber that never reads does not hold up broadcasts..." << std::endl;
+
+    EventBroadcaster broadcaster;
+    auto stalled = broadcaster.subscribe(16);
+    auto live = broadcaster.subscribe(16);
+
+    std::atomic<int> received{0};
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        while (!done) {
+            EventBroadcaster::EventPtr event;
+            if (live->next(event, std::chrono::milliseconds(50)) == Result::Event) {
+                ++received;
+            }
+        }
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10000; ++i) {
+        broadcaster.broadcast(makeProgress(i / 10000.0));
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Drain what the live reader still has queued before stopping it
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    done = true;
+    reader.join();
+
+    bool result = true;
+    if (elapsed > std::chrono::seconds(2)) {
+        std::cout << "ERROR: broadcasting 10000 events took too long" << std::endl;
+        result = false;
+    }
+
+    if (stalled->hasOverflowed()) {
+        std::cout << "ERROR: dropped progress events overflowed the stalled subscription" << std::endl;
+        result = false;
+    }
+
+    if (stalled->getNumDropped() < 10000 - 16) {
+        std::cout << "ERROR: stalled subscription dropped only " << stalled->getNumDropped() << " events" << std::endl;
+        result = false;
+    }
+
+    if (received.load() == 0) {
+        std::cout << "ERROR: live subscriber received nothing" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Slow subscriber test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testQueuedProgressCoalesces() {
+    std::cout << "Testing queued progress events collapse to the newest..." << std::endl;
+
+    EventBroadcaster broadcaster;
+    auto subscription = broadcaster.subscribe(64);
+
+    for (int i = 1; i <= 5; ++i) {
+        broadcaster.broadcast(makeProgress(i / 10.0));
+    }
+    broadcaster.broadcast(makeApplied(1));
+    broadcaster.broadcast(makeProgress(0.9));
+
+    bool result = true;
+    EventBroadcaster::EventPtr event;
+
+    if (subscription->next(event, std::chrono::milliseconds(0)) != Result::Event ||
+        !event->has_progress() || event->progress().fraction() != 0.5) {
+        std::cout << "ERROR: expected only the newest of the first progress run" << std::endl;
+        result = false;
+    }
+
+    if (subscription->next(event, std::chrono::milliseconds(0)) != Result::Event || !event->has_edl_applied()) {
+        std::cout << "ERROR: edl_applied was coalesced or reordered" << std::endl;
+        result = false;
+    }
+
+    if (subscription->next(event, std::chrono::milliseconds(0)) != Result::Event ||
+        !event->has_progress() || event->progress().fraction() != 0.9) {
+        std::cout << "ERROR: progress after edl_applied was lost" << std::endl;
+        result = false;
+    }
+
+    if (subscription->getNumDropped() != 4) {
+        std::cout << "ERROR: expected 4 coalesced events, counted " << subscription->getNumDropped() << std::endl;
+        result = false;
+    }
+
+    std::cout << "Coalescing test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testLostEventOverflowsSubscription() {
+    std::cout << "Testing a full queue overflows instead of losing edl events silently..." << std::endl;
+
+    EventBroadcaster broadcaster;
+    auto subscription = broadcaster.subscribe(8);
+
+    for (int i = 0; i < 9; ++i) {
+        broadcaster.broadcast(makeApplied(i));
+    }
+
+    EventBroadcaster::EventPtr event;
+    bool result = subscription->next(event, std::chrono::milliseconds(0)) == Result::Overflowed;
+    if (!result) {
+        std::cout << "ERROR: ninth event into a queue of 8 did not overflow" << std::endl;
+    }
+
+    auto stats = broadcaster.getStats();
+    if (stats.overflows != 1 || stats.broadcasts != 9) {
+        std::cout << "ERROR: stats report " << stats.overflows << " overflows, " << stats.broadcasts
+                  << " broadcasts" << std::endl;
+        result = false;
+    }
+
+    broadcaster.unsubscribe(subscription);
+    if (broadcaster.getStats().subscribers != 0 || broadcaster.getStats().overflows != 1) {
+        std::cout << "ERROR: unsubscribe lost the subscription's counters" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Overflow test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testWaitingSubscriberWakesPromptly() {
+    std::cout << "Testing a waiting subscriber wakes on broadcast and on close..." << std::endl;
+
+    EventBroadcaster broadcaster;
+    auto subscription = broadcaster.subscribe();
+
+    std::thread producer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        broadcaster.broadcast(makeApplied(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        broadcaster.close();
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    EventBroadcaster::EventPtr event;
+    const Result first = subscription->next(event, std::chrono::seconds(10));
+    const Result second = subscription->next(event, std::chrono::seconds(10));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    producer.join();
+
+    bool result = true;
+    if (first != Result::Event || second != Result::Closed) {
+        std::cout << "ERROR: expected an event and then Closed" << std::endl;
+        result = false;
+    }
+
+    if (elapsed > std::chrono::seconds(5)) {
+        std::cout << "ERROR: subscriber slept through the events" << std::endl;
+        result = false;
+    }
+
+    if (broadcaster.subscribe()->next(event, std::chrono::milliseconds(0)) != Result::Closed) {
+        std::cout << "ERROR: subscription after close() was not closed" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Wake-up test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testReadyCallbackDrivesNonBlockingConsumer() {
+    std::cout << "Testing the ready callback fires per event and stops after unsubscribe..." << std::endl;
+
+    EventBroadcaster broadcaster;
+    int calls = 0;
+    auto subscription = broadcaster.subscribe(16, [&calls] { ++calls; });
+
+    broadcaster.broadcast(makeApplied(1));
+    broadcaster.broadcast(makeApplied(2));
+
+    bool result = true;
+    EventBroadcaster::EventPtr event;
+    if (calls != 2 || subscription->next(event, std::chrono::milliseconds(0)) != Result::Event) {
+        std::cout << "ERROR: expected a callback per event, got " << calls << std::endl;
+        result = false;
+    }
+
+    broadcaster.unsubscribe(subscription);
+    broadcaster.broadcast(makeApplied(3));
+    broadcaster.close();
+    if (calls != 2) {
+        std::cout << "ERROR: callback fired after unsubscribe" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Ready callback test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+int main() {
+    std::cout << "Running event broadcaster tests..." << std::endl;
+
+    bool allTestsPassed = true;
+
+    if (!testEventsReachEverySubscriberInOrder()) {
+        allTestsPassed = false;
+    }
+
+    if (!testSlowSubscriberDoesNotBlockOthers()) {
+        allTestsPassed = false;
+    }
+
+    if (!testQueuedProgressCoalesces()) {
+        allTestsPassed = false;
+    }
+
+    if (!testLostEventOverflowsSubscription()) {
+        allTestsPassed = false;
+    }
+
+    if (!testWaitingSubscriberWakesPromptly()) {
+        allTestsPassed = false;
+    }
+
+    if (!testReadyCallbackDrivesNonBlockingConsumer()) {
+        allTestsPassed = false;
+    }
+
+    std::cout << "All event broadcaster tests " << (allTestsPassed ? "PASSED" : "FAILED") << std::endl;
+    return allTestsPassed ? 0 : 1;
+}
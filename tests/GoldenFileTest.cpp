@@ -5,6 +5,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <cmath>
 #include <cstdlib>
 #include <sstream>
 
@@ -173,6 +174,103 @@ public:
         }
     }
 
+    static bool runResampledWindowTest()
+    {
+        std::cout << "Running resampled windowed rendering test..." << std::endl;
+
+        auto projectRoot = juce::File::getCurrentWorkingDirectory();
+        while (!projectRoot.getChildFile("CMakeLists.txt").exists() && projectRoot.getParentDirectory() != projectRoot)
+        {
+            projectRoot = projectRoot.getParentDirectory();
+        }
+
+        const auto testOutputDir = projectRoot.getChildFile("tests/data/output");
+        const auto sineFile = testOutputDir.getChildFile("sine_1k_1s_48k_24bit.wav");
+        testOutputDir.createDirectory();
+
+        // A 48 kHz sine, converted to 44.1 kHz and compared with the ideal 44.1 kHz sine
+        const double frequency = 1000.0;
+        const double sourceRate = 48000.0;
+        const double outputRate = 44100.0;
+
+        juceaudioservice::AudioService audioService;
+        audioService.initialise();
+
+        auto sine = audioService.generateSineWave(frequency, 1.0, sourceRate, 1);
+        if (!audioService.writeAudioFile(sine, sineFile, sourceRate, 24))
+        {
+            std::cerr << "Failed to write test audio file" << std::endl;
+            return false;
+        }
+
+        const juce::int64 startFrame = 4800;
+        const int windowFrames = 24000;
+
+        juceaudioservice::AudioFileSource wholeSource;
+        juceaudioservice::AudioFileSource splitSource;
+        if (!wholeSource.loadFile(sineFile) || !splitSource.loadFile(sineFile))
+        {
+            std::cerr << "Failed to load test audio file" << std::endl;
+            return false;
+        }
+
+        juceaudioservice::OfflineRenderer wholeRenderer;
+        const auto whole = wholeRenderer.renderWindow(wholeSource, startFrame, windowFrames, sourceRate, outputRate, 1);
+
+        if (whole.getNumSamples() != 22050)
+        {
+            std::cerr << "✗ Expected 22050 output frames, got " << whole.getNumSamples() << std::endl;
+            return false;
+        }
+
+        // The window starts mid-file, so the filter sees real audio before it and no ramp is expected
+        const float peak = static_cast<float>(sine.getMagnitude(0, 0, sine.getNumSamples()));
+        float maxError = 0.0f;
+        for (int i = 0; i < whole.getNumSamples(); ++i)
+        {
+            const double time = static_cast<double>(startFrame) / sourceRate + i / outputRate;
+            const auto expected = peak * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * time));
+            maxError = juce::jmax(maxError, std::abs(whole.getSample(0, i) - expected));
+        }
+
+        if (maxError > 1.0e-3f)
+        {
+            std::cerr << "✗ Resampled sine deviates by " << maxError << std::endl;
+            return false;
+        }
+
+        // Consecutive windows continue the same stream and join seamlessly
+        juceaudioservice::OfflineRenderer splitRenderer;
+        const int windowSizes[] = { 1000, 4411, 7, 12582 };
+        juce::int64 frame = startFrame;
+        int outputFrame = 0;
+
+        for (const int frames : windowSizes)
+        {
+            const auto part = splitRenderer.renderWindow(splitSource, frame, frames, sourceRate, outputRate, 1);
+            for (int i = 0; i < part.getNumSamples(); ++i)
+            {
+                if (outputFrame + i >= whole.getNumSamples() || part.getSample(0, i) != whole.getSample(0, outputFrame + i))
+                {
+                    std::cerr << "✗ Split render differs at output frame " << outputFrame + i << std::endl;
+                    return false;
+                }
+            }
+
+            frame += frames;
+            outputFrame += part.getNumSamples();
+        }
+
+        if (outputFrame != whole.getNumSamples())
+        {
+            std::cerr << "✗ Split render produced " << outputFrame << " frames, expected " << whole.getNumSamples() << std::endl;
+            return false;
+        }
+
+        std::cout << "✓ Resampled windowed rendering test passed (max error " << maxError << ")" << std::endl;
+        return true;
+    }
+
 private:
     static juce::String calculateSHA256(const juce::File& file)
     {
@@ -235,6 +333,11 @@ int main()
         allTestsPassed = false;
     }
 
+    if (!GoldenFileTest::runResampledWindowTest())
+    {
+        allTestsPassed = false;
+    }
+
     if (allTestsPassed)
     {
         std::cout << "All golden file tests passed" << std::endl;
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "edl/MixKernels.h"
+
+using juceaudioservice::MixKernels;
+
+namespace {
+
+struct Channels {
+    std::vector<std::vector<float>> samples;
+    std::vector<float*> pointers;
+
+    Channels(int numChannels, int numSamples)
+        : samples(static_cast<size_t>(numChannels), std::vector<float>(static_cast<size_t>(numSamples))) {
+        for (auto& channel : samples) {
+            pointers.push_back(channel.data());
+        }
+    }
+};
+
+void fillRandom(std::vector<float>& values, std::mt19937& random, float low, float high) {
+    std::uniform_real_distribution<float> distribution(low, high);
+    for (auto& value : values) {
+        value = distribution(random);
+    }
+}
+
+} // namespace
+
+bool testKernelsMatchSeparatePasses() {
+    std::cout << "Testing mix kernels match separate gain, fade and sum passes..." << std::endl;
+
+    const int numSamples = 1000;
+    const int sourceStart = 3;
+    const int destStart = 17;
+    const int bufferSamples = numSamples + destStart;
+    std::mt19937 random(1234);
+
+    bool result = true;
+    for (int numChannels = 1; numChannels <= 3; ++numChannels) {
+        for (unsigned features = 0; features <= MixKernels::allFeatures; ++features) {
+            Channels source(numChannels, bufferSamples);
+            Channels mixed(numChannels, bufferSamples);
+            std::vector<float> fadeIn(numSamples), fadeOut(numSamples);
+
+            for (auto& channel : source.samples) {
+                fillRandom(channel, random, -1.0f, 1.0f);
+            }
+            for (auto& channel : mixed.samples) {
+                fillRandom(channel, random, -1.0f, 1.0f);
+            }
+            fillRandom(fadeIn, random, 0.0f, 1.0f);
+            fillRandom(fadeOut, random, 0.0f, 1.0f);
+
+            const float clipGain = 0.70794576f;
+            const float trackGain = 0.8413951f;
+
+            // Reference: one pass per factor over a copy of the clip, then a sum
+            auto expected = mixed.samples;
+            for (int ch = 0; ch < numChannels; ++ch) {
+                std::vector<float> clip(source.samples[static_cast<size_t>(ch)].begin() + sourceStart,
+                                        source.samples[static_cast<size_t>(ch)].begin() + sourceStart + numSamples);
+                for (int i = 0; i < numSamples; ++i) {
+                    if ((features & MixKernels::ClipGain) != 0) {
+                        clip[static_cast<size_t>(i)] *= clipGain;
+                    }
+                }
+                for (int i = 0; i < numSamples; ++i) {
+                    if ((features & MixKernels::FadeIn) != 0) {
+                        clip[static_cast<size_t>(i)] *= fadeIn[static_cast<size_t>(i)];
+                    }
+                }
+                for (int i = 0; i < numSamples; ++i) {
+                    if ((features & MixKernels::FadeOut) != 0) {
+                        clip[static_cast<size_t>(i)] *= fadeOut[static_cast<size_t>(i)];
+                    }
+                }
+                for (int i = 0; i < numSamples; ++i) {
+                    if ((features & MixKernels::TrackGain) != 0) {
+                        clip[static_cast<size_t>(i)] *= trackGain;
+                    }
+                }
+                for (int i = 0; i < numSamples; ++i) {
+                    expected[static_cast<size_t>(ch)][static_cast<size_t>(destStart + i)] += clip[static_cast<size_t>(i)];
+                }
+            }
+
+            MixKernels::Span span;
+            span.source = source.pointers.data();
+            span.sourceStart = sourceStart;
+            span.dest = mixed.pointers.data();
+            span.destStart = destStart;
+            span.numChannels = numChannels;
+            span.numSamples = numSamples;
+            span.clipGain = clipGain;
+            span.trackGain = trackGain;
+            span.fadeIn = fadeIn.data();
+            span.fadeOut = fadeOut.data();
+            MixKernels::select(numChannels, features)(span);
+
+            for (int ch = 0; ch < numChannels; ++ch) {
+                if (std::memcmp(expected[static_cast<size_t>(ch)].data(), mixed.samples[static_cast<size_t>(ch)].data(),
+                                sizeof(float) * static_cast<size_t>(bufferSamples)) != 0) {
+                    std::cerr << "Kernel for " << numChannels << " channels, features " << features
+                              << " differs on channel " << ch << std::endl;
+                    result = false;
+                }
+            }
+        }
+    }
+
+    std::cout << "Mix kernel test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testKernelsLeaveSamplesOutsideTheSpan() {
+    std::cout << "Testing mix kernels only touch their span..." << std::endl;
+
+    const int bufferSamples = 64;
+    Channels source(2, bufferSamples);
+    Channels mixed(2, bufferSamples);
+    for (auto& channel : source.samples) {
+        std::fill(channel.begin(), channel.end(), 1.0f);
+    }
+
+    MixKernels::Span span;
+    span.source = source.pointers.data();
+    span.dest = mixed.pointers.data();
+    span.destStart = 10;
+    span.numChannels = 2;
+    span.numSamples = 20;
+    MixKernels::select(2, 0)(span);
+
+    bool result = true;
+    for (const auto& channel : mixed.samples) {
+        for (int i = 0; i < bufferSamples; ++i) {
+            const float expected = i >= 10 && i < 30 ? 1.0f : 0.0f;
+            if (channel[static_cast<size_t>(i)] != expected) {
+                std::cerr << "Sample " << i << " is " << channel[static_cast<size_t>(i)]
+                          << ", expected " << expected << std::endl;
+                result = false;
+                break;
+            }
+        }
+    }
+
+    std::cout << "Mix span test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+int main() {
+    std::cout << "Running mix kernel tests..." << std::endl;
+
+    bool allTestsPassed = true;
+
+    if (!testKernelsMatchSeparatePasses()) {
+        allTestsPassed = false;
+    }
+
+    if (!testKernelsLeaveSamplesOutsideTheSpan()) {
+        allTestsPassed = false;
+    }
+
+    std::cout << "All mix kernel tests " << (allTestsPassed ? "PASSED" : "FAILED") << std::endl;
+    return allTestsPassed ? 0 : 1;
+}
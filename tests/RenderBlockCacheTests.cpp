@@ -0,0 +1,303 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "edl/EdlStore.h"
+#include "edl/EdlRenderer.h"
+#include "edl/RenderBlockCache.h"
+#include "edl/TimelineDiff.h"
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "TestHelpers.h"
+
+using testhelpers::buffersIdentical;
+using testhelpers::fixturePath;
+using testhelpers::makeRange;
+
+static const testhelpers::ClipFades clipFades{ 400, 900 };
+
+static audio_engine::Clip makeClip(const std::string& id, int64_t startInMedia, int64_t startInTimeline,
+                                   int64_t duration) {
+    return testhelpers::makeClip(id, "voice", startInMedia, startInTimeline, duration, clipFades);
+}
+
+// Three tracks of short clips spread over about 30 render blocks
+static audio_engine::Edl makeTestEdl() {
+    testhelpers::TestEdlLayout layout;
+    layout.numTracks = 3;
+    layout.clipsPerTrack = 6;
+    layout.clipSpacing = 20000;
+    layout.trackOffset = 3000;
+    layout.mediaTrackStep = 1000;
+    layout.clipDuration = 15000;
+    layout.fades = clipFades;
+    layout.trackGainDb = [](int t) { return -2.0f * static_cast<float>(t); };
+    return testhelpers::makeTestEdl("block-test", layout);
+}
+
+static bool applyEdit(juceaudioservice::EdlStore& store, const audio_engine::EdlEdit& edit) {
+    audio_engine::PatchEdlRequest request;
+    request.set_edl_id("block-test");
+    *request.add_edits() = edit;
+
+    std::string error;
+    juceaudioservice::EdlStore::PatchResult result;
+    if (!store.patch(request, result, error)) {
+        std::cout << "ERROR: patch failed: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool testDiffFindsChangedRegions() {
+    std::cout << "Testing timeline diffs cover exactly the edited regions..." << std::endl;
+
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    if (!store.replace(makeTestEdl(), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+    auto base = store.getCompiled();
+
+    bool result = true;
+    if (!juceaudioservice::TimelineDiff::between(*base, *base).isEmpty()) {
+        std::cout << "ERROR: identical timelines reported a change" << std::endl;
+        result = false;
+    }
+
+    // Moving a clip dirties where it was and where it is now
+    audio_engine::EdlEdit edit;
+    edit.set_track_id("t1");
+    *edit.mutable_modify_clip() = makeClip("t1c2", 1000, 50000, 15000);
+    if (!applyEdit(store, edit)) {
+        return false;
+    }
+
+    auto diff = juceaudioservice::TimelineDiff::between(*base, *store.getCompiled());
+    const std::vector<std::pair<int64_t, int64_t>> expected = { { 43000, 65000 } };
+    if (diff.everything || diff.intervals != expected) {
+        std::cout << "ERROR: moved clip produced the wrong intervals" << std::endl;
+        result = false;
+    }
+
+    if (diff.touches(0, 43000) || !diff.touches(42999, 43001) || diff.touches(65000, 70000)) {
+        std::cout << "ERROR: touches() disagrees with the intervals" << std::endl;
+        result = false;
+    }
+
+    // Track gain reaches every clip of the track
+    audio_engine::EdlEdit trackEdit;
+    trackEdit.set_track_id("t2");
+    trackEdit.mutable_modify_track()->set_gain_db(-9.0f);
+    auto moved = store.getCompiled();
+    if (!applyEdit(store, trackEdit)) {
+        return false;
+    }
+
+    diff = juceaudioservice::TimelineDiff::between(*moved, *store.getCompiled());
+    if (diff.everything || diff.intervals.size() != 6 || diff.intervals.front().first != 6000 ||
+        diff.intervals.back().second != 121000) {
+        std::cout << "ERROR: track gain change did not cover the track's clips" << std::endl;
+        result = false;
+    }
+
+    // Tracks summed in another order change every sample
+    auto reordered = makeTestEdl();
+    reordered.mutable_tracks()->SwapElements(0, 2);
+    if (!store.replace(reordered, snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+    if (!juceaudioservice::TimelineDiff::between(*base, *store.getCompiled()).everything) {
+        std::cout << "ERROR: track reorder was not treated as a full change" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Timeline diff test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testIncrementalRenderMatchesFullRender() {
+    std::cout << "Testing incremental re-renders match full renders..." << std::endl;
+
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    if (!store.replace(makeTestEdl(), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+
+    constexpr int blockSize = juceaudioservice::EdlRenderer::getBlockSize();
+    constexpr int numBlocks = 32;
+    const auto range = makeRange(0, static_cast<int64_t>(numBlocks) * blockSize);
+
+    juceaudioservice::RenderBlockCache cache(blockSize);
+    juceaudioservice::EdlRenderer incremental;
+    incremental.setBlockCache(&cache);
+    juceaudioservice::EdlRenderer full;
+
+    bool result = true;
+    auto renderBoth = [&](const audio_engine::TimeRange& renderRange, const char* what) {
+        auto compiled = store.getCompiled();
+        juce::AudioBuffer<float> expected, actual;
+        if (!full.renderToBuffer(*compiled, renderRange, expected, nullptr, error) ||
+            !incremental.renderToBuffer(*compiled, renderRange, actual, nullptr, error)) {
+            std::cout << "ERROR: render failed: " << error << std::endl;
+            result = false;
+        } else if (!buffersIdentical(expected, actual)) {
+            std::cout << "ERROR: " << what << " differs from a full render" << std::endl;
+            result = false;
+        }
+    };
+
+    renderBoth(range, "first render");
+    auto stats = cache.getStats();
+    if (stats.rendered != numBlocks || stats.reused != 0) {
+        std::cout << "ERROR: first render should mix every block, mixed " << stats.rendered << std::endl;
+        result = false;
+    }
+
+    // Repeating the render mixes nothing
+    renderBoth(range, "repeated render");
+    if (cache.getStats().rendered != stats.rendered) {
+        std::cout << "ERROR: repeated render mixed blocks again" << std::endl;
+        result = false;
+    }
+
+    // A gain change on one 15000-sample clip spans 5 blocks
+    audio_engine::EdlEdit edit;
+    edit.set_track_id("t0");
+    auto clip = makeClip("t0c3", 0, 60000, 15000);
+    clip.set_gain_db(-12.0f);
+    *edit.mutable_modify_clip() = clip;
+    if (!applyEdit(store, edit)) {
+        return false;
+    }
+
+    stats = cache.getStats();
+    renderBoth(range, "render after an edit");
+    auto after = cache.getStats();
+    if (after.rendered - stats.rendered != 5 || after.invalidated - stats.invalidated != 5) {
+        std::cout << "ERROR: expected 5 blocks re-mixed, got " << (after.rendered - stats.rendered) << std::endl;
+        result = false;
+    }
+
+    // Ranges that start and end inside blocks are cut from the grid blocks
+    renderBoth(makeRange(517, 50000), "unaligned render");
+
+    // Blocks mixed on a worker pool are interchangeable with serial ones
+    cache.clear();
+    incremental.setNumWorkerThreads(3);
+    full.setNumWorkerThreads(3);
+    renderBoth(range, "parallel render");
+    incremental.setNumWorkerThreads(1);
+    renderBoth(makeRange(blockSize * 3, blockSize * 4), "serial render from parallel blocks");
+
+    std::cout << "Incremental render test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testRewrittenMediaInvalidatesBlocks() {
+    std::cout << "Testing a media file rewritten in place invalidates its blocks..." << std::endl;
+
+    // A private copy of the fixture, so rewriting it leaves the others alone
+    auto swapFile = juce::File::createTempFile(".wav");
+    if (!juce::File(fixturePath("voice.wav")).copyFileTo(swapFile)) {
+        std::cout << "ERROR: could not copy the fixture" << std::endl;
+        return false;
+    }
+
+    auto edl = makeTestEdl();
+    auto* swap = edl.add_media();
+    swap->set_id("swap");
+    swap->set_path(swapFile.getFullPathName().toStdString());
+    swap->set_channels(1);
+
+    auto* swapTrack = edl.add_tracks();
+    swapTrack->set_id("swap-track");
+    *swapTrack->add_clips() = testhelpers::makeClip("s0", "swap", 0, 40000, 15000, clipFades);
+
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    if (!store.replace(edl, snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        swapFile.deleteFile();
+        return false;
+    }
+
+    constexpr int blockSize = juceaudioservice::EdlRenderer::getBlockSize();
+    constexpr int numBlocks = 32;
+    const auto range = makeRange(0, static_cast<int64_t>(numBlocks) * blockSize);
+    const auto compiled = store.getCompiled();
+
+    juceaudioservice::RenderBlockCache cache(blockSize);
+    juceaudioservice::EdlRenderer incremental;
+    incremental.setBlockCache(&cache);
+
+    bool result = true;
+    juce::AudioBuffer<float> before;
+    if (!incremental.renderToBuffer(*compiled, range, before, nullptr, error)) {
+        std::cout << "ERROR: render failed: " << error << std::endl;
+        result = false;
+    }
+
+    // Same path and revision, other samples; the later time rules out a same-millisecond rewrite
+    if (!juce::File(fixturePath("test_voice.wav")).copyFileTo(swapFile) ||
+        !swapFile.setLastModificationTime(juce::Time(juce::Time::currentTimeMillis() + 10000))) {
+        std::cout << "ERROR: could not rewrite the media file" << std::endl;
+        result = false;
+    }
+
+    const auto stats = cache.getStats();
+    juce::AudioBuffer<float> expected, actual;
+    juceaudioservice::EdlRenderer full;
+    if (!full.renderToBuffer(*compiled, range, expected, nullptr, error) ||
+        !incremental.renderToBuffer(*compiled, range, actual, nullptr, error)) {
+        std::cout << "ERROR: render failed: " << error << std::endl;
+        result = false;
+    } else if (!buffersIdentical(expected, actual)) {
+        std::cout << "ERROR: render after the rewrite mixed stale blocks" << std::endl;
+        result = false;
+    }
+
+    // Only the blocks under the clip on the rewritten file are mixed again
+    const uint64_t swapBlocks = (40000 + 15000 - 1) / blockSize - 40000 / blockSize + 1;
+    const auto after = cache.getStats();
+    if (after.rendered - stats.rendered != swapBlocks || after.invalidated - stats.invalidated != swapBlocks) {
+        std::cout << "ERROR: expected " << swapBlocks << " blocks re-mixed, got "
+                  << (after.rendered - stats.rendered) << std::endl;
+        result = false;
+    }
+
+    swapFile.deleteFile();
+
+    std::cout << "Rewritten media test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+int main() {
+    std::cout << "Running render block cache tests..." << std::endl;
+
+    bool allTestsPassed = true;
+
+    if (!testDiffFindsChangedRegions()) {
+        allTestsPassed = false;
+    }
+
+    if (!testIncrementalRenderMatchesFullRender()) {
+        allTestsPassed = false;
+    }
+
+    if (!testRewrittenMediaInvalidatesBlocks()) {
+        allTestsPassed = false;
+    }
+
+    std::cout << "All render block cache tests " << (allTestsPassed ? "PASSED" : "FAILED") << std::endl;
+    return allTestsPassed ? 0 : 1;
+}
@@ -0,0 +1,314 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "edl/EdlStore.h"
+#include "edl/RenderCache.h"
+
+#include <juce_core/juce_core.h>
+
+#include "TestHelpers.h"
+
+using testhelpers::makeRange;
+
+static juce::File makeTempDirectory(const char* name) {
+    auto dir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                   .getNonexistentChildFile(name, "", false);
+    dir.createDirectory();
+    return dir;
+}
+
+// The cache never looks inside the files, so any bytes stand in for a render
+static juce::File writeRender(const juce::File& dir, const char* name, int numBytes, char fill) {
+    auto file = dir.getChildFile(name);
+    std::vector<char> bytes(static_cast<size_t>(numBytes), fill);
+    file.replaceWithData(bytes.data(), bytes.size());
+    return file;
+}
+
+static std::string fakeHash(char digit) {
+    return std::string(64, digit);
+}
+
+// Keys are a digest plus the format's extension, like makeKey() builds
+static std::string fakeKey(char digit) {
+    return fakeHash(digit) + ".wav";
+}
+
+static bool sameContents(const juce::File& a, const juce::File& b) {
+    juce::MemoryBlock first, second;
+    return a.loadFileAsData(first) && b.loadFileAsData(second) && first == second;
+}
+
+// One unfaded clip; clipDuration tells two timelines apart
+static audio_engine::Edl makeTestEdl(int64_t clipDuration) {
+    testhelpers::TestEdlLayout layout;
+    layout.clipDuration = clipDuration;
+    return testhelpers::makeTestEdl("cache-test", layout);
+}
+
+bool testHitReturnsStoredRender() {
+    std::cout << "Testing a cache hit returns the stored render..." << std::endl;
+
+    auto dir = makeTempDirectory("render_cache_hit");
+    bool result = true;
+    {
+        juceaudioservice::RenderCache cache(dir.getChildFile("cache"));
+        auto rendered = writeRender(dir, "rendered.wav", 4096, 'a');
+        const std::string key = fakeKey('1');
+
+        std::string sha256;
+        auto output = dir.getChildFile("out").getChildFile("hit.wav");
+        if (cache.fetch(key, output.getFullPathName().toStdString(), sha256)) {
+            std::cout << "ERROR: empty cache reported a hit" << std::endl;
+            result = false;
+        }
+
+        if (!cache.store(key, rendered.getFullPathName().toStdString(), fakeHash('f'))) {
+            std::cout << "ERROR: store failed" << std::endl;
+            return false;
+        }
+
+        // The render stays where it was written
+        if (!rendered.existsAsFile()) {
+            std::cout << "ERROR: store moved the rendered file" << std::endl;
+            result = false;
+        }
+
+        // Hits replace whatever is at the output path, creating its directory if needed
+        if (!cache.fetch(key, output.getFullPathName().toStdString(), sha256)) {
+            std::cout << "ERROR: stored render was not found" << std::endl;
+            result = false;
+        } else if (sha256 != fakeHash('f') || !sameContents(rendered, output)) {
+            std::cout << "ERROR: hit returned the wrong file or hash" << std::endl;
+            result = false;
+        }
+
+        writeRender(dir, "stale.wav", 10, 'z').moveFileTo(output);
+        if (!cache.fetch(key, output.getFullPathName().toStdString(), sha256) || !sameContents(rendered, output)) {
+            std::cout << "ERROR: hit did not replace the existing output" << std::endl;
+            result = false;
+        }
+
+        auto stats = cache.getStats();
+        if (stats.hits != 2 || stats.misses != 1 || stats.numEntries != 1 || stats.bytesUsed != 4096) {
+            std::cout << "ERROR: unexpected stats: " << stats.hits << " hits, " << stats.misses << " misses, "
+                      << stats.numEntries << " entries, " << stats.bytesUsed << " bytes" << std::endl;
+            result = false;
+        }
+
+        // Hashes that aren't SHA-256 hex digests are refused
+        if (cache.store(fakeKey('2'), rendered.getFullPathName().toStdString(), "not-a-hash")) {
+            std::cout << "ERROR: malformed hash was stored" << std::endl;
+            result = false;
+        }
+    }
+    dir.deleteRecursively();
+
+    std::cout << "Cache hit test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testKeyCoversRevisionRangeAndBitDepth() {
+    std::cout << "Testing cache keys cover revision, range, bit depth and format..." << std::endl;
+
+    std::string error;
+    juceaudioservice::EdlStore store;
+    juceaudioservice::EdlStore::Snapshot snapshot;
+    if (!store.replace(makeTestEdl(12000), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+    auto first = store.getCompiled();
+
+    auto range = makeRange(0, 24000);
+    const std::string key = juceaudioservice::RenderCache::makeKey(*first, range, 24);
+
+    bool result = true;
+    if (key.size() != 68 || !juce::String(key).endsWith(".wav") ||
+        key != juceaudioservice::RenderCache::makeKey(*first, range, 24)) {
+        std::cout << "ERROR: key is not a stable hex digest named after its format" << std::endl;
+        result = false;
+    }
+
+    // The key names the cached file, so a FLAC render is stored as .flac
+    const std::string flacKey = juceaudioservice::RenderCache::makeKey(*first, range, 24, "flac");
+    if (flacKey == key || !juce::String(flacKey).endsWith(".flac")) {
+        std::cout << "ERROR: key ignores the output format" << std::endl;
+        result = false;
+    }
+
+    if (key == juceaudioservice::RenderCache::makeKey(*first, makeRange(1, 24000), 24) ||
+        key == juceaudioservice::RenderCache::makeKey(*first, makeRange(0, 24001), 24)) {
+        std::cout << "ERROR: key ignores the render range" << std::endl;
+        result = false;
+    }
+
+    if (key == juceaudioservice::RenderCache::makeKey(*first, range, 16)) {
+        std::cout << "ERROR: key ignores the bit depth" << std::endl;
+        result = false;
+    }
+
+    if (!store.replace(makeTestEdl(12001), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+    if (key == juceaudioservice::RenderCache::makeKey(*store.getCompiled(), range, 24)) {
+        std::cout << "ERROR: key ignores the EDL revision" << std::endl;
+        result = false;
+    }
+
+    // Identical content compiles to the same key again
+    if (!store.replace(makeTestEdl(12000), snapshot, error)) {
+        std::cout << "ERROR: EDL validation failed: " << error << std::endl;
+        return false;
+    }
+    if (key != juceaudioservice::RenderCache::makeKey(*store.getCompiled(), range, 24)) {
+        std::cout << "ERROR: same EDL content produced a different key" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Cache key test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testLeastRecentlyUsedIsEvicted() {
+    std::cout << "Testing the least recently used render is evicted..." << std::endl;
+
+    auto dir = makeTempDirectory("render_cache_evict");
+    bool result = true;
+    {
+        juceaudioservice::RenderCache cache(dir.getChildFile("cache"), 3000);
+        auto rendered = writeRender(dir, "rendered.wav", 1000, 'a');
+        const auto renderedPath = rendered.getFullPathName().toStdString();
+        const auto outputPath = dir.getChildFile("out.wav").getFullPathName().toStdString();
+
+        for (char digit : { '1', '2', '3' }) {
+            cache.store(fakeKey(digit), renderedPath, fakeHash('f'));
+        }
+
+        // Touch the oldest entry, so the second becomes the one to go
+        std::string sha256;
+        if (!cache.fetch(fakeKey('1'), outputPath, sha256)) {
+            std::cout << "ERROR: entry missing before the cap was reached" << std::endl;
+            result = false;
+        }
+
+        cache.store(fakeKey('4'), renderedPath, fakeHash('f'));
+
+        for (char digit : { '1', '3', '4' }) {
+            if (!cache.fetch(fakeKey(digit), outputPath, sha256)) {
+                std::cout << "ERROR: recently used entry " << digit << " was evicted" << std::endl;
+                result = false;
+            }
+        }
+        if (cache.fetch(fakeKey('2'), outputPath, sha256)) {
+            std::cout << "ERROR: least recently used entry was kept" << std::endl;
+            result = false;
+        }
+
+        auto stats = cache.getStats();
+        if (stats.evictions != 1 || stats.bytesUsed != 3000) {
+            std::cout << "ERROR: expected 1 eviction and 3000 bytes, got " << stats.evictions << " and "
+                      << stats.bytesUsed << std::endl;
+            result = false;
+        }
+
+        // Renders larger than the whole cache are not stored
+        auto large = writeRender(dir, "large.wav", 4000, 'b');
+        if (cache.store(fakeKey('5'), large.getFullPathName().toStdString(), fakeHash('f'))) {
+            std::cout << "ERROR: render larger than the cap was stored" << std::endl;
+            result = false;
+        }
+
+        // Shrinking the cap evicts straight away
+        cache.setMaxBytes(1000);
+        if (cache.getStats().numEntries != 1 || cache.getStats().bytesUsed != 1000) {
+            std::cout << "ERROR: lowering the cap did not evict" << std::endl;
+            result = false;
+        }
+    }
+    dir.deleteRecursively();
+
+    std::cout << "Eviction test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testEntriesSurviveRestart() {
+    std::cout << "Testing cached renders survive a restart..." << std::endl;
+
+    auto dir = makeTempDirectory("render_cache_restart");
+    auto cacheDir = dir.getChildFile("cache");
+    auto rendered = writeRender(dir, "rendered.wav", 2048, 'a');
+    const auto outputFile = dir.getChildFile("out.wav");
+    const auto outputPath = outputFile.getFullPathName().toStdString();
+
+    bool result = true;
+    {
+        juceaudioservice::RenderCache cache(cacheDir);
+        cache.store(fakeKey('1'), rendered.getFullPathName().toStdString(), fakeHash('e'));
+        cache.store(fakeKey('2'), rendered.getFullPathName().toStdString(), fakeHash('d'));
+    }
+
+    // Leftovers of an interrupted store are cleaned up
+    writeRender(cacheDir, "partial.tmp", 100, 'x');
+
+    {
+        juceaudioservice::RenderCache cache(cacheDir);
+        auto stats = cache.getStats();
+        if (stats.numEntries != 2 || stats.bytesUsed != 4096) {
+            std::cout << "ERROR: expected 2 entries after restart, got " << stats.numEntries << std::endl;
+            result = false;
+        }
+
+        if (cacheDir.getChildFile("partial.tmp").exists()) {
+            std::cout << "ERROR: temporary file was not removed" << std::endl;
+            result = false;
+        }
+
+        std::string sha256;
+        if (!cache.fetch(fakeKey('1'), outputPath, sha256) || sha256 != fakeHash('e') ||
+            !sameContents(rendered, outputFile)) {
+            std::cout << "ERROR: entry was not usable after restart" << std::endl;
+            result = false;
+        }
+
+        // The output may share its file with the cache; writing to it must not leak into later hits
+        if (auto stream = outputFile.createOutputStream()) {
+            stream->writeString("appended");
+        }
+        if (cache.fetch(fakeKey('1'), outputPath, sha256) && !sameContents(rendered, outputFile)) {
+            std::cout << "ERROR: hit returned a render modified through an earlier output" << std::endl;
+            result = false;
+        }
+    }
+    dir.deleteRecursively();
+
+    std::cout << "Restart test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+int main() {
+    std::cout << "Running render cache tests..." << std::endl;
+
+    bool allTestsPassed = true;
+
+    if (!testHitReturnsStoredRender()) {
+        allTestsPassed = false;
+    }
+
+    if (!testKeyCoversRevisionRangeAndBitDepth()) {
+        allTestsPassed = false;
+    }
+
+    if (!testLeastRecentlyUsedIsEvicted()) {
+        allTestsPassed = false;
+    }
+
+    if (!testEntriesSurviveRestart()) {
+        allTestsPassed = false;
+    }
+
+    std::cout << "All render cache tests " << (allTestsPassed ? "PASSED" : "FAILED") << std::endl;
+    return allTestsPassed ? 0 : 1;
+}
@@ -0,0 +1,231 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "util/RenderScheduler.h"
+
+bool testConcurrencyIsBounded() {
+    std::cout << "Testing render jobs run on a bounded set of workers..." << std::endl;
+
+    juceaudioservice::RenderScheduler scheduler(3, 64);
+    std::atomic<int> running{0};
+    std::atomic<int> maxRunning{0};
+    std::atomic<bool> badWorkerIndex{false};
+    std::atomic<int> accepted{0};
+
+    std::vector<std::thread> clients;
+    for (int i = 0; i < 12; ++i) {
+        clients.emplace_back([&] {
+            bool ok = scheduler.run([&](int workerIndex) {
+                if (workerIndex < 0 || workerIndex >= 3) {
+                    badWorkerIndex = true;
+                }
+
+                int now = ++running;
+                int seen = maxRunning.load();
+                while (now > seen && !maxRunning.compare_exchange_weak(seen, now)) {
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                --running;
+            });
+
+            if (ok) {
+                ++accepted;
+            }
+        });
+    }
+
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    bool result = true;
+    if (accepted.load() != 12) {
+        std::cout << "ERROR: expected all 12 jobs to run, " << accepted.load() << " ran" << std::endl;
+        result = false;
+    }
+
+    if (maxRunning.load() > 3 || maxRunning.load() < 2) {
+        std::cout << "ERROR: " << maxRunning.load() << " jobs ran at once on 3 workers" << std::endl;
+        result = false;
+    }
+
+    if (badWorkerIndex) {
+        std::cout << "ERROR: job received an out-of-range worker index" << std::endl;
+        result = false;
+    }
+
+    if (scheduler.getStats().completed != 12) {
+        std::cout << "ERROR: completed counter is " << scheduler.getStats().completed << std::endl;
+        result = false;
+    }
+
+    std::cout << "Bounded concurrency test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testFullQueueRejectsJobs() {
+    std::cout << "Testing a full render queue rejects new jobs..." << std::endl;
+
+    // One worker and one queue slot: the third concurrent job must be turned away
+    juceaudioservice::RenderScheduler scheduler(1, 1);
+
+    std::mutex mutex;
+    std::condition_variable released;
+    bool release = false;
+
+    auto blockingJob = [&](int) {
+        std::unique_lock<std::mutex> lock(mutex);
+        released.wait(lock, [&] { return release; });
+    };
+
+    std::thread first([&] { scheduler.run(blockingJob); });
+    std::thread second([&] { scheduler.run(blockingJob); });
+
+    // Wait until one job is running and one is queued
+    for (int i = 0; i < 500; ++i) {
+        auto stats = scheduler.getStats();
+        if (stats.running == 1 && stats.queued == 1) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    bool ran = false;
+    bool accepted = scheduler.run([&](int) { ran = true; });
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    released.notify_all();
+    first.join();
+    second.join();
+
+    bool result = true;
+    if (accepted || ran) {
+        std::cout << "ERROR: job was accepted by a full scheduler" << std::endl;
+        result = false;
+    }
+
+    auto stats = scheduler.getStats();
+    if (stats.rejected != 1 || stats.completed != 2) {
+        std::cout << "ERROR: unexpected counters: " << stats.rejected << " rejected, "
+                  << stats.completed << " completed" << std::endl;
+        result = false;
+    }
+
+    // Once drained, jobs are accepted again
+    if (!scheduler.run([](int) {})) {
+        std::cout << "ERROR: drained scheduler rejected a job" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Full queue test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testPostedJobsRunWithoutWaiting() {
+    std::cout << "Testing posted jobs return at once and share admission with run()..." << std::endl;
+
+    juceaudioservice::RenderScheduler scheduler(1, 1);
+
+    std::mutex mutex;
+    std::condition_variable released;
+    bool release = false;
+    std::atomic<int> finished{0};
+
+    auto blockingJob = [&](int) {
+        std::unique_lock<std::mutex> lock(mutex);
+        released.wait(lock, [&] { return release; });
+        ++finished;
+    };
+
+    // Both return while the first job is still blocked; the third finds no free slot
+    bool first = scheduler.post(blockingJob);
+    bool second = scheduler.post(blockingJob);
+    bool third = scheduler.post(blockingJob);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    released.notify_all();
+
+    for (int i = 0; i < 500 && finished.load() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    bool result = true;
+    if (!first || !second || third) {
+        std::cout << "ERROR: expected two posts accepted and the third rejected" << std::endl;
+        result = false;
+    }
+
+    if (finished.load() != 2) {
+        std::cout << "ERROR: " << finished.load() << " of 2 posted jobs ran" << std::endl;
+        result = false;
+    }
+
+    // A throwing posted job must not take its worker down
+    scheduler.post([](int) { throw std::runtime_error("posted job failed"); });
+    if (!scheduler.run([](int) {})) {
+        std::cout << "ERROR: scheduler rejected a job after a posted job threw" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Posted job test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testJobExceptionsReachCaller() {
+    std::cout << "Testing job exceptions are rethrown to the caller..." << std::endl;
+
+    juceaudioservice::RenderScheduler scheduler(2, 0);
+
+    bool caught = false;
+    try {
+        scheduler.run([](int) { throw std::runtime_error("render failed"); });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+
+    bool result = caught && scheduler.run([](int) {});
+    if (!result) {
+        std::cout << "ERROR: exception was lost or killed the worker" << std::endl;
+    }
+
+    std::cout << "Job exception test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+int main() {
+    std::cout << "Running render scheduler tests..." << std::endl;
+
+    bool allTestsPassed = true;
+
+    if (!testConcurrencyIsBounded()) {
+        allTestsPassed = false;
+    }
+
+    if (!testFullQueueRejectsJobs()) {
+        allTestsPassed = false;
+    }
+
+    if (!testPostedJobsRunWithoutWaiting()) {
+        allTestsPassed = false;
+    }
+
+    if (!testJobExceptionsReachCaller()) {
+        allTestsPassed = false;
+    }
+
+    std::cout << "All render scheduler tests " << (allTestsPassed ? "PASSED" : "FAILED") << std::endl;
+    return allTestsPassed ? 0 : 1;
+}
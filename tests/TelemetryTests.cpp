@@ -0,0 +1,196 @@
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "util/Telemetry.h"
+
+using juceaudioservice::Histogram;
+using juceaudioservice::PrometheusText;
+using juceaudioservice::Telemetry;
+
+bool testHistogramQuantiles() {
+    std::cout << "Testing histogram quantiles fall in the right buckets..." << std::endl;
+
+    Histogram histogram(1.0, 2.0);
+    for (int i = 0; i < 90; ++i) {
+        histogram.record(0.5); // bucket 0: up to 1
+    }
+    for (int i = 0; i < 10; ++i) {
+        histogram.record(6.0); // bucket 3: (4, 8]
+    }
+
+    const auto snapshot = histogram.snapshot();
+    bool result = true;
+
+    if (snapshot.count != 100 || std::abs(snapshot.sum - 105.0) > 1.0e-9) {
+        std::cerr << "Expected 100 samples summing to 105, got " << snapshot.count << " / " << snapshot.sum << std::endl;
+        result = false;
+    }
+
+    if (snapshot.buckets[0] != 90 || snapshot.buckets[3] != 10) {
+        std::cerr << "Samples landed in the wrong buckets" << std::endl;
+        result = false;
+    }
+
+    const double p50 = snapshot.quantile(0.50);
+    const double p99 = snapshot.quantile(0.99);
+    if (p50 <= 0.0 || p50 > 1.0) {
+        std::cerr << "p50 should be inside the first bucket, got " << p50 << std::endl;
+        result = false;
+    }
+    if (p99 <= 4.0 || p99 > 8.0) {
+        std::cerr << "p99 should be inside (4, 8], got " << p99 << std::endl;
+        result = false;
+    }
+
+    Histogram empty(1.0, 2.0);
+    if (empty.snapshot().quantile(0.5) != 0.0) {
+        std::cerr << "An empty histogram should report 0" << std::endl;
+        result = false;
+    }
+
+    // Values above the last finite bound are still counted
+    Histogram small(1.0, 2.0);
+    small.record(1.0e12);
+    const auto overflow = small.snapshot();
+    if (overflow.buckets[Histogram::numBuckets - 1] != 1 || !std::isinf(overflow.bounds[Histogram::numBuckets - 1])) {
+        std::cerr << "Huge values should land in the open-ended bucket" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Histogram quantile test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testPrometheusFormat() {
+    std::cout << "Testing Prometheus text exposition..." << std::endl;
+
+    Histogram histogram(1.0, 2.0);
+    histogram.record(0.5);
+    histogram.record(3.0);
+
+    PrometheusText text;
+    text.addCounter("test_renders_total", "Renders", 3, PrometheusText::label("result", "completed"));
+    text.addCounter("test_renders_total", "Renders", 1, PrometheusText::label("result", "failed"));
+    text.addGauge("test_queued", "Queued jobs", 2);
+    text.addHistogram("test_seconds", "Stage time", histogram.snapshot(), PrometheusText::label("stage", "mix"));
+
+    const std::string& output = text.getText();
+    bool result = true;
+
+    auto expect = [&](const std::string& line) {
+        if (output.find(line + "\n") == std::string::npos) {
+            std::cerr << "Missing line: " << line << std::endl;
+            result = false;
+        }
+    };
+
+    expect("# HELP test_renders_total Renders");
+    expect("# TYPE test_renders_total counter");
+    expect("test_renders_total{result=\"completed\"} 3");
+    expect("test_renders_total{result=\"failed\"} 1");
+    expect("# TYPE test_queued gauge");
+    expect("test_queued 2");
+    expect("# TYPE test_seconds histogram");
+    expect("test_seconds_bucket{stage=\"mix\",le=\"1\"} 1");
+    expect("test_seconds_bucket{stage=\"mix\",le=\"2\"} 1");
+    expect("test_seconds_bucket{stage=\"mix\",le=\"4\"} 2");
+    expect("test_seconds_bucket{stage=\"mix\",le=\"+Inf\"} 2");
+    expect("test_seconds_sum{stage=\"mix\"} 3.5");
+    expect("test_seconds_count{stage=\"mix\"} 2");
+
+    // One HELP/TYPE pair per family, however many samples it has
+    size_t typeLines = 0;
+    for (size_t at = output.find("# TYPE test_renders_total"); at != std::string::npos;
+         at = output.find("# TYPE test_renders_total", at + 1)) {
+        ++typeLines;
+    }
+    if (typeLines != 1) {
+        std::cerr << "Expected one TYPE line for a family, got " << typeLines << std::endl;
+        result = false;
+    }
+
+    if (PrometheusText::label("path", "a\"b\\c") != "path=\"a\\\"b\\\\c\"") {
+        std::cerr << "Label values should be escaped" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Prometheus format test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testRequestLogSwitch() {
+    std::cout << "Testing request logging can be turned off..." << std::endl;
+
+    bool result = true;
+
+    std::ostringstream captured;
+    auto* previous = std::cout.rdbuf(captured.rdbuf());
+
+    Telemetry::setRequestLogging(false);
+    juceaudioservice::requestLog() << "hidden" << std::endl;
+
+    Telemetry::setRequestLogging(true);
+    juceaudioservice::requestLog() << "shown" << std::endl;
+
+    std::cout.rdbuf(previous);
+
+    if (captured.str() != "shown\n") {
+        std::cerr << "Expected only the line logged while enabled, got: " << captured.str() << std::endl;
+        result = false;
+    }
+
+    std::cout << "Request log switch test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+bool testStageTimers() {
+    std::cout << "Testing scoped timers record into their stage..." << std::endl;
+
+    auto& telemetry = Telemetry::getInstance();
+    const uint64_t before = telemetry.getStage(Telemetry::Stage::Compile).count;
+
+    {
+        Telemetry::ScopedTimer timer(Telemetry::Stage::Compile);
+    }
+
+    const auto after = telemetry.getStage(Telemetry::Stage::Compile);
+    bool result = after.count == before + 1 && after.sum >= 0.0;
+    if (!result) {
+        std::cerr << "Expected one more compile sample" << std::endl;
+    }
+
+    if (std::string(Telemetry::getStageName(Telemetry::Stage::Mix)) != "mix") {
+        std::cerr << "Unexpected stage name" << std::endl;
+        result = false;
+    }
+
+    std::cout << "Stage timer test " << (result ? "passed" : "failed") << std::endl;
+    return result;
+}
+
+int main() {
+    std::cout << "Running telemetry tests..." << std::endl;
+
+    bool allTestsPassed = true;
+
+    if (!testHistogramQuantiles()) {
+        allTestsPassed = false;
+    }
+
+    if (!testPrometheusFormat()) {
+        allTestsPassed = false;
+    }
+
+    if (!testRequestLogSwitch()) {
+        allTestsPassed = false;
+    }
+
+    if (!testStageTimers()) {
+        allTestsPassed = false;
+    }
+
+    std::cout << "All telemetry tests " << (allTestsPassed ? "PASSED" : "FAILED") << std::endl;
+    return allTestsPassed ? 0 : 1;
+}
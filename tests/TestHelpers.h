@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#include "audio_engine.pb.h"
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#ifndef PROJECT_SOURCE_DIR
+#define PROJECT_SOURCE_DIR "."
+#endif
+
+// Fixtures and timelines shared by the in-process EDL tests
+namespace testhelpers {
+
+/** Absolute path of a file in fixtures/. */
+inline std::string fixturePath(const char* name) {
+    juce::File root(PROJECT_SOURCE_DIR);
+    return root.getChildFile("fixtures").getChildFile(name).getFullPathName().toStdString();
+}
+
+/** true if both buffers have the same layout and bit-identical samples. */
+inline bool buffersIdentical(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b) {
+    if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples()) {
+        return false;
+    }
+
+    for (int ch = 0; ch < a.getNumChannels(); ++ch) {
+        if (std::memcmp(a.getReadPointer(ch), b.getReadPointer(ch),
+                        sizeof(float) * static_cast<size_t>(a.getNumSamples())) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+inline audio_engine::TimeRange makeRange(int64_t start, int64_t duration) {
+    audio_engine::TimeRange range;
+    range.set_start_samples(start);
+    range.set_duration_samples(duration);
+    return range;
+}
+
+// Fades of a test clip; zero lengths leave the fade unset
+struct ClipFades {
+    int64_t fadeIn = 0;
+    int64_t fadeOut = 0;
+    audio_engine::Fade::Shape fadeOutShape = audio_engine::Fade::LINEAR;
+};
+
+inline audio_engine::Clip makeClip(const std::string& id, const std::string& mediaId, int64_t startInMedia,
+                                   int64_t startInTimeline, int64_t duration, const ClipFades& fades = {}) {
+    audio_engine::Clip clip;
+    clip.set_id(id);
+    clip.set_media_id(mediaId);
+    clip.set_start_in_media(startInMedia);
+    clip.set_start_in_timeline(startInTimeline);
+    clip.set_duration(duration);
+    if (fades.fadeIn > 0) {
+        clip.mutable_fade_in()->set_duration_samples(fades.fadeIn);
+    }
+    if (fades.fadeOut > 0) {
+        clip.mutable_fade_out()->set_duration_samples(fades.fadeOut);
+        clip.mutable_fade_out()->set_shape(fades.fadeOutShape);
+    }
+    return clip;
+}
+
+/**
+ * Add a mono fixture file to an EDL's media.
+ *
+ * @param sampleRate Rate to declare, or 0 to leave it unset
+ */
+inline void addMedia(audio_engine::Edl& edl, const std::string& id, const char* fixture, int sampleRate = 0) {
+    auto* media = edl.add_media();
+    media->set_id(id);
+    media->set_path(fixturePath(fixture));
+    if (sampleRate > 0) {
+        media->set_sample_rate(sampleRate);
+    }
+    media->set_channels(1);
+}
+
+/**
+ * Tracks t0, t1, ... of evenly spaced clips t<track>c<clip> on the "voice" fixture.
+ *
+ * Clip c of track t starts at c * clipSpacing + t * trackOffset on the
+ * timeline and at c * mediaStep + t * mediaTrackStep in the media.
+ */
+struct TestEdlLayout {
+    int numTracks = 1;
+    int clipsPerTrack = 1;
+    int64_t clipSpacing = 0;
+    int64_t trackOffset = 0;
+    int64_t mediaStep = 0;
+    int64_t mediaTrackStep = 0;
+    int64_t clipDuration = 0;
+    ClipFades fades;
+    int mediaSampleRate = 0; // declared for "voice"; 0 leaves it unset
+
+    std::function<float(int track)> trackGainDb;                 // unset: 0 dB
+    std::function<void(audio_engine::Clip&, int track, int clip)> adjustClip; // e.g. other media or gains
+};
+
+inline audio_engine::Edl makeTestEdl(const std::string& edlId, const TestEdlLayout& layout) {
+    audio_engine::Edl edl;
+    edl.set_id(edlId);
+    edl.set_sample_rate(48000);
+    addMedia(edl, "voice", "voice.wav", layout.mediaSampleRate);
+
+    for (int t = 0; t < layout.numTracks; ++t) {
+        auto* track = edl.add_tracks();
+        track->set_id("t" + std::to_string(t));
+        if (layout.trackGainDb) {
+            track->set_gain_db(layout.trackGainDb(t));
+        }
+
+        for (int c = 0; c < layout.clipsPerTrack; ++c) {
+            auto clip = makeClip("t" + std::to_string(t) + "c" + std::to_string(c), "voice",
+                                 layout.mediaStep * c + layout.mediaTrackStep * t,
+                                 layout.clipSpacing * c + layout.trackOffset * t, layout.clipDuration, layout.fades);
+            if (layout.adjustClip) {
+                layout.adjustClip(clip, t, c);
+            }
+            *track->add_clips() = std::move(clip);
+        }
+    }
+
+    return edl;
+}
+
+} // namespace testhelpers
@@ -0,0 +1,510 @@
+#include <JuceAudioService/AudioService.h>
+#include <JuceAudioService/OfflineRenderer.h>
+#include <JuceAudioService/VoiceGenerator.h>
+#include "edl/EdlCompiler.h"
+#include "edl/EdlRenderer.h"
+#include "edl/EdlStore.h"
+#include "edl/MediaPageCache.h"
+#include <juce_core/juce_core.h>
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using testhelpers::AllocationCounter;
+
+//==============================================================================
+struct BenchOptions
+{
+    int tracks = 8;
+    int clipsPerTrack = 50;
+    int fadesPerTrack = -1; // -1: every clip
+    int mediaFiles = 4;
+    double duration = 60.0;
+    int sampleRate = 48000;
+    int bitDepth = 24;
+    int threads = 1;
+    int iterations = 5;
+    int warmup = 1;
+    bool cold = false;
+    juce::String jsonFile;
+    juce::String baselineFile;
+    double tolerancePercent = 10.0;
+};
+
+struct StageResult
+{
+    juce::String name;
+    std::vector<double> seconds;
+    double allocationsPerIteration = 0.0;
+    double bytesPerIteration = 0.0;
+
+    double median() const
+    {
+        auto sorted = seconds;
+        std::sort(sorted.begin(), sorted.end());
+        const auto n = sorted.size();
+        return n == 0 ? 0.0 : (n % 2 == 1 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]));
+    }
+
+    double fastest() const
+    {
+        return seconds.empty() ? 0.0 : *std::min_element(seconds.begin(), seconds.end());
+    }
+};
+
+void printUsage(const char* programName)
+{
+    std::cout << "Usage: " << programName << " [options]\n"
+              << "\nTimeline:\n"
+              << "  --tracks <n>        Number of tracks (default: 8)\n"
+              << "  --clips <n>         Clips per track (default: 50)\n"
+              << "  --fades <n>         Clips per track with fade in and out (default: all)\n"
+              << "  --media <n>         Generated voice files the clips use (default: 4)\n"
+              << "  --dur <seconds>     Timeline and render length (default: 60)\n"
+              << "  --sr <rate>         EDL and media sample rate (default: 48000)\n"
+              << "\nRendering:\n"
+              << "  --bit-depth <bits>  WAV bit depth: 16, 24, or 32 (default: 24)\n"
+              << "  --threads <n>       Track rendering threads (default: 1)\n"
+              << "  --cold              Drop decoded media before every render\n"
+              << "\nMeasurement:\n"
+              << "  --iterations <n>    Timed runs per stage (default: 5)\n"
+              << "  --warmup <n>        Untimed runs per stage first (default: 1)\n"
+              << "  --json <file>       Write results as JSON\n"
+              << "  --baseline <file>   Compare with earlier --json results; exit 2 on regression\n"
+              << "  --tolerance <pct>   Allowed slowdown of a stage's median (default: 10)\n"
+              << "  --help              Show this help message\n";
+}
+
+bool parseArguments(int argc, char* argv[], BenchOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg(argv[i]);
+
+        if (arg == "--tracks" && i + 1 < argc)
+            options.tracks = std::atoi(argv[++i]);
+        else if (arg == "--clips" && i + 1 < argc)
+            options.clipsPerTrack = std::atoi(argv[++i]);
+        else if (arg == "--fades" && i + 1 < argc)
+            options.fadesPerTrack = std::atoi(argv[++i]);
+        else if (arg == "--media" && i + 1 < argc)
+            options.mediaFiles = std::atoi(argv[++i]);
+        else if (arg == "--dur" && i + 1 < argc)
+            options.duration = std::atof(argv[++i]);
+        else if (arg == "--sr" && i + 1 < argc)
+            options.sampleRate = std::atoi(argv[++i]);
+        else if (arg == "--bit-depth" && i + 1 < argc)
+            options.bitDepth = std::atoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc)
+            options.threads = std::atoi(argv[++i]);
+        else if (arg == "--cold")
+            options.cold = true;
+        else if (arg == "--iterations" && i + 1 < argc)
+            options.iterations = std::atoi(argv[++i]);
+        else if (arg == "--warmup" && i + 1 < argc)
+            options.warmup = std::atoi(argv[++i]);
+        else if (arg == "--json" && i + 1 < argc)
+            options.jsonFile = juce::String(argv[++i]);
+        else if (arg == "--baseline" && i + 1 < argc)
+            options.baselineFile = juce::String(argv[++i]);
+        else if (arg == "--tolerance" && i + 1 < argc)
+            options.tolerancePercent = std::atof(argv[++i]);
+        else if (arg == "--help")
+            return false;
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool validateOptions(const BenchOptions& options)
+{
+    if (options.tracks < 1 || options.clipsPerTrack < 1 || options.mediaFiles < 1)
+    {
+        std::cerr << "Error: Tracks, clips and media must be at least 1" << std::endl;
+        return false;
+    }
+
+    if (options.duration <= 0.0 || options.sampleRate <= 0)
+    {
+        std::cerr << "Error: Duration and sample rate must be positive" << std::endl;
+        return false;
+    }
+
+    if (options.bitDepth != 16 && options.bitDepth != 24 && options.bitDepth != 32)
+    {
+        std::cerr << "Error: Bit depth must be 16, 24, or 32" << std::endl;
+        return false;
+    }
+
+    if (options.threads < 1 || options.iterations < 1 || options.warmup < 0)
+    {
+        std::cerr << "Error: Threads and iterations must be at least 1" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+/** Write the voice files the benchmark timeline plays, each long enough for one clip. */
+std::vector<juce::File> generateMedia(const BenchOptions& options, const juce::File& directory, double mediaSeconds)
+{
+    juceaudioservice::AudioService audioService;
+    audioService.initialise();
+
+    std::vector<juce::File> files;
+
+    for (int i = 0; i < options.mediaFiles; ++i)
+    {
+        // Slightly different lengths, so the voices don't all share one envelope
+        const double seconds = mediaSeconds * (1.0 + 0.05 * i);
+        const auto numSamples = static_cast<int>(std::ceil(seconds * options.sampleRate));
+
+        juceaudioservice::VoiceGenerator voice(options.sampleRate, seconds);
+        juceaudioservice::OfflineRenderer renderer;
+        auto buffer = renderer.renderToBuffer(voice, options.sampleRate, 1, numSamples);
+
+        auto file = directory.getChildFile("voice_" + juce::String(i) + ".wav");
+        if (!audioService.writeAudioFile(buffer, file, options.sampleRate, 16))
+            return {};
+
+        files.push_back(file);
+    }
+
+    return files;
+}
+
+/** Evenly spaced, slightly overlapping clips on every track; the first --fades of each get fades. */
+audio_engine::Edl buildEdl(const BenchOptions& options, const std::vector<juce::File>& media,
+                           juce::int64 timelineSamples, juce::int64 clipSamples)
+{
+    audio_engine::Edl edl;
+    edl.set_id("bench");
+    edl.set_sample_rate(options.sampleRate);
+
+    for (size_t i = 0; i < media.size(); ++i)
+    {
+        auto* ref = edl.add_media();
+        ref->set_id("voice" + std::to_string(i));
+        ref->set_path(media[i].getFullPathName().toStdString());
+        ref->set_channels(1);
+    }
+
+    const juce::int64 spacing = timelineSamples / options.clipsPerTrack;
+    const juce::int64 fadeSamples = std::max<juce::int64>(1, std::min(clipSamples - spacing, clipSamples / 4));
+    const int fades = options.fadesPerTrack < 0 ? options.clipsPerTrack : options.fadesPerTrack;
+
+    for (int t = 0; t < options.tracks; ++t)
+    {
+        auto* track = edl.add_tracks();
+        track->set_id("track" + std::to_string(t));
+        track->set_gain_db(-1.0f * static_cast<float>(t % 4));
+
+        // Stagger the tracks so their clip boundaries fall in different blocks
+        const juce::int64 offset = (spacing / options.tracks) * t;
+
+        for (int c = 0; c < options.clipsPerTrack; ++c)
+        {
+            const juce::int64 start = std::min(c * spacing + offset, timelineSamples - 1);
+
+            auto* clip = track->add_clips();
+            clip->set_id("t" + std::to_string(t) + "c" + std::to_string(c));
+            clip->set_media_id("voice" + std::to_string((t + c) % media.size()));
+            clip->set_start_in_media(0);
+            clip->set_start_in_timeline(start);
+            clip->set_duration(std::min(clipSamples, timelineSamples - start));
+            clip->set_gain_db(-0.5f * static_cast<float>(c % 3));
+
+            if (c < fades)
+            {
+                clip->mutable_fade_in()->set_duration_samples(fadeSamples);
+                clip->mutable_fade_out()->set_duration_samples(fadeSamples);
+                clip->mutable_fade_out()->set_shape(c % 2 == 0 ? audio_engine::Fade::EQUAL_POWER
+                                                               : audio_engine::Fade::LINEAR);
+            }
+        }
+    }
+
+    return edl;
+}
+
+/** Time a stage; run returns false to stop the benchmark. */
+bool runStage(const juce::String& name, const BenchOptions& options, StageResult& result,
+              const std::function<void()>& prepare, const std::function<bool()>& run)
+{
+    result.name = name;
+
+    for (int i = 0; i < options.warmup; ++i)
+    {
+        prepare();
+        if (!run())
+            return false;
+    }
+
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+
+    for (int i = 0; i < options.iterations; ++i)
+    {
+        prepare();
+
+        const auto allocationsBefore = AllocationCounter::getCount();
+        const auto bytesBefore = AllocationCounter::getBytes();
+        const auto start = std::chrono::steady_clock::now();
+
+        if (!run())
+            return false;
+
+        const auto end = std::chrono::steady_clock::now();
+        allocations += AllocationCounter::getCount() - allocationsBefore;
+        bytes += AllocationCounter::getBytes() - bytesBefore;
+        result.seconds.push_back(std::chrono::duration<double>(end - start).count());
+    }
+
+    result.allocationsPerIteration = static_cast<double>(allocations) / options.iterations;
+    result.bytesPerIteration = static_cast<double>(bytes) / options.iterations;
+    return true;
+}
+
+void printResults(const std::vector<StageResult>& results, juce::int64 timelineSamples, int sampleRate)
+{
+    const double audioSeconds = static_cast<double>(timelineSamples) / sampleRate;
+
+    std::cout << "\n"
+              << std::left << std::setw(16) << "stage"
+              << std::right << std::setw(12) << "median ms"
+              << std::setw(12) << "min ms"
+              << std::setw(14) << "x realtime"
+              << std::setw(14) << "Msamples/s"
+              << std::setw(14) << "allocs/iter"
+              << std::setw(12) << "KB/iter" << "\n";
+
+    for (const auto& result : results)
+    {
+        const double median = result.median();
+        std::cout << std::left << std::setw(16) << result.name
+                  << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << median * 1000.0
+                  << std::setw(12) << result.fastest() * 1000.0
+                  << std::setprecision(1)
+                  << std::setw(14) << (median > 0.0 ? audioSeconds / median : 0.0)
+                  << std::setprecision(2)
+                  << std::setw(14) << (median > 0.0 ? timelineSamples / median / 1.0e6 : 0.0)
+                  << std::setprecision(0)
+                  << std::setw(14) << result.allocationsPerIteration
+                  << std::setw(12) << result.bytesPerIteration / 1024.0 << "\n";
+    }
+
+    std::cout << std::defaultfloat;
+}
+
+juce::var resultsToJson(const BenchOptions& options, const std::vector<StageResult>& results,
+                        juce::int64 timelineSamples)
+{
+    auto* config = new juce::DynamicObject();
+    config->setProperty("tracks", options.tracks);
+    config->setProperty("clips_per_track", options.clipsPerTrack);
+    config->setProperty("fades_per_track", options.fadesPerTrack < 0 ? options.clipsPerTrack : options.fadesPerTrack);
+    config->setProperty("media", options.mediaFiles);
+    config->setProperty("timeline_samples", timelineSamples);
+    config->setProperty("sample_rate", options.sampleRate);
+    config->setProperty("bit_depth", options.bitDepth);
+    config->setProperty("threads", options.threads);
+    config->setProperty("cold", options.cold);
+
+    auto* stages = new juce::DynamicObject();
+    for (const auto& result : results)
+    {
+        auto* stage = new juce::DynamicObject();
+        stage->setProperty("median_ms", result.median() * 1000.0);
+        stage->setProperty("min_ms", result.fastest() * 1000.0);
+        stage->setProperty("allocations", result.allocationsPerIteration);
+        stage->setProperty("bytes", result.bytesPerIteration);
+        stages->setProperty(result.name, juce::var(stage));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("config", juce::var(config));
+    root->setProperty("stages", juce::var(stages));
+    return juce::var(root);
+}
+
+/** @returns false if a stage is slower, or allocates more, than the baseline allows. */
+bool compareWithBaseline(const juce::var& baseline, const std::vector<StageResult>& results, double tolerancePercent)
+{
+    bool withinTolerance = true;
+    const double limit = 1.0 + tolerancePercent / 100.0;
+
+    std::cout << "\nCompared with baseline (tolerance " << tolerancePercent << "%):\n";
+
+    for (const auto& result : results)
+    {
+        const auto stage = baseline["stages"][juce::Identifier(result.name)];
+        if (stage.isVoid())
+        {
+            std::cout << "  " << result.name << ": not in baseline\n";
+            continue;
+        }
+
+        const double baselineMs = stage["median_ms"];
+        const double baselineAllocations = stage["allocations"];
+        const double medianMs = result.median() * 1000.0;
+        const bool slower = baselineMs > 0.0 && medianMs > baselineMs * limit;
+        const bool allocatesMore = result.allocationsPerIteration > baselineAllocations * limit + 1.0;
+
+        std::cout << "  " << result.name << ": " << std::fixed << std::setprecision(3) << medianMs << " ms vs "
+                  << baselineMs << " ms (" << std::showpos << std::setprecision(1)
+                  << (baselineMs > 0.0 ? (medianMs / baselineMs - 1.0) * 100.0 : 0.0) << "%)" << std::noshowpos
+                  << std::setprecision(0) << ", " << result.allocationsPerIteration << " vs " << baselineAllocations
+                  << " allocs" << (slower || allocatesMore ? "  REGRESSION" : "") << "\n";
+
+        withinTolerance = withinTolerance && !slower && !allocatesMore;
+    }
+
+    std::cout << std::defaultfloat;
+    return withinTolerance;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // Every heap allocation in the process is counted, so each stage can report how many it made
+    AllocationCounter::setCountingAllThreads(true);
+
+    BenchOptions options;
+
+    if (!parseArguments(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (!validateOptions(options))
+    {
+        return 1;
+    }
+
+    try
+    {
+        const auto timelineSamples = static_cast<juce::int64>(std::llround(options.duration * options.sampleRate));
+        const juce::int64 spacing = std::max<juce::int64>(1, timelineSamples / options.clipsPerTrack);
+        const juce::int64 clipSamples = spacing + spacing / 4; // a quarter of each clip overlaps the next
+
+        auto workDirectory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                 .getNonexistentChildFile("juce_audio_service_bench", "", false);
+        workDirectory.createDirectory();
+
+        std::cout << "[Bench] Generating " << options.mediaFiles << " voice files of "
+                  << static_cast<double>(clipSamples) / options.sampleRate << "s" << std::endl;
+
+        const auto media = generateMedia(options, workDirectory,
+                                         static_cast<double>(clipSamples + 1) / options.sampleRate);
+        if (media.empty())
+        {
+            std::cerr << "Error: Failed to write media to " << workDirectory.getFullPathName() << std::endl;
+            workDirectory.deleteRecursively();
+            return 1;
+        }
+
+        const auto edl = buildEdl(options, media, timelineSamples, clipSamples);
+
+        std::cout << "[Bench] Timeline: " << options.tracks << " tracks x " << options.clipsPerTrack << " clips, "
+                  << options.duration << "s @ " << options.sampleRate << " Hz, " << options.threads
+                  << " render thread(s)" << (options.cold ? ", cold media cache" : "") << std::endl;
+
+        juceaudioservice::EdlStore store;
+        juceaudioservice::EdlStore::Snapshot snapshot;
+        juceaudioservice::EdlCompiler compiler;
+        juceaudioservice::EdlCompiler::CompiledEdl compiled;
+        juceaudioservice::EdlRenderer renderer;
+        renderer.setNumWorkerThreads(options.threads);
+
+        audio_engine::TimeRange range;
+        range.set_start_samples(0);
+        range.set_duration_samples(timelineSamples);
+
+        juce::AudioBuffer<float> rendered;
+        const auto outputPath = workDirectory.getChildFile("render.wav").getFullPathName().toStdString();
+        const auto bitDepth = static_cast<juceaudioservice::EdlRenderer::BitDepth>(options.bitDepth);
+        std::string error;
+
+        std::vector<StageResult> results(4);
+        auto noPrepare = [] {};
+
+        const bool completed =
+            runStage("replace", options, results[0], noPrepare,
+                     [&] { return store.replace(edl, snapshot, error); })
+            && runStage("compile", options, results[1], noPrepare,
+                        [&] { return compiler.compile(snapshot, compiled, error); })
+            && runStage("renderToBuffer", options, results[2],
+                        [&]
+                        {
+                            if (options.cold)
+                                juceaudioservice::MediaPageCache::getInstance().clear();
+                        },
+                        [&] { return renderer.renderToBuffer(compiled, range, rendered, nullptr, error); })
+            && runStage("writeWavFile", options, results[3], noPrepare,
+                        [&] { return renderer.writeWavFile(rendered, options.sampleRate, outputPath, bitDepth, error); });
+
+        workDirectory.deleteRecursively();
+
+        if (!completed)
+        {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+
+        printResults(results, timelineSamples, options.sampleRate);
+
+        const auto json = resultsToJson(options, results, timelineSamples);
+
+        if (options.jsonFile.isNotEmpty())
+        {
+            juce::File jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(options.jsonFile);
+            if (!jsonFile.replaceWithText(juce::JSON::toString(json)))
+            {
+                std::cerr << "Error: Failed to write " << jsonFile.getFullPathName() << std::endl;
+                return 1;
+            }
+            std::cout << "\n[Bench] Wrote " << jsonFile.getFullPathName() << std::endl;
+        }
+
+        if (options.baselineFile.isNotEmpty())
+        {
+            juce::File baselineFile = juce::File::getCurrentWorkingDirectory().getChildFile(options.baselineFile);
+            const auto baseline = juce::JSON::parse(baselineFile);
+            if (!baseline.isObject())
+            {
+                std::cerr << "Error: Cannot read baseline " << baselineFile.getFullPathName() << std::endl;
+                return 1;
+            }
+
+            if (baseline["config"]["timeline_samples"] != json["config"]["timeline_samples"]
+                || baseline["config"]["tracks"] != json["config"]["tracks"]
+                || baseline["config"]["clips_per_track"] != json["config"]["clips_per_track"])
+            {
+                std::cout << "\n[Bench] Warning: baseline was recorded with a different timeline" << std::endl;
+            }
+
+            if (!compareWithBaseline(baseline, results, options.tolerancePercent))
+                return 2;
+        }
+
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}